@@ -19,6 +19,7 @@
 #include "viz_constants.h"
 #include "vizd_table_desc.h"
 #include "collector.h"
+#include "stat_rollup.h"
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
@@ -30,10 +31,12 @@ DbHandler::DbHandler(EventManager *evm,
         std::string cassandra_ip, unsigned short cassandra_port, int analytics_ttl, std::string name) :
     dbif_(GenDb::GenDbIf::GenDbIfImpl(evm->io_service(), err_handler,
                 cassandra_ip, cassandra_port, analytics_ttl*3600, name)) {
+    StatRollupInit();
 }
 
 DbHandler::DbHandler(GenDb::GenDbIf *dbif) :
     dbif_(dbif) {
+    StatRollupInit();
 }
 
 DbHandler::~DbHandler() {
@@ -78,6 +81,7 @@ bool DbHandler::CreateTables() {
     key.push_back(g_viz_constants.SYSTEM_OBJECT_ANALYTICS);
 
     bool init_done = false;
+    bool rollup_init_done = false;
     if (dbif_->Db_GetRow(col_list, cfname, key)) {
         for (std::vector<GenDb::NewCol>::iterator it = col_list.columns_.begin();
                 it != col_list.columns_.end(); it++) {
@@ -90,11 +94,14 @@ bool DbHandler::CreateTables() {
 
             if (col_name == g_viz_constants.SYSTEM_OBJECT_START_TIME) {
                 init_done = true;
+            } else if (col_name ==
+                       g_viz_constants.SYSTEM_OBJECT_STAT_ROLLUP_START_TIME) {
+                rollup_init_done = true;
             }
         }
     }
 
-    if (!init_done) {
+    if (!init_done || !rollup_init_done) {
         GenDb::ColList *col_list(new GenDb::ColList);
 
         col_list->cfname_ = g_viz_constants.SYSTEM_OBJECT_TABLE;
@@ -104,7 +111,16 @@ bool DbHandler::CreateTables() {
 
         std::vector<GenDb::NewCol>& columns = col_list->columns_;
 
-        columns.push_back(GenDb::NewCol(g_viz_constants.SYSTEM_OBJECT_START_TIME, UTCTimestampUsec(), 0));
+        uint64_t now = UTCTimestampUsec();
+        if (!init_done) {
+            columns.push_back(GenDb::NewCol(g_viz_constants.SYSTEM_OBJECT_START_TIME, now, 0));
+        }
+        // The query engine reads the rollups only for periods starting
+        // after this time, earlier samples are not in the rollup tables
+        if (!rollup_init_done) {
+            columns.push_back(GenDb::NewCol(
+                g_viz_constants.SYSTEM_OBJECT_STAT_ROLLUP_START_TIME, now, 0));
+        }
 
         std::auto_ptr<GenDb::ColList> col_list_ptr(col_list);
         if (!dbif_->AddColumnSync(col_list_ptr)) {
@@ -116,6 +132,7 @@ bool DbHandler::CreateTables() {
 }
 
 void DbHandler::UnInit(bool shutdown) {
+    StatRollupFlush();
     dbif_->Db_Uninit(shutdown);
     dbif_->Db_SetInitDone(false);
 }
@@ -439,6 +456,81 @@ void DbHandler::StatTableInsert(uint64_t ts,
         }
     }
 
+    {
+        tbb::mutex::scoped_lock lock(rollup_mutex_);
+        for (boost::ptr_vector<StatRollup>::iterator rt = rollups_.begin();
+                rt != rollups_.end(); rt++) {
+            rt->AddSample(ts, statName, statAttr, attribs_tag, attribs);
+        }
+    }
+}
+
+void DbHandler::StatRollupInit() {
+    for (size_t i = 0; i < g_viz_constants._STAT_ROLLUPS.size(); i++) {
+        rollups_.push_back(new StatRollup(g_viz_constants._STAT_ROLLUPS[i]));
+    }
+}
+
+/*
+ * Write the aggregates of all the rollup periods, open or not, to the
+ * rollup tables. Called periodically and on UnInit. Each write uses a new
+ * UUID so that the periods flushed more than once are added up by the
+ * query engine.
+ */
+void DbHandler::StatRollupFlush() {
+    for (boost::ptr_vector<StatRollup>::iterator rt = rollups_.begin();
+            rt != rollups_.end(); rt++) {
+        StatRollup::EntryMap flushed;
+        {
+            tbb::mutex::scoped_lock lock(rollup_mutex_);
+            rt->Flush(&flushed);
+        }
+
+        for (StatRollup::EntryMap::const_iterator it = flushed.begin();
+                it != flushed.end(); it++) {
+            const StatRollup::Key &key = it->first;
+            GenDb::ColList *col_list(new GenDb::ColList);
+            col_list->cfname_ = rt->TableName(key.tag_value.type);
+
+            GenDb::DbDataValue pv;
+            if (key.tag_value.type == UINT64) {
+                pv = key.tag_value.num;
+            } else if (key.tag_value.type == DOUBLE) {
+                pv = key.tag_value.dbl;
+            } else {
+                pv = key.tag_value.str;
+            }
+
+            GenDb::DbDataValueVec& rowkey = col_list->rowkey_;
+            rowkey.push_back((uint32_t)(key.ts >> g_viz_constants.RowTimeInBits));
+            rowkey.push_back(key.stat_name);
+            rowkey.push_back(key.stat_attr);
+            rowkey.push_back(key.tag_name);
+
+            rand_mutex_.lock();
+            boost::uuids::uuid unm(umn_gen_());
+            rand_mutex_.unlock();
+
+            GenDb::DbDataValueVec col_name;
+            col_name.push_back(pv);
+            col_name.push_back(string());
+            col_name.push_back((uint32_t)(key.ts & g_viz_constants.RowTimeInMask));
+            col_name.push_back(unm);
+
+            GenDb::DbDataValueVec col_value;
+            col_value.push_back(StatRollup::Jsonify(key, it->second));
+
+            col_list->columns_.push_back(GenDb::NewCol(col_name, col_value));
+
+            std::auto_ptr<GenDb::ColList> col_list_ptr(col_list);
+            if (!dbif_->NewDb_AddColumn(col_list_ptr)) {
+                LOG(ERROR, __func__ << ": Addition of " << key.stat_name <<
+                        ", " << key.stat_attr << " rollup " << key.tag_name <<
+                        " into table " << rt->TableName(key.tag_value.type) <<
+                        " FAILED");
+            }
+        }
+    }
 }
 
 /* walker to go through all nodes and insert the node that matches listed fields
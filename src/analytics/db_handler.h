@@ -8,6 +8,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -21,6 +22,8 @@
 
 #include "viz_message.h"
 
+class StatRollup;
+
 class DbHandler {
 public:
     static const int DefaultDbTTL = 0;
@@ -75,6 +78,7 @@ public:
             const AttribMap & attribs_all);
 
     bool FlowTableInsert(const RuleMsg& rmsg);
+    void StatRollupFlush();
     bool GetStats(uint64_t &queue_count, uint64_t &enqueues) const;
 
     GenDb::GenDbIf *get_dbif() {
@@ -82,12 +86,18 @@ public:
     }
 
 private:
+    void StatRollupInit();
+
     boost::scoped_ptr<GenDb::GenDbIf> dbif_;
 
     // Random generator for UUIDs
     tbb::mutex rand_mutex_;
     boost::uuids::random_generator umn_gen_;
 
+    // Rollups of the stats samples, from the finest to the coarsest
+    tbb::mutex rollup_mutex_;
+    boost::ptr_vector<StatRollup> rollups_;
+
     DISALLOW_COPY_AND_ASSIGN(DbHandler);
 };
 
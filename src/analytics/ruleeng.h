@@ -38,6 +38,10 @@ class Ruleeng {
             rulelist_->print(os);
         }
 
+        const t_rulelist::t_rulestatsmap& get_rule_stats() const {
+            return rulelist_->get_stats();
+        }
+
         OpServerProxy * GetOSP() { return osp_; }
     private:
         DbHandler *db_handler_;
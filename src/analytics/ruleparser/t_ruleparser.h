@@ -5,13 +5,16 @@
 #ifndef T_RULEENG_H
 #define T_RULEENG_H
 
+#include <map>
 #include <string>
 #include <vector>
 #include <iostream>
 #include <unistd.h>
 #include "boost/lexical_cast.hpp"
 #include <boost/scoped_ptr.hpp>
+#include <boost/ptr_container/ptr_map.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <tbb/atomic.h>
 
 #include "ruleutil.h"
 #include "t_doc.h"
@@ -49,6 +52,14 @@ struct t_rulemsgtype {
                  context_ == rhs.context_));
     }
 
+    bool operator<(const t_rulemsgtype& rhs) const {
+        if (msgtype_ != rhs.msgtype_)
+            return msgtype_ < rhs.msgtype_;
+        if (has_context_ != rhs.has_context_)
+            return has_context_ < rhs.has_context_;
+        return has_context_ && (context_ < rhs.context_);
+    }
+
     bool has_context_;
     std::string msgtype_;
     std::string context_;
@@ -159,13 +170,17 @@ class t_rangevalue {
 
 class t_cond_base {
     public:
-        t_cond_base(std::string fieldid) : fieldid_(fieldid) {}
+        t_cond_base(std::string fieldid) : fieldid_(fieldid) {
+            RuleMsg::field_path(fieldid_, &field_path_);
+        }
         virtual ~t_cond_base() {}
         virtual void print(std::ostream& os) = 0;
         virtual bool rule_match(const RuleMsg& rmsg) = 0;
 
     protected:
         std::string fieldid_;
+        // fieldid_ split on '.' once, when the rule is parsed
+        RuleMsg::FieldPath field_path_;
 };
 
 class t_cond_range : public t_cond_base {
@@ -183,7 +198,7 @@ class t_cond_range : public t_cond_base {
 
     virtual bool rule_match(const RuleMsg& rmsg) {
         std::string type, value;
-        int ret = rmsg.field_value(fieldid_, type, value);
+        int ret = rmsg.field_value(field_path_, type, value);
 
         if (!ret) {
             return rangevalue_->range_check(type, value);
@@ -208,7 +223,7 @@ class t_cond_simple : public t_cond_base {
 
     virtual bool rule_match(const RuleMsg& rmsg) {
         std::string type, value;
-        int ret = rmsg.field_value(fieldid_, type, value);
+        int ret = rmsg.field_value(field_path_, type, value);
 
         if (!ret) {
             if (type == "string") {
@@ -413,17 +428,8 @@ class t_rule : public t_doc {
                      rulemsgtype_->context_ == m.context_));
         }
 
-        void rule_execute(const RuleMsg& rmsg) {
-            if (!((rulemsgtype_->msgtype_ == rmsg.messagetype) &&
-                ((!rulemsgtype_->has_context_ && !rmsg.hdr.__isset.Context) ||
-                 (rulemsgtype_->has_context_ && rmsg.hdr.__isset.Context && rulemsgtype_->context_ == rmsg.hdr.Context)))) {
-                return;
-            }
-
-            if (!condlist_ || condlist_->rule_match(rmsg)) {
-                if (actionlist_)
-                    actionlist_->execute(rmsg);
-            }
+        const t_rulemsgtype& get_msgtype() const {
+            return *rulemsgtype_;
         }
 
         void rule_execute(const RuleMsg& rmsg) const {
@@ -433,10 +439,20 @@ class t_rule : public t_doc {
                 return;
             }
 
+            rule_fire(rmsg);
+        }
+
+        /*
+         * Evaluate the conditions and execute the actions on a match,
+         * the caller has already matched the msgtype and context
+         */
+        bool rule_fire(const RuleMsg& rmsg) const {
             if (!condlist_ || condlist_->rule_match(rmsg)) {
                 if (actionlist_)
                     actionlist_->execute(rmsg);
+                return true;
             }
+            return false;
         }
 
     private:
@@ -446,9 +462,26 @@ class t_rule : public t_doc {
         boost::scoped_ptr<t_ruleactionlist> actionlist_;
 };
 
+/**
+ * t_rulestats - rule evaluations and matches for a msgtype
+ *
+ */
+struct t_rulestats {
+    t_rulestats() {
+        evaluations_ = 0;
+        matches_ = 0;
+    }
+
+    tbb::atomic<uint64_t> evaluations_;
+    tbb::atomic<uint64_t> matches_;
+};
+
 /**
  * t_rulelist consists of all rules parsed in a file
  *
+ * Rules are indexed by msgtype and context when they are added, so a
+ * message only evaluates the rules written for it
+ *
  */
 class t_rulelist: public t_doc {
     public:
@@ -470,6 +503,25 @@ class t_rulelist: public t_doc {
                 }
             }
             rules_.push_back(rule);
+
+            const t_rulemsgtype& msgtype = rule->get_msgtype();
+            t_ruleindexentry& entry = index_[msgtype];
+            if (!entry.stats_) {
+                t_rulestatsmap::iterator it = stats_.find(msgtype.msgtype_);
+                if (it == stats_.end()) {
+                    std::string key(msgtype.msgtype_);
+                    it = stats_.insert(key, new t_rulestats).first;
+                }
+                entry.stats_ = it->second;
+            }
+            entry.rules_.push_back(rule);
+        }
+
+        typedef boost::ptr_map<std::string, t_rulestats> t_rulestatsmap;
+
+        // Per msgtype counters, only msgtypes with rules have an entry
+        const t_rulestatsmap& get_stats() const {
+            return stats_;
         }
 
         boost::ptr_vector<t_rule>& get_rules() {
@@ -484,26 +536,44 @@ class t_rulelist: public t_doc {
         }
 
         bool rule_present(const t_rulemsgtype& msgtype) {
-            boost::ptr_vector<t_rule>::iterator iter;
-            for (iter = rules_.begin(); iter != rules_.end(); iter++) {
-                if ((iter)->rule_present(msgtype)) {
-                    return true;
-                }
-            }
-            return false;
+            return (index_.find(msgtype) != index_.end());
         }
 
         bool rule_execute(const RuleMsg& rmsg) {
             t_ruleaction::RuleActionEchoResult.clear();
 
-            boost::ptr_vector<t_rule>::iterator iter;
-            for (iter = rules_.begin(); iter != rules_.end(); iter++) {
-                (iter)->rule_execute(rmsg);
+            t_rulemsgtype msgtype(rmsg.messagetype);
+            if (rmsg.hdr.__isset.Context) {
+                msgtype.has_context_ = true;
+                msgtype.context_ = rmsg.hdr.Context;
+            }
+            t_ruleindex::const_iterator it = index_.find(msgtype);
+            if (it == index_.end()) {
+                return true;
+            }
+
+            const t_ruleindexentry& entry = it->second;
+            std::vector<t_rule *>::const_iterator iter;
+            for (iter = entry.rules_.begin(); iter != entry.rules_.end(); iter++) {
+                entry.stats_->evaluations_++;
+                if ((*iter)->rule_fire(rmsg)) {
+                    entry.stats_->matches_++;
+                }
             }
             return true;
         }
 
     private:
+        struct t_ruleindexentry {
+            t_ruleindexentry() : stats_(NULL) {}
+
+            // rules for the msgtype and context, in the order added
+            std::vector<t_rule *> rules_;
+            t_rulestats *stats_;
+        };
+        typedef std::map<t_rulemsgtype, t_ruleindexentry> t_ruleindex;
+
+
         // File path
         std::string path_;
 
@@ -512,6 +582,12 @@ class t_rulelist: public t_doc {
 
         // vector of all rules
         boost::ptr_vector<t_rule> rules_;
+
+        // rules_ indexed by msgtype and context
+        t_ruleindex index_;
+
+        // counters per msgtype
+        t_rulestatsmap stats_;
 };
 
 #endif
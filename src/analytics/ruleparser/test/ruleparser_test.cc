@@ -219,6 +219,27 @@ TEST_F(RuleParserTest, RuleActionTest) {
     EXPECT_EQ(" echoaction Rule2 STATS_MSG matched echoaction Rule3 STATS_MSG matched",
             t_ruleaction::RuleActionEchoResult);
 
+    // SYSLOG_MSG without the context does not evaluate Rule1
+    messagetype = "SYSLOG_MSG";
+    unm = boost::uuids::random_generator()();
+    boost::shared_ptr<VizMsg> vmsgp4(new VizMsg(hdr, messagetype, xmlmessage, unm));
+    RuleMsg rmsg4(vmsgp4);
+
+    rulelist->rule_execute(rmsg4);
+
+    EXPECT_EQ("", t_ruleaction::RuleActionEchoResult);
+
+    const t_rulelist::t_rulestatsmap& stats = rulelist->get_stats();
+    t_rulelist::t_rulestatsmap::const_iterator it = stats.find("SYSLOG_MSG");
+    ASSERT_TRUE(it != stats.end());
+    EXPECT_EQ(1U, it->second->evaluations_);
+    EXPECT_EQ(1U, it->second->matches_);
+    it = stats.find("STATS_MSG");
+    ASSERT_TRUE(it != stats.end());
+    EXPECT_EQ(4U, it->second->evaluations_);
+    EXPECT_EQ(3U, it->second->matches_);
+    EXPECT_TRUE(stats.find("UVE_MSG") == stats.end());
+
     delete rulelist;
 }
 
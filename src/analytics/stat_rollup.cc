@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "stat_rollup.h"
+
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+using std::string;
+
+static bool VarIsLess(const DbHandler::Var &lhs, const DbHandler::Var &rhs) {
+    if (lhs.type != rhs.type) {
+        return lhs.type < rhs.type;
+    }
+    switch (lhs.type) {
+    case DbHandler::STRING:
+        return lhs.str < rhs.str;
+    case DbHandler::UINT64:
+        return lhs.num < rhs.num;
+    case DbHandler::DOUBLE:
+        return lhs.dbl < rhs.dbl;
+    default:
+        return false;
+    }
+}
+
+static void AddJsonMember(rapidjson::Document &dd, const string &name,
+                          const DbHandler::Var &value) {
+    rapidjson::Value val(rapidjson::kNumberType);
+    if (value.type == DbHandler::UINT64) {
+        val.SetUint64(value.num);
+    } else {
+        val.SetDouble(value.dbl);
+    }
+    dd.AddMember(name.c_str(), dd.GetAllocator(), val, dd.GetAllocator());
+}
+
+StatRollup::Key::Key(uint64_t t, const string &name, const string &attr,
+                     const string &tname, const DbHandler::Var &tvalue) :
+    ts(t), stat_name(name), stat_attr(attr), tag_name(tname),
+    tag_value(tvalue) {
+}
+
+bool StatRollup::Key::operator<(const Key &rhs) const {
+    if (ts != rhs.ts) return ts < rhs.ts;
+    if (stat_name != rhs.stat_name) return stat_name < rhs.stat_name;
+    if (stat_attr != rhs.stat_attr) return stat_attr < rhs.stat_attr;
+    if (tag_name != rhs.tag_name) return tag_name < rhs.tag_name;
+    return VarIsLess(tag_value, rhs.tag_value);
+}
+
+StatRollup::Aggregate::Aggregate(const DbHandler::Var &value) :
+    sum(value), min(value), max(value) {
+}
+
+void StatRollup::Aggregate::Update(const DbHandler::Var &value) {
+    if (value.type != sum.type) {
+        return;
+    }
+    if (value.type == DbHandler::UINT64) {
+        sum.num += value.num;
+    } else {
+        sum.dbl += value.dbl;
+    }
+    if (VarIsLess(value, min)) {
+        min = value;
+    }
+    if (VarIsLess(max, value)) {
+        max = value;
+    }
+}
+
+StatRollup::StatRollup(const stat_rollup &rollup) :
+    period_((uint64_t)rollup.period * 1000000),
+    str_tag_table_(rollup.str_tag_table),
+    u64_tag_table_(rollup.u64_tag_table),
+    dbl_tag_table_(rollup.dbl_tag_table) {
+}
+
+void StatRollup::AddSample(uint64_t ts, const string &stat_name,
+                           const string &stat_attr,
+                           const DbHandler::TagMap &attribs_tag,
+                           const DbHandler::AttribMap &attribs) {
+    uint64_t start = ts - (ts % period_);
+    for (DbHandler::TagMap::const_iterator it = attribs_tag.begin();
+         it != attribs_tag.end(); ++it) {
+        // Suffix tags are not supported by the stats tables either
+        if (!it->second.second.empty()) {
+            continue;
+        }
+        Key key(start, stat_name, stat_attr, it->first, it->second.first);
+        Entry &entry = entries_[key];
+        entry.count++;
+        for (DbHandler::AttribMap::const_iterator at = attribs.begin();
+             at != attribs.end(); ++at) {
+            if (at->second.type != DbHandler::UINT64 &&
+                at->second.type != DbHandler::DOUBLE) {
+                continue;
+            }
+            std::map<string, Aggregate>::iterator agg =
+                entry.attribs.find(at->first);
+            if (agg == entry.attribs.end()) {
+                entry.attribs.insert(std::make_pair(at->first,
+                                                    Aggregate(at->second)));
+            } else {
+                agg->second.Update(at->second);
+            }
+        }
+    }
+}
+
+void StatRollup::Flush(EntryMap *flushed) {
+    flushed->swap(entries_);
+    entries_.clear();
+}
+
+const string &StatRollup::TableName(DbHandler::VarType tag_type) const {
+    if (tag_type == DbHandler::UINT64) {
+        return u64_tag_table_;
+    } else if (tag_type == DbHandler::DOUBLE) {
+        return dbl_tag_table_;
+    }
+    return str_tag_table_;
+}
+
+string StatRollup::Jsonify(const Key &key, const Entry &entry) {
+    rapidjson::Document dd;
+    dd.SetObject();
+
+    for (std::map<string, Aggregate>::const_iterator it =
+         entry.attribs.begin(); it != entry.attribs.end(); ++it) {
+        AddJsonMember(dd, "SUM(" + it->first + ")", it->second.sum);
+        AddJsonMember(dd, "MIN(" + it->first + ")", it->second.min);
+        AddJsonMember(dd, "MAX(" + it->first + ")", it->second.max);
+    }
+    AddJsonMember(dd, "COUNT(" + key.stat_attr + ")",
+                  DbHandler::Var(entry.count));
+
+    rapidjson::StringBuffer sb;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
+    dd.Accept(writer);
+    return sb.GetString();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef STAT_ROLLUP_H_
+#define STAT_ROLLUP_H_
+
+#include <map>
+#include <string>
+
+#include "db_handler.h"
+#include "viz_types.h"
+
+//
+// StatRollup
+// Aggregates the stats samples over a rollup period (e.g. 1 minute) per
+// stat, tag and tag value. For each numeric attribute, the SUM, MIN and
+// MAX are kept, along with the COUNT of samples.
+//
+// The collector flushes all the periods it has aggregates for on a timer,
+// including the periods that are still open. Each flush is written to the
+// rollup tables with a new UUID, so a period gets one column per flush
+// that saw samples for it, and the query engine adds the columns up. Only
+// the samples received since the last flush are lost on a crash, and the
+// entries kept are bounded by the samples received in one flush interval.
+//
+class StatRollup {
+public:
+    struct Key {
+        Key(uint64_t t, const std::string &name, const std::string &attr,
+            const std::string &tname, const DbHandler::Var &tvalue);
+        bool operator<(const Key &rhs) const;
+
+        uint64_t ts;    // start of the period
+        std::string stat_name;
+        std::string stat_attr;
+        std::string tag_name;
+        DbHandler::Var tag_value;
+    };
+
+    struct Aggregate {
+        explicit Aggregate(const DbHandler::Var &value);
+        void Update(const DbHandler::Var &value);
+
+        DbHandler::Var sum;
+        DbHandler::Var min;
+        DbHandler::Var max;
+    };
+
+    struct Entry {
+        Entry() : count(0) {}
+
+        uint64_t count;
+        std::map<std::string, Aggregate> attribs;
+    };
+    typedef std::map<Key, Entry> EntryMap;
+
+    explicit StatRollup(const stat_rollup &rollup);
+
+    void AddSample(uint64_t ts, const std::string &stat_name,
+                   const std::string &stat_attr,
+                   const DbHandler::TagMap &attribs_tag,
+                   const DbHandler::AttribMap &attribs);
+    // Move the aggregates of all the periods to flushed, which is empty
+    void Flush(EntryMap *flushed);
+
+    const std::string &TableName(DbHandler::VarType tag_type) const;
+    static std::string Jsonify(const Key &key, const Entry &entry);
+
+    uint64_t period() const { return period_; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    uint64_t period_;   // in micro seconds
+    std::string str_tag_table_;
+    std::string u64_tag_table_;
+    std::string dbl_tag_table_;
+    EntryMap entries_;
+
+    DISALLOW_COPY_AND_ASSIGN(StatRollup);
+};
+
+#endif // STAT_ROLLUP_H_
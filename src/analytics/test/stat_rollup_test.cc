@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "testing/gunit.h"
+#include "base/logging.h"
+#include "rapidjson/document.h"
+#include "../viz_constants.h"
+#include "../stat_rollup.h"
+
+class StatRollupTest : public ::testing::Test {
+public:
+    static const uint64_t kMinute = 60 * 1000000ULL;
+
+    StatRollupTest() : rollup_(g_viz_constants._STAT_ROLLUPS[0]) {
+    }
+
+    void AddSample(uint64_t ts, const std::string &vn, uint64_t bytes,
+                   double cpu) {
+        DbHandler::TagMap tags;
+        tags.insert(std::make_pair(std::string("name"),
+            std::make_pair(DbHandler::Var(vn), DbHandler::AttribMap())));
+        DbHandler::AttribMap attribs;
+        attribs.insert(std::make_pair(std::string("name"),
+                                      DbHandler::Var(vn)));
+        attribs.insert(std::make_pair(std::string("vn_stats.in_bytes"),
+                                      DbHandler::Var(bytes)));
+        attribs.insert(std::make_pair(std::string("vn_stats.cpu"),
+                                      DbHandler::Var(cpu)));
+        rollup_.AddSample(ts, "UveVirtualNetworkAgent", "vn_stats", tags,
+                          attribs);
+    }
+
+    StatRollup rollup_;
+};
+
+TEST_F(StatRollupTest, Aggregate) {
+    EXPECT_EQ(60 * 1000000ULL, rollup_.period());
+    uint64_t start = 1000 * kMinute;
+    AddSample(start, "vn1", 100, 1.5);
+    AddSample(start + 10, "vn1", 300, 0.5);
+    AddSample(start + kMinute - 1, "vn1", 200, 2.5);
+    AddSample(start, "vn2", 10, 1.0);
+    AddSample(start + kMinute, "vn1", 1000, 1.0);
+    EXPECT_EQ(3U, rollup_.size());
+
+    StatRollup::EntryMap flushed;
+    rollup_.Flush(&flushed);
+    ASSERT_EQ(3U, flushed.size());
+    EXPECT_EQ(0U, rollup_.size());
+
+    StatRollup::EntryMap::const_iterator it = flushed.begin();
+    EXPECT_EQ(start, it->first.ts);
+    EXPECT_EQ("name", it->first.tag_name);
+    EXPECT_EQ("vn1", it->first.tag_value.str);
+    EXPECT_EQ(3U, it->second.count);
+    EXPECT_EQ(g_viz_constants.STATS_ROLLUP_1M_BY_STR_TAG,
+              rollup_.TableName(it->first.tag_value.type));
+
+    // String attributes are not rolled up
+    EXPECT_EQ(2U, it->second.attribs.size());
+    const StatRollup::Aggregate &bytes =
+        it->second.attribs.find("vn_stats.in_bytes")->second;
+    EXPECT_EQ(600U, bytes.sum.num);
+    EXPECT_EQ(100U, bytes.min.num);
+    EXPECT_EQ(300U, bytes.max.num);
+    const StatRollup::Aggregate &cpu =
+        it->second.attribs.find("vn_stats.cpu")->second;
+    EXPECT_DOUBLE_EQ(4.5, cpu.sum.dbl);
+    EXPECT_DOUBLE_EQ(0.5, cpu.min.dbl);
+    EXPECT_DOUBLE_EQ(2.5, cpu.max.dbl);
+
+    rapidjson::Document d;
+    std::string json(StatRollup::Jsonify(it->first, it->second));
+    d.Parse<0>(const_cast<char *>(json.c_str()));
+    EXPECT_EQ(600U, d["SUM(vn_stats.in_bytes)"].GetUint64());
+    EXPECT_EQ(300U, d["MAX(vn_stats.in_bytes)"].GetUint64());
+    EXPECT_DOUBLE_EQ(0.5, d["MIN(vn_stats.cpu)"].GetDouble());
+    EXPECT_EQ(3U, d["COUNT(vn_stats)"].GetUint64());
+
+    ++it;
+    EXPECT_EQ("vn2", it->first.tag_value.str);
+    EXPECT_EQ(1U, it->second.count);
+}
+
+// Samples for a period that is already flushed are flushed on their own
+TEST_F(StatRollupTest, IncrementalFlush) {
+    uint64_t start = 1000 * kMinute;
+    AddSample(start, "vn1", 100, 1.0);
+    StatRollup::EntryMap flushed;
+    rollup_.Flush(&flushed);
+    EXPECT_EQ(1U, flushed.size());
+
+    flushed.clear();
+    AddSample(start + 30, "vn1", 50, 1.0);
+    AddSample(start + kMinute, "vn1", 70, 1.0);
+    rollup_.Flush(&flushed);
+    ASSERT_EQ(2U, flushed.size());
+    StatRollup::EntryMap::const_iterator it = flushed.begin();
+    EXPECT_EQ(start, it->first.ts);
+    EXPECT_EQ(1U, it->second.count);
+    EXPECT_EQ(50U, it->second.attribs.find(
+        "vn_stats.in_bytes")->second.sum.num);
+    ++it;
+    EXPECT_EQ(start + kMinute, it->first.ts);
+    EXPECT_EQ(70U, it->second.attribs.find(
+        "vn_stats.in_bytes")->second.sum.num);
+
+    // Nothing is written when no sample came in since the last flush
+    flushed.clear();
+    rollup_.Flush(&flushed);
+    EXPECT_TRUE(flushed.empty());
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -41,6 +41,19 @@ TEST_F(VizMessageTest, Test1) {
     EXPECT_EQ(type, "i32");
     EXPECT_EQ(boost::lexical_cast<int>(value), boost::lexical_cast<int>("003"));
 
+    RuleMsg::FieldPath path;
+    RuleMsg::field_path("field2.field22", &path);
+    ASSERT_EQ(2U, path.size());
+    ret = rmsg.field_value(path, type, value);
+    EXPECT_EQ(ret, 0);
+    EXPECT_EQ(value, "string22");
+
+    // field1 is not a struct
+    ret = rmsg.field_value("field1.field22", type, value);
+    EXPECT_EQ(ret, -1);
+    ret = rmsg.field_value("field4", type, value);
+    EXPECT_EQ(ret, -1);
+
     RuleMsg::RuleMsgPredicate p1("First");
     p1 = std::string("Second");
     EXPECT_EQ(p1.tmp_, "Second");
@@ -34,6 +34,9 @@ VizCollector::VizCollector(EventManager *evm, unsigned short listen_port,
             cassandra_ip, cassandra_port, analytics_ttl)),
     dbif_timer_(TimerManager::CreateTimer(
             *evm_->io_service(), "Collector DbIf Timer",
+            TaskScheduler::GetInstance()->GetTaskId("collector::DbIf"))),
+    stat_rollup_timer_(TimerManager::CreateTimer(
+            *evm_->io_service(), "Collector Stat Rollup Timer",
             TaskScheduler::GetInstance()->GetTaskId("collector::DbIf"))) {
     error_code error;
     if (dup)
@@ -51,6 +54,9 @@ VizCollector::VizCollector(EventManager *evm, DbHandler *db_handler,
     collector_(collector),
     dbif_timer_(TimerManager::CreateTimer(
             *evm_->io_service(), "Collector DbIf Timer",
+            TaskScheduler::GetInstance()->GetTaskId("collector::DbIf"))),
+    stat_rollup_timer_(TimerManager::CreateTimer(
+            *evm_->io_service(), "Collector Stat Rollup Timer",
             TaskScheduler::GetInstance()->GetTaskId("collector::DbIf"))) {
     error_code error;
     name_ = boost::asio::ip::host_name(error);
@@ -58,6 +64,7 @@ VizCollector::VizCollector(EventManager *evm, DbHandler *db_handler,
 
 VizCollector::~VizCollector() {
     TimerManager::DeleteTimer(dbif_timer_);
+    TimerManager::DeleteTimer(stat_rollup_timer_);
 }
 
 std::string VizCollector::DbifGlobalName(bool dup) {
@@ -105,6 +112,8 @@ void VizCollector::Shutdown() {
 
     TimerManager::DeleteTimer(dbif_timer_);
     dbif_timer_ = NULL;
+    TimerManager::DeleteTimer(stat_rollup_timer_);
+    stat_rollup_timer_ = NULL;
 
     db_handler_->UnInit(true);
 }
@@ -132,6 +141,21 @@ void VizCollector::StartDbifReinit() {
     StartDbifReinitTimer();
 }
 
+bool VizCollector::StatRollupTimerExpired() {
+    db_handler_->StatRollupFlush();
+    return true;
+}
+
+void VizCollector::StartStatRollupTimer() {
+    if (stat_rollup_timer_->running()) {
+        return;
+    }
+    stat_rollup_timer_->Start(g_viz_constants.STAT_ROLLUP_FLUSH_TIME * 1000,
+            boost::bind(&VizCollector::StatRollupTimerExpired, this),
+            boost::bind(&VizCollector::DbifReinitTimerErrorHandler, this,
+                    _1, _2));
+}
+
 bool VizCollector::Init() {
     if (!db_handler_->Init()) {
         LOG(DEBUG, __func__ << " DB Handler initialization failed");
@@ -139,6 +163,7 @@ bool VizCollector::Init() {
         return false;
     }
     ruleeng_->Init();
+    StartStatRollupTimer();
     LOG(DEBUG, __func__ << " Initialization complete");
     return true;
 }
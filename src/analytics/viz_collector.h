@@ -66,6 +66,7 @@ private:
     std::string name_;
 
     Timer *dbif_timer_;
+    Timer *stat_rollup_timer_;
 
     void Ruleeng_Initialize(); 
     void DbifReinit_fromdb();
@@ -73,6 +74,8 @@ private:
     void DbifReinitTimerErrorHandler(std::string error_name, std::string error_message);
     void StartDbifReinitTimer();
     void StartDbifReinit();
+    bool StatRollupTimerExpired();
+    void StartStatRollupTimer();
 
     std::string DbifGlobalName(bool dup=false);
 
@@ -17,38 +17,54 @@ RuleMsg::RuleMsg(const boost::shared_ptr<VizMsg> vmsgp) : hdr(vmsgp->hdr),
 RuleMsg::~RuleMsg() {
 }
 
-int RuleMsg::field_value_recur(const std::string& field_id, std::string& type, std::string& value, pugi::xml_node doc) const {
-    size_t dotpos;
-    if ((dotpos = field_id.find_first_of('.')) != std::string::npos) {
-        std::string parent = field_id.substr(0, dotpos);
-        std::string children = field_id.substr(dotpos+1);
+namespace {
 
-        RuleMsgPredicate p1(parent);
+// Same as RuleMsg::RuleMsgPredicate, without the copy of the name
+struct FieldNamePredicate {
+    explicit FieldNamePredicate(const std::string &name) : name_(name) { }
+    bool operator()(pugi::xml_node node) const {
+        return (strcmp(node.name(), name_.c_str()) == 0);
+    }
+    const std::string &name_;
+};
+
+} // namespace
 
-        pugi::xml_node node = doc.find_node(p1);
+void RuleMsg::field_path(const std::string& field_id, FieldPath *path) {
+    path->clear();
+    size_t start = 0, dotpos;
+    while ((dotpos = field_id.find_first_of('.', start)) != std::string::npos) {
+        path->push_back(field_id.substr(start, dotpos - start));
+        start = dotpos + 1;
+    }
+    path->push_back(field_id.substr(start));
+}
+
+int RuleMsg::field_value(const FieldPath& field_path, std::string& type, std::string& value) const {
+    if (field_path.empty()) {
+        return -1;
+    }
+
+    pugi::xml_node node = doc_;
+    for (size_t i = 0; i < field_path.size(); i++) {
+        node = node.find_node(FieldNamePredicate(field_path[i]));
         if (node.type() == pugi::node_null) {
             return -1;
         }
-
-        const char *ret;
-        ret = node.attribute("type").value();
-        if (strncmp("struct", ret, 6))
+        // Only a struct has children to look into
+        if ((i + 1 < field_path.size()) &&
+            strncmp("struct", node.attribute("type").value(), 6)) {
             return -1;
-
-        return (field_value_recur(children, type, value, node));
-    }
-    
-    RuleMsgPredicate p1(field_id);
-    pugi::xml_node node = doc.find_node(p1);
-    if (node.type() == pugi::node_null) {
-        return -1;
+        }
     }
-    value = node.child_value();;
+    value = node.child_value();
     type = node.attribute("type").value();
 
     return 0;
 }
 
 int RuleMsg::field_value(const std::string& field_id, std::string& type, std::string& value) const {
-    return field_value_recur(field_id, type, value, doc_);
+    FieldPath path;
+    field_path(field_id, &path);
+    return field_value(path, type, value);
 }
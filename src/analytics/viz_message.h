@@ -6,6 +6,7 @@
 #define __VIZ_MESSAGE_H__
 
 #include <string>
+#include <vector>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -38,7 +39,12 @@ struct RuleMsg {
         RuleMsg(const boost::shared_ptr<VizMsg> vmsgp);
         ~RuleMsg();
 
+        // field_id split on '.', e.g. "field2.field21"
+        typedef std::vector<std::string> FieldPath;
+        static void field_path(const std::string& field_id, FieldPath *path);
+
         int field_value(const std::string& field_id, std::string& type, std::string& value) const;
+        int field_value(const FieldPath& field_path, std::string& type, std::string& value) const;
         SandeshHeader hdr;
         std::string messagetype;
 
@@ -59,8 +65,6 @@ struct RuleMsg {
 
     private:
 
-        int field_value_recur(const std::string& field_id, std::string& type, std::string& value, pugi::xml_node doc) const;
-
         pugi::xml_document doc_;
 };
 
@@ -401,4 +401,35 @@ void init_vizd_tables() {
                 (GenDb::DbDataType::LexicalUUIDType)
                 ))
         ;
+
+/* Stats Rollup Tables by String, U64 and Double tag
+ * The schema is as follows:
+ *   RowKey      : T2, StatName, StatAttr, TagName
+ *   ColumnName  : TagValue, Tag2 Value, T1 of the period start, RollupUUID
+ *   ColumnValue : JSON of SUM/MIN/MAX(attrib):value and COUNT(StatAttr):value */
+    for (size_t i = 0; i < g_viz_constants._STAT_ROLLUPS.size(); i++) {
+        const stat_rollup &rollup = g_viz_constants._STAT_ROLLUPS[i];
+        const std::string cfnames[] = { rollup.str_tag_table,
+            rollup.u64_tag_table, rollup.dbl_tag_table };
+        const GenDb::DbDataType::type tag_types[] = {
+            GenDb::DbDataType::AsciiType,
+            GenDb::DbDataType::Unsigned64Type,
+            GenDb::DbDataType::DoubleType };
+        for (size_t j = 0; j < 3; j++) {
+            vizd_flow_tables.push_back(GenDb::NewCf(cfnames[j],
+                      boost::assign::list_of
+                      (GenDb::DbDataType::Unsigned32Type)
+                      (GenDb::DbDataType::AsciiType)
+                      (GenDb::DbDataType::AsciiType)
+                      (GenDb::DbDataType::AsciiType),
+                      boost::assign::list_of
+                      (tag_types[j])
+                      (GenDb::DbDataType::AsciiType)
+                      (GenDb::DbDataType::Unsigned32Type)
+                      (GenDb::DbDataType::LexicalUUIDType),
+                      boost::assign::list_of
+                      (GenDb::DbDataType::AsciiType)
+                     ));
+        }
+    }
 }
@@ -4,11 +4,13 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
 #include "tbb/atomic.h"
 #include "io/test/event_manager_test.h"
 #include "base/test/task_test_util.h"
 #include "base/logging.h"
 #include "base/timer.h"
+#include "base/util.h"
 #include "testing/gunit.h"
 
 using namespace std;
@@ -248,6 +250,142 @@ TEST_F(TimerUT, cancel_fired) {
 }
 
 
+class TimerWheelUT : public TimerUT {
+public:
+    virtual void SetUp() {
+        TimerManager::set_wheel_backend(true);
+        TimerUT::SetUp();
+    }
+
+    virtual void TearDown() {
+        TimerUT::TearDown();
+        TimerManager::set_wheel_backend(false);
+    }
+
+    TimerWheel::Stats GetWheelStats() {
+        return boost::asio::use_service<TimerWheel>(
+            *evm_->io_service()).GetStats();
+    }
+};
+
+TEST_F(TimerWheelUT, basic_1) {
+    TimerTest *timer1 = new TimerTest(*evm_->io_service(), "Basic-1");
+    TimerTest *timer2 = new TimerTest(*evm_->io_service(), "Basic-2");
+    timer1->Start(100, TimerCb);
+    timer2->Start(100, TimerCb);
+    ValidateTimerCount(2, 100);
+    task_util::WaitForIdle();
+
+    // Both run from the same task, unless started across a tick boundary
+    TimerWheel::Stats stats = GetWheelStats();
+    EXPECT_EQ(2U, stats.timers_fired);
+    EXPECT_GE(2U, stats.tasks);
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer1));
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer2));
+}
+
+TEST_F(TimerWheelUT, basic_periodic) {
+    TimerTest *timer1 = new TimerTest(*evm_->io_service(), "Basic-1");
+
+    timer_count_ = 20;
+    timer1->Start(1, PeriodicTimerCb);
+    ValidateTimerCount(0, 200);
+
+    task_util::WaitForIdle();
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer1));
+}
+
+// Timers beyond level 0 are cascaded down before they expire.
+TEST_F(TimerWheelUT, cascade) {
+    TimerTest *timer1 = new TimerTest(*evm_->io_service(), "Cascade-1");
+    TimerTest *timer2 = new TimerTest(*evm_->io_service(), "Cascade-2");
+    int level1 = TimerWheel::kSlots * TimerWheel::kTickMsec * 2;
+    uint64_t start = UTCTimestampUsec();
+    timer1->Start(level1, TimerCb);
+    timer2->Start(level1 + 100, TimerCb);
+    TASK_UTIL_EXPECT_EQ(1, timer_count_);
+    EXPECT_LE((uint64_t) level1 * 1000, UTCTimestampUsec() - start);
+    TASK_UTIL_EXPECT_EQ(2, timer_count_);
+    EXPECT_LE((uint64_t) (level1 + 100) * 1000, UTCTimestampUsec() - start);
+    task_util::WaitForIdle();
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer1));
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer2));
+}
+
+TEST_F(TimerWheelUT, cancel_running_1) {
+    TimerTest *timer1 = new TimerTest(*evm_->io_service(), "Cancel-1");
+    timer1->Start(10, TimerCb);
+    EXPECT_TRUE(timer1->Cancel());
+    ValidateTimerCount(0, 100);
+
+    timer1->Start(10, TimerCb);
+    ValidateTimerCount(1, 30);
+    task_util::WaitForIdle();
+
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer1));
+}
+
+// Cancel after the expiry, while the wheel task is pending
+TEST_F(TimerWheelUT, cancel_running_2) {
+    TimerTest *timer1 = new TimerTest(*evm_->io_service(), "Init-1");
+    TaskScheduler::GetInstance()->Stop();
+    timer1->Start(10, TimerCb);
+    usleep(50 * 1000);
+    TASK_UTIL_EXPECT_TRUE(timer1->Cancel());
+    TaskScheduler::GetInstance()->Start();
+    ValidateTimerCount(0, 20);
+    task_util::WaitForIdle();
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer1));
+}
+
+TEST_F(TimerWheelUT, destroy_running_1) {
+    TimerTest *timer1 = new TimerTest(*evm_->io_service(), "Init-1");
+    timer1->Start(10, TimerCb);
+    EXPECT_TRUE(TimerManager::DeleteTimer(timer1));
+    ValidateTimerCount(0, 50);
+}
+
+//
+// Benchmark: start 100K timers spread over a second and wait for all of
+// them to fire, with either backend.
+//
+static void TimerScale(EventManager *evm, const char *backend) {
+    const int kTimers = 100 * 1000;
+    std::vector<Timer *> timers;
+
+    uint64_t start = UTCTimestampUsec();
+    for (int i = 0; i < kTimers; i++) {
+        timers.push_back(TimerManager::CreateTimer(*evm->io_service(),
+                                                   "Scale"));
+        timers.back()->Start(100 + (i % 1000), TimerCb);
+    }
+    uint64_t started = UTCTimestampUsec();
+    TASK_UTIL_EXPECT_EQ(kTimers, timer_count_);
+    uint64_t fired = UTCTimestampUsec();
+
+    for (int i = 0; i < kTimers; i++) {
+        EXPECT_TRUE(TimerManager::DeleteTimer(timers[i]));
+    }
+    uint64_t deleted = UTCTimestampUsec();
+    cout << backend << ": " << kTimers << " timers, start "
+         << (started - start) << " usecs, fire "
+         << (fired - start) << " usecs, delete "
+         << (deleted - fired) << " usecs" << endl;
+}
+
+TEST_F(TimerUT, scale_100k) {
+    TimerScale(evm_.get(), "asio");
+    task_util::WaitForIdle();
+}
+
+TEST_F(TimerWheelUT, scale_100k) {
+    TimerScale(evm_.get(), "wheel");
+    task_util::WaitForIdle();
+    TimerWheel::Stats stats = GetWheelStats();
+    cout << "wheel: " << stats.timers_fired << " timers run by "
+         << stats.tasks << " tasks in " << stats.ticks << " ticks" << endl;
+}
+
 int main(int argc, char *argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     scheduler = TaskScheduler::GetInstance();
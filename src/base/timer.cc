@@ -4,6 +4,8 @@
 
 #include "base/timer.h"
 
+#include <map>
+
 class Timer::TimerTask : public Task {
 public:
     TimerTask(TimerPtr timer, boost::system::error_code ec)
@@ -73,8 +75,12 @@ Timer::Timer(boost::asio::io_service &service, const std::string &name,
           int task_id, int task_instance)
     : boost::asio::deadline_timer(service), name_(name), handler_(NULL),
     error_handler_(NULL), state_(Init), timer_task_(NULL), time_(0),
-    task_id_(task_id), task_instance_(task_instance), seq_no_(0) {
+    task_id_(task_id), task_instance_(task_instance), seq_no_(0),
+    wheel_(NULL), wheel_slot_(NULL), wheel_expiry_(0), wheel_seq_no_(0) {
     refcount_ = 0;
+    if (TimerManager::wheel_backend()) {
+        wheel_ = &boost::asio::use_service<TimerWheel>(service);
+    }
 }
 
 Timer::~Timer() {
@@ -101,6 +107,14 @@ bool Timer::Start(int time, Handler handler, ErrorHandler error_handler) {
     handler_ = handler;
     seq_no_++;
     error_handler_ = error_handler;
+
+    if (wheel_) {
+        time_ = time;
+        SetState(Running);
+        wheel_->Add(this, time);
+        return true;
+    }
+
     boost::system::error_code ec;
     expires_from_now(boost::posix_time::milliseconds(time), ec);
     if (ec) {
@@ -131,6 +145,12 @@ bool Timer::Cancel() {
         timer_task_ = NULL;
     }
 
+    // A timer that already expired from the wheel is skipped by the wheel
+    // task once cancelled
+    if (wheel_) {
+        wheel_->Remove(this);
+    }
+
     SetState(Cancelled);
     return true;
 }
@@ -161,11 +181,35 @@ void Timer::StartTimerTask(boost::asio::deadline_timer* t, TimerPtr timer,
     TaskScheduler::GetInstance()->Enqueue(timer->timer_task_);
 }
 
+void Timer::RunWheelHandler(uint32_t seq_no) {
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+
+        // Cancelled, or cancelled and started again, after the expiry
+        if (state_ != Running || seq_no_ != seq_no) {
+            return;
+        }
+        SetState(Fired);
+    }
+
+    bool restart = handler_();
+
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        SetState(Init);
+    }
+
+    if (restart) {
+        Start(time_, handler_, error_handler_);
+    }
+}
+
 //
 // TimerManager class routines
 //
 TimerManager::TimerSet TimerManager::timer_ref_;
 tbb::mutex TimerManager::mutex_;
+bool TimerManager::wheel_backend_ = false;
 
 Timer *TimerManager::CreateTimer(
             boost::asio::io_service &service, const std::string &name,
@@ -197,3 +241,227 @@ bool TimerManager::DeleteTimer(Timer *timer) {
     return true;
 }
 
+
+//
+// TimerWheel class routines
+//
+boost::asio::io_service::id TimerWheel::id;
+
+// Runs the wheel timers of a task id and instance that are due in a tick
+class TimerWheel::WheelTask : public Task {
+public:
+    WheelTask(int task_id, int task_instance)
+        : Task(task_id, task_instance) {
+    }
+
+    void Add(const TimerPtr &timer, uint32_t seq_no) {
+        timers_.push_back(std::make_pair(timer, seq_no));
+    }
+
+    virtual bool Run() {
+        for (TimerList::iterator iter = timers_.begin();
+             iter != timers_.end(); ++iter) {
+            RunTimer(iter->first.get(), iter->second);
+        }
+        return true;
+    }
+
+private:
+    TimerList timers_;
+    DISALLOW_COPY_AND_ASSIGN(WheelTask);
+};
+
+TimerWheel::TimerWheel(boost::asio::io_service &service)
+    : boost::asio::io_service::service(service), tick_timer_(service),
+      start_time_(boost::asio::deadline_timer::traits_type::now()),
+      tick_running_(false), next_tick_(0), count_(0) {
+}
+
+TimerWheel::~TimerWheel() {
+}
+
+void TimerWheel::shutdown_service() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    boost::system::error_code ec;
+    tick_timer_.cancel(ec);
+    for (int level = 0; level < kLevels; level++) {
+        for (int index = 0; index < kSlots; index++) {
+            Slot &slot = slots_[level][index];
+            for (Slot::iterator iter = slot.begin(); iter != slot.end();
+                 ++iter) {
+                (*iter)->wheel_slot_ = NULL;
+            }
+            slot.clear();
+        }
+    }
+    count_ = 0;
+}
+
+uint64_t TimerWheel::NowMsec() const {
+    boost::posix_time::time_duration elapsed =
+        boost::asio::deadline_timer::traits_type::now() - start_time_;
+    return elapsed.total_milliseconds();
+}
+
+// Returns the slot for an expiry tick relative to next_tick_
+TimerWheel::Slot *TimerWheel::GetSlot(uint64_t expiry) {
+    const uint64_t max_ticks = 1ULL << (kSlotBits * kLevels);
+    uint64_t delta = (expiry > next_tick_) ? expiry - next_tick_ : 0;
+    if (delta >= max_ticks) {
+        delta = max_ticks - 1;
+    }
+    expiry = next_tick_ + delta;
+
+    int level = 0;
+    while (delta >= (1ULL << (kSlotBits * (level + 1)))) {
+        level++;
+    }
+    int index = (expiry >> (kSlotBits * level)) & (kSlots - 1);
+    return &slots_[level][index];
+}
+
+// Move the timer to the slot of its expiry. Iterators stay valid across
+// the splice.
+void TimerWheel::Insert(Timer *timer, Slot *from, Slot::iterator iter) {
+    Slot *slot = GetSlot(timer->wheel_expiry_);
+    slot->splice(slot->end(), *from, iter);
+    timer->wheel_slot_ = slot;
+    timer->wheel_iter_ = iter;
+}
+
+void TimerWheel::Add(Timer *timer, int time) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    assert(timer->wheel_slot_ == NULL);
+
+    uint64_t now = NowMsec();
+    if (count_ == 0) {
+        // All slots are empty, skip the idle ticks
+        next_tick_ = now / kTickMsec;
+    }
+
+    // Round up so that the timer never fires early
+    timer->wheel_expiry_ = (now + time + kTickMsec - 1) / kTickMsec;
+    timer->wheel_seq_no_ = timer->seq_no_;
+
+    Slot pending;
+    pending.push_back(TimerPtr(timer));
+    Insert(timer, &pending, pending.begin());
+    count_++;
+    StartTick();
+}
+
+void TimerWheel::Remove(Timer *timer) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    if (timer->wheel_slot_ == NULL) {
+        return;
+    }
+    Slot *slot = timer->wheel_slot_;
+    timer->wheel_slot_ = NULL;
+    count_--;
+    // Erasing may drop the last reference, do it last
+    slot->erase(timer->wheel_iter_);
+}
+
+void TimerWheel::Cascade(int level, int index) {
+    Slot pending;
+    pending.splice(pending.end(), slots_[level][index]);
+    while (!pending.empty()) {
+        Insert(pending.front().get(), &pending, pending.begin());
+    }
+}
+
+// Must be called with the mutex held
+void TimerWheel::StartTick() {
+    if (tick_running_ || count_ == 0) {
+        return;
+    }
+    boost::system::error_code ec;
+    tick_timer_.expires_at(start_time_ +
+        boost::posix_time::milliseconds(next_tick_ * kTickMsec), ec);
+    tick_timer_.async_wait(
+        boost::bind(&TimerWheel::TickHandler, this,
+                    boost::asio::placeholders::error));
+    tick_running_ = true;
+}
+
+void TimerWheel::TickHandler(const boost::system::error_code &ec) {
+    if (ec && ec.value() == boost::asio::error::operation_aborted) {
+        return;
+    }
+
+    TimerList due;
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        tick_running_ = false;
+        uint64_t now_tick = NowMsec() / kTickMsec;
+        while (next_tick_ <= now_tick && count_) {
+            int index = next_tick_ & (kSlots - 1);
+            if (index == 0) {
+                for (int level = 1; level < kLevels; level++) {
+                    int level_index =
+                        (next_tick_ >> (kSlotBits * level)) & (kSlots - 1);
+                    Cascade(level, level_index);
+                    if (level_index != 0) break;
+                }
+            }
+
+            Slot &slot = slots_[0][index];
+            uint64_t tick = next_tick_++;
+            stats_.ticks++;
+            while (!slot.empty()) {
+                Timer *timer = slot.front().get();
+                if (timer->wheel_expiry_ > tick) {
+                    // Parked beyond the last level
+                    Insert(timer, &slot, slot.begin());
+                    continue;
+                }
+                due.push_back(std::make_pair(slot.front(),
+                                             timer->wheel_seq_no_));
+                timer->wheel_slot_ = NULL;
+                slot.pop_front();
+                count_--;
+            }
+        }
+        if (count_ == 0) {
+            next_tick_ = now_tick + 1;
+        }
+        StartTick();
+        stats_.timers_fired += due.size();
+    }
+
+    // Batch the callbacks into one task per task id and instance
+    typedef std::map<std::pair<int, int>, WheelTask *> TaskMap;
+    TaskMap tasks;
+    for (TimerList::iterator iter = due.begin(); iter != due.end(); ++iter) {
+        Timer *timer = iter->first.get();
+        std::pair<int, int> key(timer->task_id_, timer->task_instance_);
+        TaskMap::iterator task_iter = tasks.find(key);
+        if (task_iter == tasks.end()) {
+            task_iter = tasks.insert(std::make_pair(key,
+                new WheelTask(key.first, key.second))).first;
+        }
+        task_iter->second->Add(iter->first, iter->second);
+    }
+
+    TaskScheduler *scheduler = TaskScheduler::GetInstance();
+    for (TaskMap::iterator iter = tasks.begin(); iter != tasks.end(); ++iter) {
+        scheduler->Enqueue(iter->second);
+    }
+
+    tbb::mutex::scoped_lock lock(mutex_);
+    stats_.tasks += tasks.size();
+}
+
+void TimerWheel::RunTimer(Timer *timer, uint32_t seq_no) {
+    timer->RunWheelHandler(seq_no);
+}
+
+size_t TimerWheel::size() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return count_;
+}
+
+TimerWheel::Stats TimerWheel::GetStats() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return stats_;
+}
@@ -24,6 +24,15 @@
 //    Cancels the timer and triggers deletion of the timer. Application should
 //    not access the timer after its deleted
 //
+//  Backends:
+//  - By default each timer is its own asio deadline_timer and every expiry
+//    enqueues a TimerTask
+//  - With TimerManager::set_wheel_backend(true), timers created afterwards
+//    are kept in a TimerWheel per io_service instead. The wheel runs a
+//    single asio timer that ticks every TimerWheel::kTickMsec, and the
+//    timers due in a tick are run by one task per task id and instance.
+//    Expiry is rounded up to the tick.
+//
 //  Concurrency aspects:
 //  - Timer is allocated by application
 //  - Applications must call TimerManager::DeleteTimer() to delete the timer
@@ -44,10 +53,14 @@
 #include <boost/function.hpp>
 #include <boost/asio.hpp>
 #include <boost/system/error_code.hpp>
+#include <list>
 #include <set>
+#include <vector>
 
 #include <base/task.h>
 
+class TimerWheel;
+
 class Timer : public boost::asio::deadline_timer {
 private:
 	// Task used to fire the timer
@@ -106,10 +119,12 @@ public:
 private:
     friend class TimerManager;
     friend class TimerTest;
+    friend class TimerWheel;
 
     friend void intrusive_ptr_add_ref(Timer *timer);
     friend void intrusive_ptr_release(Timer *timer);
     typedef boost::intrusive_ptr<Timer> TimerPtr;
+    typedef std::list<TimerPtr> WheelSlot;
 
     enum TimerState {
         Init            = 0,
@@ -123,6 +138,9 @@ private:
                                int time, uint32_t seq_no,
                                const boost::system::error_code &ec);
 
+    // Invoked from the TimerWheel task on expiry
+    void RunWheelHandler(uint32_t seq_no);
+
     void SetState(TimerState s) { state_ = s; }
     static int GetTimerInstanceId() { return -1; }
     static int GetTimerTaskId() {
@@ -146,6 +164,14 @@ private:
     int task_instance_;
     uint32_t seq_no_;
     tbb::atomic<int> refcount_;
+
+    // Timing wheel backend, NULL for the asio backend. The wheel_ fields
+    // below are protected by the wheel mutex.
+    TimerWheel *wheel_;
+    WheelSlot *wheel_slot_;         // NULL if not in the wheel
+    WheelSlot::iterator wheel_iter_;
+    uint64_t wheel_expiry_;         // in ticks
+    uint32_t wheel_seq_no_;
 };
 
 inline void intrusive_ptr_add_ref(Timer *timer) {
@@ -179,6 +205,10 @@ public:
                               int task_instance = Timer::GetTimerInstanceId());
     static bool DeleteTimer(Timer *Timer);
 
+    // Use the TimerWheel for timers created afterwards
+    static void set_wheel_backend(bool enable) { wheel_backend_ = enable; }
+    static bool wheel_backend() { return wheel_backend_; }
+
 private:
     friend class TimerTest;
 
@@ -194,6 +224,74 @@ private:
 
     static tbb::mutex mutex_;
     static TimerSet timer_ref_;
+    static bool wheel_backend_;
+};
+
+//
+// Hierarchical timing wheel serving all the wheel backed timers of an
+// io_service. It is an asio service, so it is created on first use and
+// destroyed with the io_service.
+//
+// There are kLevels levels of kSlots slots. Level 0 has one slot per tick,
+// each slot of level n spans the whole of level n-1. Timers are cascaded to
+// the lower level when the tick reaches their slot. Timers beyond the last
+// level are parked in its farthest slot and cascaded again.
+//
+// The asio timer only runs while there are timers in the wheel.
+//
+class TimerWheel : public boost::asio::io_service::service {
+public:
+    static boost::asio::io_service::id id;
+
+    static const int kTickMsec = 10;
+    static const int kSlotBits = 6;
+    static const int kSlots = 1 << kSlotBits;
+    static const int kLevels = 4;
+
+    struct Stats {
+        Stats() : ticks(0), timers_fired(0), tasks(0) {
+        }
+        uint64_t ticks;
+        uint64_t timers_fired;
+        uint64_t tasks;
+    };
+
+    explicit TimerWheel(boost::asio::io_service &service);
+    virtual ~TimerWheel();
+
+    // Called with the timer mutex held
+    void Add(Timer *timer, int time);
+    void Remove(Timer *timer);
+
+    size_t size() const;
+    Stats GetStats() const;
+
+private:
+    class WheelTask;
+    typedef boost::intrusive_ptr<Timer> TimerPtr;
+    typedef Timer::WheelSlot Slot;
+    typedef std::vector<std::pair<TimerPtr, uint32_t> > TimerList;
+
+    virtual void shutdown_service();
+
+    uint64_t NowMsec() const;
+    Slot *GetSlot(uint64_t expiry);
+    void Insert(Timer *timer, Slot *from, Slot::iterator iter);
+    void Cascade(int level, int index);
+    void StartTick();
+    void TickHandler(const boost::system::error_code &ec);
+    static void RunTimer(Timer *timer, uint32_t seq_no);
+
+    mutable tbb::mutex mutex_;
+    boost::asio::deadline_timer tick_timer_;
+    boost::posix_time::ptime start_time_;
+    bool tick_running_;
+    uint64_t next_tick_;            // next tick to be processed
+    size_t count_;
+    Slot slots_[kLevels][kSlots];
+    Stats stats_;
+
+    DISALLOW_COPY_AND_ASSIGN(TimerWheel);
 };
 
 #endif /* TIMER_H_ */
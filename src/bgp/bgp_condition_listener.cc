@@ -4,6 +4,8 @@
 
 #include "bgp/bgp_condition_listener.h"
 
+#include <algorithm>
+
 #include <boost/bind.hpp>
 
 #include "base/logging.h"
@@ -11,6 +13,8 @@
 #include "base/task_annotations.h"
 #include "base/task_trigger.h"
 
+#include "bgp/bgp_peer_types.h"
+#include "bgp/inet/inet_prefix_index.h"
 #include "db/db_table_partition.h"
 #include "db/db_table_walker.h"
 
@@ -96,10 +100,14 @@ private:
 // the ConditionMatch and all table walks have finished
 // Holds a table reference to ensure that table with active walk or listener
 // is not deleted
+// ConditionMatch objects that declare a ConditionMatchFilter are indexed by
+// prefix and address, so that a route is only dispatched to the objects
+// whose filter selects it. Objects without a filter see every route
 //
 class ConditionMatchTableState {
 public:
     typedef std::set<ConditionMatchPtr> MatchList;
+    typedef std::vector<ConditionMatch *> MatchVector;
     ConditionMatchTableState(BgpTable *table, DBTableBase::ListenerId id);
     ~ConditionMatchTableState();
 
@@ -114,10 +122,31 @@ public:
         return &match_object_list_;
     }
 
-    void AddMatchObject(ConditionMatch *obj) {
-        match_object_list_.insert(ConditionMatchPtr(obj));
+    void AddMatchObject(ConditionMatch *obj);
+    void RemoveMatchObject(ConditionMatch *obj);
+
+    // Match objects whose filter selects the route, in addition to the
+    // ones returned by unfiltered_objects()
+    void GetFilteredObjects(BgpRoute *route, MatchVector *list);
+
+    MatchList *unfiltered_objects() {
+        return &unfiltered_list_;
+    }
+
+    size_t filtered_count() const {
+        return filter_map_.size();
+    }
+
+    void UpdateStats(uint64_t match_calls, uint64_t matches) {
+        notify_count_++;
+        match_calls_ += match_calls;
+        matches_ += matches;
     }
 
+    uint64_t notify_count() const { return notify_count_; }
+    uint64_t match_calls() const { return match_calls_; }
+    uint64_t matches() const { return matches_; }
+
     //
     // Mutex required to manager MatchState list for concurrency
     //
@@ -126,9 +155,20 @@ public:
     }
 
 private:
+    typedef std::map<ConditionMatch *, ConditionMatchFilter> FilterMap;
+    typedef std::map<Ip4Address, MatchList> AddressMap;
+
     tbb::mutex table_state_mutex_;
     DBTableBase::ListenerId id_;
+    BgpTable *table_;
     MatchList match_object_list_;
+    MatchList unfiltered_list_;
+    FilterMap filter_map_;
+    Ip4PrefixIndex<MatchList> prefix_index_;
+    AddressMap address_map_;
+    tbb::atomic<uint64_t> notify_count_;
+    tbb::atomic<uint64_t> match_calls_;
+    tbb::atomic<uint64_t> matches_;
     LifetimeRef<ConditionMatchTableState> table_delete_ref_;
     DISALLOW_COPY_AND_ASSIGN(ConditionMatchTableState);
 };
@@ -331,15 +371,33 @@ bool BgpConditionListener::BgpRouteNotify(BgpServer *server,
     DBTableBase::ListenerId id = ts->GetListenerId();
     assert(id != DBTableBase::kInvalidId);
 
+    uint64_t match_calls = 0, matches = 0;
     for(ConditionMatchTableState::MatchList::iterator match_obj_it = 
-        ts->match_objects()->begin();
-        match_obj_it != ts->match_objects()->end(); match_obj_it++) {
+        ts->unfiltered_objects()->begin();
+        match_obj_it != ts->unfiltered_objects()->end(); match_obj_it++) {
+        bool deleted = false;
+        if ((*match_obj_it)->deleted() || del_rt) {
+            deleted = true;
+        }
+        match_calls++;
+        if ((*match_obj_it)->Match(server, bgptable, rt, deleted))
+            matches++;
+    }
+
+    ConditionMatchTableState::MatchVector filtered;
+    ts->GetFilteredObjects(rt, &filtered);
+    for (ConditionMatchTableState::MatchVector::iterator match_obj_it =
+         filtered.begin(); match_obj_it != filtered.end(); match_obj_it++) {
         bool deleted = false;
         if ((*match_obj_it)->deleted() || del_rt) {
             deleted = true;
         }
-        (*match_obj_it)->Match(server, bgptable, rt, deleted);
+        match_calls++;
+        if ((*match_obj_it)->Match(server, bgptable, rt, deleted))
+            matches++;
     }
+
+    ts->UpdateStats(match_calls, matches);
     return true;
 }
 
@@ -397,7 +455,7 @@ void BgpConditionListener::UnregisterCondition(BgpTable *bgptable,
     //
     if ((!walk_state || !walk_state->is_walk_pending(obj)) && 
         obj->deleted()) {
-        ts->match_objects()->erase(obj);
+        ts->RemoveMatchObject(obj);
     }
 
     if (ts->match_objects()->empty()) {
@@ -407,14 +465,134 @@ void BgpConditionListener::UnregisterCondition(BgpTable *bgptable,
     }
 }
 
+void BgpConditionListener::FillShowInfo(
+        std::vector<ShowConditionListenerTable> *list) const {
+    for (TableMap::const_iterator it = map_.begin(); it != map_.end(); ++it) {
+        ConditionMatchTableState *ts = it->second;
+        ShowConditionListenerTable table;
+        table.set_name(it->first->name());
+        table.set_match_objects(ts->match_objects()->size());
+        table.set_filtered_match_objects(ts->filtered_count());
+        table.set_route_notifications(ts->notify_count());
+        table.set_match_calls(ts->match_calls());
+        table.set_matches(ts->matches());
+        table.set_match_rate(ts->match_calls() ?
+            (double) ts->matches() / ts->match_calls() : 0.0);
+        list->push_back(table);
+    }
+}
+
 ConditionMatchTableState::ConditionMatchTableState(BgpTable *table, 
                                                    DBTableBase::ListenerId id)
-    : id_(id), table_delete_ref_(this, table->deleter()) {
+    : id_(id), table_(table), table_delete_ref_(this, table->deleter()) {
     assert(table->deleter() != NULL);
+    notify_count_ = 0;
+    match_calls_ = 0;
+    matches_ = 0;
 }
 
 ConditionMatchTableState::~ConditionMatchTableState() {
 }
 
+//
+// Add the ConditionMatch object and index it based on its filter
+// Filter is only honored for inet tables
+//
+void ConditionMatchTableState::AddMatchObject(ConditionMatch *obj) {
+    if (!match_object_list_.insert(ConditionMatchPtr(obj)).second)
+        return;
+
+    ConditionMatchFilter filter;
+    if (table_->family() == Address::INET)
+        obj->GetMatchFilter(table_, &filter);
+    if (filter.empty()) {
+        unfiltered_list_.insert(ConditionMatchPtr(obj));
+        return;
+    }
+
+    for (ConditionMatchFilter::PrefixList::const_iterator it =
+         filter.prefix_list().begin(); it != filter.prefix_list().end(); ++it) {
+        MatchList *list = prefix_index_.Find(*it);
+        if (!list) {
+            prefix_index_.Insert(*it, MatchList());
+            list = prefix_index_.Find(*it);
+        }
+        list->insert(ConditionMatchPtr(obj));
+    }
+    for (ConditionMatchFilter::AddressList::const_iterator it =
+         filter.address_list().begin(); it != filter.address_list().end();
+         ++it) {
+        address_map_[*it].insert(ConditionMatchPtr(obj));
+    }
+    filter_map_.insert(std::make_pair(obj, filter));
+}
+
+void ConditionMatchTableState::RemoveMatchObject(ConditionMatch *obj) {
+    FilterMap::iterator loc = filter_map_.find(obj);
+    if (loc == filter_map_.end()) {
+        unfiltered_list_.erase(ConditionMatchPtr(obj));
+        match_object_list_.erase(ConditionMatchPtr(obj));
+        return;
+    }
+
+    const ConditionMatchFilter &filter = loc->second;
+    for (ConditionMatchFilter::PrefixList::const_iterator it =
+         filter.prefix_list().begin(); it != filter.prefix_list().end(); ++it) {
+        MatchList *list = prefix_index_.Find(*it);
+        if (!list)
+            continue;
+        list->erase(ConditionMatchPtr(obj));
+        if (list->empty())
+            prefix_index_.Remove(*it);
+    }
+    for (ConditionMatchFilter::AddressList::const_iterator it =
+         filter.address_list().begin(); it != filter.address_list().end();
+         ++it) {
+        AddressMap::iterator addr_it = address_map_.find(*it);
+        if (addr_it == address_map_.end())
+            continue;
+        addr_it->second.erase(ConditionMatchPtr(obj));
+        if (addr_it->second.empty())
+            address_map_.erase(addr_it);
+    }
+    filter_map_.erase(loc);
+    match_object_list_.erase(ConditionMatchPtr(obj));
+}
+
+//
+// Collect the filtered ConditionMatch objects interested in the route
+// All covering prefixes in the index are visited, from the longest match up
+// An object is returned once even if several of its filters select the route
+//
+void ConditionMatchTableState::GetFilteredObjects(BgpRoute *route,
+                                                  MatchVector *list) {
+    if (filter_map_.empty())
+        return;
+
+    const Ip4Prefix &prefix = static_cast<InetRoute *>(route)->GetPrefix();
+    Ip4Prefix match;
+    for (MatchList *objects = prefix_index_.LongestMatch(prefix, &match);
+         objects != NULL;
+         objects = prefix_index_.LongestLessSpecificMatch(match, &match)) {
+        for (MatchList::iterator it = objects->begin();
+             it != objects->end(); ++it) {
+            list->push_back(it->get());
+        }
+    }
+
+    AddressMap::iterator loc = address_map_.find(prefix.ip4_addr());
+    if (loc != address_map_.end()) {
+        for (MatchList::iterator it = loc->second.begin();
+             it != loc->second.end(); ++it) {
+            list->push_back(it->get());
+        }
+    }
+
+    if (list->size() > 1) {
+        std::sort(list->begin(), list->end());
+        list->erase(std::unique(list->begin(), list->end()), list->end());
+    }
+}
+
 WalkRequest::WalkRequest() : id_(DBTableWalker::kInvalidWalkerId) {
 }
@@ -7,6 +7,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 
@@ -16,7 +17,49 @@
 
 #include "bgp/bgp_table.h"
 #include "bgp/bgp_route.h"
+#include "bgp/inet/inet_route.h"
 #include "db/db_table_partition.h"
+
+class ShowConditionListenerTable;
+
+//
+// ConditionMatchFilter
+// Routes of a table that a ConditionMatch is interested in
+// Prefix: routes that are equal to or more specific than the prefix
+// Address: routes with the given prefix address, irrespective of length
+// An empty filter selects all the routes of the table
+// Filter applies to inet tables only
+//
+class ConditionMatchFilter {
+public:
+    typedef std::vector<Ip4Prefix> PrefixList;
+    typedef std::vector<Ip4Address> AddressList;
+
+    void AddPrefix(const Ip4Prefix &prefix) {
+        prefix_list_.push_back(prefix);
+    }
+
+    void AddAddress(const Ip4Address &address) {
+        address_list_.push_back(address);
+    }
+
+    const PrefixList &prefix_list() const {
+        return prefix_list_;
+    }
+
+    const AddressList &address_list() const {
+        return address_list_;
+    }
+
+    bool empty() const {
+        return prefix_list_.empty() && address_list_.empty();
+    }
+
+private:
+    PrefixList prefix_list_;
+    AddressList address_list_;
+};
+
 // 
 // ConditionMatch
 // Base class for ConditionMatch 
@@ -40,6 +83,14 @@ public:
     virtual bool Match(BgpServer *server, BgpTable *table, 
                        BgpRoute *route, bool deleted) = 0;
 
+    // Declare the routes of the table that can match
+    // Called once when the ConditionMatch is added to the table
+    // BgpConditionListener dispatches only the routes selected by the filter
+    // to Match. Default is to dispatch all routes
+    virtual void GetMatchFilter(BgpTable *table,
+                                ConditionMatchFilter *filter) const {
+    }
+
     bool deleted() {
         return deleted_;
     }
@@ -150,6 +201,9 @@ public:
         return server_;
     }
 
+    // Per table match object counts and match statistics for introspect
+    void FillShowInfo(std::vector<ShowConditionListenerTable> *list) const;
+
 private:
     BgpServer *server_;
 
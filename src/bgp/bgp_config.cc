@@ -502,6 +502,34 @@ static int GetVirtualNetworkIndex(DBGraph *graph, IFMapNode *node) {
     return 0;
 }
 
+//
+// Get the policy config for a routing-instance-routing-policy. The input
+// IFMapNode is the midnode that represents the link. We traverse the graph
+// edges till we find the adjacency to the routing-policy.
+//
+// Return true and fill in the config if we find the routing-policy.
+//
+static bool GetRoutingPolicyConfig(DBGraph *graph, IFMapNode *node,
+        PolicyConfig *config) {
+    for (DBGraphVertex::adjacency_iterator iter = node->begin(graph);
+         iter != node->end(graph); ++iter) {
+        IFMapNode *adj = static_cast<IFMapNode *>(iter.operator->());
+        if (strcmp(adj->table()->Typename(), "routing-policy") != 0)
+            continue;
+        const autogen::RoutingPolicy *policy =
+            static_cast<autogen::RoutingPolicy *>(adj->GetObject());
+        if (!policy)
+            return false;
+        if (policy->IsPropertySet(autogen::RoutingPolicy::ENTRIES)) {
+            config->Build(adj->name(), policy->entries());
+        } else {
+            config->Build(adj->name(), autogen::PolicyStatement());
+        }
+        return true;
+    }
+    return false;
+}
+
 //
 // Update BgpInstanceConfig based on a new autogen::RoutingInstance object.
 //
@@ -515,10 +543,18 @@ static int GetVirtualNetworkIndex(DBGraph *graph, IFMapNode *node) {
 // Export targets for all other routing-instances that we are connected to
 // are added to our import list.
 //
+// The routing-policy that is linked with a routing-instance-routing-policy
+// becomes the import or export policy or both depending on the import_export
+// attribute. If more than one policy is linked for the same direction, the
+// one with the smallest name is used so that the choice doesn't depend on
+// the order of the adjacencies.
+//
 void BgpInstanceConfig::Update(BgpConfigManager *manager,
                                const autogen::RoutingInstance *config) {
     import_list_.clear();
     export_list_.clear();
+    import_policy_ = PolicyConfig();
+    export_policy_ = PolicyConfig();
 
     DBGraph *graph = manager->graph();
     IFMapNode *node = node_proxy_.node();
@@ -550,6 +586,26 @@ void BgpInstanceConfig::Update(BgpConfigManager *manager,
         } else if (strcmp(adj->table()->Typename(), "virtual-network") == 0) {
             virtual_network_ = adj->name();
             virtual_network_index_ = GetVirtualNetworkIndex(graph, adj);
+        } else if (strcmp(adj->table()->Typename(),
+                          "routing-instance-routing-policy") == 0) {
+            PolicyConfig policy;
+            if (!GetRoutingPolicyConfig(graph, adj, &policy))
+                continue;
+            const autogen::RoutingInstanceRoutingPolicy *link =
+                dynamic_cast<autogen::RoutingInstanceRoutingPolicy *>(
+                    adj->GetObject());
+            assert(link);
+            const autogen::InstanceTargetType &itt = link->data();
+            if (itt.import_export != "export" &&
+                (import_policy_.name.empty() ||
+                 policy.name < import_policy_.name)) {
+                import_policy_ = policy;
+            }
+            if (itt.import_export != "import" &&
+                (export_policy_.name.empty() ||
+                 policy.name < export_policy_.name)) {
+                export_policy_ = policy;
+            }
         }
     }
 
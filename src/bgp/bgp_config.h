@@ -17,6 +17,7 @@
 #include "base/util.h"
 #include "bgp/bgp_common.h"
 #include "ifmap/ifmap_node_proxy.h"
+#include "routing-policy/policy_config.h"
 #include "schema/bgp_schema_types.h"
 #include "schema/vnc_cfg_types.h"
 
@@ -272,6 +273,8 @@ public:
 
     const RouteTargetList &import_list() const { return import_list_; }
     const RouteTargetList &export_list() const { return export_list_; }
+    const PolicyConfig &import_policy() const { return import_policy_; }
+    const PolicyConfig &export_policy() const { return export_policy_; }
 
     const BgpProtocolConfig *bgp_config() const { return bgp_router_.get(); }
     BgpProtocolConfig *bgp_config_mutable() { return bgp_router_.get(); }
@@ -307,6 +310,8 @@ private:
 
     RouteTargetList import_list_;
     RouteTargetList export_list_;
+    PolicyConfig import_policy_;
+    PolicyConfig export_policy_;
     std::string virtual_network_;
     int virtual_network_index_;
 
@@ -51,9 +51,22 @@ void BgpConfigListener::DependencyTracker::Initialize() {
     ReactionMap rt_instance_react = map_list_of<string, PropagateList>
         ("instance-target", list_of("self")("connection"))
         ("connection", list_of("self"))
-        ("virtual-network-routing-instance", list_of("self"));
+        ("virtual-network-routing-instance", list_of("self"))
+        ("routing-instance-routing-policy", list_of("self"));
     policy_.insert(make_pair("routing-instance", rt_instance_react));
 
+    ReactionMap rt_instance_policy_react = map_list_of<string, PropagateList>
+        ("self", list_of("routing-instance-routing-policy"))
+        ("routing-instance-routing-policy",
+            list_of("routing-instance-routing-policy"));
+    policy_.insert(make_pair("routing-instance-routing-policy",
+        rt_instance_policy_react));
+
+    ReactionMap routing_policy_react = map_list_of<string, PropagateList>
+        ("self", list_of("routing-instance-routing-policy"))
+        ("routing-instance-routing-policy", PropagateList());
+    policy_.insert(make_pair("routing-policy", routing_policy_react));
+
     ReactionMap virtual_network_react = map_list_of<string, PropagateList>
         ("self", list_of("virtual-network-routing-instance"));
     policy_.insert(make_pair("virtual-network", virtual_network_react));
@@ -297,10 +310,16 @@ BgpConfigListener::~BgpConfigListener() {
 // community based on the virtual network index in the VirtualNetwork. The
 // OriginVn extended community is used for service chaining.
 //
+// RoutingPolicies and the routing-instance-routing-policy links with their
+// import/export attribute are relevant because they determine the policies
+// that are applied to the tables of a routing-instance.
+//
 static const char *bgp_config_types[] = {
     "bgp-peering",
     "bgp-router",
     "routing-instance",
+    "routing-instance-routing-policy",
+    "routing-policy",
     "virtual-network",
 };
 
@@ -457,6 +457,88 @@ static bool ParseInstanceTarget(const string &instance, const xml_node &node,
     return true;
 }
 
+static bool ParseInstanceRoutingPolicy(const string &instance,
+                                       const xml_node &node, bool add_change,
+                                       BgpConfigParser::RequestList *requests) {
+    string policy(node.attribute("to").value());
+    if (policy.empty()) {
+        BGP_LOG_STR(BgpMessage, SandeshLevel::SYS_WARN,
+                BGP_LOG_FLAG_SYSLOG,
+                "Missing routing-policy for instance " << instance);
+        return false;
+    }
+
+    auto_ptr<autogen::InstanceTargetType> params(
+        new autogen::InstanceTargetType());
+    if (!params->XmlParse(node)) {
+        assert(0);
+    }
+
+    if (add_change) {
+        MapObjectLinkAttr("routing-instance", instance, "routing-policy",
+            policy, "routing-instance-routing-policy", params.release(),
+            requests);
+    } else {
+        MapObjectUnlink("routing-instance", instance, "routing-policy",
+            policy, "routing-instance-routing-policy", requests);
+    }
+
+    return true;
+}
+
+static void SetRoutingPolicyEntries(const string &identifier,
+                                    autogen::PolicyStatement *params,
+                                    BgpConfigParser::RequestList *requests) {
+    DBRequest *request = new DBRequest;
+    request->oper = DBRequest::DB_ENTRY_ADD_CHANGE;
+    IFMapTable::RequestKey *key = new IFMapTable::RequestKey();
+    request->key.reset(key);
+    key->id_type = "routing-policy";
+    key->id_name = identifier;
+    IFMapServerTable::RequestData *data = new IFMapServerTable::RequestData();
+    request->data.reset(data);
+    data->metadata = "routing-policy-entries";
+    data->content.reset(params);
+    data->origin.set_origin(IFMapOrigin::MAP_SERVER);
+    requests->push_back(request);
+}
+
+static void ClearRoutingPolicyEntries(const string &identifier,
+                                      BgpConfigParser::RequestList *requests) {
+    DBRequest *request = new DBRequest;
+    request->oper = DBRequest::DB_ENTRY_DELETE;
+    IFMapTable::RequestKey *key = new IFMapTable::RequestKey();
+    request->key.reset(key);
+    key->id_type = "routing-policy";
+    key->id_name = identifier;
+    IFMapServerTable::RequestData *data = new IFMapServerTable::RequestData();
+    request->data.reset(data);
+    data->metadata = "routing-policy-entries";
+    data->origin.set_origin(IFMapOrigin::MAP_SERVER);
+    requests->push_back(request);
+}
+
+static bool ParseRoutingPolicy(const xml_node &node, bool add_change,
+                               BgpConfigParser::RequestList *requests) {
+    string policy(node.attribute("name").value());
+    if (policy.empty()) {
+        return false;
+    }
+
+    auto_ptr<autogen::PolicyStatement> params(new autogen::PolicyStatement());
+    if (!params->XmlParse(node)) {
+        assert(0);
+    }
+
+    if (add_change) {
+        SetRoutingPolicyEntries(policy, params.release(), requests);
+    } else {
+        ClearRoutingPolicyEntries(policy, requests);
+    }
+
+    return true;
+}
+
 }  // namespace
 
 BgpConfigParser::BgpConfigParser(DB *db)
@@ -491,6 +573,8 @@ bool BgpConfigParser::ParseRoutingInstance(const xml_node &parent,
             ParseServiceChain(instance, node, add_change, requests);
         } else if (strcmp(node.name(), "static-route-entries") == 0) {
             ParseStaticRoute(instance, node, add_change, requests);
+        } else if (strcmp(node.name(), "routing-policy") == 0) {
+            ParseInstanceRoutingPolicy(instance, node, add_change, requests);
         }
     }
 
@@ -524,6 +608,9 @@ bool BgpConfigParser::ParseConfig(const xml_node &root, bool add_change,
         if (strcmp(node.name(), "routing-instance") == 0) {
             ParseRoutingInstance(node, add_change, requests);
         }
+        if (strcmp(node.name(), "routing-policy") == 0) {
+            ParseRoutingPolicy(node, add_change, requests);
+        }
     }
 
     if (add_change) {
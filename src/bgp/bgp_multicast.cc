@@ -47,7 +47,8 @@ private:
 McastForwarder::McastForwarder(InetMcastRoute *route)
     : route_(route),
       label_(0),
-      rd_(route->GetPrefix().route_distinguisher()) {
+      rd_(route->GetPrefix().route_distinguisher()),
+      tree_index_(0) {
     const BgpPath *path = route->BestPath();
     label_block_ = path->GetAttr()->label_block();
     address_ = path->GetAttr()->nexthop().to_v4();
@@ -66,12 +67,15 @@ McastForwarder::~McastForwarder() {
 
 //
 // Update the` McastForwarder based on information in the InetMcastRoute.
-// Return true if something changed.
+// Return true if something changed. The label, if any, is released when the
+// LabelBlock changes and gets allocated from the new one on the next update
+// of the distribution tree.
 //
 bool McastForwarder::Update(InetMcastRoute *route) {
     McastForwarder forwarder(route);
     bool changed = false;
     if (label_block_ != forwarder.label_block_) {
+        ReleaseLabel();
         label_block_ = forwarder.label_block_;
         changed = true;
     }
@@ -201,7 +205,8 @@ McastSGEntry::McastSGEntry(McastManagerPartition *partition,
     : partition_(partition),
       group_(group),
       source_(source),
-      on_work_queue_(false) {
+      on_work_queue_(false),
+      forwarder_update_count_(0) {
 }
 
 //
@@ -222,7 +227,8 @@ std::string McastSGEntry::ToString() const {
 // of the distribution tree.
 //
 void McastSGEntry::AddForwarder(McastForwarder *forwarder) {
-    forwarders_.insert(forwarder);
+    if (forwarders_.insert(forwarder).second)
+        TreeInsert(forwarder);
     partition_->EnqueueSGEntry(this);
 }
 
@@ -231,61 +237,122 @@ void McastSGEntry::AddForwarder(McastForwarder *forwarder) {
 // of the distribution tree.
 //
 void McastSGEntry::DeleteForwarder(McastForwarder *forwarder) {
-    forwarders_.erase(forwarder);
+    ForwarderSet::iterator it = forwarders_.find(forwarder);
+    if (it != forwarders_.end() && *it == forwarder) {
+        forwarders_.erase(it);
+        TreeDelete(forwarder);
+    }
+    update_set_.erase(forwarder);
     partition_->EnqueueSGEntry(this);
 }
 
 //
-// Update the distribution tree for this McastSGEntry.  We traverse all the
-// McastForwarders in sorted order and arrange them in breadth first fashion
-// in a k-ary tree.  Building the tree in this manner guarantees that we get
-// the same tree for a given set of forwarders, independent of the order in
-// in which they joined. This predictability is deemed to be more important
-// than other criteria such as minimizing disruption of traffic, minimizing
-// the cost/weight of the tree etc.
+// Trigger update of the given McastForwarder and the McastForwarders linked
+// to it, since their OLists contain its address, label and encapsulation.
 //
-void McastSGEntry::UpdateTree() {
-    CHECK_CONCURRENCY("db::DBTable");
+void McastSGEntry::ChangeForwarder(McastForwarder *forwarder) {
+    update_set_.insert(forwarder);
+    const McastForwarderList &links = forwarder->tree_links();
+    update_set_.insert(links.begin(), links.end());
+    partition_->EnqueueSGEntry(this);
+}
 
-    // First get rid of the previous distribution tree and enqueue all the
-    // associated InetMcastRoutes for notification.  Note that DBListeners
-    // will not get invoked until after this routine is done.
-    for (ForwarderSet::iterator it = forwarders_.begin();
-        it != forwarders_.end(); ++it) {
-       (*it)->FlushLinks();
-       (*it)->ReleaseLabel();
-       partition_->GetTablePartition()->Notify((*it)->route());
-    }
+//
+// Add a link between the two McastForwarders in the distribution tree.
+//
+void McastSGEntry::TreeLink(McastForwarder *forwarder1,
+                            McastForwarder *forwarder2) {
+    forwarder1->AddLink(forwarder2);
+    forwarder2->AddLink(forwarder1);
+    update_set_.insert(forwarder1);
+    update_set_.insert(forwarder2);
+}
+
+//
+// Remove all links of the McastForwarder in the distribution tree.
+//
+void McastSGEntry::TreeUnlink(McastForwarder *forwarder) {
+    const McastForwarderList &links = forwarder->tree_links();
+    update_set_.insert(links.begin(), links.end());
+    forwarder->FlushLinks();
+}
 
-    // Don't need to build a tree unless we have at least 2 McastForwarders.
-    if (forwarders_.size() <= 1)
+//
+// Insert the McastForwarder in the distribution tree. It's added as the next
+// leaf in breadth first order, which keeps the k-ary tree complete. Only the
+// new McastForwarder and its parent need to be updated.
+//
+void McastSGEntry::TreeInsert(McastForwarder *forwarder) {
+    size_t idx = tree_.size();
+    tree_.push_back(forwarder);
+    forwarder->set_tree_index(idx);
+    update_set_.insert(forwarder);
+    if (idx == 0)
         return;
 
+    size_t parent_idx = (idx - 1) / McastTreeManager::kDegree;
+    TreeLink(forwarder, tree_[parent_idx]);
+}
+
+//
+// Delete the McastForwarder from the distribution tree. The last leaf in
+// breadth first order takes its place, which keeps the k-ary tree complete.
+// Only the neighbors of the deleted McastForwarder and the last leaf and its
+// parent need to be updated.
+//
+void McastSGEntry::TreeDelete(McastForwarder *forwarder) {
+    size_t idx = forwarder->tree_index();
+    assert(idx < tree_.size() && tree_[idx] == forwarder);
+    TreeUnlink(forwarder);
 
-    // Create a vector of pointers to the McastForwarders in sorted order. We
-    // resort to this because std:set doesn't support random access iterators.
-    McastForwarderList vec;
-    vec.reserve(forwarders_.size());
-    for (ForwarderSet::iterator it = forwarders_.begin();
-         it != forwarders_.end(); ++it) {
-        vec.push_back(*it);
+    McastForwarder *last = tree_.back();
+    tree_.pop_back();
+    if (last == forwarder)
+        return;
+
+    TreeUnlink(last);
+    tree_[idx] = last;
+    last->set_tree_index(idx);
+    update_set_.insert(last);
+    if (idx > 0) {
+        size_t parent_idx = (idx - 1) / McastTreeManager::kDegree;
+        TreeLink(last, tree_[parent_idx]);
     }
+    for (size_t child_idx = idx * McastTreeManager::kDegree + 1;
+         child_idx <= (idx + 1) * McastTreeManager::kDegree &&
+         child_idx < tree_.size(); ++child_idx) {
+        TreeLink(last, tree_[child_idx]);
+    }
+}
 
-    // Go through each McastForwarder in the vector and link it to it's parent
-    // McastForwarder in the k-ary tree. We also add a link from the parent to
-    // the entry in question.
-    for (McastForwarderList::iterator it = vec.begin(); it != vec.end(); ++it) {
-        (*it)->AllocateLabel();
-        int idx = it - vec.begin();
-        if (idx == 0)
-            continue;
-
-        int parent_idx = (idx - 1) / McastTreeManager::kDegree;
-        McastForwarderList::iterator parent_it = vec.begin() + parent_idx;
-        assert(parent_it != vec.end());
-        (*it)->AddLink(*parent_it);
-        (*parent_it)->AddLink(*it);
+//
+// Update the distribution tree for this McastSGEntry.  The links have been
+// updated incrementally as McastForwarders joined and left.  Here we make
+// sure that the McastForwarders whose links or neighbors changed have a
+// label and enqueue the associated InetMcastRoutes for notification.  Note
+// that DBListeners will not get invoked until after this routine is done.
+//
+// The tree is kept balanced, but its shape depends on the order in which the
+// McastForwarders joined. This is traded for not having to re-advertise the
+// whole tree when a single McastForwarder joins or leaves.
+//
+void McastSGEntry::UpdateTree() {
+    CHECK_CONCURRENCY("db::DBTable");
+
+    for (UpdateSet::iterator it = update_set_.begin();
+         it != update_set_.end(); ++it) {
+        McastForwarder *forwarder = *it;
+
+        // Don't need a label unless we have at least 2 McastForwarders.
+        if (forwarders_.size() <= 1) {
+            forwarder->ReleaseLabel();
+        } else if (forwarder->label() == 0) {
+            forwarder->AllocateLabel();
+        }
+        partition_->GetTablePartition()->Notify(forwarder->route());
+        forwarder_update_count_++;
     }
+    update_set_.clear();
 }
 
 //
@@ -494,7 +561,7 @@ void McastTreeManager::RouteListener(
         } else if (forwarder->Update(route)) {
 
             // Trigger update of the distribution tree.
-            partition->EnqueueSGEntry(sg_entry);
+            sg_entry->ChangeForwarder(forwarder);
         }
 
     }
@@ -62,7 +62,8 @@ typedef std::vector<McastForwarder *> McastForwarderList;
 // the distribution tree for the McastSGEntry. Note that only a single MPLS
 // label is used for a McastForwarder in a given distribution tree.  Hence
 // the label can be stored in the McastForwarder itself and does not need
-// to be part of the link information.
+// to be part of the link information. The tree index is the position of the
+// McastForwarder in the breadth first layout of the tree.
 //
 class McastForwarder : public DBState {
 public:
@@ -89,6 +90,10 @@ public:
     RouteDistinguisher route_distinguisher() const { return rd_; }
 
     bool empty() { return tree_links_.empty(); }
+    const McastForwarderList &tree_links() const { return tree_links_; }
+
+    size_t tree_index() const { return tree_index_; }
+    void set_tree_index(size_t tree_index) { tree_index_ = tree_index; }
 
 private:
     friend class BgpMulticastTest;
@@ -101,6 +106,7 @@ private:
     Ip4Address address_;
     std::vector<std::string> encap_;
     McastForwarderList tree_links_;
+    size_t tree_index_;
 
     DISALLOW_COPY_AND_ASSIGN(McastForwarder);
 };
@@ -143,10 +149,15 @@ struct McastForwarderCompare {
 //
 // A set of pointers to McastForwarders is maintatined to keep track of the
 // forwarders that have sent joins for this (G,S).  The set is keyed by the
-// RouteDistinguisher of the McastForwarders. It's used to build distribution
-// tree for this McastSGEntry. The McastSGEntry is enqueued on the WorkQueue
-// in the McastManagerPartition when a McastForwarder is added or deleted,
-// so that the distribution tree gets updtaed.
+// RouteDistinguisher of the McastForwarders.
+//
+// The distribution tree is a k-ary tree kept in breadth first layout in the
+// tree vector. It's updated incrementally as McastForwarders join and leave,
+// so that only the McastForwarders whose links change need to be updated.
+// These are remembered in the update set. The McastSGEntry is enqueued on
+// the WorkQueue in the McastManagerPartition when a McastForwarder is added,
+// deleted or changed, so that the McastForwarders in the update set get
+// labels and are notified.
 //
 class McastSGEntry {
 public:
@@ -158,6 +169,7 @@ public:
 
     void AddForwarder(McastForwarder *forwarder);
     void DeleteForwarder(McastForwarder *forwarder);
+    void ChangeForwarder(McastForwarder *forwarder);
 
     void UpdateTree();
 
@@ -170,16 +182,29 @@ public:
 
     bool empty() { return forwarders_.empty(); }
 
+    uint64_t forwarder_update_count() const {
+        return forwarder_update_count_;
+    }
+
 private:
     friend class BgpMulticastTest;
     friend class ShowMulticastManagerDetailHandler;
 
     typedef std::set<McastForwarder *, McastForwarderCompare> ForwarderSet;
+    typedef std::set<McastForwarder *> UpdateSet;
+
+    void TreeInsert(McastForwarder *forwarder);
+    void TreeDelete(McastForwarder *forwarder);
+    void TreeLink(McastForwarder *forwarder1, McastForwarder *forwarder2);
+    void TreeUnlink(McastForwarder *forwarder);
 
     McastManagerPartition *partition_;
     Ip4Address group_, source_;
     bool on_work_queue_;
     ForwarderSet forwarders_;
+    McastForwarderList tree_;
+    UpdateSet update_set_;
+    uint64_t forwarder_update_count_;
 
     DISALLOW_COPY_AND_ASSIGN(McastSGEntry);
 };
@@ -23,6 +23,7 @@
 #include "bgp/bgp_session.h"
 #include "bgp/state_machine.h"
 #include "bgp/bgp_session_manager.h"
+#include "bgp/bgp_update_decoder.h"
 #include "bgp/bgp_peer_types.h"
 #include "bgp/bgp_sandesh.h"
 #include "bgp/evpn/evpn_table.h"
@@ -681,6 +682,8 @@ bool BgpPeer::SendUpdate(const uint8_t *msg, size_t msgsize) {
         return true;
 
     if (!SkipUpdateSend()) {
+        // Updates are written out together from FlushUpdate
+        session_->Cork();
         send_ready_ = session_->Send(msg, msgsize, NULL);
         if (send_ready_) {
             StartKeepaliveTimerUnlocked();
@@ -701,6 +704,19 @@ bool BgpPeer::SendUpdate(const uint8_t *msg, size_t msgsize) {
     return send_ready_;
 }
 
+bool BgpPeer::FlushUpdate() {
+    spin_mutex::scoped_lock lock(spin_mutex_);
+
+    if (!session_)
+        return true;
+
+    if (!session_->Uncork()) {
+        send_ready_ = false;
+        StopKeepaliveTimerUnlocked();
+    }
+    return send_ready_;
+}
+
 void BgpPeer::SendNotification(BgpSession *session,
         int code, int subcode, const std::string &data) {
     spin_mutex::scoped_lock lock(spin_mutex_);
@@ -760,27 +776,70 @@ bool BgpPeer::MpNlriAllowed(uint16_t afi, uint8_t safi) {
     return false;
 }
 
-void BgpPeer::ProcessUpdate(const BgpProto::Update *msg) {
-    BgpAttrPtr attr = server_->attr_db()->Locate(msg->path_attributes);
-    // Check as path loop and neighbor-as 
-    const BgpAttr *path_attr = attr.get(); 
+// Check as path loop and neighbor-as
+uint32_t BgpPeer::GetPathFlags(const BgpAttr *attr) const {
     uint32_t flags = 0;
-
-    inc_rx_route_update();
-
-    if (path_attr->as_path() != NULL) {
+    if (attr->as_path() != NULL) {
         // Check whether neighbor has appended its AS to the AS_PATH
-        if ((PeerType() == BgpProto::EBGP) && 
-            (!path_attr->as_path()->path().AsLeftMostMatch(peer_as()))) {
+        if ((PeerType() == BgpProto::EBGP) &&
+            (!attr->as_path()->path().AsLeftMostMatch(peer_as()))) {
             flags |= BgpPath::NoNeighborAs;
         }
 
         // Check for AS_PATH loop
-        if (path_attr->as_path()->path().AsPathLoop(
+        if (attr->as_path()->path().AsPathLoop(
                 server_->autonomous_system())) {
             flags |= BgpPath::AsPathLooped;
         }
     }
+    return flags;
+}
+
+//
+// Process an UPDATE decoded by BgpUpdateDecoder. The prefixes are enqueued
+// to the inet table as they are, the attributes have already been located.
+//
+void BgpPeer::ProcessUpdate(const BgpInetUpdate *msg) {
+    inc_rx_route_update();
+
+    RoutingInstance *instance = GetRoutingInstance();
+    InetTable *table =
+        static_cast<InetTable *>(instance->GetTable(Address::INET));
+    if (!table) {
+        BGP_LOG_PEER(this, SandeshLevel::SYS_CRIT, BGP_LOG_FLAG_ALL,
+                     BGP_PEER_DIR_IN, "Cannot find inet table");
+        return;
+    }
+
+    for (vector<Ip4Prefix>::const_iterator it = msg->withdrawn_routes.begin();
+         it != msg->withdrawn_routes.end(); ++it) {
+        DBRequest req;
+        req.oper = DBRequest::DB_ENTRY_DELETE;
+        req.key.reset(new InetTable::RequestKey(*it, this));
+        table->Enqueue(&req);
+        inc_rx_route_unreach();
+    }
+
+    if (msg->nlri.empty())
+        return;
+
+    uint32_t flags = GetPathFlags(msg->attr.get());
+    for (vector<Ip4Prefix>::const_iterator it = msg->nlri.begin();
+         it != msg->nlri.end(); ++it) {
+        DBRequest req;
+        req.oper = DBRequest::DB_ENTRY_ADD_CHANGE;
+        req.data.reset(new InetTable::RequestData(msg->attr, flags, 0));
+        req.key.reset(new InetTable::RequestKey(*it, this));
+        table->Enqueue(&req);
+        inc_rx_route_reach();
+    }
+}
+
+void BgpPeer::ProcessUpdate(const BgpProto::Update *msg) {
+    BgpAttrPtr attr = server_->attr_db()->Locate(msg->path_attributes);
+    uint32_t flags = GetPathFlags(attr.get());
+
+    inc_rx_route_update();
 
 
     RoutingInstance *instance = GetRoutingInstance();
@@ -1013,6 +1072,15 @@ string BgpPeer::BytesToHexString(const u_int8_t *msg, size_t size) {
 
 void BgpPeer::ReceiveMsg(BgpSession *session, const u_int8_t *msg,
                          size_t size) {
+    // Plain IPv4 unicast updates don't need the generic decoder.
+    BgpInetUpdate *update = BgpUpdateDecoder::Decode(server_->attr_db(),
+        msg, size, PeerType() == BgpProto::IBGP);
+    if (update) {
+        BGP_TRACE_PEER_PACKET(this, msg, size, SandeshLevel::UT_DEBUG);
+        state_machine_->OnInetUpdate(session, update);
+        return;
+    }
+
     ParseErrorContext ec;
     BgpProto::BgpMessage *minfo = BgpProto::Decode(msg, size, &ec);
 
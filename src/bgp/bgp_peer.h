@@ -24,6 +24,7 @@
 #include "bgp/state_machine.h"
 #include "net/address.h"
 
+struct BgpInetUpdate;
 class BgpNeighborConfig;
 class BgpPeerInfo;
 class BgpServer;
@@ -52,6 +53,7 @@ public:
     // thread: bgp::SendTask
     // Used to send an UPDATE message on the socket.
     virtual bool SendUpdate(const uint8_t *msg, size_t msgsize);
+    virtual bool FlushUpdate();
 
     // thread: bgp::config
     void ConfigUpdate(const BgpNeighborConfig *config);
@@ -79,6 +81,7 @@ public:
 
     // thread: io::ReaderTask
     void ProcessUpdate(const BgpProto::Update *msg);
+    void ProcessUpdate(const BgpInetUpdate *msg);
 
     // thread: io::ReaderTask
     virtual void ReceiveMsg(BgpSession *session, const u_int8_t *msg,
@@ -212,6 +215,7 @@ private:
 
     virtual bool MpNlriAllowed(uint16_t afi, uint8_t safi);
     BgpAttrPtr GetMpNlriNexthop(BgpMpNlri *nlri, BgpAttrPtr attr);
+    uint32_t GetPathFlags(const BgpAttr *attr) const;
 
     void PostCloseRelease();
     void CustomClose();
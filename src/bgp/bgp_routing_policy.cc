@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "bgp/bgp_routing_policy.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <set>
+#include <sstream>
+
+#include "base/parse_object.h"
+#include "bgp/bgp_table.h"
+#include "bgp/community.h"
+#include "bgp/inet/inet_route.h"
+#include "bgp/l3vpn/inetvpn_route.h"
+#include "bgp/rtarget/rtarget_address.h"
+
+using namespace std;
+
+namespace {
+
+//
+// Bitmask of the terms whose prefix condition is satisfied by the route.
+// Small policies don't need any memory allocation.
+//
+class TermMask {
+public:
+    explicit TermMask(size_t size) : words_(inline_words_) {
+        size_t count = (size + 63) / 64;
+        if (count > kInlineWords) {
+            heap_words_.resize(count);
+            words_ = &heap_words_[0];
+        } else {
+            std::fill(inline_words_, inline_words_ + kInlineWords, 0);
+        }
+    }
+
+    void Set(size_t idx) {
+        words_[idx / 64] |= (1ULL << (idx % 64));
+    }
+
+    bool Test(size_t idx) const {
+        return (words_[idx / 64] & (1ULL << (idx % 64))) != 0;
+    }
+
+private:
+    static const size_t kInlineWords = 4;
+    uint64_t inline_words_[kInlineWords];
+    std::vector<uint64_t> heap_words_;
+    uint64_t *words_;
+};
+
+bool GetRoutePrefix(const BgpTable *table, const BgpRoute *route,
+                    Ip4Prefix *prefix) {
+    switch (table->family()) {
+    case Address::INET:
+        *prefix = static_cast<const InetRoute *>(route)->GetPrefix();
+        return true;
+    case Address::INETVPN: {
+        const InetVpnPrefix &vpn_prefix =
+            static_cast<const InetVpnRoute *>(route)->GetPrefix();
+        *prefix = Ip4Prefix(vpn_prefix.addr(), vpn_prefix.prefixlen());
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool ParseNumber(const std::string &str, uint32_t max, uint32_t *value) {
+    if (str.empty())
+        return false;
+    char *end;
+    unsigned long num = strtoul(str.c_str(), &end, 10);
+    if (*end != '\0' || num > max)
+        return false;
+    *value = num;
+    return true;
+}
+
+}  // namespace
+
+//
+// Community and route target updates accumulated over the matching terms.
+// The add and remove sets are kept disjoint so that the order of the terms
+// is preserved.
+//
+class RoutingPolicy::Updates {
+public:
+    Updates()
+        : changed(false), communities_changed(false), set_communities(false),
+          targets_changed(false), local_pref(0) {
+    }
+
+    void Merge(const Term &term) {
+        if (term.update_communities) {
+            changed = true;
+            communities_changed = true;
+            if (term.set_communities) {
+                set_communities = true;
+                add_communities.clear();
+                remove_communities.clear();
+            }
+            for (CommunityList::const_iterator it =
+                 term.add_communities.begin();
+                 it != term.add_communities.end(); ++it) {
+                add_communities.insert(*it);
+                remove_communities.erase(*it);
+            }
+            for (CommunityList::const_iterator it =
+                 term.remove_communities.begin();
+                 it != term.remove_communities.end(); ++it) {
+                add_communities.erase(*it);
+                remove_communities.insert(*it);
+            }
+        }
+        if (!term.add_targets.empty() || !term.remove_targets.empty()) {
+            changed = true;
+            targets_changed = true;
+            for (TargetList::const_iterator it = term.add_targets.begin();
+                 it != term.add_targets.end(); ++it) {
+                add_targets.insert(*it);
+                remove_targets.erase(*it);
+            }
+            for (TargetList::const_iterator it = term.remove_targets.begin();
+                 it != term.remove_targets.end(); ++it) {
+                add_targets.erase(*it);
+                remove_targets.insert(*it);
+            }
+        }
+        if (term.update_local_pref) {
+            changed = true;
+            local_pref = term.update_local_pref;
+        }
+    }
+
+    bool changed;
+    bool communities_changed;
+    bool set_communities;
+    std::set<uint32_t> add_communities;
+    std::set<uint32_t> remove_communities;
+    bool targets_changed;
+    std::set<uint64_t> add_targets;
+    std::set<uint64_t> remove_targets;
+    uint32_t local_pref;
+};
+
+RoutingPolicy::Term::Term()
+    : match_prefix(false), match_as_path(false), match_local_pref(0),
+      match_nexthop(false), update_communities(false),
+      set_communities(false), update_local_pref(0), action(NEXT) {
+    hits = 0;
+}
+
+RoutingPolicy::RoutingPolicy(const std::string &name)
+    : name_(name), has_as_path_(false), has_targets_(false) {
+    evaluations_ = 0;
+    rejects_ = 0;
+}
+
+RoutingPolicy::~RoutingPolicy() {
+}
+
+bool RoutingPolicy::ParsePrefix(const std::string &str, Ip4Prefix *prefix,
+                                PrefixMatchType *type) {
+    std::istringstream iss(str);
+    std::string prefix_str, type_str, extra;
+    iss >> prefix_str >> type_str >> extra;
+    if (prefix_str.empty() || !extra.empty())
+        return false;
+
+    boost::system::error_code ec;
+    *prefix = Ip4Prefix::FromString(prefix_str, &ec);
+    if (ec)
+        return false;
+
+    if (type_str.empty() || type_str == "orlonger") {
+        *type = ORLONGER;
+    } else if (type_str == "longer") {
+        *type = LONGER;
+    } else if (type_str == "exact") {
+        *type = EXACT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool RoutingPolicy::ParseCommunities(const std::vector<std::string> &list,
+                                     CommunityList *communities,
+                                     TargetList *targets) {
+    for (std::vector<std::string>::const_iterator it = list.begin();
+         it != list.end(); ++it) {
+        const std::string &str = *it;
+        if (str == "no-export") {
+            communities->push_back(Community::NoExport);
+        } else if (str == "no-advertise") {
+            communities->push_back(Community::NoAdvertise);
+        } else if (str == "no-export-subconfed") {
+            communities->push_back(Community::NoExportSubconfed);
+        } else if (str.compare(0, 7, "target:") == 0) {
+            boost::system::error_code ec;
+            RouteTarget rtarget = RouteTarget::FromString(str, &ec);
+            if (ec)
+                return false;
+            targets->push_back(rtarget.GetExtCommunityValue());
+        } else {
+            size_t pos = str.find(':');
+            if (pos == std::string::npos)
+                return false;
+            uint32_t asn, value;
+            if (!ParseNumber(str.substr(0, pos), 0xFFFF, &asn) ||
+                !ParseNumber(str.substr(pos + 1), 0xFFFF, &value))
+                return false;
+            communities->push_back((asn << 16) | value);
+        }
+    }
+
+    std::sort(communities->begin(), communities->end());
+    communities->erase(std::unique(communities->begin(), communities->end()),
+                       communities->end());
+    std::sort(targets->begin(), targets->end());
+    targets->erase(std::unique(targets->begin(), targets->end()),
+                   targets->end());
+    return true;
+}
+
+//
+// Compile the AS path pattern. An unanchored pattern is wrapped in ".*" so
+// that matching is always against the whole AS path.
+//
+bool RoutingPolicy::ParseAsPath(const std::string &str,
+                                AsPathProgram *program) {
+    std::vector<std::string> tokens;
+    std::istringstream iss(str);
+    std::string token;
+    while (iss >> token) {
+        tokens.push_back(token);
+    }
+    if (tokens.empty())
+        return false;
+
+    bool anchor_start = (tokens.front() == "^");
+    bool anchor_end = (tokens.back() == "$");
+    size_t first = anchor_start ? 1 : 0;
+    size_t last = tokens.size() - (anchor_end ? 1 : 0);
+    if (first > last)
+        return false;
+
+    if (!anchor_start)
+        program->push_back(AsPathOp(AS_ANY_SEQUENCE, 0));
+    for (size_t idx = first; idx < last; ++idx) {
+        if (tokens[idx] == ".") {
+            program->push_back(AsPathOp(AS_ANY, 0));
+        } else if (tokens[idx] == ".*") {
+            program->push_back(AsPathOp(AS_ANY_SEQUENCE, 0));
+        } else {
+            uint32_t asn;
+            if (!ParseNumber(tokens[idx], 0xFFFF, &asn))
+                return false;
+            program->push_back(AsPathOp(AS_NUMBER, asn));
+        }
+    }
+    if (!anchor_end)
+        program->push_back(AsPathOp(AS_ANY_SEQUENCE, 0));
+    return true;
+}
+
+//
+// Match the AS path against the compiled pattern. Backtracks to the last
+// ".*" on a mismatch, which bounds the work to O(path length * pattern
+// length).
+//
+bool RoutingPolicy::MatchAsPath(const AsPathProgram &program,
+                                const std::vector<as_t> &as_list) {
+    size_t op = 0, pos = 0;
+    size_t star_op = program.size(), star_pos = 0;
+    while (pos < as_list.size()) {
+        if (op < program.size() &&
+            program[op].opcode == AS_ANY_SEQUENCE) {
+            star_op = op++;
+            star_pos = pos;
+        } else if (op < program.size() &&
+                   (program[op].opcode == AS_ANY ||
+                    program[op].asn == as_list[pos])) {
+            op++;
+            pos++;
+        } else if (star_op != program.size()) {
+            op = star_op + 1;
+            pos = ++star_pos;
+        } else {
+            return false;
+        }
+    }
+    while (op < program.size() && program[op].opcode == AS_ANY_SEQUENCE) {
+        op++;
+    }
+    return (op == program.size());
+}
+
+RoutingPolicy *RoutingPolicy::Compile(const PolicyConfig &config,
+                                      std::string *error) {
+    std::auto_ptr<RoutingPolicy> policy(new RoutingPolicy(config.name));
+    for (std::vector<PolicyTermConfig>::const_iterator it =
+         config.terms.begin(); it != config.terms.end(); ++it) {
+        std::string term_error;
+        if (!policy->AddTerm(*it, &term_error)) {
+            if (error) *error = it->name + ": " + term_error;
+            return NULL;
+        }
+    }
+    return policy.release();
+}
+
+bool RoutingPolicy::AddTerm(const PolicyTermConfig &config,
+                            std::string *error) {
+    // Neither the neighbor nor the protocol is known to the table when it
+    // evaluates the policy.
+    if (!config.match_neighbor.empty()) {
+        if (error) *error = "Unsupported neighbor match";
+        return false;
+    }
+    if (!config.match_protocol.empty()) {
+        if (error) *error = "Unsupported protocol match";
+        return false;
+    }
+
+    std::auto_ptr<Term> term(new Term);
+    term->name = config.name;
+
+    std::vector<std::pair<Ip4Prefix, PrefixMatchType> > prefixes;
+    for (std::vector<std::string>::const_iterator it =
+         config.match_prefixes.begin();
+         it != config.match_prefixes.end(); ++it) {
+        Ip4Prefix prefix;
+        PrefixMatchType type;
+        if (!ParsePrefix(*it, &prefix, &type)) {
+            if (error) *error = "Invalid prefix " + *it;
+            return false;
+        }
+        prefixes.push_back(std::make_pair(prefix, type));
+    }
+    term->match_prefix = !prefixes.empty();
+
+    if (!ParseCommunities(config.match_communities,
+                          &term->match_communities, &term->match_targets)) {
+        if (error) *error = "Invalid match community";
+        return false;
+    }
+
+    if (!config.match_as_path.empty()) {
+        if (!ParseAsPath(config.match_as_path, &term->as_path)) {
+            if (error) *error = "Invalid as-path " + config.match_as_path;
+            return false;
+        }
+        term->match_as_path = true;
+    }
+
+    term->match_local_pref = config.match_local_pref;
+
+    if (!config.match_nexthop.empty()) {
+        boost::system::error_code ec;
+        term->nexthop = IpAddress::from_string(config.match_nexthop, ec);
+        if (ec) {
+            if (error) *error = "Invalid next-hop " + config.match_nexthop;
+            return false;
+        }
+        term->match_nexthop = true;
+    }
+
+    TargetList set_targets;
+    if (!ParseCommunities(config.add_communities,
+                          &term->add_communities, &term->add_targets) ||
+        !ParseCommunities(config.remove_communities,
+                          &term->remove_communities, &term->remove_targets) ||
+        !ParseCommunities(config.set_communities,
+                          &term->add_communities, &set_targets) ||
+        !set_targets.empty()) {
+        if (error) *error = "Invalid community update";
+        return false;
+    }
+    term->set_communities = !config.set_communities.empty();
+    term->update_communities = term->set_communities ||
+        !term->add_communities.empty() || !term->remove_communities.empty();
+    term->update_local_pref = config.update_local_pref;
+
+    if (config.action.empty() || config.action == "next") {
+        term->action = NEXT;
+    } else if (config.action == "accept") {
+        term->action = ACCEPT;
+    } else if (config.action == "reject") {
+        term->action = REJECT;
+    } else {
+        if (error) *error = "Invalid action " + config.action;
+        return false;
+    }
+
+    size_t term_idx = terms_.size();
+    for (size_t idx = 0; idx < prefixes.size(); ++idx) {
+        PrefixTermList *list = prefix_index_.Find(prefixes[idx].first);
+        if (!list) {
+            prefix_index_.Insert(prefixes[idx].first, PrefixTermList());
+            list = prefix_index_.Find(prefixes[idx].first);
+        }
+        list->push_back(PrefixTerm(term_idx, prefixes[idx].second));
+    }
+    has_as_path_ |= term->match_as_path;
+    has_targets_ |= !term->match_targets.empty();
+    terms_.push_back(term.release());
+    return true;
+}
+
+bool RoutingPolicy::MatchTerm(const Term &term, const BgpAttr *attr,
+                              const TargetList &targets,
+                              const std::vector<as_t> &as_list) const {
+    if (term.match_local_pref && attr->local_pref() != term.match_local_pref)
+        return false;
+
+    if (term.match_nexthop && attr->nexthop() != term.nexthop)
+        return false;
+
+    if (!term.match_communities.empty()) {
+        if (!attr->community())
+            return false;
+        const std::vector<uint32_t> &communities =
+            attr->community()->communities();
+        if (!std::includes(communities.begin(), communities.end(),
+                           term.match_communities.begin(),
+                           term.match_communities.end()))
+            return false;
+    }
+
+    if (!term.match_targets.empty() &&
+        !std::includes(targets.begin(), targets.end(),
+                       term.match_targets.begin(), term.match_targets.end()))
+        return false;
+
+    if (term.match_as_path && !MatchAsPath(term.as_path, as_list))
+        return false;
+
+    return true;
+}
+
+void RoutingPolicy::ApplyUpdates(const Updates &updates,
+                                 BgpAttrPtr *attr) const {
+    const BgpAttr *old_attr = attr->get();
+    BgpAttr *clone = new BgpAttr(*old_attr);
+
+    if (updates.local_pref)
+        clone->set_local_pref(updates.local_pref);
+
+    if (updates.communities_changed) {
+        std::set<uint32_t> communities;
+        if (!updates.set_communities && old_attr->community()) {
+            communities.insert(old_attr->community()->communities().begin(),
+                               old_attr->community()->communities().end());
+        }
+        for (std::set<uint32_t>::const_iterator it =
+             updates.remove_communities.begin();
+             it != updates.remove_communities.end(); ++it) {
+            communities.erase(*it);
+        }
+        communities.insert(updates.add_communities.begin(),
+                           updates.add_communities.end());
+        if (communities.empty()) {
+            clone->set_community(NULL);
+        } else {
+            CommunitySpec spec;
+            spec.communities.assign(communities.begin(), communities.end());
+            clone->set_community(&spec);
+        }
+    }
+
+    if (updates.targets_changed) {
+        ExtCommunitySpec spec;
+        if (old_attr->ext_community()) {
+            const ExtCommunity::ExtCommunityList &list =
+                old_attr->ext_community()->communities();
+            for (ExtCommunity::ExtCommunityList::const_iterator it =
+                 list.begin(); it != list.end(); ++it) {
+                uint64_t value = get_value(it->data(), it->size());
+                if (ExtCommunity::is_route_target(*it) &&
+                    updates.remove_targets.count(value))
+                    continue;
+                spec.communities.push_back(value);
+            }
+        }
+        spec.communities.insert(spec.communities.end(),
+                                updates.add_targets.begin(),
+                                updates.add_targets.end());
+        if (spec.communities.empty()) {
+            clone->set_ext_community(ExtCommunityPtr());
+        } else {
+            clone->set_ext_community(&spec);
+        }
+    }
+
+    *attr = old_attr->attr_db()->Locate(clone);
+}
+
+bool RoutingPolicy::Evaluate(const BgpTable *table, const BgpRoute *route,
+                             BgpAttrPtr *attr) {
+    evaluations_++;
+    const BgpAttr *route_attr = attr->get();
+
+    // Single walk over the prefixes covering the route.
+    TermMask prefix_mask(terms_.size());
+    Ip4Prefix prefix;
+    if (!prefix_index_.empty() && GetRoutePrefix(table, route, &prefix)) {
+        Ip4Prefix match;
+        for (PrefixTermList *list = prefix_index_.LongestMatch(prefix, &match);
+             list != NULL;
+             list = prefix_index_.LongestLessSpecificMatch(match, &match)) {
+            for (PrefixTermList::const_iterator it = list->begin();
+                 it != list->end(); ++it) {
+                if ((it->type == EXACT &&
+                     match.prefixlen() != prefix.prefixlen()) ||
+                    (it->type == LONGER &&
+                     match.prefixlen() == prefix.prefixlen()))
+                    continue;
+                prefix_mask.Set(it->term_idx);
+            }
+        }
+    }
+
+    // Route targets and AS path are only extracted if some term needs them.
+    TargetList targets;
+    if (has_targets_ && route_attr->ext_community()) {
+        const ExtCommunity::ExtCommunityList &list =
+            route_attr->ext_community()->communities();
+        for (ExtCommunity::ExtCommunityList::const_iterator it = list.begin();
+             it != list.end(); ++it) {
+            if (ExtCommunity::is_route_target(*it))
+                targets.push_back(get_value(it->data(), it->size()));
+        }
+        std::sort(targets.begin(), targets.end());
+    }
+
+    std::vector<as_t> as_list;
+    if (has_as_path_ && route_attr->as_path()) {
+        const AsPathSpec &as_path = route_attr->as_path()->path();
+        for (size_t idx = 0; idx < as_path.path_segments.size(); ++idx) {
+            const std::vector<as_t> &segment =
+                as_path.path_segments[idx]->path_segment;
+            as_list.insert(as_list.end(), segment.begin(), segment.end());
+        }
+    }
+
+    Updates updates;
+    Action result = NEXT;
+    for (size_t idx = 0; idx < terms_.size(); ++idx) {
+        Term &term = terms_[idx];
+        if (term.match_prefix && !prefix_mask.Test(idx))
+            continue;
+        if (!MatchTerm(term, route_attr, targets, as_list))
+            continue;
+        term.hits++;
+        updates.Merge(term);
+        if (term.action != NEXT) {
+            result = term.action;
+            break;
+        }
+    }
+
+    if (result == REJECT) {
+        rejects_++;
+        return false;
+    }
+    if (updates.changed)
+        ApplyUpdates(updates, attr);
+    return true;
+}
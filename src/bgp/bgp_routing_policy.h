@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef ctrlplane_bgp_routing_policy_h
+#define ctrlplane_bgp_routing_policy_h
+
+#include <string>
+#include <vector>
+
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/shared_ptr.hpp>
+#include <tbb/atomic.h>
+
+#include "base/util.h"
+#include "bgp/bgp_attr.h"
+#include "bgp/inet/inet_prefix_index.h"
+#include "routing-policy/policy_config.h"
+
+class BgpRoute;
+class BgpTable;
+
+//
+// RoutingPolicy
+// Compiled form of a routing policy, evaluated against routes in the BgpTable
+// input and export paths. The config model, PolicyConfig, lives in the
+// routing-policy module.
+//
+// Terms are evaluated in order. Updates of matching terms accumulate and the
+// first matching term with an accept or reject action ends the evaluation.
+// A route that doesn't hit such a term is accepted. All terms match against
+// the attributes the route came with, not the updated ones.
+//
+// Match conditions are compiled into flat tables when the term is added:
+// the prefixes of all terms share a single Patricia tree, so that one walk
+// over the prefixes covering the route finds every term whose prefix
+// condition is satisfied; communities are kept sorted and matched with a
+// single merge; AS path patterns are compiled into opcodes.
+//
+// Evaluation only updates the atomic hit counters and may run concurrently
+// in all DB partitions. Terms can't be added once the policy is in use.
+//
+class RoutingPolicy {
+public:
+    enum Action {
+        NEXT,
+        ACCEPT,
+        REJECT
+    };
+
+    explicit RoutingPolicy(const std::string &name);
+    ~RoutingPolicy();
+
+    // Compile all terms of the config. Returns NULL if any term is invalid.
+    static RoutingPolicy *Compile(const PolicyConfig &config,
+                                  std::string *error = NULL);
+
+    // Compile and append a term. Returns false if the config is invalid, in
+    // which case the policy is unchanged.
+    bool AddTerm(const PolicyTermConfig &config, std::string *error = NULL);
+
+    // Evaluate the policy for the route. Returns false if the route is
+    // rejected. Otherwise attr is replaced by the updated attributes, if
+    // any matching term has updates.
+    bool Evaluate(const BgpTable *table, const BgpRoute *route,
+                  BgpAttrPtr *attr);
+
+    const std::string &name() const { return name_; }
+    size_t term_count() const { return terms_.size(); }
+    const std::string &term_name(size_t idx) const {
+        return terms_[idx].name;
+    }
+    uint64_t term_hits(size_t idx) const { return terms_[idx].hits; }
+    uint64_t evaluations() const { return evaluations_; }
+    uint64_t rejects() const { return rejects_; }
+
+private:
+    enum PrefixMatchType {
+        EXACT,
+        LONGER,
+        ORLONGER
+    };
+
+    enum AsPathOpcode {
+        AS_NUMBER,
+        AS_ANY,
+        AS_ANY_SEQUENCE
+    };
+
+    struct AsPathOp {
+        AsPathOp(AsPathOpcode opcode, as_t asn) : opcode(opcode), asn(asn) {
+        }
+        AsPathOpcode opcode;
+        as_t asn;
+    };
+
+    struct PrefixTerm {
+        PrefixTerm(size_t term_idx, PrefixMatchType type)
+            : term_idx(term_idx), type(type) {
+        }
+        size_t term_idx;
+        PrefixMatchType type;
+    };
+
+    typedef std::vector<PrefixTerm> PrefixTermList;
+    typedef std::vector<uint32_t> CommunityList;
+    typedef std::vector<uint64_t> TargetList;
+    typedef std::vector<AsPathOp> AsPathProgram;
+
+    struct Term {
+        Term();
+
+        std::string name;
+        bool match_prefix;
+        CommunityList match_communities;
+        TargetList match_targets;
+        bool match_as_path;
+        AsPathProgram as_path;
+        uint32_t match_local_pref;
+        bool match_nexthop;
+        IpAddress nexthop;
+
+        bool update_communities;
+        bool set_communities;
+        CommunityList add_communities;
+        CommunityList remove_communities;
+        TargetList add_targets;
+        TargetList remove_targets;
+        uint32_t update_local_pref;
+        Action action;
+
+        tbb::atomic<uint64_t> hits;
+    };
+
+    class Updates;
+
+    static bool ParsePrefix(const std::string &str, Ip4Prefix *prefix,
+                            PrefixMatchType *type);
+    static bool ParseCommunities(const std::vector<std::string> &list,
+                                 CommunityList *communities,
+                                 TargetList *targets);
+    static bool ParseAsPath(const std::string &str, AsPathProgram *program);
+    static bool MatchAsPath(const AsPathProgram &program,
+                            const std::vector<as_t> &as_list);
+
+    bool MatchTerm(const Term &term, const BgpAttr *attr,
+                   const TargetList &targets,
+                   const std::vector<as_t> &as_list) const;
+    void ApplyUpdates(const Updates &updates, BgpAttrPtr *attr) const;
+
+    std::string name_;
+    boost::ptr_vector<Term> terms_;
+    Ip4PrefixIndex<PrefixTermList> prefix_index_;
+    bool has_as_path_;
+    bool has_targets_;
+    tbb::atomic<uint64_t> evaluations_;
+    tbb::atomic<uint64_t> rejects_;
+
+    DISALLOW_COPY_AND_ASSIGN(RoutingPolicy);
+};
+
+typedef boost::shared_ptr<RoutingPolicy> RoutingPolicyPtr;
+
+#endif  // ctrlplane_bgp_routing_policy_h
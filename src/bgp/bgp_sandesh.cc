@@ -2,22 +2,28 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <cstdlib>
+#include <sstream>
+
 #include <boost/assign/list_of.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/foreach.hpp>
+#include <boost/shared_ptr.hpp>
 #include <sandesh/sandesh_types.h>
 #include <sandesh/sandesh.h>
 #include <sandesh/request_pipeline.h>
 
 #include "base/util.h"
 #include "io/tcp_server.h"
+#include "bgp/bgp_condition_listener.h"
 #include "bgp/bgp_config.h"
 #include "bgp/bgp_multicast.h"
 #include "bgp/bgp_path.h"
 #include "bgp/bgp_peer_types.h"
 #include "bgp/bgp_peer_membership.h"
 #include "bgp/bgp_route.h"
+#include "bgp/bgp_routing_policy.h"
 #include "bgp/bgp_sandesh.h"
 #include "bgp/bgp_session_manager.h"
 #include "bgp/bgp_table.h"
@@ -40,42 +46,172 @@ struct ShowRouteData : public RequestPipeline::InstData {
     vector<ShowRouteTable> route_table_list;
 };
 
+//
+// Parameters of a show route request.
+//
+// A ShowRouteReqIterate carries them, along with the position of the route to
+// resume from, in its route_info. The fields are separated by "||".
+//
+struct ShowRouteParams {
+    ShowRouteParams()
+        : longer_match(false), count(0), paging(false), bsc(NULL) {
+    }
+
+    bool FromRequest(const Sandesh *sr);
+    string ToIterateString(const string &next_instance,
+                           const string &next_table,
+                           const string &next_prefix) const;
+
+    // Maximum number of routes in the response, 0 if unlimited
+    uint32_t RouteLimit() const {
+        if (count || !paging) return count;
+        return bsc->page_limit;
+    }
+    // Maximum number of routes looked at in a partition, 0 if unlimited.
+    // Applies to all the requests, so that a request does not hog the CPU.
+    uint32_t IterLimit() const {
+        return bsc->iter_limit;
+    }
+
+    string routing_instance;
+    string routing_table;
+    string prefix;
+    bool longer_match;
+    uint32_t count;
+    bool paging;
+    string start_routing_instance;
+    string start_routing_table;
+    string start_prefix;
+
+    BgpSandeshContext *bsc;
+    string context;
+};
+
+static const char kIterSeparator[] = "||";
+
+bool ShowRouteParams::FromRequest(const Sandesh *sr) {
+    const ShowRouteReq *req = dynamic_cast<const ShowRouteReq *>(sr);
+    if (req) {
+        routing_instance = req->get_routing_instance();
+        routing_table = req->get_routing_table();
+        prefix = req->get_prefix();
+        longer_match = req->get_longer_match();
+        count = req->get_count();
+        paging = req->get_paging();
+        start_routing_instance = req->get_start_routing_instance();
+        start_routing_table = req->get_start_routing_table();
+        start_prefix = req->get_start_prefix();
+        bsc = static_cast<BgpSandeshContext *>(req->client_context());
+        context = req->context();
+        return true;
+    }
+
+    const ShowRouteReqIterate *iter_req =
+        dynamic_cast<const ShowRouteReqIterate *>(sr);
+    if (!iter_req)
+        return false;
+    bsc = static_cast<BgpSandeshContext *>(iter_req->client_context());
+    context = iter_req->context();
+
+    vector<string> fields;
+    const string &route_info = iter_req->get_route_info();
+    size_t start = 0;
+    while (true) {
+        size_t pos = route_info.find(kIterSeparator, start);
+        fields.push_back(route_info.substr(start, pos - start));
+        if (pos == string::npos)
+            break;
+        start = pos + sizeof(kIterSeparator) - 1;
+    }
+    if (fields.size() != 9)
+        return false;
+
+    routing_instance = fields[0];
+    routing_table = fields[1];
+    prefix = fields[2];
+    longer_match = (fields[3] == "1");
+    count = strtoul(fields[4].c_str(), NULL, 10);
+    paging = (fields[5] == "1");
+    start_routing_instance = fields[6];
+    start_routing_table = fields[7];
+    start_prefix = fields[8];
+    return true;
+}
+
+string ShowRouteParams::ToIterateString(const string &next_instance,
+                                        const string &next_table,
+                                        const string &next_prefix) const {
+    ostringstream out;
+    out << routing_instance << kIterSeparator << routing_table
+        << kIterSeparator << prefix << kIterSeparator
+        << (longer_match ? "1" : "0") << kIterSeparator << count
+        << kIterSeparator << (paging ? "1" : "0")
+        << kIterSeparator << next_instance << kIterSeparator << next_table
+        << kIterSeparator << next_prefix;
+    return out.str();
+}
+
+//
+// Position of a route in the order in which show route walks the routes:
+// routing instance name, table name and then the key order of the table.
+//
+struct ShowRoutePosition {
+    ShowRoutePosition() {
+    }
+    ShowRoutePosition(DB *db, const string &instance, const string &table,
+                      const string &route_prefix)
+        : routing_instance(instance), routing_table(table),
+          prefix(route_prefix) {
+        BgpTable *bgp_table = static_cast<BgpTable *>(db->FindTable(table));
+        if (bgp_table)
+            key.reset(bgp_table->AllocEntryStr(prefix).release());
+    }
+
+    bool operator<(const ShowRoutePosition &rhs) const {
+        if (routing_instance != rhs.routing_instance)
+            return routing_instance < rhs.routing_instance;
+        if (routing_table != rhs.routing_table)
+            return routing_table < rhs.routing_table;
+        if (key && rhs.key)
+            return key->IsLess(*rhs.key);
+        return prefix < rhs.prefix;
+    }
+
+    string routing_instance;
+    string routing_table;
+    string prefix;
+    // NULL if the table has gone away since the route was looked at
+    boost::shared_ptr<DBEntry> key;
+};
+
 class ShowRouteHandler {
 public:
     struct ShowRouteData : public RequestPipeline::InstData {
+        ShowRouteData() : stopped(false) {
+        }
+
         vector<ShowRouteTable> route_table_list;
-    };
 
-    ShowRouteHandler(const ShowRouteReq *req, int inst_id) :
-        req_(req), inst_id_(inst_id) {}
+        // Set if the walk ran into the route count or the iteration limit.
+        // The stop_ fields give the first route that was not looked at.
+        bool stopped;
+        string stop_routing_instance;
+        string stop_routing_table;
+        string stop_prefix;
+    };
 
-    // Search for interesting prefixes in a given table for specified partition
-    void BuildShowRouteTable(BgpTable *table,
-            vector<ShowRoute> &route_list,
-            int count) {
-        DBTablePartition *partition =
-            static_cast<DBTablePartition *>(table->GetTablePartition(inst_id_));
-        BgpRoute *route;
-
-        // As of now, this code walks through all the prefixes even if we are
-        // searching for a specific one. We can improve it by doing a lookup
-        if (table->name() == req_->get_start_routing_table()) {
-            auto_ptr<DBEntry> key = table->AllocEntryStr(req_->get_start_prefix());
-            route = static_cast<BgpRoute *>(partition->lower_bound(key.get()));
-        } else {
-            route = static_cast<BgpRoute *>(partition->GetFirst());
-        }
-        for (int i = 0; route && (!count || i < count);
-                route = static_cast<BgpRoute *>(partition->GetNext(route)), i++) {
-            if (!MatchPrefix(req_->get_prefix(), route,
-                             req_->get_longer_match()))
-                continue;
-            ShowRoute show_route;
-            route->FillRouteInfo(table, &show_route);
-            route_list.push_back(show_route);
-        }
+    ShowRouteHandler(const ShowRouteParams &params, int inst_id)
+        : params_(params), inst_id_(inst_id), matched_(0), visited_(0) {
+        count_ = params.RouteLimit();
+        iter_limit_ = params.IterLimit();
     }
 
+    // Search for interesting prefixes in a given table for specified
+    // partition. Returns false, along with the prefix of the next route, if
+    // the walk stopped before the end of the table.
+    bool BuildShowRouteTable(BgpTable *table, vector<ShowRoute> *route_list,
+                             string *stop_prefix);
+
     bool MatchPrefix(const string &expected_prefix, BgpRoute *route,
                      bool longer_match) {
         if (expected_prefix == "") return true;
@@ -104,35 +240,139 @@ public:
             const RequestPipeline::PipeSpec ps,
             int stage, int instNum,
             RequestPipeline::InstData *data);
+
+    static void StartPipeline(const SandeshRequest *sr,
+                              BgpSandeshContext *bsc);
+
 private:
-    const ShowRouteReq *req_;
+    bool LimitReached() const {
+        return ((count_ && matched_ >= count_) ||
+                (iter_limit_ && visited_ >= iter_limit_));
+    }
+
+    BgpRoute *FirstRoute(BgpTable *table, DBTablePartition *partition,
+                         Ip4Address *last_address);
+
+    const ShowRouteParams &params_;
     int inst_id_;
+    uint32_t count_;
+    uint32_t iter_limit_;
+    uint32_t matched_;
+    uint32_t visited_;
 };
 
+// Find the first route to look at in the partition. For a longer match in an
+// inet table, only the range of addresses covered by the prefix is walked and
+// last_address is set to the end of the range.
+BgpRoute *ShowRouteHandler::FirstRoute(BgpTable *table,
+                                       DBTablePartition *partition,
+                                       Ip4Address *last_address) {
+    auto_ptr<DBEntry> start_key;
+    if (table->name() == params_.start_routing_table &&
+        !params_.start_prefix.empty()) {
+        start_key = table->AllocEntryStr(params_.start_prefix);
+    }
+
+    if (params_.longer_match && !params_.prefix.empty() &&
+        table->family() == Address::INET) {
+        boost::system::error_code ec;
+        Ip4Prefix match = Ip4Prefix::FromString(params_.prefix, &ec);
+        if (ec)
+            return NULL;
+        uint32_t mask = match.prefixlen() ?
+            (0xFFFFFFFF << (32 - match.prefixlen())) : 0;
+        uint32_t first = match.ip4_addr().to_ulong() & mask;
+        *last_address = Ip4Address(first | ~mask);
+        InetRoute range_start(Ip4Prefix(Ip4Address(first), 0));
+        if (!start_key.get() || start_key->IsLess(range_start)) {
+            return static_cast<BgpRoute *>(partition->lower_bound(&range_start));
+        }
+    }
+
+    if (start_key.get())
+        return static_cast<BgpRoute *>(partition->lower_bound(start_key.get()));
+    return static_cast<BgpRoute *>(partition->GetFirst());
+}
+
+bool ShowRouteHandler::BuildShowRouteTable(BgpTable *table,
+                                           vector<ShowRoute> *route_list,
+                                           string *stop_prefix) {
+    DBTablePartition *partition =
+        static_cast<DBTablePartition *>(table->GetTablePartition(inst_id_));
+
+    // Exact match is a single lookup in the partition that owns the prefix
+    if (!params_.prefix.empty() && !params_.longer_match) {
+        auto_ptr<DBEntry> key = table->AllocEntryStr(params_.prefix);
+        BgpRoute *route = static_cast<BgpRoute *>(partition->Find(key.get()));
+        if (!route || route->ToString() != params_.prefix)
+            return true;
+        if (table->name() == params_.start_routing_table &&
+            !params_.start_prefix.empty()) {
+            auto_ptr<DBEntry> start_key =
+                table->AllocEntryStr(params_.start_prefix);
+            if (route->IsLess(*start_key))
+                return true;
+        }
+        if (LimitReached()) {
+            *stop_prefix = route->ToString();
+            return false;
+        }
+        visited_++;
+        matched_++;
+        ShowRoute show_route;
+        route->FillRouteInfo(table, &show_route);
+        route_list->push_back(show_route);
+        return true;
+    }
+
+    Ip4Address last_address;
+    bool inet_range = (params_.longer_match && !params_.prefix.empty() &&
+                       table->family() == Address::INET);
+    BgpRoute *route = FirstRoute(table, partition, &last_address);
+    for (; route; route = static_cast<BgpRoute *>(partition->GetNext(route))) {
+        if (inet_range && static_cast<InetRoute *>(route)->GetPrefix().ip4_addr()
+            > last_address) {
+            break;
+        }
+        if (LimitReached()) {
+            *stop_prefix = route->ToString();
+            return false;
+        }
+        visited_++;
+        if (!MatchPrefix(params_.prefix, route, params_.longer_match))
+            continue;
+        matched_++;
+        ShowRoute show_route;
+        route->FillRouteInfo(table, &show_route);
+        route_list->push_back(show_route);
+    }
+    return true;
+}
+
 bool ShowRouteHandler::CallbackS1(const Sandesh *sr,
             const RequestPipeline::PipeSpec ps,
             int stage, int instNum,
             RequestPipeline::InstData *data) {
     ShowRouteData* mydata = static_cast<ShowRouteData*>(data);
     int inst_id = ps.stages_[stage].instances_[instNum];
-    const ShowRouteReq *req = static_cast<const ShowRouteReq *>(ps.snhRequest_.get());
-    ShowRouteHandler handler(req, inst_id);
-    BgpSandeshContext *bsc = static_cast<BgpSandeshContext *>(req->client_context());
-    RoutingInstanceMgr *rim = bsc->bgp_server->routing_instance_mgr();
+    ShowRouteParams params;
+    if (!params.FromRequest(ps.snhRequest_.get()))
+        return true;
+    ShowRouteHandler handler(params, inst_id);
+    RoutingInstanceMgr *rim = params.bsc->bgp_server->routing_instance_mgr();
     RoutingInstanceMgr::NameIterator i =
-            rim->name_lower_bound(req->get_start_routing_instance());
-    uint32_t count = 0;
+            rim->name_lower_bound(params.start_routing_instance);
     for (;i != rim->name_end(); i++) {
-        if (!handler.match(req->get_routing_instance(), i->first))
+        if (!handler.match(params.routing_instance, i->first))
             continue;
         RoutingInstance::RouteTableList::const_iterator j;
-        if (req->get_start_routing_instance() == i->first)
-            j = i->second->GetTables().lower_bound(req->get_start_routing_table());
+        if (params.start_routing_instance == i->first)
+            j = i->second->GetTables().lower_bound(params.start_routing_table);
         else
             j = i->second->GetTables().begin();
         for (;j != i->second->GetTables().end(); j++) {
             BgpTable *table = j->second;
-            if (!handler.match(req->get_routing_table(), table->name()))
+            if (!handler.match(params.routing_table, table->name()))
                 continue;
             ShowRouteTable srt;
             srt.set_routing_instance(i->first);
@@ -146,16 +386,21 @@ bool ShowRouteHandler::CallbackS1(const Sandesh *sr,
             srt.paths = srt.primary_paths + srt.secondary_paths;
 
             vector<ShowRoute> route_list;
-            handler.BuildShowRouteTable(table, route_list,
-                                req->get_count()?req->get_count() - count : 0);
+            string stop_prefix;
+            bool done =
+                handler.BuildShowRouteTable(table, &route_list, &stop_prefix);
             if (route_list.size()) {
                 srt.set_routes(route_list);
                 mydata->route_table_list.push_back(srt);
             }
-            count += route_list.size();
-            if (req->get_count() && count >= req->get_count()) break;
+            if (!done) {
+                mydata->stopped = true;
+                mydata->stop_routing_instance = i->first;
+                mydata->stop_routing_table = table->name();
+                mydata->stop_prefix = stop_prefix;
+                return true;
+            }
         }
-        if (req->get_count() && count >= req->get_count()) break;
     }
     return true;
 }
@@ -170,105 +415,114 @@ bool ShowRouteTable::operator<(const ShowRouteTable &rhs) const {
     return false;
 }
 
-template <class T>
-void MergeSort(vector<T> &result, vector<const vector<T> *> &input, int limit);
-
-int MergeValues(ShowRoute &result, vector<const ShowRoute *> &input, int limit) {
-    assert(input.size() == 1);
-    result = *input[0];
-    return 1;
-}
-
-int MergeValues(ShowRouteTable &result, vector<const ShowRouteTable *> &input,
-                 int limit) {
-    vector<const vector<ShowRoute> *> list;
-    result.routing_instance = input[0]->routing_instance;
-    result.routing_table_name = input[0]->routing_table_name;
-    result.prefixes = input[0]->prefixes;
-    result.primary_paths = input[0]->primary_paths;
-    result.secondary_paths = input[0]->secondary_paths;
-    result.infeasible_paths = input[0]->infeasible_paths;
-    result.paths = input[0]->paths;
-
-    int count = 0;
-    for (size_t i = 0; i < input.size(); i++) {
-        if (input[i]->routes.size())
-            list.push_back(&input[i]->routes);
-    }
-    MergeSort(result.routes, list, limit ? limit - count : 0);
-    count += result.routes.size();
-    return count;
-}
-
-// Merge n number of vectors in result. input is a vector of pointers to vector
-template <class T>
-void MergeSort(vector<T> &result, vector<const vector<T> *> &input, int limit) {
-    size_t size = input.size();
-    size_t index[size];
-    bzero(index, sizeof(index));
-    int count = 0;
-    while (limit == 0 || count < limit) {
-        size_t best_index = size;
-        const T *best = NULL;
-        for (size_t i = 0; i < size; i++) {
-            if (index[i] == input[i]->size()) continue;
-            if (best == NULL ||
-                input[i]->at(index[i]) < *best) {
-                best = &input[i]->at(index[i]);
-                best_index = i;
-                continue;
-            }
-        }
-        if (best_index >= size) break;
-        T table;
-        vector<const T *> list;
-        for (size_t j = best_index; j < size; j++) {
-            if (index[j] == input[j]->size()) continue;
-            if (input[j]->at(index[j]) < *best ||
-                *best < input[j]->at(index[j]))
-                continue;
-            list.push_back(&input[j]->at(index[j]));
-            index[j]++;
-        }
-        count += MergeValues(table, list, limit ? limit - count : 0);
-        result.push_back(table);
+struct ShowRouteEntry {
+    ShowRouteEntry(const ShowRouteTable *srt, const ShowRoute *sr,
+                   const ShowRoutePosition &pos)
+        : table(srt), route(sr), position(pos) {
+    }
+    bool operator<(const ShowRouteEntry &rhs) const {
+        return position < rhs.position;
     }
 
-}
+    const ShowRouteTable *table;
+    const ShowRoute *route;
+    ShowRoutePosition position;
+};
 
+// Merge the routes from all partitions in walk order. Routes at or after the
+// earliest position where a partition stopped are left out, since the routes
+// of that partition beyond it have not been looked at. The next batch
+// resumes from the first route that is left out.
 bool ShowRouteHandler::CallbackS2(const Sandesh *sr,
             const RequestPipeline::PipeSpec ps,
             int stage, int instNum,
             RequestPipeline::InstData *data) {
-    const ShowRouteReq *req = static_cast<const ShowRouteReq *>(ps.snhRequest_.get());
+    ShowRouteParams params;
+    if (!params.FromRequest(ps.snhRequest_.get())) {
+        // Malformed route_info
+        ShowRouteResp *resp = new ShowRouteResp;
+        resp->set_context(params.context);
+        resp->Response();
+        return true;
+    }
+    DB *db = params.bsc->bgp_server->database();
+    uint32_t limit = params.RouteLimit();
+
     const RequestPipeline::StageData *sd = ps.GetStageData(0);
-    ShowRouteResp *resp = new ShowRouteResp;
-    vector<ShowRouteTable> route_table_list;
-    vector<const vector<ShowRouteTable> *> table_lists;
+    vector<ShowRouteEntry> entries;
+    bool stopped = false;
+    ShowRoutePosition stop_position;
     for (size_t i = 0; i < sd->size(); i++) {
-        const ShowRouteData &old_data = static_cast<const ShowRouteData &>(sd->at(i));
-        if (old_data.route_table_list.size())
-            table_lists.push_back(&old_data.route_table_list);
+        const ShowRouteData &old_data =
+            static_cast<const ShowRouteData &>(sd->at(i));
+        BOOST_FOREACH(const ShowRouteTable &srt, old_data.route_table_list) {
+            BOOST_FOREACH(const ShowRoute &route, srt.routes) {
+                entries.push_back(ShowRouteEntry(&srt, &route,
+                    ShowRoutePosition(db, srt.routing_instance,
+                                      srt.routing_table_name, route.prefix)));
+            }
+        }
+        if (!old_data.stopped)
+            continue;
+        ShowRoutePosition position(db, old_data.stop_routing_instance,
+                                   old_data.stop_routing_table,
+                                   old_data.stop_prefix);
+        if (!stopped || position < stop_position) {
+            stop_position = position;
+            stopped = true;
+        }
     }
-    MergeSort(route_table_list, table_lists, req->get_count());
+    sort(entries.begin(), entries.end());
+
+    vector<ShowRouteTable> route_table_list;
+    const ShowRoutePosition *next = stopped ? &stop_position : NULL;
+    uint32_t count = 0;
+    for (vector<ShowRouteEntry>::const_iterator it = entries.begin();
+         it != entries.end(); ++it) {
+        if (stopped && !(it->position < stop_position))
+            break;
+        if (limit && count == limit) {
+            next = &it->position;
+            break;
+        }
+        if (route_table_list.empty() ||
+            route_table_list.back().routing_table_name !=
+            it->table->routing_table_name) {
+            ShowRouteTable srt;
+            srt.routing_instance = it->table->routing_instance;
+            srt.routing_table_name = it->table->routing_table_name;
+            srt.prefixes = it->table->prefixes;
+            srt.primary_paths = it->table->primary_paths;
+            srt.secondary_paths = it->table->secondary_paths;
+            srt.infeasible_paths = it->table->infeasible_paths;
+            srt.paths = it->table->paths;
+            route_table_list.push_back(srt);
+        }
+        route_table_list.back().routes.push_back(*it->route);
+        count++;
+    }
+
+    ShowRouteResp *resp = new ShowRouteResp;
     resp->set_tables(route_table_list);
-    resp->set_context(req->context());
+    if (next) {
+        resp->set_next_batch(params.ToIterateString(next->routing_instance,
+            next->routing_table, next->prefix));
+    }
+    resp->set_context(params.context);
     resp->Response();
     return true;
 }
 
-// handler for 'show route'
-void ShowRouteReq::HandleRequest() const {
-    BgpSandeshContext *bsc = static_cast<BgpSandeshContext *>(client_context());
-
-    RequestPipeline::PipeSpec ps(this);
+void ShowRouteHandler::StartPipeline(const SandeshRequest *sr,
+                                     BgpSandeshContext *bsc) {
+    RequestPipeline::PipeSpec ps(sr);
 
     // Request pipeline has 2 stages. In first stage, we spawn one task per
     // partition and generate the list of routes. In second stage, we look
-    // at the generated list and merge it so that we can send it out
-    //
-    // In future, we can enhance it to have many stages and send partial output
-    // after every second stage
+    // at the generated list and merge it so that we can send it out.
+    // Each partition stops after the requested number of routes or after
+    // looking at iter_limit routes, and the response carries a next_batch
+    // to resume from there.
     RequestPipeline::StageSpec s1, s2;
     TaskScheduler *scheduler = TaskScheduler::GetInstance();
     s1.taskId_ = scheduler->GetTaskId("db::DBTable");
@@ -288,6 +542,18 @@ void ShowRouteReq::HandleRequest() const {
     RequestPipeline rp(ps);
 }
 
+// handler for 'show route'
+void ShowRouteReq::HandleRequest() const {
+    BgpSandeshContext *bsc = static_cast<BgpSandeshContext *>(client_context());
+    ShowRouteHandler::StartPipeline(this, bsc);
+}
+
+// handler for the next batch of 'show route'
+void ShowRouteReqIterate::HandleRequest() const {
+    BgpSandeshContext *bsc = static_cast<BgpSandeshContext *>(client_context());
+    ShowRouteHandler::StartPipeline(this, bsc);
+}
+
 class ShowNeighborHandler {
 public:
     struct ShowNeighborData : public RequestPipeline::InstData {
@@ -599,6 +865,21 @@ void BgpNeighborReq::HandleRequest() const {
 
 class ShowRoutingInstanceHandler {
 public:
+    static void FillRoutingPolicyStats(ShowRoutingPolicy &srp,
+                                       const RoutingPolicy *policy) {
+        srp.set_name(policy->name());
+        srp.set_evaluations(policy->evaluations());
+        srp.set_rejects(policy->rejects());
+        vector<ShowRoutingPolicyTerm> term_list;
+        for (size_t idx = 0; idx < policy->term_count(); ++idx) {
+            ShowRoutingPolicyTerm term;
+            term.set_name(policy->term_name(idx));
+            term.set_hits(policy->term_hits(idx));
+            term_list.push_back(term);
+        }
+        srp.set_terms(term_list);
+    }
+
     static void FillRoutingTableStats(ShowRoutingInstanceTable &rit,
                                       BgpTable *table) {
         rit.set_name(table->name());
@@ -616,6 +897,16 @@ public:
         rit.secondary_paths = table->GetSecondaryPathCount();
         rit.infeasible_paths = table->GetInfeasiblePathCount();
         rit.paths = rit.primary_paths + rit.secondary_paths;
+        if (table->import_policy()) {
+            ShowRoutingPolicy policy;
+            FillRoutingPolicyStats(policy, table->import_policy());
+            rit.set_import_policy(policy);
+        }
+        if (table->export_policy()) {
+            ShowRoutingPolicy policy;
+            FillRoutingPolicyStats(policy, table->export_policy());
+            rit.set_export_policy(policy);
+        }
     }
 
     static void FillRoutingInstanceInfo(const RequestPipeline::StageData *sd,
@@ -954,6 +1245,43 @@ void ShowMulticastManagerDetailReq::HandleRequest() const {
     RequestPipeline rp(ps);
 }
 
+class ShowConditionListenerHandler {
+public:
+    static bool CallbackS1(const Sandesh *sr,
+            const RequestPipeline::PipeSpec ps, int stage, int instNum,
+            RequestPipeline::InstData *data) {
+        const ShowConditionListenerReq *req =
+            static_cast<const ShowConditionListenerReq *>(
+                ps.snhRequest_.get());
+        BgpSandeshContext *bsc =
+            static_cast<BgpSandeshContext *>(req->client_context());
+
+        vector<ShowConditionListenerTable> table_list;
+        bsc->bgp_server->condition_listener()->FillShowInfo(&table_list);
+
+        ShowConditionListenerResp *resp = new ShowConditionListenerResp;
+        resp->set_tables(table_list);
+        resp->set_context(req->context());
+        resp->Response();
+        return true;
+    }
+};
+
+void ShowConditionListenerReq::HandleRequest() const {
+    RequestPipeline::PipeSpec ps(this);
+
+    // Request pipeline has single stage to collect condition listener stats
+    // and respond to the request. It runs in db::DBTable task since match
+    // objects get unregistered from the ServiceChain and StaticRoute tasks.
+    RequestPipeline::StageSpec s1;
+    TaskScheduler *scheduler = TaskScheduler::GetInstance();
+    s1.taskId_ = scheduler->GetTaskId("db::DBTable");
+    s1.cbFn_ = ShowConditionListenerHandler::CallbackS1;
+    s1.instances_.push_back(0);
+    ps.stages_ = list_of(s1);
+    RequestPipeline rp(ps);
+}
+
 
 class ShowRouteVrfHandler {
 public:
@@ -12,9 +12,22 @@ class BgpXmppChannelManager;
 class IFMapServer;
 
 struct BgpSandeshContext : public SandeshContext {
+    // Default number of routes in a paged show route response
+    static const uint32_t kPageLimit = 1000;
+    // Number of routes examined in a table partition for one show route
+    // request, after which the response is cut short with a next_batch
+    static const uint32_t kIterLimit = 100000;
+
+    BgpSandeshContext()
+        : bgp_server(NULL), xmpp_peer_manager(NULL), ifmap_server(NULL),
+          page_limit(kPageLimit), iter_limit(kIterLimit) {
+    }
+
     BgpServer *bgp_server;
     BgpXmppChannelManager *xmpp_peer_manager;
     IFMapServer *ifmap_server;
+    uint32_t page_limit;
+    uint32_t iter_limit;
 };
 
 #endif /* BGP_SANDESH_H_ */
@@ -65,6 +65,13 @@ BgpPeer *BgpSessionManager::FindPeer(ip::tcp::endpoint remote_endpoint) {
     return peer;
 }
 
+// The timers of a peer are created along with it on the main io_service,
+// before there is a session. Its passive sessions are kept there as well, so
+// that the session and timer handlers of the peer run on the same thread.
+boost::asio::io_service *BgpSessionManager::AcceptIoService() {
+    return event_manager()->io_service();
+}
+
 bool BgpSessionManager::AcceptSession(TcpSession *tcp_session) {
     BgpSession *session = dynamic_cast<BgpSession *>(tcp_session);
     ip::tcp::endpoint remote = session->remote_endpoint();
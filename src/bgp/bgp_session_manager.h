@@ -32,6 +32,7 @@ public:
 protected:
     virtual TcpSession *AllocSession(Socket *socket);
     virtual bool AcceptSession(TcpSession *session);
+    virtual boost::asio::io_service *AcceptIoService();
 
 private:
     friend class BgpSessionManagerTest;
@@ -18,6 +18,7 @@
 #include "bgp/bgp_ribout.h"
 #include "bgp/bgp_ribout_updates.h"
 #include "bgp/bgp_route.h"
+#include "bgp/bgp_routing_policy.h"
 #include "bgp/bgp_sandesh.h"
 #include "bgp/bgp_server.h"
 #include "bgp/bgp_update_queue.h"
@@ -135,6 +136,16 @@ UpdateInfo *BgpTable::GetUpdateInfo(RibOut *ribout, BgpRoute *route,
     BgpAttrPtr attr_ptr;
     const BgpAttr *attr = path->GetAttr();
 
+    // Apply the export policy, if any. The policy sees the attributes of
+    // the best path, before the LocalPref reset and AsPath prepend for eBGP
+    // below, so that those are applied to what the policy returns.
+    if (export_policy_) {
+        attr_ptr = attr;
+        if (!export_policy_->Evaluate(this, route, &attr_ptr))
+            return NULL;
+        attr = attr_ptr.get();
+    }
+
     // LocalPref, Med and AsPath manipulation is needed only if the RibOut
     // has BGP encoding. Similarly, well-known communities do not apply if
     // the encoding is not BGP.
@@ -321,12 +332,14 @@ void BgpTable::Input(DBTablePartition *root, DBClient *client,
     // list again to purge any stale paths originated from this peer.
 
     // Create rt if it is not already there for adds/updates.
+    bool new_route = false;
     if (!rt) {
         if (req->oper == DBRequest::DB_ENTRY_DELETE) return;
 
         rt = static_cast<BgpRoute *>(Add(req));
         static_cast<DBTablePartition *>(root)->Add(rt);
         BGP_LOG_ROUTE(this, peer, rt, "Insert new BGP path");
+        new_route = true;
     }
 
     // Use a map to mark and sweep deleted paths, update the rest.
@@ -360,12 +373,6 @@ void BgpTable::Input(DBTablePartition *root, DBClient *client,
             path = rt->FindPath(BgpPath::BGP_XMPP, peer,
                                 nexthop.address_.to_v4().to_ulong());
 
-            if (path && req->oper != DBRequest::DB_ENTRY_DELETE) {
-                if (path->IsStale()) {
-                    path->ResetStale();
-                }
-                deleted_paths.erase(path);
-            }
             if (data && data->attrs() && count > 0) {
                 BgpAttr *clone = new BgpAttr(*data->attrs());
                 clone->set_ext_community(
@@ -378,7 +385,23 @@ void BgpTable::Input(DBTablePartition *root, DBClient *client,
                 attr = data->attrs()->attr_db()->Locate(clone);
             }
 
-            InputCommon(root, rt, path, peer, req, req->oper, attr,
+            // Apply the import policy, if any. A rejected path is left marked
+            // for deletion so that a previously accepted version is flushed.
+            BgpAttrPtr path_attr = attr;
+            if (import_policy_ && path_attr &&
+                req->oper != DBRequest::DB_ENTRY_DELETE &&
+                !import_policy_->Evaluate(this, rt, &path_attr)) {
+                continue;
+            }
+
+            if (path && req->oper != DBRequest::DB_ENTRY_DELETE) {
+                if (path->IsStale()) {
+                    path->ResetStale();
+                }
+                deleted_paths.erase(path);
+            }
+
+            InputCommon(root, rt, path, peer, req, req->oper, path_attr,
                         nexthop.address_.to_v4().to_ulong(), nexthop.flags_,
                         nexthop.label_);
         }
@@ -391,6 +414,20 @@ void BgpTable::Input(DBTablePartition *root, DBClient *client,
         InputCommon(root, rt, path, peer, req, DBRequest::DB_ENTRY_DELETE,
                     NULL, path->GetPathId(), 0, 0);
     }
+
+    // Delete the new route if the import policy rejected all its paths.
+    if (new_route && rt->front() == NULL)
+        root->Delete(rt);
+}
+
+void BgpTable::set_import_policy(boost::shared_ptr<RoutingPolicy> policy) {
+    CHECK_CONCURRENCY("bgp::Config");
+    import_policy_ = policy;
+}
+
+void BgpTable::set_export_policy(boost::shared_ptr<RoutingPolicy> policy) {
+    CHECK_CONCURRENCY("bgp::Config");
+    export_policy_ = policy;
 }
 
 bool BgpTable::MayDelete() const {
@@ -6,6 +6,7 @@
 #define ctrlplane_bgp_table_h
 
 #include <map>
+#include <boost/shared_ptr.hpp>
 #include <tbb/atomic.h>
 
 #include "base/lifetime.h"
@@ -22,6 +23,7 @@ class BgpPath;
 class Path;
 class Route;
 class RoutingInstance;
+class RoutingPolicy;
 class SchedulingGroupManager;
 struct UpdateInfo;
 
@@ -119,6 +121,13 @@ public:
         return infeasible_path_count_;
     }
 
+    // Routing policies applied to paths received from peers and to routes
+    // advertised to peers. Only affect routes on their next update.
+    RoutingPolicy *import_policy() const { return import_policy_.get(); }
+    void set_import_policy(boost::shared_ptr<RoutingPolicy> policy);
+    RoutingPolicy *export_policy() const { return export_policy_.get(); }
+    void set_export_policy(boost::shared_ptr<RoutingPolicy> policy);
+
 private:
     class DeleteActor;
     friend class BgpTableTest;
@@ -132,6 +141,8 @@ private:
     tbb::atomic<uint64_t> primary_path_count_;
     tbb::atomic<uint64_t> secondary_path_count_;
     tbb::atomic<uint64_t> infeasible_path_count_;
+    boost::shared_ptr<RoutingPolicy> import_policy_;
+    boost::shared_ptr<RoutingPolicy> export_policy_;
 
     DISALLOW_COPY_AND_ASSIGN(BgpTable);
 };
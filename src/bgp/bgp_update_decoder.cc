@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "bgp/bgp_update_decoder.h"
+
+#include <memory>
+
+#include "base/parse_object.h"
+#include "bgp/bgp_aspath.h"
+#include "bgp/bgp_proto.h"
+#include "bgp/community.h"
+
+using namespace std;
+
+namespace {
+
+// Size of the marker, length and type fields in the BGP header.
+const size_t kHeaderSize = 19;
+
+// Attribute flags of each supported attribute code, with the optional and
+// transitive bits only. Zero for codes that are left to the slow path.
+uint8_t AttributeFlags(uint8_t code) {
+    switch (code) {
+    case BgpAttribute::Origin:
+        return BgpAttrOrigin::kFlags;
+    case BgpAttribute::AsPath:
+        return AsPathSpec::kFlags;
+    case BgpAttribute::NextHop:
+        return BgpAttrNextHop::kFlags;
+    case BgpAttribute::MultiExitDisc:
+        return BgpAttrMultiExitDisc::kFlags;
+    case BgpAttribute::LocalPref:
+        return BgpAttrLocalPref::kFlags;
+    case BgpAttribute::AtomicAggregate:
+        return BgpAttrAtomicAggregate::kFlags;
+    case BgpAttribute::Aggregator:
+        return BgpAttrAggregator::kFlags;
+    case BgpAttribute::Communities:
+        return CommunitySpec::kFlags;
+    default:
+        return 0;
+    }
+}
+
+}  // namespace
+
+bool BgpUpdateDecoder::DecodePrefixes(const uint8_t *data, size_t size,
+                                      vector<Ip4Prefix> *prefixes) {
+    size_t offset = 0;
+    while (offset < size) {
+        int prefixlen = data[offset++];
+        if (prefixlen > 32)
+            return false;
+        size_t nbytes = (prefixlen + 7) / 8;
+        if (offset + nbytes > size)
+            return false;
+        Ip4Address::bytes_type bt = { { 0 } };
+        copy(data + offset, data + offset + nbytes, bt.begin());
+        prefixes->push_back(Ip4Prefix(Ip4Address(bt), prefixlen));
+        offset += nbytes;
+    }
+    return true;
+}
+
+bool BgpUpdateDecoder::DecodeAsPath(const uint8_t *data, size_t size,
+                                    AsPathSpec *spec) {
+    size_t offset = 0;
+    while (offset < size) {
+        if (offset + 2 > size)
+            return false;
+        int type = data[offset];
+        size_t count = data[offset + 1];
+        offset += 2;
+        if (type != AsPathSpec::PathSegment::AS_SET &&
+            type != AsPathSpec::PathSegment::AS_SEQUENCE)
+            return false;
+        if (offset + count * 2 > size)
+            return false;
+        AsPathSpec::PathSegment *ps = new AsPathSpec::PathSegment;
+        ps->path_segment_type = type;
+        ps->path_segment.reserve(count);
+        for (size_t idx = 0; idx < count; ++idx, offset += 2) {
+            ps->path_segment.push_back(get_short(data + offset));
+        }
+        spec->path_segments.push_back(ps);
+    }
+    return true;
+}
+
+bool BgpUpdateDecoder::DecodeCommunities(const uint8_t *data, size_t size,
+                                         CommunitySpec *spec) {
+    if (size % 4 != 0)
+        return false;
+    spec->communities.reserve(size / 4);
+    for (size_t offset = 0; offset < size; offset += 4) {
+        spec->communities.push_back(get_value(data + offset, 4));
+    }
+    return true;
+}
+
+//
+// The checks mirror the verifiers in bgp_proto.cc and the ones done by
+// BgpProto::Update::Validate. Anything that fails them is handed back to
+// the slow path, which generates the appropriate error.
+//
+BgpInetUpdate *BgpUpdateDecoder::Decode(BgpAttrDB *attr_db,
+                                        const uint8_t *data, size_t size,
+                                        bool ibgp) {
+    if (size < kHeaderSize + 4 || size > (size_t) BgpProto::kMaxMessageSize)
+        return NULL;
+    for (size_t idx = 0; idx < 16; ++idx) {
+        if (data[idx] != 0xff)
+            return NULL;
+    }
+    if (get_short(data + 16) != size || data[18] != BgpProto::UPDATE)
+        return NULL;
+
+    const uint8_t *end = data + size;
+    const uint8_t *cp = data + kHeaderSize;
+
+    auto_ptr<BgpInetUpdate> update(new BgpInetUpdate);
+    size_t withdrawn_len = get_short(cp);
+    cp += 2;
+    if (cp + withdrawn_len + 2 > end)
+        return NULL;
+    if (!DecodePrefixes(cp, withdrawn_len, &update->withdrawn_routes))
+        return NULL;
+    cp += withdrawn_len;
+
+    size_t attr_len = get_short(cp);
+    cp += 2;
+    if (cp + attr_len > end)
+        return NULL;
+    const uint8_t *attr_end = cp + attr_len;
+
+    uint32_t seen = 0;
+    uint8_t origin = BgpAttrOrigin::INCOMPLETE;
+    uint32_t nexthop = 0;
+    uint32_t med = 0;
+    uint32_t local_pref = BgpAttrLocalPref::kDefault;
+    as_t aggregator_as = 0;
+    uint32_t aggregator_address = 0;
+    AsPathSpec as_path;
+    CommunitySpec communities;
+
+    while (cp < attr_end) {
+        if (cp + 3 > attr_end)
+            return NULL;
+        uint8_t flags = cp[0];
+        uint8_t code = cp[1];
+        size_t len;
+        if (flags & BgpAttribute::ExtendedLength) {
+            if (cp + 4 > attr_end)
+                return NULL;
+            len = get_short(cp + 2);
+            cp += 4;
+        } else {
+            len = cp[2];
+            cp += 3;
+        }
+        if (cp + len > attr_end)
+            return NULL;
+
+        // Duplicates and unsupported attributes go to the slow path.
+        uint8_t expected_flags = AttributeFlags(code);
+        if (!expected_flags || (seen & (1 << code)))
+            return NULL;
+        if ((flags & BgpAttribute::FLAG_MASK) != expected_flags)
+            return NULL;
+        seen |= (1 << code);
+
+        switch (code) {
+        case BgpAttribute::Origin:
+            if (len != 1)
+                return NULL;
+            origin = cp[0];
+            if (origin != BgpAttrOrigin::IGP &&
+                origin != BgpAttrOrigin::EGP &&
+                origin != BgpAttrOrigin::INCOMPLETE)
+                return NULL;
+            break;
+        case BgpAttribute::AsPath:
+            if (!DecodeAsPath(cp, len, &as_path))
+                return NULL;
+            break;
+        case BgpAttribute::NextHop:
+            if (len != 4 || (nexthop = get_value(cp, 4)) == 0)
+                return NULL;
+            break;
+        case BgpAttribute::MultiExitDisc:
+            if (len != 4)
+                return NULL;
+            med = get_value(cp, 4);
+            break;
+        case BgpAttribute::LocalPref:
+            if (len != 4)
+                return NULL;
+            local_pref = get_value(cp, 4);
+            break;
+        case BgpAttribute::AtomicAggregate:
+            if (len != 0 || flags != BgpAttrAtomicAggregate::kFlags)
+                return NULL;
+            break;
+        case BgpAttribute::Aggregator:
+            if (len != 6)
+                return NULL;
+            aggregator_as = get_short(cp);
+            aggregator_address = get_value(cp + 2, 4);
+            break;
+        case BgpAttribute::Communities:
+            if (!DecodeCommunities(cp, len, &communities))
+                return NULL;
+            break;
+        }
+        cp += len;
+    }
+
+    if (!DecodePrefixes(cp, end - cp, &update->nlri))
+        return NULL;
+
+    // Only IBGP can have an empty path, for routes originated by the peer.
+    if (!ibgp && (seen & (1 << BgpAttribute::AsPath)) &&
+        (as_path.path_segments.empty() ||
+         as_path.path_segments[0]->path_segment.empty()))
+        return NULL;
+    if (update->nlri.empty())
+        return update.release();
+
+    // Mandatory attributes, see BgpProto::Update::Validate.
+    if (!(seen & (1 << BgpAttribute::NextHop)) ||
+        !(seen & (1 << BgpAttribute::Origin)) ||
+        !(seen & (1 << BgpAttribute::AsPath)))
+        return NULL;
+    if (ibgp && !(seen & (1 << BgpAttribute::LocalPref)))
+        return NULL;
+
+    BgpAttr *attr = new BgpAttr(attr_db);
+    attr->set_origin(static_cast<BgpAttrOrigin::OriginType>(origin));
+    attr->set_nexthop(Ip4Address(nexthop));
+    attr->set_med(med);
+    attr->set_local_pref(local_pref);
+    attr->set_atomic_aggregate(
+        (seen & (1 << BgpAttribute::AtomicAggregate)) != 0);
+    if (seen & (1 << BgpAttribute::Aggregator))
+        attr->set_aggregator(aggregator_as, Ip4Address(aggregator_address));
+    attr->set_as_path(&as_path);
+    if (seen & (1 << BgpAttribute::Communities))
+        attr->set_community(&communities);
+    update->attr = attr_db->Locate(attr);
+    return update.release();
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef ctrlplane_bgp_update_decoder_h
+#define ctrlplane_bgp_update_decoder_h
+
+#include <vector>
+
+#include "bgp/bgp_attr.h"
+#include "bgp/inet/inet_route.h"
+
+struct AsPathSpec;
+struct CommunitySpec;
+
+//
+// Decoded form of an UPDATE that only carries IPv4 unicast routes. The
+// attributes are already interned in the BgpAttrDB. attr is NULL if the
+// message doesn't have any NLRI.
+//
+struct BgpInetUpdate {
+    BgpAttrPtr attr;
+    std::vector<Ip4Prefix> withdrawn_routes;
+    std::vector<Ip4Prefix> nlri;
+};
+
+//
+// BgpUpdateDecoder
+// Fast path decoder for UPDATE messages with IPv4 unicast NLRI and only the
+// well-known path attributes and communities, which is what a full table
+// from an ASBR consists of.
+//
+// The decoder walks the wire buffer in place. Path attributes are stored
+// straight into a BgpAttr that gets located in the BgpAttrDB and prefixes
+// are collected as Ip4Prefix values, without the BgpAttribute and
+// BgpProtoPrefix objects that BgpProto::Decode builds for every element.
+//
+// The decoder doesn't generate errors. Any message that it doesn't fully
+// understand, whether it carries multiprotocol NLRI, other attributes or is
+// malformed, is left to BgpProto::Decode and BgpProto::Update::Validate so
+// that there's a single place that decides on the NOTIFICATION to send.
+//
+class BgpUpdateDecoder {
+public:
+    // Decode the message in data, including the BGP header. Returns NULL if
+    // the message needs to go through BgpProto::Decode.
+    static BgpInetUpdate *Decode(BgpAttrDB *attr_db, const uint8_t *data,
+                                 size_t size, bool ibgp);
+
+private:
+    static bool DecodePrefixes(const uint8_t *data, size_t size,
+                               std::vector<Ip4Prefix> *prefixes);
+    static bool DecodeAsPath(const uint8_t *data, size_t size,
+                             AsPathSpec *spec);
+    static bool DecodeCommunities(const uint8_t *data, size_t size,
+                                  CommunitySpec *spec);
+};
+
+#endif  // ctrlplane_bgp_update_decoder_h
@@ -230,7 +230,8 @@ public:
     XmppPeer(BgpServer *server, BgpXmppChannel *channel)
         : server_(server),
           parent_(channel),
-          is_deleted_(false) {
+          is_deleted_(false),
+          send_ready_(true) {
         refcount_ = 0;
     }
 
@@ -239,6 +240,7 @@ public:
     }
 
     virtual bool SendUpdate(const uint8_t *msg, size_t msgsize);
+    virtual bool FlushUpdate();
     virtual std::string ToString() const {
         return parent_->ToString();
     }
@@ -295,6 +297,13 @@ public:
     virtual tbb::atomic<int> GetRefCount() const { return refcount_; }
 
 private:
+    void SendNotReady() {
+        XmppPeerInfoData peer_info;
+        peer_info.set_name(ToUVEKey());
+        peer_info.set_send_state("not in sync");
+        XMPPPeerInfo::Send(peer_info);
+    }
+
     void WriteReadyCb(const boost::system::error_code &ec) {
         if (!server_) return;
         SchedulingGroupManager *sg_mgr = server_->scheduling_group_manager();
@@ -332,13 +341,12 @@ bool BgpXmppChannel::XmppPeer::SendUpdate(const uint8_t *msg, size_t msgsize) {
     if (channel->GetPeerState() == xmps::READY) {
         parent_->stats_[1].rt_updates ++;
         if (SkipUpdateSend()) return true;
+        // Updates are written out together from FlushUpdate
+        channel->Cork();
         send_ready_ = channel->Send(msg, msgsize, xmps::BGP,
                 boost::bind(&BgpXmppChannel::XmppPeer::WriteReadyCb, this, _1));
         if (!send_ready_) {
-            XmppPeerInfoData peer_info;
-            peer_info.set_name(ToUVEKey());
-            peer_info.set_send_state("not in sync");
-            XMPPPeerInfo::Send(peer_info);
+            SendNotReady();
         }
         return send_ready_;
     } else {
@@ -346,6 +354,18 @@ bool BgpXmppChannel::XmppPeer::SendUpdate(const uint8_t *msg, size_t msgsize) {
     }
 }
 
+bool BgpXmppChannel::XmppPeer::FlushUpdate() {
+    XmppChannel *channel = parent_->channel_;
+    if (!channel->Uncork(xmps::BGP,
+            boost::bind(&BgpXmppChannel::XmppPeer::WriteReadyCb, this, _1))) {
+        if (send_ready_) {
+            SendNotReady();
+        }
+        send_ready_ = false;
+    }
+    return send_ready_;
+}
+
 void BgpXmppChannel::XmppPeer::Close() {
     SetDeleted(true);
     if (server_ == NULL) {
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef ctrlplane_inet_prefix_index_h
+#define ctrlplane_inet_prefix_index_h
+
+#include <boost/cstdint.hpp>
+
+#include "base/patricia.h"
+#include "base/util.h"
+#include "bgp/inet/inet_route.h"
+
+//
+// Longest prefix match index of Ip4Prefix to a value of type T.
+//
+// Prefixes are kept in a Patricia tree so that the covering prefix of a route
+// is found in O(prefix length) instead of walking every configured prefix.
+// Host bits beyond the prefix length are ignored.
+//
+template <typename T>
+class Ip4PrefixIndex {
+public:
+    Ip4PrefixIndex() {
+    }
+
+    ~Ip4PrefixIndex() {
+        clear();
+    }
+
+    // Returns false if the prefix is already present
+    bool Insert(const Ip4Prefix &prefix, const T &value) {
+        ValueEntry *entry = new ValueEntry(prefix, value);
+        if (!tree_.Insert(entry)) {
+            delete entry;
+            return false;
+        }
+        return true;
+    }
+
+    bool Remove(const Ip4Prefix &prefix) {
+        Entry key(prefix);
+        Entry *entry = tree_.Find(&key);
+        if (!entry)
+            return false;
+        tree_.Remove(entry);
+        delete static_cast<ValueEntry *>(entry);
+        return true;
+    }
+
+    // Exact match
+    T *Find(const Ip4Prefix &prefix) {
+        Entry key(prefix);
+        return Value(tree_.Find(&key), NULL);
+    }
+
+    // Longest prefix in the index covering the given prefix, including the
+    // prefix itself
+    T *LongestMatch(const Ip4Prefix &prefix, Ip4Prefix *match = NULL) {
+        Entry key(prefix);
+        return Value(tree_.LPMFind(&key), match);
+    }
+
+    // Longest prefix in the index that is strictly less specific than the
+    // given prefix
+    T *LongestLessSpecificMatch(const Ip4Prefix &prefix,
+                                Ip4Prefix *match = NULL) {
+        if (prefix.prefixlen() == 0)
+            return NULL;
+        Entry key(Ip4Prefix(prefix.ip4_addr(), prefix.prefixlen() - 1));
+        return Value(tree_.LPMFind(&key), match);
+    }
+
+    std::size_t size() {
+        return tree_.Size();
+    }
+
+    bool empty() {
+        return tree_.Size() == 0;
+    }
+
+    void clear() {
+        Entry *entry;
+        while ((entry = tree_.GetNext(NULL)) != NULL) {
+            tree_.Remove(entry);
+            delete static_cast<ValueEntry *>(entry);
+        }
+    }
+
+private:
+    struct Entry {
+        explicit Entry(const Ip4Prefix &prefix)
+            : prefixlen_(prefix.prefixlen()),
+              addr_(prefix.ip4_addr().to_ulong() & Mask(prefixlen_)) {
+        }
+
+        static uint32_t Mask(int prefixlen) {
+            return prefixlen ? (0xFFFFFFFFu << (32 - prefixlen)) : 0;
+        }
+
+        Ip4Prefix prefix() const {
+            return Ip4Prefix(Ip4Address(addr_), prefixlen_);
+        }
+
+        int prefixlen_;
+        uint32_t addr_;
+        Patricia::Node node_;
+    };
+
+    struct ValueEntry : public Entry {
+        ValueEntry(const Ip4Prefix &prefix, const T &value)
+            : Entry(prefix), value_(value) {
+        }
+        T value_;
+    };
+
+    struct EntryKey {
+        static std::size_t Length(Entry *entry) {
+            return entry->prefixlen_;
+        }
+
+        static char ByteValue(Entry *entry, std::size_t i) {
+            return (entry->addr_ >> (24 - 8 * i)) & 0xFF;
+        }
+    };
+
+    typedef Patricia::Tree<Entry, &Entry::node_, EntryKey> Tree;
+
+    T *Value(Entry *entry, Ip4Prefix *match) {
+        if (!entry)
+            return NULL;
+        if (match)
+            *match = entry->prefix();
+        return &static_cast<ValueEntry *>(entry)->value_;
+    }
+
+    Tree tree_;
+
+    DISALLOW_COPY_AND_ASSIGN(Ip4PrefixIndex);
+};
+
+#endif
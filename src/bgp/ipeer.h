@@ -20,6 +20,11 @@ public:
     // Send an update. Returns true if the peer can send additional messages,
     // false if it is send blocked.
     virtual bool SendUpdate(const uint8_t *msg, size_t msgsize) = 0;
+
+    // Write out updates that SendUpdate may have held back to batch them.
+    // Called at the end of each batch of updates. Returns false if the peer
+    // is send blocked.
+    virtual bool FlushUpdate() { return true; }
 };
 
 class IPeerDebugStats {
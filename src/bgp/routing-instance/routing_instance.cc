@@ -11,6 +11,7 @@
 #include "bgp/bgp_config.h"
 #include "bgp/bgp_factory.h"
 #include "bgp/bgp_log.h"
+#include "bgp/bgp_routing_policy.h"
 #include "bgp/bgp_server.h"
 #include "bgp/routing-instance/peer_manager.h"
 #include "bgp/routing-instance/routepath_replicator.h"
@@ -525,6 +526,8 @@ void RoutingInstance::ProcessConfig(BgpServer *server) {
         }
     }
 
+    ProcessRoutingPolicyConfig();
+
     if (config_->instance_config() == NULL) {
         return;
     }
@@ -540,6 +543,56 @@ void RoutingInstance::ProcessConfig(BgpServer *server) {
         static_route_mgr()->ProcessStaticRouteConfig();
 }
 
+//
+// Compile the policy config into a RoutingPolicy. An empty config or one
+// that fails to compile results in no policy.
+//
+RoutingPolicyPtr RoutingInstance::CompileRoutingPolicy(
+        const PolicyConfig &config) {
+    if (config.name.empty())
+        return RoutingPolicyPtr();
+
+    string error;
+    RoutingPolicyPtr policy(RoutingPolicy::Compile(config, &error));
+    if (!policy) {
+        BGP_LOG_STR(BgpMessage, SandeshLevel::SYS_WARN, BGP_LOG_FLAG_SYSLOG,
+                    "Invalid routing-policy " << config.name <<
+                    " for instance " << name_ << ": " << error);
+    }
+    return policy;
+}
+
+//
+// Update the import and export policies of all tables of the instance with
+// the routing-policies from the BgpInstanceConfig. A policy is compiled again
+// only when its config has changed, so that tables keep sharing the same
+// compiled policy and its counters.
+//
+void RoutingInstance::ProcessRoutingPolicyConfig() {
+    bool import_changed = (config_->import_policy() != import_policy_config_);
+    bool export_changed = (config_->export_policy() != export_policy_config_);
+    if (!import_changed && !export_changed)
+        return;
+
+    if (import_changed) {
+        import_policy_config_ = config_->import_policy();
+        import_policy_ = CompileRoutingPolicy(import_policy_config_);
+    }
+    if (export_changed) {
+        export_policy_config_ = config_->export_policy();
+        export_policy_ = CompileRoutingPolicy(export_policy_config_);
+    }
+
+    for (RouteTableList::iterator it = vrf_table_.begin();
+         it != vrf_table_.end(); ++it) {
+        BgpTable *table = it->second;
+        if (import_changed)
+            table->set_import_policy(import_policy_);
+        if (export_changed)
+            table->set_export_policy(export_policy_);
+    }
+}
+
 void RoutingInstance::UpdateConfig(BgpServer *server,
         const BgpInstanceConfig *cfg) {
     CHECK_CONCURRENCY("bgp::Config");
@@ -552,6 +605,8 @@ void RoutingInstance::UpdateConfig(BgpServer *server,
     virtual_network_ = cfg->virtual_network();
     virtual_network_index_ = cfg->virtual_network_index();
 
+    ProcessRoutingPolicyConfig();
+
     // Master routing instance doesn't have import & export list
     // Master instance imports and exports all RT
     if (IsDefaultRoutingInstance())
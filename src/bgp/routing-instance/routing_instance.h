@@ -15,6 +15,7 @@
 #include <boost/intrusive_ptr.hpp>
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "base/bitset.h"
 #include "base/index_map.h"
@@ -25,6 +26,7 @@
 #include "bgp/ipeer.h"
 #include "bgp/inet/inet_route.h"
 #include "net/address.h"
+#include "routing-policy/policy_config.h"
 #include "sandesh/sandesh_trace.h"
 #include "schema/bgp_schema_types.h"
 
@@ -36,6 +38,7 @@ class BgpTable;
 class RouteDistinguisher;
 class RoutingInstanceMgr;
 class RoutingInstanceInfo;
+class RoutingPolicy;
 class BgpNeighborResp;
 class LifetimeActor;
 class PeerManager;
@@ -121,6 +124,10 @@ private:
     BgpTable *InetVpnTableCreate(BgpServer *server);
     BgpTable *EvpnTableCreate(BgpServer *server);
 
+    void ProcessRoutingPolicyConfig();
+    boost::shared_ptr<RoutingPolicy> CompileRoutingPolicy(
+        const PolicyConfig &config);
+
     std::string name_;
     int index_;
     std::auto_ptr<RouteDistinguisher> rd_;
@@ -132,6 +139,10 @@ private:
     bool is_default_;
     std::string virtual_network_;
     int virtual_network_index_;
+    PolicyConfig import_policy_config_;
+    PolicyConfig export_policy_config_;
+    boost::shared_ptr<RoutingPolicy> import_policy_;
+    boost::shared_ptr<RoutingPolicy> export_policy_;
     boost::scoped_ptr<DeleteActor> deleter_;
     LifetimeRef<RoutingInstance> manager_delete_ref_;
     boost::scoped_ptr<StaticRouteMgr> static_route_mgr_;
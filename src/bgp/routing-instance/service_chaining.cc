@@ -42,7 +42,10 @@ ServiceChain::ServiceChain(RoutingInstance *src, RoutingInstance *dest,
         error_code ec;
         Ip4Prefix ipam_subnet = Ip4Prefix::FromString(*it, &ec);
         assert(ec == 0);
-        prefix_to_routelist_map_[ipam_subnet] = RouteList();
+        std::pair<PrefixToRouteListMap::iterator, bool> result =
+            prefix_to_routelist_map_.insert(
+                std::make_pair(ipam_subnet, RouteList()));
+        prefix_index_.Insert(ipam_subnet, result.first);
     }
 }
 
@@ -184,32 +187,30 @@ bool ServiceChain::Match(BgpServer *server, BgpTable *table,
     return true;
 }
 
+// Only the connected route is of interest in the connected table. Any route
+// in the dest table can be a more specific or an external connecting route.
+void ServiceChain::GetMatchFilter(BgpTable *table,
+                                  ConditionMatchFilter *filter) const {
+    if (table == dest_table() || !service_chain_addr().is_v4())
+        return;
+    filter->AddAddress(service_chain_addr().to_v4());
+}
+
+// Find the longest subnet prefix that the route is more specific of
 bool ServiceChain::is_more_specific(BgpRoute *route, 
                                     Ip4Prefix *aggregate_match) {
-    unsigned long broadcast = 0xFFFFFFFF;
     InetRoute *inet_route = dynamic_cast<InetRoute *>(route);
-    Ip4Address address = inet_route->GetPrefix().ip4_addr();
-    for(PrefixToRouteListMap::iterator it = prefix_to_route_list_map()->begin();
-        it != prefix_to_route_list_map()->end(); it++) {
-        unsigned long shift_mask = (32 - it->first.prefixlen());
-        if ((it->first.prefixlen() != inet_route->GetPrefix().prefixlen()) &&
-            ((address.to_ulong() & (broadcast << shift_mask)) == 
-             (it->first.ip4_addr().to_ulong() & (broadcast << shift_mask)))) {
-            *aggregate_match = it->first;
-            return true;
-        }
-    }
-    return false;
+    PrefixToRouteListMap::iterator *it =
+        prefix_index_.LongestLessSpecificMatch(inet_route->GetPrefix());
+    if (!it)
+        return false;
+    *aggregate_match = (*it)->first;
+    return true;
 }
 
 bool ServiceChain::is_aggregate(BgpRoute *route) {
     InetRoute *inet_route = dynamic_cast<InetRoute *>(route);
-    for (PrefixToRouteListMap::iterator it = prefix_to_route_list_map()->begin();
-        it != prefix_to_route_list_map()->end(); it++) {
-        if (it->first == inet_route->GetPrefix())
-            return true;
-    }
-    return false;
+    return (prefix_index_.Find(inet_route->GetPrefix()) != NULL);
 }
 
 // RemoveServiceChainRoute
@@ -19,6 +19,7 @@
 
 #include "bgp/bgp_condition_listener.h"
 #include "bgp/bgp_config.h"
+#include "bgp/inet/inet_prefix_index.h"
 #include "bgp/inet/inet_route.h"
 
 #include "bgp/routing-instance/service_chaining_types.h"
@@ -151,6 +152,9 @@ public:
     virtual bool Match(BgpServer *server, BgpTable *table, 
                        BgpRoute *route, bool deleted);
 
+    virtual void GetMatchFilter(BgpTable *table,
+                                ConditionMatchFilter *filter) const;
+
     void FillServiceChainInfo(ShowServicechainInfo &info) const; 
 
     void connected_table_unregistered() {
@@ -209,6 +213,8 @@ private:
     BgpRoute *connected_route_;
     IpAddress service_chain_addr_;
     PrefixToRouteListMap prefix_to_routelist_map_;
+    // LPM index of the subnet prefixes in prefix_to_routelist_map_
+    Ip4PrefixIndex<PrefixToRouteListMap::iterator> prefix_index_;
     // List of routes from Destination VN for external connectivity
     ExtConnectRouteList ext_connect_routes_;
     bool connected_table_unregistered_;
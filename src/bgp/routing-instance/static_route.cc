@@ -163,6 +163,12 @@ public:
     virtual bool Match(BgpServer *server, BgpTable *table, 
                        BgpRoute *route, bool deleted);
 
+    virtual void GetMatchFilter(BgpTable *table,
+                                ConditionMatchFilter *filter) const {
+        if (nexthop_.is_v4())
+            filter->AddAddress(nexthop_.to_v4());
+    }
+
     void set_unregistered() {
         unregistered_ = true;
     }
@@ -435,6 +435,7 @@ public:
                 break;
             }
             }
+            group_->FlushUpdates();
         }
 
         return true;
@@ -850,6 +851,9 @@ void SchedulingGroup::WorkEnqueue(WorkBase *wentry) {
 // sync. Note that we need to use bit indices that are specific to the RibOut,
 // not the ones from the SchedulingGroup.
 //
+// The in sync IPeers may get updates from the tail dequeue, so they are also
+// marked to be flushed at the end of the work item.
+//
 void SchedulingGroup::BuildSyncUnsyncBitSet(const RibOut *ribout, RibState *rs,
         RibPeerSet *msync, RibPeerSet *munsync) {
     CHECK_CONCURRENCY("bgp::SendTask");
@@ -860,6 +864,7 @@ void SchedulingGroup::BuildSyncUnsyncBitSet(const RibOut *ribout, RibState *rs,
         int rix = ribout->GetPeerIndex(ps->peer());
         if (ps->in_sync()) {
             msync->set(rix);
+            flush_set_.set(ps->index());
         } else {
             munsync->set(rix);
         }
@@ -871,6 +876,9 @@ void SchedulingGroup::BuildSyncUnsyncBitSet(const RibOut *ribout, RibState *rs,
 // that we need to use bit indices that are specific to the RibOut, not the
 // ones from the SchedulingGroup.
 //
+// The send ready IPeers may get updates from the peer dequeue, so they are
+// also marked to be flushed at the end of the work item.
+//
 void SchedulingGroup::BuildSendReadyBitSet(RibOut *ribout, RibPeerSet *mready) {
     CHECK_CONCURRENCY("bgp::SendTask");
 
@@ -882,6 +890,7 @@ void SchedulingGroup::BuildSendReadyBitSet(RibOut *ribout, RibPeerSet *mready) {
         if (ps->send_ready()) {
             int rix = ribout->GetPeerIndex(ps->peer());
             mready->set(rix);
+            flush_set_.set(ps->index());
         }
     }
 }
@@ -1035,6 +1044,25 @@ bool SchedulingGroup::UpdatePeerQueue(IPeerUpdate *peer, PeerState *ps,
     return true;
 }
 
+//
+// Write out the updates held back by the peers while processing a work item.
+// Only the peers marked in flush_set_ by the work item may have updates held
+// back. A peer that gets blocked here stays send ready in the group until its
+// next SendUpdate returns false.
+//
+void SchedulingGroup::FlushUpdates() {
+    CHECK_CONCURRENCY("bgp::SendTask");
+
+    for (size_t i = flush_set_.find_first(); i != BitSet::npos;
+         i = flush_set_.find_next(i)) {
+        if (i >= peer_state_imap_.size()) break;
+        PeerState *ps = peer_state_imap_.At(i);
+        if (ps == NULL) continue;
+        ps->peer()->FlushUpdate();
+    }
+    flush_set_.clear();
+}
+
 //
 // Drain the queue of all updates for this IPeerUpdate, until it is up-to date
 // or it becomes blocked.
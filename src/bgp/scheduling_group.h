@@ -127,6 +127,7 @@ private:
 
     void UpdateRibOut(RibOut *ribout, int queue_id);
     void UpdatePeer(IPeerUpdate *peer);
+    void FlushUpdates();
 
     // Notification that a peer is send ready.
     void SendReady(IPeerUpdate *peer);
@@ -156,6 +157,9 @@ private:
 
     PeerStateMap peer_state_imap_;
     RibStateMap rib_state_imap_;
+    // Peers that may have updates held back by the current work item,
+    // by PeerState index.
+    GroupPeerSet flush_set_;
     
     static int send_task_id_;
 
@@ -23,6 +23,7 @@
 #include "bgp/bgp_server.h"
 #include "bgp/bgp_session.h"
 #include "bgp/bgp_session_manager.h"
+#include "bgp/bgp_update_decoder.h"
 
 using boost::system::error_code;
 using namespace std;
@@ -286,12 +287,16 @@ struct EvBgpUpdate : sc::event<EvBgpUpdate> {
     EvBgpUpdate(BgpSession *session, const BgpProto::Update *msg)
         : session(session), msg(msg) {
     }
+    EvBgpUpdate(BgpSession *session, const BgpInetUpdate *inet_update)
+        : session(session), inet_update(inet_update) {
+    }
     static const char *Name() {
         return "EvBgpUpdate";
     }
 
     BgpSession *session;
     boost::shared_ptr<const BgpProto::Update> msg;
+    boost::shared_ptr<const BgpInetUpdate> inet_update;
 };
 
 struct EvBgpUpdateError : sc::event<EvBgpUpdateError> {
@@ -1011,7 +1016,11 @@ struct Established : sc::state<Established, StateMachine> {
     sc::result react(const EvBgpUpdate &event) {
         StateMachine *state_machine = &context<StateMachine>();
         state_machine->StartHoldTimer();
-        state_machine->peer()->ProcessUpdate(event.msg.get());
+        if (event.msg) {
+            state_machine->peer()->ProcessUpdate(event.msg.get());
+        } else {
+            state_machine->peer()->ProcessUpdate(event.inet_update.get());
+        }
         return discard_event();
     }
 };
@@ -1443,6 +1452,16 @@ void StateMachine::OnMessage(BgpSession *session, BgpProto::BgpMessage *msg) {
     delete msg;
 }
 
+//
+// Handle an incoming UPDATE that was decoded by the fast path decoder. It
+// has already gone through all the checks in BgpProto::Update::Validate.
+//
+void StateMachine::OnInetUpdate(BgpSession *session, BgpInetUpdate *update) {
+    BgpPeer *peer = session ? session->Peer() : NULL;
+    if (peer) peer->inc_rx_update();
+    Enqueue(fsm::EvBgpUpdate(session, update));
+}
+
 //
 // Handle errors in incoming message on the session.
 //
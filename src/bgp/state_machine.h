@@ -19,6 +19,7 @@ class BgpSession;
 class BgpPeerInfo;
 class BgpMessage;
 class StateMachine;
+struct BgpInetUpdate;
 
 namespace fsm {
 struct Idle;
@@ -126,6 +127,7 @@ public:
     bool PassiveOpen(BgpSession *session);
 
     void OnMessage(BgpSession *session, BgpProto::BgpMessage *msg);
+    void OnInetUpdate(BgpSession *session, BgpInetUpdate *update);
     void OnMessageError(BgpSession *session, const ParseErrorContext *context);
 
     void SendNotificationAndClose(BgpSession *session,
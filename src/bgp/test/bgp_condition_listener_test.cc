@@ -11,6 +11,7 @@
 #include "base/test/task_test_util.h"
 #include "bgp/bgp_config.h"
 #include "bgp/bgp_log.h"
+#include "bgp/bgp_peer_types.h"
 #include "bgp/inet/inet_table.h"
 #include "bgp/routing-instance/routing_instance.h"
 #include "bgp/test/bgp_test_util.h"
@@ -52,8 +53,15 @@ private:
 class TestConditionMatch : public ConditionMatch {
 public:
     typedef std::map<Ip4Prefix, BgpRoute *> MatchList;
-    TestConditionMatch(Ip4Prefix &prefix, bool hold_db_state) 
-        : prefix_(prefix), hold_db_state_(hold_db_state) {
+    TestConditionMatch(Ip4Prefix &prefix, bool hold_db_state,
+                       bool use_filter = false)
+        : prefix_(prefix), hold_db_state_(hold_db_state),
+          use_filter_(use_filter) {
+    }
+
+    void GetMatchFilter(BgpTable *table, ConditionMatchFilter *filter) const {
+        if (use_filter_)
+            filter->AddPrefix(prefix_);
     }
 
     bool Match(BgpServer *server, BgpTable *table, 
@@ -125,6 +133,7 @@ private:
     MatchList match_list_;
     Ip4Prefix prefix_;
     bool hold_db_state_;
+    bool use_filter_;
 };
 
 class BgpConditionListenerTest : public ::testing::Test {
@@ -265,11 +274,13 @@ protected:
     }
 
     void AddMatchCondition(string name, std::string match, 
-                           bool hold_db_state = false) {
+                           bool hold_db_state = false,
+                           bool use_filter = false) {
         ConcurrencyScope scope("bgp::Config");
         BgpConditionListener *listener = bgp_server_->condition_listener();
         Ip4Prefix prefix = Ip4Prefix::FromString(match);
-        match_.reset(new TestConditionMatch(prefix, hold_db_state));
+        match_.reset(new TestConditionMatch(prefix, hold_db_state,
+                                            use_filter));
         RoutingInstance *rti =
             bgp_server_->routing_instance_mgr()->GetRoutingInstance(name);
         BgpTable *table = rti->GetTable(Address::INET);
@@ -530,6 +541,49 @@ TEST_F(BgpConditionListenerTest, ChangeNotify) {
     task_util::WaitForIdle();
 }
 
+//
+// Match object with a prefix filter only sees the routes covered by the
+// prefix, while the match condition itself would accept any host route
+//
+TEST_F(BgpConditionListenerTest, FilteredMatch) {
+    AddRoutingInstance("blue");
+    task_util::WaitForIdle();
+
+    AddInetRoute("blue", "192.168.1.2/32");
+    AddInetRoute("blue", "10.1.1.1/32");
+
+    AddMatchCondition("blue", "192.168.1.0/24", false, true);
+    task_util::WaitForIdle();
+    AddInetRoute("blue", "192.168.1.3/32");
+    AddInetRoute("blue", "192.168.2.1/32");
+
+    TestConditionMatch *match = 
+        static_cast<TestConditionMatch *>(match_.get());
+    TASK_UTIL_EXPECT_EQ(2, match->matched_routes_size());
+    TASK_UTIL_EXPECT_TRUE(match->lookup_matched_routes(
+        Ip4Prefix::FromString("192.168.1.2/32")) != NULL);
+    TASK_UTIL_EXPECT_TRUE(match->lookup_matched_routes(
+        Ip4Prefix::FromString("192.168.1.3/32")) != NULL);
+
+    vector<ShowConditionListenerTable> table_list;
+    bgp_server_->condition_listener()->FillShowInfo(&table_list);
+    TASK_UTIL_EXPECT_EQ(1U, table_list.size());
+    TASK_UTIL_EXPECT_EQ("blue.inet.0", table_list[0].get_name());
+    TASK_UTIL_EXPECT_EQ(1U, table_list[0].get_match_objects());
+    TASK_UTIL_EXPECT_EQ(1U, table_list[0].get_filtered_match_objects());
+    TASK_UTIL_EXPECT_EQ(table_list[0].get_matches(),
+                        table_list[0].get_match_calls());
+
+    RemoveMatchCondition("blue");
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_TRUE(match->matched_routes_empty());
+
+    DeleteInetRoute("blue", "192.168.1.2/32");
+    DeleteInetRoute("blue", "192.168.1.3/32");
+    DeleteInetRoute("blue", "10.1.1.1/32");
+    DeleteInetRoute("blue", "192.168.2.1/32");
+}
+
 class TestEnvironment : public ::testing::Environment {
     virtual ~TestEnvironment() { }
 };
@@ -1488,6 +1488,49 @@ TEST_F(BgpConfigListenerTest, VirtualNetworkUninterestingLinkChange) {
     TASK_UTIL_EXPECT_EQ(0, GetChangeListCount());
 }
 
+//
+// Node event for a routing-policy object linked to a routing-instance.
+//
+TEST_F(BgpConfigListenerTest, RoutingPolicyChange) {
+
+    // Initialize config with 3 routing-instances - red, blue and green.
+    // Add a routing-policy p1 and link it to routing-instance red.
+    //
+    // Note that routing-instance-routing-policy is a link with attributes so
+    // a middle node called routing-instance-routing-policy will get created.
+    string content = ReadFile("src/bgp/testdata/config_listener_test_4.xml");
+    EXPECT_TRUE(parser_.Parse(content));
+    ifmap_test_util::IFMapMsgNodeAdd(&db_, "routing-policy", "p1");
+    ifmap_test_util::IFMapMsgLink(&db_, "routing-instance", "red",
+        "routing-policy", "p1", "routing-instance-routing-policy");
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(0, GetChangeListCount());
+
+    // Pause propagation, notify routing-policy p1.
+    PauseChangeListPropagation();
+    ifmap_test_util::IFMapNodeNotify(&db_, "routing-policy", "p1");
+    task_util::WaitForIdle();
+
+    // The routing-policy should be on the change list and on the node list
+    // since there's an entry for self in the reaction map.
+    TASK_UTIL_EXPECT_EQ(1, GetChangeListCount());
+    TASK_UTIL_EXPECT_EQ(1, GetNodeListCount());
+    TASK_UTIL_EXPECT_EQ(0, GetEdgeListCount());
+
+    // Perform propagation and verify change list.
+    // The red routing-instance gets added to the change list because the
+    // propagate list for self in routing-policy has the link, which the
+    // middle node passes on, and the propagate list for the link in the
+    // routing-instance contains self. The middle node itself isn't added.
+    PerformChangeListPropagation();
+    TASK_UTIL_EXPECT_EQ(2, GetChangeListCount());
+    TASK_UTIL_EXPECT_EQ(1, GetChangeListCount("routing-policy"));
+    TASK_UTIL_EXPECT_EQ(1, GetChangeListCount("routing-instance"));
+
+    ResumeChangeListPropagation();
+    TASK_UTIL_EXPECT_EQ(0, GetChangeListCount());
+}
+
 int main(int argc, char **argv) {
     bgp_log_test::init();
     ControlNode::SetDefaultSchedulingPolicy();
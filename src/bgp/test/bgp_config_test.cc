@@ -14,6 +14,7 @@
 #include "bgp/bgp_config.h"
 #include "bgp/bgp_config_parser.h"
 #include "bgp/bgp_log.h"
+#include "bgp/bgp_routing_policy.h"
 #include "bgp/inet/inet_table.h"
 #include "bgp/test/bgp_test_util.h"
 #include "bgp/routing-instance/peer_manager.h"
@@ -1322,6 +1323,53 @@ TEST_F(BgpConfigTest, AddressFamilies3) {
     TASK_UTIL_EXPECT_EQ(0, db_graph_.vertex_count());
 }
 
+//
+// Routing policies linked to a routing-instance get applied to all of its
+// tables and follow changes to the routing-policy.
+//
+TEST_F(BgpConfigTest, RoutingPolicy) {
+    string content_a = FileRead("src/bgp/testdata/config_test_20a.xml");
+    string content_b = FileRead("src/bgp/testdata/config_test_20b.xml");
+    EXPECT_TRUE(parser_.Parse(content_a));
+    task_util::WaitForIdle();
+
+    RoutingInstanceMgr *mgr = server_.routing_instance_mgr();
+    TASK_UTIL_EXPECT_EQ(2, mgr->count());
+    RoutingInstance *red = mgr->GetRoutingInstance("red");
+    TASK_UTIL_ASSERT_TRUE(red != NULL);
+
+    BgpTable *inet_table = red->GetTable(Address::INET);
+    BgpTable *enet_table = red->GetTable(Address::ENET);
+    TASK_UTIL_ASSERT_TRUE(inet_table != NULL);
+    TASK_UTIL_ASSERT_TRUE(enet_table != NULL);
+    TASK_UTIL_ASSERT_TRUE(inet_table->import_policy() != NULL);
+    TASK_UTIL_ASSERT_TRUE(inet_table->export_policy() != NULL);
+    TASK_UTIL_EXPECT_EQ("p1", inet_table->import_policy()->name());
+    TASK_UTIL_EXPECT_EQ(2, inet_table->import_policy()->term_count());
+    TASK_UTIL_EXPECT_EQ("p2", inet_table->export_policy()->name());
+    TASK_UTIL_EXPECT_EQ(1, inet_table->export_policy()->term_count());
+    TASK_UTIL_EXPECT_TRUE(
+        enet_table->import_policy() == inet_table->import_policy());
+    TASK_UTIL_EXPECT_TRUE(
+        enet_table->export_policy() == inet_table->export_policy());
+
+    // Update p1. Only the import policy should get compiled again.
+    RoutingPolicy *export_policy = inet_table->export_policy();
+    EXPECT_TRUE(parser_.Parse(content_b));
+    task_util::WaitForIdle();
+    TASK_UTIL_ASSERT_TRUE(inet_table->import_policy() != NULL);
+    TASK_UTIL_EXPECT_EQ(1, inet_table->import_policy()->term_count());
+    TASK_UTIL_EXPECT_TRUE(inet_table->export_policy() == export_policy);
+
+    boost::replace_all(content_a, "<config>", "<delete>");
+    boost::replace_all(content_a, "</config>", "</delete>");
+    EXPECT_TRUE(parser_.Parse(content_a));
+    task_util::WaitForIdle();
+
+    TASK_UTIL_EXPECT_EQ(1, mgr->count());
+    TASK_UTIL_EXPECT_EQ(0, db_graph_.vertex_count());
+}
+
 class IFMapConfigTest : public ::testing::Test {
   protected:
     IFMapConfigTest()
@@ -341,6 +341,24 @@ protected:
         return total;
     }
 
+    uint64_t GetForwarderUpdateCount(McastTreeManager *tm,
+            string group_str) {
+        boost::system::error_code ec;
+        Ip4Address group = Ip4Address::from_string(group_str.c_str(), ec);
+        Ip4Address source = Ip4Address::from_string("0.0.0.0", ec);
+
+        uint64_t total = 0;
+        for (McastTreeManager::PartitionList::iterator it =
+                tm->partitions_.begin();
+                it != tm->partitions_.end(); ++it) {
+            McastSGEntry *sg_entry = (*it)->FindSGEntry(group, source);
+            if (sg_entry)
+                total += sg_entry->forwarder_update_count();
+        }
+
+        return total;
+    }
+
     EventManager evm_;
     BgpServer server_;
     InetMcastTable *red_table_;
@@ -685,6 +703,53 @@ TEST_F(BgpMulticastTest, TreeUpdateCompression) {
     TASK_UTIL_EXPECT_EQ(2, VerifyTreeUpdateCount(red_tm_));
 }
 
+//
+// Each join or leave should only update the McastForwarders whose links in
+// the distribution tree changed, independent of the size of the tree.
+//
+TEST_F(BgpMulticastTest, IncrementalTreeUpdate) {
+    static const int kScalePeerCount = 200;
+    const int max_leave_updates = (int) McastTreeManager::kDegree + 3;
+
+    std::vector<XmppPeerMock *> scale_peers;
+    for (int idx = 0; idx < kScalePeerCount; idx++) {
+        std::ostringstream repr;
+        repr << "10.1." << (2 + idx / 250) << "." << (idx % 250 + 1);
+        scale_peers.push_back(new XmppPeerMock(&server_, repr.str()));
+    }
+
+    uint64_t prev_count = 0;
+    for (int idx = 0; idx < kScalePeerCount; idx++) {
+        scale_peers[idx]->AddRoute(red_table_, "192.168.1.255");
+        task_util::WaitForIdle();
+        uint64_t count = GetForwarderUpdateCount(red_tm_, "192.168.1.255");
+        EXPECT_LE(count - prev_count, 2U);
+        prev_count = count;
+    }
+    VerifyForwarderCount(red_tm_, "192.168.1.255", kScalePeerCount);
+    BGP_DEBUG_UT("Forwarder updates for " << kScalePeerCount <<
+                 " joins: " << prev_count);
+
+    uint64_t join_count = prev_count;
+    for (int idx = 0; idx < kScalePeerCount - 1; idx++) {
+        scale_peers[(idx * 7) % kScalePeerCount]->DelRoute(
+            red_table_, "192.168.1.255");
+        task_util::WaitForIdle();
+        uint64_t count = GetForwarderUpdateCount(red_tm_, "192.168.1.255");
+        EXPECT_LE(count - prev_count, (uint64_t) max_leave_updates);
+        prev_count = count;
+    }
+    VerifyForwarderCount(red_tm_, "192.168.1.255", 1);
+    BGP_DEBUG_UT("Forwarder updates for " << kScalePeerCount - 1 <<
+                 " leaves: " << prev_count - join_count);
+
+    scale_peers[((kScalePeerCount - 1) * 7) % kScalePeerCount]->DelRoute(
+        red_table_, "192.168.1.255");
+    task_util::WaitForIdle();
+    VerifySGCount(red_tm_, 0);
+    STLDeleteValues(&scale_peers);
+}
+
 int main(int argc, char **argv) {
     bgp_log_test::init();
     ::testing::InitGoogleTest(&argc, argv);
@@ -4,12 +4,18 @@
 
 #include "base/logging.h"
 #include "base/proto.h"
+#include "base/task.h"
+#include "base/test/task_test_util.h"
 #include "control-node/control_node.h"
 #include "testing/gunit.h"
 #include <boost/assign/list_of.hpp>
+#include <boost/scoped_ptr.hpp>
 #include "net/bgp_af.h"
 #include "bgp/bgp_log.h"
 #include "bgp/bgp_proto.h"
+#include "bgp/bgp_server.h"
+#include "bgp/bgp_update_decoder.h"
+#include "io/event_manager.h"
 #include "bgp_message_test.h"
 
 using namespace std;
@@ -661,6 +667,251 @@ TEST_F(BgpProtoTest, RandomError) {
         GenerateByteError(data, res);
     }
 }
+
+class BgpUpdateDecoderTest : public testing::Test {
+protected:
+    BgpUpdateDecoderTest()
+        : server_(&evm_), attr_db_(server_.attr_db()) {
+    }
+
+    void TearDown() {
+        server_.Shutdown();
+        task_util::WaitForIdle();
+    }
+
+    // Build an IPv4 unicast update with /24 NLRI and /16 withdrawn routes.
+    static void BuildInetUpdate(BgpProto::Update *update, int nlri_count,
+                                int withdrawn_count, bool nexthop = true,
+                                bool local_pref = true, bool as_path = true) {
+        for (int idx = 0; idx < withdrawn_count; idx++) {
+            BgpProtoPrefix *prefix = new BgpProtoPrefix;
+            prefix->prefixlen = 16;
+            prefix->prefix.push_back(20);
+            prefix->prefix.push_back(idx % 256);
+            update->withdrawn_routes.push_back(prefix);
+        }
+
+        update->path_attributes.push_back(
+            new BgpAttrOrigin(BgpAttrOrigin::IGP));
+        if (nexthop)
+            update->path_attributes.push_back(new BgpAttrNextHop(0x0a0a0a01));
+        update->path_attributes.push_back(new BgpAttrMultiExitDisc(10));
+        if (local_pref)
+            update->path_attributes.push_back(new BgpAttrLocalPref(200));
+        update->path_attributes.push_back(new BgpAttrAtomicAggregate);
+        update->path_attributes.push_back(
+            new BgpAttrAggregator(64512, 0x0a0a0a02));
+        AsPathSpec *path_spec = new AsPathSpec;
+        if (as_path) {
+            AsPathSpec::PathSegment *ps = new AsPathSpec::PathSegment;
+            ps->path_segment_type = AsPathSpec::PathSegment::AS_SEQUENCE;
+            ps->path_segment.push_back(64512);
+            ps->path_segment.push_back(64513);
+            path_spec->path_segments.push_back(ps);
+        }
+        update->path_attributes.push_back(path_spec);
+        CommunitySpec *community = new CommunitySpec;
+        community->communities.push_back(0xfc000064);
+        community->communities.push_back(0xfc0000c8);
+        update->path_attributes.push_back(community);
+
+        for (int idx = 0; idx < nlri_count; idx++) {
+            BgpProtoPrefix *prefix = new BgpProtoPrefix;
+            prefix->prefixlen = 24;
+            prefix->prefix.push_back(10);
+            prefix->prefix.push_back(idx / 256);
+            prefix->prefix.push_back(idx % 256);
+            update->nlri.push_back(prefix);
+        }
+    }
+
+    // Decode with both decoders and verify that the results are the same.
+    void VerifyDecode(const uint8_t *data, size_t size, bool ibgp) {
+        boost::scoped_ptr<BgpInetUpdate> fast(
+            BgpUpdateDecoder::Decode(attr_db_, data, size, ibgp));
+        ASSERT_TRUE(fast.get() != NULL);
+        boost::scoped_ptr<BgpProto::Update> slow(
+            static_cast<BgpProto::Update *>(BgpProto::Decode(data, size)));
+        ASSERT_TRUE(slow.get() != NULL);
+
+        ASSERT_EQ(slow->withdrawn_routes.size(),
+                  fast->withdrawn_routes.size());
+        for (size_t idx = 0; idx < slow->withdrawn_routes.size(); idx++) {
+            EXPECT_TRUE(Ip4Prefix(*slow->withdrawn_routes[idx]) ==
+                        fast->withdrawn_routes[idx]);
+        }
+        ASSERT_EQ(slow->nlri.size(), fast->nlri.size());
+        for (size_t idx = 0; idx < slow->nlri.size(); idx++) {
+            EXPECT_TRUE(Ip4Prefix(*slow->nlri[idx]) == fast->nlri[idx]);
+        }
+        if (!slow->nlri.empty()) {
+            BgpAttrPtr attr = attr_db_->Locate(slow->path_attributes);
+            EXPECT_EQ(attr.get(), fast->attr.get());
+        }
+    }
+
+    BgpInetUpdate *Decode(BgpProto::Update *update, bool ibgp) {
+        int res = BgpProto::Encode(update, data_, sizeof(data_));
+        EXPECT_NE(-1, res);
+        return BgpUpdateDecoder::Decode(attr_db_, data_, res, ibgp);
+    }
+
+    EventManager evm_;
+    BgpServer server_;
+    BgpAttrDB *attr_db_;
+    uint8_t data_[BgpProto::kMaxMessageSize];
+};
+
+TEST_F(BgpUpdateDecoderTest, Decode) {
+    BgpProto::Update update;
+    BuildInetUpdate(&update, 32, 8);
+    int res = BgpProto::Encode(&update, data_, sizeof(data_));
+    EXPECT_NE(-1, res);
+    VerifyDecode(data_, res, true);
+    VerifyDecode(data_, res, false);
+
+    boost::scoped_ptr<BgpInetUpdate> fast(
+        BgpUpdateDecoder::Decode(attr_db_, data_, res, false));
+    ASSERT_TRUE(fast.get() != NULL);
+    const BgpAttr *attr = fast->attr.get();
+    EXPECT_EQ(BgpAttrOrigin::IGP, attr->origin());
+    EXPECT_EQ("10.10.10.1", attr->nexthop().to_string());
+    EXPECT_EQ(10U, attr->med());
+    EXPECT_EQ(200U, attr->local_pref());
+    EXPECT_TRUE(attr->atomic_aggregate());
+    ASSERT_TRUE(attr->as_path() != NULL);
+    EXPECT_TRUE(attr->as_path()->path().AsLeftMostMatch(64512));
+    ASSERT_TRUE(attr->community() != NULL);
+    EXPECT_EQ(2U, attr->community()->communities().size());
+    EXPECT_EQ("10.0.31.0/24", fast->nlri[31].ToString());
+    EXPECT_EQ("20.7.0.0/16", fast->withdrawn_routes[7].ToString());
+}
+
+TEST_F(BgpUpdateDecoderTest, Withdraw) {
+    BgpProto::Update update;
+    BuildInetUpdate(&update, 0, 16);
+    STLDeleteValues(&update.path_attributes);
+    int res = BgpProto::Encode(&update, data_, sizeof(data_));
+    EXPECT_NE(-1, res);
+    VerifyDecode(data_, res, false);
+
+    boost::scoped_ptr<BgpInetUpdate> fast(
+        BgpUpdateDecoder::Decode(attr_db_, data_, res, false));
+    ASSERT_TRUE(fast.get() != NULL);
+    EXPECT_TRUE(fast->attr.get() == NULL);
+    EXPECT_EQ(16U, fast->withdrawn_routes.size());
+}
+
+// Messages that need the generic decoder or that fail validation.
+TEST_F(BgpUpdateDecoderTest, Fallback) {
+    {
+        BgpProto::Update update;
+        BgpMessageTest::GenerateUpdateMessage(&update, BgpAf::IPv4,
+                                              BgpAf::Vpn);
+        EXPECT_TRUE(Decode(&update, true) == NULL);
+    }
+    {
+        BgpProto::Update update;
+        BuildInetUpdate(&update, 4, 0, false);
+        EXPECT_TRUE(Decode(&update, true) == NULL);
+    }
+    {
+        BgpProto::Update update;
+        BuildInetUpdate(&update, 4, 0, true, false);
+        EXPECT_TRUE(Decode(&update, true) == NULL);
+        boost::scoped_ptr<BgpInetUpdate> fast(Decode(&update, false));
+        EXPECT_TRUE(fast.get() != NULL);
+    }
+    {
+        BgpProto::Update update;
+        BuildInetUpdate(&update, 4, 0, true, true, false);
+        EXPECT_TRUE(Decode(&update, false) == NULL);
+        boost::scoped_ptr<BgpInetUpdate> fast(Decode(&update, true));
+        EXPECT_TRUE(fast.get() != NULL);
+    }
+    {
+        BgpProto::Update update;
+        BuildInetUpdate(&update, 4, 0);
+        update.path_attributes.push_back(new BgpAttrNextHop(0x0a0a0a03));
+        EXPECT_TRUE(Decode(&update, true) == NULL);
+    }
+    {
+        BgpProto::Update update;
+        BuildInetUpdate(&update, 4, 4);
+        int res = BgpProto::Encode(&update, data_, sizeof(data_));
+        EXPECT_NE(-1, res);
+        EXPECT_TRUE(
+            BgpUpdateDecoder::Decode(attr_db_, data_, res - 1, true) == NULL);
+        data_[BgpProto::kMinMessageSize + 2] = 33;
+        EXPECT_TRUE(
+            BgpUpdateDecoder::Decode(attr_db_, data_, res, true) == NULL);
+    }
+}
+
+// Any corrupted message accepted by the fast path needs to be accepted by
+// the generic decoder with the same result.
+TEST_F(BgpUpdateDecoderTest, RandomError) {
+    BgpProto::Update update;
+    BuildInetUpdate(&update, 8, 4);
+    uint8_t data[BgpProto::kMaxMessageSize];
+    int res = BgpProto::Encode(&update, data, sizeof(data));
+    EXPECT_NE(-1, res);
+
+    int count = getenv("HEAPCHECK") ? 100 : 10000;
+    for (int i = 0; i < count; i++) {
+        memcpy(data_, data, res);
+        int pos = BgpProto::kMinMessageSize + rand() % (res -
+                  BgpProto::kMinMessageSize);
+        data_[pos] = rand();
+        boost::scoped_ptr<BgpInetUpdate> fast(
+            BgpUpdateDecoder::Decode(attr_db_, data_, res, true));
+        if (fast.get() != NULL) {
+            VerifyDecode(data_, res, true);
+        }
+    }
+}
+
+//
+// Compare the cost of the generic decoder, including the conversion of its
+// output that BgpPeer::ProcessUpdate does, with the fast path decoder.
+//
+TEST_F(BgpUpdateDecoderTest, Benchmark) {
+    static const int kNlriCount = 900;
+    static const int kIterations = 1000;
+
+    BgpProto::Update update;
+    BuildInetUpdate(&update, kNlriCount, 0);
+    int res = BgpProto::Encode(&update, data_, sizeof(data_));
+    ASSERT_NE(-1, res);
+
+    uint64_t start = UTCTimestampUsec();
+    size_t slow_count = 0;
+    for (int i = 0; i < kIterations; i++) {
+        boost::scoped_ptr<BgpProto::Update> msg(
+            static_cast<BgpProto::Update *>(BgpProto::Decode(data_, res)));
+        BgpAttrPtr attr = attr_db_->Locate(msg->path_attributes);
+        for (vector<BgpProtoPrefix *>::const_iterator it = msg->nlri.begin();
+             it != msg->nlri.end(); ++it) {
+            Ip4Prefix prefix(**it);
+            slow_count++;
+        }
+    }
+    uint64_t slow_usec = UTCTimestampUsec() - start;
+
+    start = UTCTimestampUsec();
+    size_t fast_count = 0;
+    for (int i = 0; i < kIterations; i++) {
+        boost::scoped_ptr<BgpInetUpdate> msg(
+            BgpUpdateDecoder::Decode(attr_db_, data_, res, true));
+        fast_count += msg->nlri.size();
+    }
+    uint64_t fast_usec = UTCTimestampUsec() - start;
+
+    EXPECT_EQ(slow_count, fast_count);
+    BGP_DEBUG_UT("Decoded " << kIterations << " updates with " <<
+        kNlriCount << " prefixes: generic " << slow_usec << " usec, " <<
+        "fast path " << fast_usec << " usec");
+}
 }  // namespace
 
 int main(int argc, char **argv) {
@@ -672,5 +923,8 @@ int main(int argc, char **argv) {
     // Enable this debug flag when required during debugging
     //
     // detail::debug_ = false;
-    return RUN_ALL_TESTS();
+    int result = RUN_ALL_TESTS();
+    task_util::WaitForIdle();
+    TaskScheduler::GetInstance()->Terminate();
+    return result;
 }
@@ -5,12 +5,14 @@
 #include "bgp/bgp_table.h"
 
 #include "base/task.h"
+#include "base/task_annotations.h"
 #include "base/util.h"
 #include "base/test/task_test_util.h"
 #include "bgp/bgp_attr.h"
 #include "bgp/bgp_log.h"
 #include "bgp/bgp_path.h"
 #include "bgp/bgp_peer.h"
+#include "bgp/bgp_routing_policy.h"
 #include "bgp/bgp_update.h"
 #include "bgp/scheduling_group.h"
 #include "bgp/inet/inet_table.h"
@@ -126,6 +128,7 @@ protected:
 
     virtual void TearDown() {
         rt_.RemovePath(peer_.get());
+        SetExportPolicy(boost::shared_ptr<RoutingPolicy>());
         table_->RibOutDelete(ribout_->ExportPolicy());
         server_.Shutdown();
         task_util::WaitForIdle();
@@ -184,6 +187,17 @@ protected:
         ribout_ = table_->RibOutLocate(&mgr_, policy);
     }
 
+    void SetExportPolicy(boost::shared_ptr<RoutingPolicy> policy) {
+        ConcurrencyScope scope("bgp::Config");
+        table_->set_export_policy(policy);
+    }
+
+    void SetExportPolicy(const PolicyTermConfig &config) {
+        boost::shared_ptr<RoutingPolicy> policy(new RoutingPolicy("export"));
+        EXPECT_TRUE(policy->AddTerm(config));
+        SetExportPolicy(policy);
+    }
+
     void SetAttrAsPath(as_t as_number) {
         BgpAttr *attr = new BgpAttr(*attr_ptr_);
         const AsPathSpec &path_spec = attr_ptr_->as_path()->path();
@@ -483,6 +497,46 @@ TEST_P(BgpTableExportParamTest1, AsPathLoop) {
     VerifyExportReject();
 }
 
+//
+// Table : inet.0, bgp.l3vpn.0
+// Source: eBGP, iBGP
+// RibOut: eBGP
+// Intent: LocalPref set by the export policy is not sent to eBGP.
+//
+TEST_P(BgpTableExportParamTest1, EBgpPolicyNoLocalPref) {
+    CreateRibOut(BgpProto::EBGP, RibExportPolicy::BGP, 300);
+    PolicyTermConfig config;
+    config.name = "lpref";
+    config.update_local_pref = 300;
+    config.action = "accept";
+    SetExportPolicy(config);
+    AddPath();
+    RunExport();
+    VerifyExportAccept();
+    VerifyAttrLocalPref(0);
+    VerifyAttrMed(0);
+    VerifyAttrAsPrepend();
+}
+
+//
+// Table : inet.0, bgp.l3vpn.0
+// Source: eBGP, iBGP
+// RibOut: eBGP
+// Intent: Export policy matches the AsPath before our AS is prepended.
+//
+TEST_P(BgpTableExportParamTest1, EBgpPolicyAsPathNoPrepend) {
+    CreateRibOut(BgpProto::EBGP, RibExportPolicy::BGP, 300);
+    PolicyTermConfig config;
+    config.name = "local-as";
+    config.match_as_path = "^ 200";
+    config.action = "reject";
+    SetExportPolicy(config);
+    AddPath();
+    RunExport();
+    VerifyExportAccept();
+    VerifyAttrAsPrepend();
+}
+
 INSTANTIATE_TEST_CASE_P(Instance, BgpTableExportParamTest1,
         ::testing::Combine(
             ::testing::Values("inet.0", "bgp.l3vpn.0"),
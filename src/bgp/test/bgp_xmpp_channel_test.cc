@@ -42,11 +42,29 @@ using ::testing::Return;
 
 class XmppChannelMock : public XmppChannel {
 public:
-    XmppChannelMock() { }
+    XmppChannelMock() : corked_(false), send_ready_(true), sent_(0),
+        written_(0) { }
     virtual ~XmppChannelMock() { }
     bool Send(const uint8_t *, size_t, xmps::PeerId, SendReadyCb) {
+        sent_++;
+        if (!corked_) written_ = sent_;
         return true;
     }
+    void Cork() { corked_ = true; }
+    bool Uncork(xmps::PeerId, SendReadyCb cb) {
+        corked_ = false;
+        written_ = sent_;
+        if (!send_ready_) cb_ = cb;
+        return send_ready_;
+    }
+    void WriteReady() {
+        send_ready_ = true;
+        cb_(boost::system::error_code());
+    }
+    bool corked() const { return corked_; }
+    void set_send_ready(bool send_ready) { send_ready_ = send_ready; }
+    int sent() const { return sent_; }
+    int written() const { return written_; }
     MOCK_METHOD2(RegisterReceive, void(xmps::PeerId, ReceiveCb));
     MOCK_METHOD1(UnRegisterReceive, void(xmps::PeerId));
     std::string ToString() const { return string("fake"); }
@@ -96,6 +114,13 @@ public:
     virtual std::string LastFlap() const {
         return "";
     }
+
+private:
+    bool corked_;
+    bool send_ready_;
+    int sent_;
+    int written_;
+    SendReadyCb cb_;
 };
 
 class BgpXmppChannelMock : public BgpXmppChannel {
@@ -446,6 +471,45 @@ TEST_F(BgpXmppChannelTest, Connection) {
     EXPECT_EQ(0, Count(mgr_.get()));
 }
 
+// Updates sent to an XMPP peer are held back until FlushUpdate, which
+// reports the peer as send blocked until the channel is ready again.
+TEST_F(BgpXmppChannelTest, FlushUpdate) {
+    EXPECT_CALL(*(a.get()), RegisterReceive(xmps::BGP, _))
+                .Times(1);
+    mgr_->XmppHandleChannelEvent(a.get(), xmps::READY);
+    BgpXmppChannel *channel = this->FindChannel(a.get());
+    ASSERT_FALSE(channel == NULL);
+    IPeer *peer = channel->Peer();
+
+    const uint8_t msg[] = "update";
+    for (int i = 0; i < 3; i++) {
+        EXPECT_TRUE(peer->SendUpdate(msg, sizeof(msg)));
+    }
+    EXPECT_TRUE(a->corked());
+    EXPECT_EQ(3, a->sent());
+    EXPECT_EQ(0, a->written());
+    EXPECT_TRUE(peer->FlushUpdate());
+    EXPECT_FALSE(a->corked());
+    EXPECT_EQ(3, a->written());
+
+    a->set_send_ready(false);
+    EXPECT_TRUE(peer->SendUpdate(msg, sizeof(msg)));
+    EXPECT_FALSE(peer->FlushUpdate());
+    EXPECT_EQ(4, a->written());
+    EXPECT_FALSE(peer->FlushUpdate());
+    a->WriteReady();
+    task_util::WaitForIdle();
+    EXPECT_TRUE(peer->FlushUpdate());
+
+    EXPECT_CALL(*(a.get()), UnRegisterReceive(xmps::BGP))
+                .Times(1);
+    mgr_->XmppHandleChannelEvent(a.get(), xmps::NOT_READY);
+    task_util::WaitForIdle();
+    delete FindChannel(a.get());
+    mgr_->RemoveChannel(a.get());
+    EXPECT_EQ(0, Count(mgr_.get()));
+}
+
 }
 
 class TestEnvironment : public ::testing::Environment {
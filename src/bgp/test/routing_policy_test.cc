@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "bgp/bgp_routing_policy.h"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "base/logging.h"
+#include "base/task.h"
+#include "base/test/task_test_util.h"
+#include "base/util.h"
+#include "bgp/bgp_log.h"
+#include "bgp/bgp_server.h"
+#include "bgp/community.h"
+#include "bgp/inet/inet_route.h"
+#include "bgp/inet/inet_table.h"
+#include "control-node/control_node.h"
+#include "db/db.h"
+#include "io/event_manager.h"
+#include "testing/gunit.h"
+
+using namespace std;
+
+class RoutingPolicyTest : public ::testing::Test {
+protected:
+    RoutingPolicyTest()
+        : server_(&evm_),
+          attr_db_(server_.attr_db()),
+          table_(static_cast<InetTable *>(db_.CreateTable("inet.0"))) {
+    }
+
+    void TearDown() {
+        server_.Shutdown();
+        task_util::WaitForIdle();
+    }
+
+    BgpAttrPtr BuildAttr(uint32_t local_pref,
+                         const vector<uint32_t> &communities,
+                         const vector<as_t> &as_path) {
+        BgpAttrSpec spec;
+        BgpAttrOrigin origin(BgpAttrOrigin::IGP);
+        spec.push_back(&origin);
+        BgpAttrLocalPref lpref(local_pref);
+        spec.push_back(&lpref);
+        CommunitySpec comm_spec;
+        comm_spec.communities = communities;
+        if (!communities.empty())
+            spec.push_back(&comm_spec);
+        AsPathSpec path_spec;
+        AsPathSpec::PathSegment *ps = new AsPathSpec::PathSegment;
+        ps->path_segment_type = AsPathSpec::PathSegment::AS_SEQUENCE;
+        ps->path_segment = as_path;
+        path_spec.path_segments.push_back(ps);
+        spec.push_back(&path_spec);
+        return attr_db_->Locate(spec);
+    }
+
+    BgpAttrPtr BuildAttr(uint32_t local_pref = 100) {
+        return BuildAttr(local_pref, vector<uint32_t>(), vector<as_t>());
+    }
+
+    // Evaluate the policy for the given prefix. Returns false if rejected.
+    bool Evaluate(RoutingPolicy *policy, const string &prefix_str,
+                  BgpAttrPtr *attr) {
+        boost::system::error_code ec;
+        Ip4Prefix prefix = Ip4Prefix::FromString(prefix_str, &ec);
+        EXPECT_FALSE(ec);
+        InetRoute route(prefix);
+        return policy->Evaluate(table_, &route, attr);
+    }
+
+    static PolicyTermConfig PrefixTerm(const string &name,
+                                       const string &prefix,
+                                       const string &action) {
+        PolicyTermConfig config;
+        config.name = name;
+        config.match_prefixes.push_back(prefix);
+        config.action = action;
+        return config;
+    }
+
+    static uint32_t CommunityValue(uint16_t asn, uint16_t value) {
+        return (static_cast<uint32_t>(asn) << 16) | value;
+    }
+
+    EventManager evm_;
+    BgpServer server_;
+    BgpAttrDB *attr_db_;
+    DB db_;
+    InetTable *table_;
+};
+
+TEST_F(RoutingPolicyTest, InvalidConfig) {
+    RoutingPolicy policy("policy");
+    string error;
+
+    PolicyTermConfig config;
+    config.match_prefixes.push_back("10.1.1.0/33");
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+    EXPECT_FALSE(error.empty());
+
+    config = PolicyTermConfig();
+    config.match_prefixes.push_back("10.1.1.0/24 shorter");
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    config = PolicyTermConfig();
+    config.match_communities.push_back("70000:1");
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    config = PolicyTermConfig();
+    config.match_as_path = "^ 100 foo $";
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    config = PolicyTermConfig();
+    config.set_communities.push_back("target:64512:1");
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    config = PolicyTermConfig();
+    config.action = "drop";
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    config = PolicyTermConfig();
+    config.match_neighbor = "10.0.0.1";
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    config = PolicyTermConfig();
+    config.match_protocol = "bgp";
+    EXPECT_FALSE(policy.AddTerm(config, &error));
+
+    EXPECT_EQ(0U, policy.term_count());
+}
+
+TEST_F(RoutingPolicyTest, Compile) {
+    PolicyConfig config;
+    config.name = "policy";
+    config.terms.push_back(PrefixTerm("t1", "10.1.0.0/16", "reject"));
+    config.terms.push_back(PrefixTerm("t2", "10.2.0.0/16", "accept"));
+
+    boost::scoped_ptr<RoutingPolicy> policy(RoutingPolicy::Compile(config));
+    ASSERT_TRUE(policy.get() != NULL);
+    EXPECT_EQ("policy", policy->name());
+    EXPECT_EQ(2U, policy->term_count());
+    EXPECT_EQ("t2", policy->term_name(1));
+
+    string error;
+    config.terms.push_back(PrefixTerm("t3", "10.3.0.0/33", "accept"));
+    policy.reset(RoutingPolicy::Compile(config, &error));
+    EXPECT_TRUE(policy.get() == NULL);
+    EXPECT_NE(string::npos, error.find("t3"));
+}
+
+TEST_F(RoutingPolicyTest, PrefixMatchType) {
+    RoutingPolicy policy("policy");
+    EXPECT_TRUE(policy.AddTerm(
+        PrefixTerm("exact", "10.1.0.0/16 exact", "reject")));
+    EXPECT_TRUE(policy.AddTerm(
+        PrefixTerm("longer", "10.2.0.0/16 longer", "reject")));
+    EXPECT_TRUE(policy.AddTerm(
+        PrefixTerm("orlonger", "10.3.0.0/16", "reject")));
+
+    BgpAttrPtr attr = BuildAttr();
+    EXPECT_FALSE(Evaluate(&policy, "10.1.0.0/16", &attr));
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    EXPECT_TRUE(Evaluate(&policy, "10.0.0.0/8", &attr));
+
+    EXPECT_TRUE(Evaluate(&policy, "10.2.0.0/16", &attr));
+    EXPECT_FALSE(Evaluate(&policy, "10.2.1.0/24", &attr));
+
+    EXPECT_FALSE(Evaluate(&policy, "10.3.0.0/16", &attr));
+    EXPECT_FALSE(Evaluate(&policy, "10.3.1.1/32", &attr));
+    EXPECT_TRUE(Evaluate(&policy, "10.4.0.0/16", &attr));
+
+    EXPECT_EQ(1U, policy.term_hits(0));
+    EXPECT_EQ(1U, policy.term_hits(1));
+    EXPECT_EQ(2U, policy.term_hits(2));
+    EXPECT_EQ(8U, policy.evaluations());
+    EXPECT_EQ(4U, policy.rejects());
+}
+
+// Overlapping prefixes in different terms are all found by the single walk.
+TEST_F(RoutingPolicyTest, OverlappingPrefixes) {
+    RoutingPolicy policy("policy");
+    PolicyTermConfig config = PrefixTerm("t1", "10.1.1.0/24", "next");
+    config.update_local_pref = 200;
+    EXPECT_TRUE(policy.AddTerm(config));
+    EXPECT_TRUE(policy.AddTerm(PrefixTerm("t2", "10.0.0.0/8", "next")));
+    config = PrefixTerm("t3", "10.1.1.0/24 exact", "accept");
+    config.match_prefixes.push_back("20.0.0.0/8");
+    EXPECT_TRUE(policy.AddTerm(config));
+    EXPECT_TRUE(policy.AddTerm(PrefixTerm("t4", "0.0.0.0/0", "reject")));
+
+    BgpAttrPtr attr = BuildAttr();
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    EXPECT_EQ(200U, attr->local_pref());
+
+    attr = BuildAttr();
+    EXPECT_TRUE(Evaluate(&policy, "20.1.0.0/16", &attr));
+    EXPECT_EQ(100U, attr->local_pref());
+
+    attr = BuildAttr();
+    EXPECT_FALSE(Evaluate(&policy, "10.1.2.0/24", &attr));
+
+    EXPECT_EQ(1U, policy.term_hits(0));
+    EXPECT_EQ(2U, policy.term_hits(1));
+    EXPECT_EQ(2U, policy.term_hits(2));
+    EXPECT_EQ(1U, policy.term_hits(3));
+}
+
+TEST_F(RoutingPolicyTest, MatchCommunity) {
+    RoutingPolicy policy("policy");
+    PolicyTermConfig config;
+    config.name = "community";
+    config.match_communities.push_back("64512:100");
+    config.match_communities.push_back("no-export");
+    config.action = "reject";
+    EXPECT_TRUE(policy.AddTerm(config));
+
+    vector<uint32_t> communities;
+    communities.push_back(CommunityValue(64512, 100));
+    BgpAttrPtr attr = BuildAttr(100, communities, vector<as_t>());
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+
+    communities.push_back(Community::NoExport);
+    communities.push_back(CommunityValue(64512, 200));
+    attr = BuildAttr(100, communities, vector<as_t>());
+    EXPECT_FALSE(Evaluate(&policy, "10.1.1.0/24", &attr));
+
+    attr = BuildAttr();
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+}
+
+TEST_F(RoutingPolicyTest, UpdateCommunity) {
+    RoutingPolicy policy("policy");
+    PolicyTermConfig config;
+    config.name = "add";
+    config.add_communities.push_back("64512:300");
+    config.remove_communities.push_back("64512:100");
+    config.action = "next";
+    EXPECT_TRUE(policy.AddTerm(config));
+
+    vector<uint32_t> communities;
+    communities.push_back(CommunityValue(64512, 100));
+    communities.push_back(CommunityValue(64512, 200));
+    BgpAttrPtr attr = BuildAttr(100, communities, vector<as_t>());
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    ASSERT_TRUE(attr->community() != NULL);
+    const vector<uint32_t> &result = attr->community()->communities();
+    EXPECT_EQ(2U, result.size());
+    EXPECT_TRUE(find(result.begin(), result.end(),
+                     CommunityValue(64512, 200)) != result.end());
+    EXPECT_TRUE(find(result.begin(), result.end(),
+                     CommunityValue(64512, 300)) != result.end());
+
+    // A later term with set replaces the communities.
+    config = PolicyTermConfig();
+    config.name = "set";
+    config.set_communities.push_back("no-advertise");
+    config.action = "accept";
+    EXPECT_TRUE(policy.AddTerm(config));
+
+    attr = BuildAttr(100, communities, vector<as_t>());
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    ASSERT_TRUE(attr->community() != NULL);
+    EXPECT_EQ(1U, attr->community()->communities().size());
+    EXPECT_EQ(static_cast<uint32_t>(Community::NoAdvertise),
+              attr->community()->communities()[0]);
+}
+
+TEST_F(RoutingPolicyTest, MatchAsPath) {
+    RoutingPolicy policy("policy");
+    PolicyTermConfig config;
+    config.name = "origin";
+    config.match_as_path = "300 $";
+    config.action = "reject";
+    EXPECT_TRUE(policy.AddTerm(config));
+    config.name = "neighbor";
+    config.match_as_path = "^ 100 . 200";
+    config.update_local_pref = 50;
+    config.action = "accept";
+    EXPECT_TRUE(policy.AddTerm(config));
+
+    vector<as_t> as_path;
+    as_path.push_back(100);
+    as_path.push_back(300);
+    BgpAttrPtr attr = BuildAttr(100, vector<uint32_t>(), as_path);
+    EXPECT_FALSE(Evaluate(&policy, "10.1.1.0/24", &attr));
+
+    as_path.clear();
+    as_path.push_back(100);
+    as_path.push_back(150);
+    as_path.push_back(200);
+    as_path.push_back(400);
+    attr = BuildAttr(100, vector<uint32_t>(), as_path);
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    EXPECT_EQ(50U, attr->local_pref());
+
+    as_path.clear();
+    as_path.push_back(100);
+    as_path.push_back(200);
+    attr = BuildAttr(100, vector<uint32_t>(), as_path);
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    EXPECT_EQ(100U, attr->local_pref());
+
+    EXPECT_EQ(1U, policy.term_hits(0));
+    EXPECT_EQ(1U, policy.term_hits(1));
+}
+
+TEST_F(RoutingPolicyTest, MatchLocalPref) {
+    RoutingPolicy policy("policy");
+    PolicyTermConfig config;
+    config.name = "lpref";
+    config.match_local_pref = 200;
+    config.update_local_pref = 300;
+    config.action = "accept";
+    EXPECT_TRUE(policy.AddTerm(config));
+
+    BgpAttrPtr attr = BuildAttr(100);
+    BgpAttrPtr orig_attr = attr;
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    EXPECT_EQ(orig_attr.get(), attr.get());
+
+    attr = BuildAttr(200);
+    EXPECT_TRUE(Evaluate(&policy, "10.1.1.0/24", &attr));
+    EXPECT_EQ(300U, attr->local_pref());
+}
+
+//
+// Evaluation rate of a policy with many prefix terms, most of which don't
+// cover the route. With the compiled prefix index the cost is proportional
+// to the number of covering prefixes rather than the number of terms.
+//
+TEST_F(RoutingPolicyTest, Benchmark) {
+    static const int kTermCount = 1000;
+    static const int kRouteCount = 2000;
+    static const int kIterations = 20;
+
+    RoutingPolicy policy("policy");
+    for (int idx = 0; idx < kTermCount; ++idx) {
+        PolicyTermConfig config;
+        config.name = "term" + integerToString(idx);
+        config.match_prefixes.push_back(
+            "10." + integerToString(idx / 256) + "." +
+            integerToString(idx % 256) + ".0/24 exact");
+        config.match_communities.push_back("64512:" + integerToString(idx));
+        config.action = "reject";
+        EXPECT_TRUE(policy.AddTerm(config));
+    }
+    PolicyTermConfig config;
+    config.name = "default";
+    config.update_local_pref = 200;
+    config.action = "accept";
+    EXPECT_TRUE(policy.AddTerm(config));
+
+    vector<InetRoute *> routes;
+    for (int idx = 0; idx < kRouteCount; ++idx) {
+        Ip4Address addr(0x0a000000 + (idx << 8));
+        routes.push_back(new InetRoute(Ip4Prefix(addr, 24)));
+    }
+    BgpAttrPtr attr = BuildAttr();
+
+    uint64_t start = UTCTimestampUsec();
+    int accepted = 0;
+    for (int iter = 0; iter < kIterations; ++iter) {
+        for (vector<InetRoute *>::iterator it = routes.begin();
+             it != routes.end(); ++it) {
+            BgpAttrPtr route_attr = attr;
+            if (policy.Evaluate(table_, *it, &route_attr))
+                accepted++;
+        }
+    }
+    uint64_t elapsed = UTCTimestampUsec() - start;
+    EXPECT_EQ(kRouteCount * kIterations, accepted);
+
+    uint64_t evaluations = kRouteCount * kIterations;
+    BGP_DEBUG_UT("RoutingPolicy: " << evaluations << " evaluations with " <<
+        kTermCount << " terms in " << elapsed << " usec (" <<
+        (elapsed ? evaluations * 1000000 / elapsed : 0) << " per sec)");
+
+    STLDeleteValues(&routes);
+}
+
+static void SetUp() {
+    bgp_log_test::init();
+    ControlNode::SetDefaultSchedulingPolicy();
+}
+
+static void TearDown() {
+    task_util::WaitForIdle();
+    TaskScheduler *scheduler = TaskScheduler::GetInstance();
+    scheduler->Terminate();
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    SetUp();
+    int result = RUN_ALL_TESTS();
+    TearDown();
+    return result;
+}
@@ -3298,6 +3298,87 @@ TEST_P(ServiceChainParamTest, DeleteConnectedWithExtConnectRoute) {
     DeleteConnectedRoute(NULL, "1.1.2.3/32");
     task_util::WaitForIdle();
 }
+static string ScaleSubnet(int index) {
+    return "10." + boost::lexical_cast<string>(index / 256) + "." +
+        boost::lexical_cast<string>(index % 256);
+}
+
+//
+// Service chain with 10K subnet prefixes. More specific routes spread over the
+// subnets must be matched to their own aggregate and routes outside of the
+// subnets must be treated as external connecting routes.
+//
+TEST_P(ServiceChainParamTest, ScaleSubnetPrefixes) {
+    static const int kSubnetCount = 10000;
+    vector<string> instance_names = list_of("blue")("blue-i1")("red-i2")("red");
+    multimap<string, string> connections = 
+        map_list_of("blue", "blue-i1") ("red-i2", "red");
+    NetworkConfig(instance_names, connections);
+    VerifyNetworkConfig(instance_names);
+
+    std::auto_ptr<autogen::ServiceChainInfo> params = 
+        GetChainConfig("src/bgp/testdata/service_chain_1.xml");
+    params->prefix.clear();
+    for (int i = 0; i < kSubnetCount; i++) {
+        params->prefix.push_back(ScaleSubnet(i) + ".0/24");
+    }
+
+    // Service Chain Info
+    ifmap_test_util::IFMapMsgPropertyAdd(&config_db_, "routing-instance", 
+                                         "blue-i1", 
+                                         "service-chain-information", 
+                                         params.release(),
+                                         0);
+    task_util::WaitForIdle();
+
+    // Add Connected
+    AddConnectedRoute(NULL, "1.1.2.3/32", 100, "2.3.4.5");
+    task_util::WaitForIdle();
+
+    // Add More specifics, spread over the subnets, and an external route
+    uint64_t start = UTCTimestampUsec();
+    vector<string> subnets;
+    for (int i = 0; i < kSubnetCount; i += 97) {
+        string subnet = ScaleSubnet(i);
+        subnets.push_back(subnet);
+        AddInetRoute(NULL, "red", subnet + ".1/32", 100);
+    }
+    AddInetRoute(NULL, "red", "20.1.1.1/32", 100);
+    task_util::WaitForIdle();
+    LOG(DEBUG, "Matched " << subnets.size() << " more specific routes against "
+        << kSubnetCount << " subnets in "
+        << (UTCTimestampUsec() - start) << " usec");
+
+    // Check for aggregated routes
+    BOOST_FOREACH(const string &subnet, subnets) {
+        TASK_UTIL_WAIT_NE_NO_MSG(InetRouteLookup("blue", subnet + ".0/24"),
+                                 NULL, 1000, 10000, 
+                                 "Wait for Aggregate route in blue..");
+        TASK_UTIL_EXPECT_TRUE(InetRouteLookup("blue", subnet + ".1/32") ==
+                              NULL);
+    }
+
+    // Check for ExtConnect route
+    TASK_UTIL_WAIT_NE_NO_MSG(InetRouteLookup("blue", "20.1.1.1/32"),
+                             NULL, 1000, 10000, 
+                             "Wait for ExtConnect route in blue..");
+
+    // Delete More specifics, ExtRoute and connected route
+    BOOST_FOREACH(const string &subnet, subnets) {
+        DeleteInetRoute(NULL, "red", subnet + ".1/32");
+    }
+    DeleteInetRoute(NULL, "red", "20.1.1.1/32");
+    task_util::WaitForIdle();
+
+    BOOST_FOREACH(const string &subnet, subnets) {
+        TASK_UTIL_WAIT_EQ_NO_MSG(InetRouteLookup("blue", subnet + ".0/24"),
+                                 NULL, 1000, 10000, 
+                                 "Wait for Aggregate route in blue..");
+    }
+    DeleteConnectedRoute(NULL, "1.1.2.3/32");
+    task_util::WaitForIdle();
+}
+
 INSTANTIATE_TEST_CASE_P(Instance, ServiceChainParamTest,
         ::testing::Combine(::testing::Bool(), ::testing::Bool()));
 
@@ -225,16 +225,33 @@ protected:
                 }
             }
             cout << "*******************************************************"<<endl;
+            next_batch_ = resp->get_next_batch();
             validate_done_ = 1;
         }
+
+        // Count the routes in the response and save the next batch
+        static void CountSandeshResponse(Sandesh *sandesh) {
+            ShowRouteResp *resp = dynamic_cast<ShowRouteResp *>(sandesh);
+            EXPECT_NE((ShowRouteResp *)NULL, resp);
+            for (size_t i = 0; i < resp->get_tables().size(); i++) {
+                route_count_ += resp->get_tables()[i].routes.size();
+            }
+            next_batch_ = resp->get_next_batch();
+            validate_done_ = 1;
+        }
+
         auto_ptr<EventManager> evm_;
         auto_ptr<ServerThread> thread_;
         auto_ptr<BgpServerTest> a_;
         auto_ptr<BgpServerTest> b_;
 
         static int validate_done_;
+        static int route_count_;
+        static string next_batch_;
     };
     int ShowRouteTest::validate_done_;
+    int ShowRouteTest::route_count_;
+    string ShowRouteTest::next_batch_;
 
     namespace {
 
@@ -401,6 +418,84 @@ protected:
     show_req->HandleRequest();
     show_req->Release();
     task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    EXPECT_EQ("", next_batch_);
+
+    // Without paging, all the routes are shown regardless of page_limit
+    sandesh_context.page_limit = 5;
+    show_req = new ShowRouteReq;
+    result = list_of(3)(3)(3)(3);
+    Sandesh::set_response_callback(boost::bind(ValidateSandeshResponse, _1,
+                                               result, __LINE__));
+    validate_done_ = 0;
+    show_req->HandleRequest();
+    show_req->Release();
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    EXPECT_EQ("", next_batch_);
+
+    // Page through all the routes, 5 at a time
+    show_req = new ShowRouteReq;
+    show_req->set_paging(true);
+    result = list_of(3)(2);
+    Sandesh::set_response_callback(boost::bind(ValidateSandeshResponse, _1,
+                                               result, __LINE__));
+    validate_done_ = 0;
+    show_req->HandleRequest();
+    show_req->Release();
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    EXPECT_NE("", next_batch_);
+
+    ShowRouteReqIterate *iter_req = new ShowRouteReqIterate;
+    result = list_of(1)(3)(1);
+    Sandesh::set_response_callback(boost::bind(ValidateSandeshResponse, _1,
+                                               result, __LINE__));
+    iter_req->set_route_info(next_batch_);
+    validate_done_ = 0;
+    iter_req->HandleRequest();
+    iter_req->Release();
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    EXPECT_NE("", next_batch_);
+
+    iter_req = new ShowRouteReqIterate;
+    result = list_of(2);
+    Sandesh::set_response_callback(boost::bind(ValidateSandeshResponse, _1,
+                                               result, __LINE__));
+    iter_req->set_route_info(next_batch_);
+    validate_done_ = 0;
+    iter_req->HandleRequest();
+    iter_req->Release();
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    EXPECT_EQ("", next_batch_);
+    sandesh_context.page_limit = BgpSandeshContext::kPageLimit;
+
+    // Look at one route per partition for each request, with or without
+    // paging. All the routes must still be shown exactly once across the
+    // batches
+    sandesh_context.iter_limit = 1;
+    Sandesh::set_response_callback(boost::bind(CountSandeshResponse, _1));
+    route_count_ = 0;
+    show_req = new ShowRouteReq;
+    validate_done_ = 0;
+    show_req->HandleRequest();
+    show_req->Release();
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    for (int i = 0; i < 100 && !next_batch_.empty(); i++) {
+        iter_req = new ShowRouteReqIterate;
+        iter_req->set_route_info(next_batch_);
+        validate_done_ = 0;
+        iter_req->HandleRequest();
+        iter_req->Release();
+        task_util::WaitForIdle();
+        TASK_UTIL_EXPECT_EQ(1, validate_done_);
+    }
+    EXPECT_EQ("", next_batch_);
+    EXPECT_EQ(12, route_count_);
+    sandesh_context.iter_limit = BgpSandeshContext::kIterLimit;
 
     //
     // Delete all the routes added
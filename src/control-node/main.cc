@@ -55,6 +55,7 @@ static TaskTrigger *node_info_trigger;
 static Timer *node_info_log_timer;
 static uint64_t start_time;
 static EventManager evm;
+static const int kDefaultIoShards = 1;
 
 static string FileRead(const char *filename) {
     ifstream file(filename);
@@ -411,6 +412,8 @@ int main(int argc, char *argv[]) {
         ("hostname", opt::value<string>()->default_value(hostname),
             "Hostname of control-node")
         ("host-ip", opt::value<string>(), "IP address of control-node")
+        ("io-shards", opt::value<int>()->default_value(kDefaultIoShards),
+            "Number of IO threads for the accepted XMPP and HTTP sessions")
         ("http-server-port",
             opt::value<int>()->default_value(ContrailPorts::HttpPortControl),
             "Sandesh HTTP listener port")
@@ -488,6 +491,10 @@ int main(int argc, char *argv[]) {
     }
     TaskScheduler::Initialize();
     ControlNode::SetDefaultSchedulingPolicy();
+
+    // The sessions of the servers created below are spread across the
+    // shards, so they must be added before the first server.
+    evm.SetShardCount(var_map["io-shards"].as<int>());
     BgpSandeshContext sandesh_context;
 
     if (!var_map.count("discovery-server")) { 
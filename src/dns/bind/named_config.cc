@@ -27,6 +27,14 @@ const string NamedConfig::NamedZoneMXPrefix = "contrail-mx";
 const char NamedConfig::ZoneFileDirectory[] = "/etc/contrail/dns/";
 const char NamedConfig::pid_file_name[] = "named.pid";
 
+NamedConfig::~NamedConfig() {
+    if (reconfig_timer_) {
+        reconfig_timer_->Cancel();
+        TimerManager::DeleteTimer(reconfig_timer_);
+    }
+    singleton_ = NULL;
+}
+
 void NamedConfig::Init() {
     assert(singleton_ == NULL);
     singleton_ = new NamedConfig();
@@ -73,6 +81,11 @@ void NamedConfig::ChangeView(const VirtualDnsConfig *vdns) {
 
 void NamedConfig::DelView(const VirtualDnsConfig *vdns) {
     UpdateNamedConf(vdns);
+    // The virtual DNS is gone by the time the update is applied, remove its
+    // zone files along with it
+    ZoneList zones;
+    MakeZoneList(vdns, zones);
+    RemoveZoneFiles(vdns, zones);
 }
 
 void NamedConfig::AddAllViews() {
@@ -117,8 +130,58 @@ void NamedConfig::DelZone(const Subnet &subnet, const VirtualDnsConfig *vdns) {
 }
 
 void NamedConfig::UpdateNamedConf(const VirtualDnsConfig *updated_vdns) {
-    CreateNamedConf(updated_vdns);
-    sync();
+    if (updated_vdns)
+        pending_vdns_.insert(updated_vdns->GetName());
+
+    if (reset_flag_ || all_zone_files_) {
+        FlushNamedConf();
+        return;
+    }
+
+    if (!reconfig_timer_) {
+        reconfig_timer_ = TimerManager::CreateTimer(
+                          *Dns::GetEventManager()->io_service(),
+                          "NamedConfigTimer",
+                          TaskScheduler::GetInstance()->GetTaskId("dns::Config"),
+                          0);
+    }
+    reconfig_pending_ = true;
+    if (!reconfig_timer_->running()) {
+        reconfig_timer_->Start(kReconfigDelay,
+                               boost::bind(&NamedConfig::ReconfigTimerExpiry,
+                                           this));
+    }
+}
+
+bool NamedConfig::ReconfigTimerExpiry() {
+    FlushNamedConf();
+    return false;
+}
+
+void NamedConfig::FlushNamedConf() {
+    if (reconfig_timer_)
+        reconfig_timer_->Cancel();
+    reconfig_pending_ = false;
+
+    for (std::set<std::string>::iterator it = pending_zone_removals_.begin();
+         it != pending_zone_removals_.end(); ++it) {
+        remove(it->c_str());
+        remove((*it + ".jnl").c_str());
+    }
+    pending_zone_removals_.clear();
+
+    if (CreateNamedConf(NULL)) {
+        sync();
+        Reconfig();
+        reconfig_count_++;
+    }
+    pending_vdns_.clear();
+
+    if (!reconfig_cb_.empty())
+        reconfig_cb_();
+}
+
+void NamedConfig::Reconfig() {
     // rndc_reconfig();
     // TODO: convert this to a call to rndc library
     std::stringstream str;
@@ -128,17 +191,26 @@ void NamedConfig::UpdateNamedConf(const VirtualDnsConfig *updated_vdns) {
     system(str.str().c_str());
 }
 
-void NamedConfig::CreateNamedConf(const VirtualDnsConfig *updated_vdns) {
+// Returns true if the contents of named.conf changed
+bool NamedConfig::CreateNamedConf(const VirtualDnsConfig *updated_vdns) {
      GetDefaultForwarders();
-     file_.open(named_conf_file_.c_str());
+     file_.str("");
+     file_.clear();
     
      WriteOptionsConfig();
      WriteRndcConfig();
      WriteLoggingConfig();
      WriteViewConfig(updated_vdns);
 
-     file_.flush();
-     file_.close();
+     std::ofstream conf(named_conf_file_.c_str());
+     conf << file_.str();
+     conf.flush();
+     conf.close();
+
+     if (file_.str() == named_conf_)
+         return false;
+     named_conf_ = file_.str();
+     return true;
 }
 
 void NamedConfig::WriteOptionsConfig() {
@@ -233,7 +305,8 @@ void NamedConfig::WriteViewConfig(const VirtualDnsConfig *updated_vdns) {
 
         file_ << "};" << endl << endl;
 
-        if (curr_vdns == updated_vdns || all_zone_files_)
+        if (curr_vdns == updated_vdns || all_zone_files_ ||
+            pending_vdns_.find(curr_vdns->GetName()) != pending_vdns_.end())
             AddZoneFiles(zones, curr_vdns);
     }
 
@@ -290,6 +363,11 @@ void NamedConfig::RemoveZoneFiles(const VirtualDnsConfig *vdns,
 
 void NamedConfig::RemoveZoneFile(const VirtualDnsConfig *vdns, string &zone) {
     string zfile_name = GetZoneFilePath(vdns->GetViewName(), zone);
+    // BIND serves the zone until the pending update is applied
+    if (reconfig_pending_) {
+        pending_zone_removals_.insert(zfile_name);
+        return;
+    }
     remove(zfile_name.c_str());
     zfile_name.append(".jnl");
     remove(zfile_name.c_str());
@@ -323,6 +401,7 @@ void NamedConfig::CreateZoneFile(std::string &zone_name,
     ofstream zfile;
     string ns_name;
     string zone_filename = GetZoneFilePath(vdns->GetViewName(), zone_name);
+    pending_zone_removals_.erase(zone_filename);
 
     zfile.open(zone_filename.c_str());
     zfile << "$ORIGIN ." << endl;
@@ -8,7 +8,9 @@
 #include <iostream>
 #include <fstream>
 #include <set>
+#include <sstream>
 #include <string>
+#include <boost/function.hpp>
 #include <base/timer.h>
 
 class BindStatus {
@@ -39,10 +41,20 @@ private:
     DISALLOW_COPY_AND_ASSIGN(BindStatus);
 };
 
+// Generates named.conf and the zone files for the virtual DNS servers.
+// Changes to named.conf are coalesced and applied kReconfigDelay after the
+// first pending change, followed by a single "rndc reconfig". The reconfig
+// is skipped when the generated config is unchanged, e.g. when a subnet
+// maps to a reverse zone that is already present. Records are not part of
+// named.conf; they are sent to BIND as dynamic updates by DnsManager, which
+// holds them back while a reconfig is pending (see IsReconfigPending).
 class NamedConfig {
 public:
     typedef std::map<std::string, ZoneList> ViewZoneMap;
     typedef std::pair<std::string, ZoneList> ViewZonePair;
+    typedef boost::function<void()> ReconfigCallback;
+
+    static const uint32_t kReconfigDelay = 200;   // milli seconds
 
     static const char NamedConfigFile[];
     static const char NamedLogFile[];
@@ -67,12 +79,15 @@ public:
 
     NamedConfig() : file_(), named_conf_file_(NamedConfigFile), 
                     zone_file_dir_(ZoneFileDirectory), reset_flag_(false),
-                    all_zone_files_(false) {}
+                    all_zone_files_(false), reconfig_timer_(NULL),
+                    reconfig_pending_(false), reconfig_count_(0) {}
     NamedConfig(const char *conf_file, const char *zone_dir) : file_(), 
                 named_conf_file_(conf_file), zone_file_dir_(zone_dir),
-                reset_flag_(false), all_zone_files_(false) {}
+                reset_flag_(false), all_zone_files_(false),
+                reconfig_timer_(NULL), reconfig_pending_(false),
+                reconfig_count_(0) {}
 
-    virtual ~NamedConfig() { singleton_ = NULL; }
+    virtual ~NamedConfig();
     static NamedConfig *GetNamedConfigObject() { return singleton_; }
     static void Init();
     static void Shutdown();
@@ -85,6 +100,12 @@ public:
     virtual void DelZone(const Subnet &subnet, const VirtualDnsConfig *vdns);
 
     virtual void UpdateNamedConf(const VirtualDnsConfig *updated_vdns = NULL);
+    // Apply the pending changes right away
+    void FlushNamedConf();
+    bool IsReconfigPending() const { return reconfig_pending_; }
+    // Invoked after pending changes are applied
+    void RegisterReconfigCallback(ReconfigCallback cb) { reconfig_cb_ = cb; }
+    uint32_t reconfig_count() const { return reconfig_count_; }
     void RemoveZoneFiles(const VirtualDnsConfig *vdns, ZoneList &zones);
     virtual std::string GetZoneFileName(const std::string &vdns, 
                                         const std::string &name);
@@ -96,7 +117,9 @@ public:
     std::string GetZoneDir() const { return zone_file_dir_; }
 
 protected:
-    void CreateNamedConf(const VirtualDnsConfig *updated_vdns);
+    bool CreateNamedConf(const VirtualDnsConfig *updated_vdns);
+    virtual void Reconfig();
+    bool ReconfigTimerExpiry();
     void WriteOptionsConfig();
     void WriteRndcConfig();
     void WriteLoggingConfig();
@@ -112,12 +135,21 @@ protected:
     void MakeZoneList(const VirtualDnsConfig *vdns_config, ZoneList &zones);
     void GetDefaultForwarders();
 
-    std::ofstream file_;
+    std::ostringstream file_;
+    std::string named_conf_;        // contents last written to named.conf
     std::string named_conf_file_;
     std::string zone_file_dir_;
     std::string default_forwarders_;
     bool reset_flag_;
     bool all_zone_files_;
+    // virtual DNS servers whose zone files are written on the next update
+    std::set<std::string> pending_vdns_;
+    // zone files removed on the next update
+    std::set<std::string> pending_zone_removals_;
+    Timer *reconfig_timer_;
+    bool reconfig_pending_;
+    ReconfigCallback reconfig_cb_;
+    uint32_t reconfig_count_;
     static NamedConfig *singleton_;
 };
 
@@ -40,6 +40,8 @@ DnsManager::DnsManager()
 
 void DnsManager::Initialize(DB *config_db, DBGraph *config_graph) {
     NamedConfig::Init();
+    NamedConfig::GetNamedConfigObject()->RegisterReconfigCallback(
+        boost::bind(&DnsManager::SendPendingUpdates, this));
     // bind_status_.SetTrigger();
     config_mgr_.Initialize(config_db, config_graph);
 }
@@ -270,6 +272,31 @@ bool DnsManager::SendRecordUpdate(BindUtil::Operation op,
 
 void DnsManager::SendUpdate(BindUtil::Operation op, const std::string &view,
                             const std::string &zone, DnsItems &items) {
+    // The view or zone of the record may be part of a pending named.conf
+    // update; hold the record until BIND is reconfigured
+    NamedConfig *ncfg = NamedConfig::GetNamedConfigObject();
+    if (ncfg && ncfg->IsReconfigPending()) {
+        tbb::mutex::scoped_lock lock(update_mutex_);
+        pending_updates_.push_back(PendingUpdate(op, view, zone, items));
+        return;
+    }
+    SendBindUpdate(op, view, zone, items);
+}
+
+void DnsManager::SendPendingUpdates() {
+    PendingUpdateList updates;
+    {
+        tbb::mutex::scoped_lock lock(update_mutex_);
+        updates.swap(pending_updates_);
+    }
+    for (PendingUpdateList::iterator it = updates.begin();
+         it != updates.end(); ++it) {
+        SendBindUpdate(it->op, it->view, it->zone, it->items);
+    }
+}
+
+void DnsManager::SendBindUpdate(BindUtil::Operation op, const std::string &view,
+                                const std::string &zone, DnsItems &items) {
     uint8_t *pkt = new uint8_t[BindResolver::max_pkt_size];
     uint16_t xid = GetTransId();
     int len = BindUtil::BuildDnsUpdate(pkt, op, xid, view, zone, items);
@@ -5,6 +5,7 @@
 #ifndef __dns_manager_h__
 #define __dns_manager_h__
 
+#include <vector>
 #include <tbb/mutex.h>
 #include <mgr/dns_oper.h>
 #include <bind/named_config.h>
@@ -31,6 +32,7 @@ public:
     DnsConfigManager &GetConfigManager() { return config_mgr_; }
     void SendUpdate(BindUtil::Operation op, const std::string &view,
                     const std::string &zone, DnsItems &items);
+    void SendPendingUpdates();
     void UpdateAll();
     void BindEventHandler(BindStatus::Event ev);
 
@@ -43,12 +45,28 @@ public:
 private:
     friend class DnsBindTest;
 
+    // Record update held back while named.conf is being updated
+    struct PendingUpdate {
+        PendingUpdate(BindUtil::Operation o, const std::string &v,
+                      const std::string &z, const DnsItems &i)
+            : op(o), view(v), zone(z), items(i) {}
+        BindUtil::Operation op;
+        std::string view;
+        std::string zone;
+        DnsItems items;
+    };
+    typedef std::vector<PendingUpdate> PendingUpdateList;
+
     bool SendRecordUpdate(BindUtil::Operation op, 
                           const VirtualDnsRecordConfig *config);
+    void SendBindUpdate(BindUtil::Operation op, const std::string &view,
+                        const std::string &zone, DnsItems &items);
     inline uint16_t GetTransId();
     inline bool CheckName(std::string rec_name, std::string name);
 
     tbb::mutex mutex_;
+    tbb::mutex update_mutex_;
+    PendingUpdateList pending_updates_;
     BindStatus bind_status_;
     DnsConfigManager config_mgr_;    
     static uint16_t g_trans_id_;
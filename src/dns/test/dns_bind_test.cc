@@ -33,7 +33,7 @@ using namespace std;
 class NamedConfigTest : public NamedConfig {
 public:
     NamedConfigTest(const char *conf_file, const char *zone_dir) : 
-                    NamedConfig(conf_file, zone_dir) {}
+                    NamedConfig(conf_file, zone_dir), coalesce_(false) {}
     static void Init() {
         assert(singleton_ == NULL);
         singleton_ = new NamedConfigTest("./named.conf", "./");
@@ -45,8 +45,14 @@ public:
         remove("./named.conf");
     }
     virtual void UpdateNamedConf(const VirtualDnsConfig *updated_vdns) {
+        if (coalesce_) {
+            NamedConfig::UpdateNamedConf(updated_vdns);
+            return;
+        }
         CreateNamedConf(updated_vdns);
     }
+    virtual void Reconfig() {}
+    void set_coalesce(bool coalesce) { coalesce_ = coalesce; }
     std::string GetZoneFileName(const std::string &vdns, 
                                 const std::string &name) {
         if (name.size() && name.at(name.size() - 1) == '.')
@@ -62,6 +68,9 @@ public:
         return GetZoneFilePath("", name);
     }
     std::string GetResolveFile() { return ""; }
+
+private:
+    bool coalesce_;
 };
 
 static bool FileExists(const char *file) {
@@ -488,6 +497,56 @@ TEST_F(DnsBindTest, Reordered) {
     }
 }
 
+TEST_F(DnsBindTest, CoalescedReconfig) {
+    NamedConfigTest *cfg = static_cast<NamedConfigTest *>(NamedConfig::GetNamedConfigObject());
+    cfg->set_coalesce(true);
+    cfg->RegisterReconfigCallback(
+        boost::bind(&DnsManager::SendPendingUpdates, &dns_manager_));
+
+    string dns_domains[] = {
+        "contrail.juniper.net",
+        "test.example.com",
+        "test.juniper.net",
+        "test1.juniper.net",
+        "192.1.1.in-addr.arpa",
+        "193.1.1.in-addr.arpa",
+    };
+
+    // all the views and zones in the config are applied with one reconfig
+    uint32_t count = cfg->reconfig_count();
+    string content = FileRead("src/dns/testdata/config_test_2.xml");
+    EXPECT_TRUE(parser_.Parse(content));
+    task_util::WaitForIdle();
+    cfg->FlushNamedConf();
+    EXPECT_FALSE(cfg->IsReconfigPending());
+    EXPECT_EQ(count + 1, cfg->reconfig_count());
+    EXPECT_TRUE(FilesEqual(cfg->GetConfFilePath().c_str(),
+                "src/dns/testdata/named.conf.4"));
+    for (int i = 0; i < 6; i++) {
+        string s1 = cfg->GetZoneFilePath(dns_domains[i]);
+        EXPECT_TRUE(FileExists(s1.c_str()));
+    }
+
+    // no reconfig when named.conf doesnt change
+    cfg->UpdateNamedConf(NULL);
+    EXPECT_TRUE(cfg->IsReconfigPending());
+    cfg->FlushNamedConf();
+    EXPECT_EQ(count + 1, cfg->reconfig_count());
+
+    // zone files are removed when the delete is applied
+    boost::replace_all(content, "<config>", "<delete>");
+    boost::replace_all(content, "</config>", "</delete>");
+    EXPECT_TRUE(parser_.Parse(content));
+    task_util::WaitForIdle();
+    cfg->FlushNamedConf();
+    EXPECT_EQ(count + 2, cfg->reconfig_count());
+    for (int i = 0; i < 6; i++) {
+        string s1 = cfg->GetZoneFilePath(dns_domains[i]);
+        EXPECT_FALSE(FileExists(s1.c_str()));
+    }
+    cfg->set_coalesce(false);
+}
+
 }  // namespace
 
 int main(int argc, char **argv) {
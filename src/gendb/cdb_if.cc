@@ -3,6 +3,7 @@
  */
 
 #include "cdb_if.h"
+#include <deque>
 #include <boost/bind.hpp>
 #include <boost/cast.hpp>
 #include <boost/lexical_cast.hpp>
@@ -37,6 +38,12 @@ namespace cassandra = ::org::apache::cassandra;
     CompositeType = 15,
  */
 
+const size_t CdbIf::max_read_connections;
+const size_t CdbIf::max_idle_read_connections;
+const uint32_t CdbIf::read_page_count_first;
+const uint32_t CdbIf::read_page_count_max;
+CdbIf::CdbIfReadPool CdbIf::read_pool_;
+
 CdbIf::CdbIfTypeMapDef CdbIf::CdbIfTypeMap =
     boost::assign::map_list_of
         (GenDb::DbDataType::AsciiType, CdbIf::CdbIfTypeInfo("AsciiType",
@@ -96,10 +103,13 @@ CdbIf::CdbIf(boost::asio::io_service *ioservice, DbErrorHandler errhandler,
     errhandler_(errhandler),
     db_init_done_(false),
     name_(name),
-    cassandra_ttl_(ttl) {
+    cassandra_ttl_(ttl),
+    cassandra_ip_(cassandra_ip),
+    cassandra_port_(cassandra_port) {
 }
 
-CdbIf::CdbIf()
+CdbIf::CdbIf() :
+    cassandra_port_(0)
 { }
 
 bool CdbIf::Db_IsInitDone() const {
@@ -140,6 +150,7 @@ bool CdbIf::Db_Init(std::string task_id, int task_instance) {
 }
 
 void CdbIf::Db_Uninit(bool shutdown) {
+    Db_CloseReadConnections();
     try {
         transport_->close();
     } catch (TTransportException &tx) {
@@ -1004,6 +1015,288 @@ bool CdbIf::Db_GetRangeSlices_Internal(GenDb::ColList& col_list,
     return true;
 }
 
+CdbIf::CdbIfReadConn *CdbIf::CdbIfReadPool::Get(
+        const std::string& cassandra_ip, unsigned short cassandra_port,
+        const std::string& keyspace) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    for (boost::ptr_vector<CdbIfReadConn>::iterator it = idle_.begin();
+            it != idle_.end(); it++) {
+        if (it->cassandra_ip_ == cassandra_ip &&
+                it->cassandra_port_ == cassandra_port &&
+                it->keyspace_ == keyspace) {
+            return idle_.release(it).release();
+        }
+    }
+    return NULL;
+}
+
+void CdbIf::CdbIfReadPool::Put(CdbIfReadConn *conn) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    if (idle_.size() >= max_idle_read_connections) {
+        delete conn;
+        return;
+    }
+    idle_.push_back(conn);
+}
+
+size_t CdbIf::CdbIfReadPool::size() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return idle_.size();
+}
+
+size_t CdbIf::Db_OpenReadConnections() {
+    while (read_conns_.size() < max_read_connections) {
+        CdbIfReadConn *idle = read_pool_.Get(cassandra_ip_, cassandra_port_,
+                tablespace_);
+        if (idle) {
+            read_conns_.push_back(idle);
+            continue;
+        }
+
+        std::auto_ptr<CdbIfReadConn> conn(
+                new CdbIfReadConn(cassandra_ip_, cassandra_port_, tablespace_));
+        try {
+            conn->transport_->open();
+            conn->client_->set_keyspace(tablespace_);
+        } catch (InvalidRequestException &tx) {
+            CDBIF_HANDLE_EXCEPTION(__func__ << ": InvalidRequestException: " << tx.why);
+            break;
+        } catch (TException &tx) {
+            CDBIF_HANDLE_EXCEPTION(__func__ << ": TException what: " << tx.what());
+            break;
+        }
+        read_conns_.push_back(conn.release());
+    }
+
+    return read_conns_.size();
+}
+
+void CdbIf::Db_ReleaseReadConnections() {
+    while (!read_conns_.empty()) {
+        read_pool_.Put(read_conns_.pop_back().release());
+    }
+}
+
+void CdbIf::Db_CloseReadConnections() {
+    /*
+     * a connection with a request in flight can not be reused, it is
+     * closed instead of going back to the pool
+     */
+    read_conns_.clear();
+}
+
+void CdbIf::Db_MultigetSlice(
+        std::map<std::string, std::vector<cassandra::ColumnOrSuperColumn> >& result,
+        const std::vector<std::string>& keys,
+        const cassandra::ColumnParent& cparent,
+        const cassandra::SlicePredicate& slicep) {
+    client_->multiget_slice(result, keys, cparent, slicep,
+            ConsistencyLevel::ONE);
+}
+
+void CdbIf::Db_SendGetSlice(size_t conn, const std::string& key,
+        const cassandra::ColumnParent& cparent,
+        const cassandra::SlicePredicate& slicep) {
+    read_conns_[conn].client_->send_get_slice(key, cparent, slicep,
+            ConsistencyLevel::ONE);
+}
+
+void CdbIf::Db_RecvGetSlice(size_t conn,
+        std::vector<cassandra::ColumnOrSuperColumn>& result) {
+    read_conns_[conn].client_->recv_get_slice(result);
+}
+
+void CdbIf::Db_SendRowRead(size_t conn, const CdbIfRowRead& read,
+        const cassandra::ColumnParent& cparent, cassandra::SliceRange slicer) {
+    // a page starts with the last column of the previous page
+    slicer.__set_start(read.start);
+    slicer.__set_count(read.count + 1);
+
+    cassandra::SlicePredicate slicep;
+    slicep.__set_slice_range(slicer);
+    Db_SendGetSlice(conn, read.key, cparent, slicep);
+}
+
+bool CdbIf::Db_GetMultiRowSlices(const std::string& cfname,
+        const std::vector<DbDataValueVec>& rowkeys,
+        const GenDb::ColumnNameRange& crange, DbGetColumnsCb cb) {
+    if (rowkeys.empty() || crange.count == 0) {
+        return true;
+    }
+
+    std::string start_string;
+    std::string finish_string;
+    if (!ConstructDbDataValueColumnName(start_string, cfname, crange.start_)) {
+        CDBIF_CONDCHECK_LOG_RETF(0);
+    }
+    if (!ConstructDbDataValueColumnName(finish_string, cfname, crange.finish_)) {
+        CDBIF_CONDCHECK_LOG_RETF(0);
+    }
+
+    for (size_t first = 0; first < rowkeys.size(); first += max_query_rows) {
+        size_t last = std::min(first + max_query_rows, rowkeys.size());
+        if (!Db_GetMultiRowSlicesBatch(cfname, rowkeys, first, last,
+                start_string, finish_string, crange.count, cb)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CdbIf::Db_GetMultiRowSlicesBatch(const std::string& cfname,
+        const std::vector<DbDataValueVec>& rowkeys, size_t first, size_t last,
+        const std::string& start_string, const std::string& finish_string,
+        uint32_t count, DbGetColumnsCb cb) {
+    std::vector<std::string> keys;
+    for (size_t row = first; row < last; row++) {
+        std::string key;
+        if (!ConstructDbDataValueKey(key, cfname, rowkeys[row])) {
+            CDBIF_CONDCHECK_LOG_RETF(0);
+        }
+        keys.push_back(key);
+    }
+
+    cassandra::SliceRange slicer;
+    slicer.__set_finish(finish_string);
+
+    cassandra::ColumnParent cparent;
+    cparent.column_family.assign(cfname);
+
+    /*
+     * the first page of all the rows is read with one multiget_slice, as
+     * most rows fit in it
+     */
+    uint32_t first_count = std::min(read_page_count_first, count);
+    std::map<std::string, std::vector<ColumnOrSuperColumn> > first_pages;
+    {
+        cassandra::SliceRange first_slicer(slicer);
+        first_slicer.__set_start(start_string);
+        first_slicer.__set_count(first_count);
+        cassandra::SlicePredicate slicep;
+        slicep.__set_slice_range(first_slicer);
+        try {
+            Db_MultigetSlice(first_pages, keys, cparent, slicep);
+        } catch (InvalidRequestException& ire) {
+            CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": InvalidRequestException: " << ire.why << "for cf: " << cfname);
+        } catch (UnavailableException& ue) {
+            CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": UnavailableException: " << ue.what() << "for cf: " << cfname);
+        } catch (TimedOutException& te) {
+            CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": TimedOutException: " << te.what() << "for cf: " << cfname);
+        } catch (TApplicationException& tx) {
+            CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": TApplicationException: " << tx.what() << "for cf: " << cfname);
+        } catch (TException& tx) {
+            CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": TException what: " << tx.what() << "for cf: " << cfname);
+        }
+    }
+
+    /*
+     * the rows with a full first page are read further on the read
+     * connections, with one row read in flight on each. The page size
+     * doubles on each full page so that the large rows take few round
+     * trips. The request for the next page, or the next row, is sent
+     * before the page received is decoded and passed to cb, so that the
+     * db works while the caller does
+     */
+    std::deque<CdbIfRowRead> pending;
+    for (size_t i = 0; i < keys.size(); i++) {
+        std::vector<ColumnOrSuperColumn>& result = first_pages[keys[i]];
+        if (result.size() == first_count && count > first_count) {
+            CdbIfRowRead read;
+            read.Reset(first + i, keys[i], result.back().column.name,
+                    first_count, count - first_count);
+            pending.push_back(read);
+        }
+    }
+
+    size_t conns = 0;
+    if (!pending.empty()) {
+        conns = Db_OpenReadConnections();
+        if (conns == 0) {
+            CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": no read connection for cf: " << cfname);
+        }
+    }
+
+    std::vector<CdbIfRowRead> reads(std::min(conns, pending.size()));
+    size_t in_flight = 0;
+    try {
+        for (size_t conn = 0; conn < reads.size(); conn++) {
+            reads[conn] = pending.front();
+            pending.pop_front();
+            Db_SendRowRead(conn, reads[conn], cparent, slicer);
+            in_flight++;
+        }
+
+        for (size_t i = 0; i < keys.size(); i++) {
+            GenDb::ColList col_list;
+            col_list.cfname_ = cfname;
+            col_list.rowkey_ = rowkeys[first + i];
+            CdbIf::ColListFromColumnOrSuper(col_list, first_pages[keys[i]],
+                    cfname);
+            cb(col_list);
+        }
+
+        for (size_t conn = 0; in_flight > 0;
+                conn = (conn + 1) % reads.size()) {
+            CdbIfRowRead& read = reads[conn];
+            if (!read.busy) {
+                continue;
+            }
+
+            std::vector<cassandra::ColumnOrSuperColumn> result;
+            Db_RecvGetSlice(conn, result);
+
+            bool page_full = (result.size() == read.count + 1);
+            if (!result.empty() && result.front().column.name == read.start) {
+                result.erase(result.begin());
+            }
+            if (result.size() > read.remaining) {
+                result.resize(read.remaining);
+            }
+            read.remaining -= result.size();
+            size_t row = read.row;
+
+            if (page_full && read.remaining > 0 && !result.empty()) {
+                read.Reset(read.row, read.key, result.back().column.name,
+                        read.count, read.remaining);
+                Db_SendRowRead(conn, read, cparent, slicer);
+            } else if (!pending.empty()) {
+                read = pending.front();
+                pending.pop_front();
+                Db_SendRowRead(conn, read, cparent, slicer);
+            } else {
+                read.busy = false;
+                in_flight--;
+            }
+
+            GenDb::ColList col_list;
+            col_list.cfname_ = cfname;
+            col_list.rowkey_ = rowkeys[row];
+            CdbIf::ColListFromColumnOrSuper(col_list, result, cfname);
+            cb(col_list);
+        }
+    } catch (InvalidRequestException& ire) {
+        Db_CloseReadConnections();
+        CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": InvalidRequestException: " << ire.why << "for cf: " << cfname);
+    } catch (UnavailableException& ue) {
+        Db_CloseReadConnections();
+        CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": UnavailableException: " << ue.what() << "for cf: " << cfname);
+    } catch (TimedOutException& te) {
+        Db_CloseReadConnections();
+        CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": TimedOutException: " << te.what() << "for cf: " << cfname);
+    } catch (TApplicationException& tx) {
+        Db_CloseReadConnections();
+        CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": TApplicationException: " << tx.what() << "for cf: " << cfname);
+    } catch (TException& tx) {
+        Db_CloseReadConnections();
+        CDBIF_HANDLE_EXCEPTION_RETF(__func__ << ": TException what: " << tx.what() << "for cf: " << cfname);
+    }
+
+    if (conns) {
+        Db_ReleaseReadConnections();
+    }
+    return true;
+}
+
 bool CdbIf::Db_GetQueueStats(uint64_t &queue_count, uint64_t &enqueues) const {
     if (!Db_IsInitDone()) {
         return false;
@@ -15,6 +15,7 @@
 #include <boost/function.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/ptr_container/ptr_map.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
 #include <tbb/task.h>
 #include <tbb/mutex.h>
@@ -92,8 +93,36 @@ class CdbIf : public GenDbIf {
                 const std::string& cfname,
                 const GenDb::ColumnNameRange& crange,
                 const GenDb::DbDataValueVec& key);
+        /* api to get range of column data for many rows. The first page
+         * of the rows is read with multiget_slice, the rest of the large
+         * rows in pages with a row read in flight on each of the read
+         * connections. The next page of a row is requested before cb is
+         * called with the current one
+         */
+        virtual bool Db_GetMultiRowSlices(const std::string& cfname,
+                const std::vector<GenDb::DbDataValueVec>& rowkeys,
+                const GenDb::ColumnNameRange& crange, DbGetColumnsCb cb);
         virtual bool Db_GetQueueStats(uint64_t &queue_count, uint64_t &enqueues) const;
 
+    protected:
+        /*
+         * read connections used by Db_GetMultiRowSlices, taken from the
+         * pool of the process or opened, and released to the pool after
+         * the read. Db_MultigetSlice, Db_SendGetSlice and Db_RecvGetSlice
+         * throw the thrift exceptions of the cassandra calls
+         */
+        virtual size_t Db_OpenReadConnections();
+        virtual void Db_ReleaseReadConnections();
+        virtual void Db_CloseReadConnections();
+        virtual void Db_MultigetSlice(
+                std::map<std::string, std::vector<ColumnOrSuperColumn> >& result,
+                const std::vector<std::string>& keys,
+                const ColumnParent& cparent, const SlicePredicate& slicep);
+        virtual void Db_SendGetSlice(size_t conn, const std::string& key,
+                const ColumnParent& cparent, const SlicePredicate& slicep);
+        virtual void Db_RecvGetSlice(size_t conn,
+                std::vector<ColumnOrSuperColumn>& result);
+
     private:
         friend class CdbIfTest;
 
@@ -109,6 +138,12 @@ class CdbIf : public GenDbIf {
 
         static const int max_query_rows = 5000;
         static const int PeriodicTimeSec = 10;
+        static const size_t max_read_connections = 4;
+        static const size_t max_idle_read_connections = 16;
+        /* page sizes of Db_GetMultiRowSlices. The first page is read with
+         * multiget_slice, the later ones double on each full page */
+        static const uint32_t read_page_count_first = 1000;
+        static const uint32_t read_page_count_max = 10000;
 
         typedef boost::function<std::string(const DbDataValue&)> Db_encode_composite_fn;
         typedef boost::function<DbDataValue(const char *input, int& used)> Db_decode_composite_fn;
@@ -154,6 +189,81 @@ class CdbIf : public GenDbIf {
         typedef boost::ptr_map<std::string, CdbIfCfInfo> CdbIfCfListType;
         CdbIfCfListType CdbIfCfList;
 
+        /*
+         * connection of the read pool
+         */
+        struct CdbIfReadConn {
+            CdbIfReadConn(const std::string& cassandra_ip,
+                    unsigned short cassandra_port,
+                    const std::string& keyspace) :
+                cassandra_ip_(cassandra_ip),
+                cassandra_port_(cassandra_port),
+                keyspace_(keyspace),
+                socket_(new TSocket(cassandra_ip, cassandra_port)),
+                transport_(new TFramedTransport(socket_)),
+                protocol_(new TBinaryProtocol(transport_)),
+                client_(new CassandraClient(protocol_)) {
+            }
+            ~CdbIfReadConn() {
+                transport_->close();
+            }
+
+            std::string cassandra_ip_;
+            unsigned short cassandra_port_;
+            std::string keyspace_;
+            shared_ptr<TTransport> socket_;
+            shared_ptr<TTransport> transport_;
+            shared_ptr<TProtocol> protocol_;
+            boost::scoped_ptr<CassandraClient> client_;
+        };
+
+        /*
+         * idle read connections of the process. The query engine creates
+         * a CdbIf for each query chunk, the connections are kept here for
+         * the next chunks
+         */
+        class CdbIfReadPool {
+        public:
+            /* idle connection to the keyspace, NULL if there is none */
+            CdbIfReadConn *Get(const std::string& cassandra_ip,
+                    unsigned short cassandra_port,
+                    const std::string& keyspace);
+            void Put(CdbIfReadConn *conn);
+            size_t size() const;
+
+        private:
+            mutable tbb::mutex mutex_;
+            boost::ptr_vector<CdbIfReadConn> idle_;
+        };
+        static CdbIfReadPool read_pool_;
+
+        /*
+         * state of a row read of Db_GetMultiRowSlices, after its first page
+         */
+        struct CdbIfRowRead {
+            CdbIfRowRead() : row(0), count(0), remaining(0), busy(false) {
+            }
+            /* read the page following the one ending with last_column */
+            void Reset(size_t row_index, const std::string& row_key,
+                    const std::string& last_column, uint32_t last_count,
+                    uint32_t remaining_count) {
+                row = row_index;
+                key = row_key;
+                start = last_column;
+                count = std::min(std::min(last_count * 2,
+                        read_page_count_max), remaining_count);
+                remaining = remaining_count;
+                busy = true;
+            }
+
+            size_t row;         /* index of the row key */
+            std::string key;
+            std::string start;  /* last column of the previous page */
+            uint32_t count;     /* new columns asked for in the page */
+            uint32_t remaining; /* columns left in the range */
+            bool busy;
+        };
+
         /*
          * structure for passing between sync and async add_column
          */
@@ -178,6 +288,13 @@ class CdbIf : public GenDbIf {
         bool DbDataValueVecToString(std::string&, const DbDataTypeVec&, const DbDataValueVec&);
         bool DbDataValueVecFromString(GenDb::DbDataValueVec&, const DbDataTypeVec&, const string&);
         bool ColListFromColumnOrSuper(GenDb::ColList&, std::vector<org::apache::cassandra::ColumnOrSuperColumn>&, const string&);
+        void Db_SendRowRead(size_t conn, const CdbIfRowRead& read,
+                const ColumnParent& cparent, SliceRange slicer);
+        bool Db_GetMultiRowSlicesBatch(const std::string& cfname,
+                const std::vector<GenDb::DbDataValueVec>& rowkeys,
+                size_t first, size_t last, const std::string& start_string,
+                const std::string& finish_string, uint32_t count,
+                DbGetColumnsCb cb);
 
         bool Db_AsyncAddColumn(CdbIfColList *cl);
         bool Db_Columnfamily_present(const std::string& cfname);
@@ -233,6 +350,10 @@ class CdbIf : public GenDbIf {
         std::string name_;
 
         int cassandra_ttl_;
+
+        std::string cassandra_ip_;
+        unsigned short cassandra_port_;
+        boost::ptr_vector<CdbIfReadConn> read_conns_;
 };
 
 #endif
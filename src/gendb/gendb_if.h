@@ -100,6 +100,7 @@ struct ColumnNameRange {
 class GenDbIf {
     public:
         typedef boost::function<void(void)> DbErrorHandler;
+        typedef boost::function<void(ColList&)> DbGetColumnsCb;
 
         GenDbIf() {}
         virtual ~GenDbIf() {}
@@ -135,6 +136,13 @@ class GenDbIf {
         virtual bool Db_GetRangeSlices(ColList& col_list,
                 const std::string& cfname, const ColumnNameRange& crange,
                 const DbDataValueVec& key) = 0;
+        /* api to get range of column data for many rows, with the reads
+         * of the rows in flight together. The columns of each row are
+         * passed to cb in order, one page at a time
+         */
+        virtual bool Db_GetMultiRowSlices(const std::string& cfname,
+                const std::vector<DbDataValueVec>& keys,
+                const ColumnNameRange& crange, DbGetColumnsCb cb) = 0;
         virtual bool Db_GetQueueStats(uint64_t &queue_count, uint64_t &enqueues) const = 0;
 
         static GenDbIf *GenDbIfImpl(boost::asio::io_service *ioservice, DbErrorHandler hdlr, 
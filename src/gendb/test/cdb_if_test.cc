@@ -2,10 +2,124 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <boost/bind.hpp>
 #include "testing/gunit.h"
 #include "../cdb_if.h"
 #include "base/logging.h"
 
+//
+// CdbIf with the read connections served from an in memory table
+//
+class CdbIfReadMock : public CdbIf {
+public:
+    typedef std::map<std::string, std::string> Row;
+
+    explicit CdbIfReadMock(size_t conns) :
+        conns_(conns), pending_(conns), multigets_(0), sends_(0), recvs_(0),
+        releases_(0), closes_(0), in_flight_(0), max_in_flight_(0),
+        fail_recv_(0) {
+    }
+
+    Row &row(const std::string &key) { return table_[key]; }
+    const std::vector<int32_t> &counts() const { return counts_; }
+    size_t multigets() const { return multigets_; }
+    size_t sends() const { return sends_; }
+    size_t releases() const { return releases_; }
+    size_t closes() const { return closes_; }
+    size_t max_in_flight() const { return max_in_flight_; }
+    void set_fail_recv(size_t fail_recv) { fail_recv_ = fail_recv; }
+
+protected:
+    virtual size_t Db_OpenReadConnections() {
+        return conns_;
+    }
+    virtual void Db_ReleaseReadConnections() {
+        for (size_t conn = 0; conn < conns_; conn++) {
+            EXPECT_FALSE(pending_[conn].busy);
+        }
+        releases_++;
+    }
+    virtual void Db_CloseReadConnections() {
+        closes_++;
+        pending_.assign(conns_, Request());
+        in_flight_ = 0;
+    }
+    virtual void Db_MultigetSlice(
+            std::map<std::string, std::vector<ColumnOrSuperColumn> > &result,
+            const std::vector<std::string> &keys, const ColumnParent &cparent,
+            const SlicePredicate &slicep) {
+        multigets_++;
+        for (std::vector<std::string>::const_iterator it = keys.begin();
+             it != keys.end(); ++it) {
+            Slice(*it, slicep.slice_range, result[*it]);
+        }
+    }
+    virtual void Db_SendGetSlice(size_t conn, const std::string &key,
+            const ColumnParent &cparent, const SlicePredicate &slicep) {
+        // one request in flight on a connection
+        EXPECT_FALSE(pending_.at(conn).busy);
+        pending_[conn].busy = true;
+        pending_[conn].key = key;
+        pending_[conn].range = slicep.slice_range;
+        counts_.push_back(slicep.slice_range.count);
+        sends_++;
+        in_flight_++;
+        max_in_flight_ = std::max(max_in_flight_, in_flight_);
+    }
+    virtual void Db_RecvGetSlice(size_t conn,
+            std::vector<ColumnOrSuperColumn> &result) {
+        Request request = pending_.at(conn);
+        EXPECT_TRUE(request.busy);
+        pending_[conn].busy = false;
+        in_flight_--;
+        if (++recvs_ == fail_recv_) {
+            throw TimedOutException();
+        }
+        Slice(request.key, request.range, result);
+    }
+
+private:
+    struct Request {
+        Request() : busy(false) {
+        }
+        bool busy;
+        std::string key;
+        SliceRange range;
+    };
+
+    void Slice(const std::string &key, const SliceRange &range,
+               std::vector<ColumnOrSuperColumn> &result) {
+        const Row &row = table_[key];
+        Row::const_iterator it = range.start.empty() ? row.begin() :
+            row.lower_bound(range.start);
+        for (; it != row.end() && (int32_t)result.size() < range.count;
+             ++it) {
+            if (!range.finish.empty() && it->first > range.finish) {
+                break;
+            }
+            Column column;
+            column.__set_name(it->first);
+            column.__set_value(it->second);
+            ColumnOrSuperColumn cosc;
+            cosc.__set_column(column);
+            result.push_back(cosc);
+        }
+    }
+
+    size_t conns_;
+    std::vector<Request> pending_;
+    std::map<std::string, Row> table_;
+    std::vector<int32_t> counts_;
+    size_t multigets_;
+    size_t sends_;
+    size_t recvs_;
+    size_t releases_;
+    size_t closes_;
+    size_t in_flight_;
+    size_t max_in_flight_;
+    size_t fail_recv_;
+};
+
 class CdbIfTest : public ::testing::Test {
 public:
 
@@ -38,6 +152,58 @@ public:
         return cdbif_->Db_decode_Double_non_composite(testdouble_enc);
     }
 
+    static std::string ColumnName(int i) {
+        char name[16];
+        snprintf(name, sizeof(name), "c%06d", i);
+        return name;
+    }
+    // Table of rows keyed by T2, with columns c000000, c000001...
+    void AddReadTable(CdbIf *cdbif) {
+        std::string cfname("ReadTable");
+        GenDb::DbDataTypeVec key_type(1, GenDb::DbDataType::Unsigned32Type);
+        GenDb::DbDataTypeVec name_type(1, GenDb::DbDataType::AsciiType);
+        cdbif->CdbIfCfList.insert(cfname, new CdbIf::CdbIfCfInfo(new CfDef,
+            new GenDb::NewCf(cfname, key_type, name_type, name_type)));
+    }
+    void AddReadRow(CdbIfReadMock *cdbif, uint32_t t2, int columns) {
+        CdbIf *base = cdbif;
+        std::string key;
+        ASSERT_TRUE(base->ConstructDbDataValueKey(key, "ReadTable",
+            GenDb::DbDataValueVec(1, t2)));
+        CdbIfReadMock::Row &row = cdbif->row(key);
+        for (int i = 0; i < columns; i++) {
+            row[ColumnName(i)] = "v" + ColumnName(i);
+        }
+    }
+    void AddColumns(std::map<uint32_t, std::vector<std::string> > *rows,
+                    GenDb::ColList &col_list) {
+        EXPECT_EQ("ReadTable", col_list.cfname_);
+        std::vector<std::string> &names =
+            (*rows)[boost::get<uint32_t>(col_list.rowkey_.at(0))];
+        for (std::vector<GenDb::NewCol>::iterator it =
+             col_list.columns_.begin(); it != col_list.columns_.end(); ++it) {
+            names.push_back(boost::get<std::string>(it->name.at(0)));
+        }
+    }
+    typedef CdbIf::CdbIfReadConn ReadConn;
+    typedef CdbIf::CdbIfReadPool ReadPool;
+    static ReadConn *NewReadConn(const std::string &keyspace) {
+        return new ReadConn("127.0.0.1", 9160, keyspace);
+    }
+    static ReadPool &read_pool() {
+        return CdbIf::read_pool_;
+    }
+    static size_t max_idle_read_connections() {
+        return CdbIf::max_idle_read_connections;
+    }
+    void CheckRow(const std::vector<std::string> &names, int first,
+                  int count) {
+        ASSERT_EQ((size_t)count, names.size());
+        for (int i = 0; i < count; i++) {
+            EXPECT_EQ(ColumnName(first + i), names[i]);
+        }
+    }
+
 private:
     CdbIf *cdbif_;
 };
@@ -75,6 +241,157 @@ TEST_F(CdbIfTest, Test1) {
     }
 }
 
+// The first page of the rows is read with one multiget, the large rows in
+// pages growing up to the maximum, without missing or repeating a column
+TEST_F(CdbIfTest, MultiRowSlicesPaging) {
+    CdbIfReadMock cdbif(2);
+    AddReadTable(&cdbif);
+    AddReadRow(&cdbif, 1, 0);
+    AddReadRow(&cdbif, 2, 2500);
+    AddReadRow(&cdbif, 3, 25000);
+
+    std::vector<GenDb::DbDataValueVec> keys;
+    for (uint32_t t2 = 1; t2 <= 4; t2++) {
+        keys.push_back(GenDb::DbDataValueVec(1, t2));
+    }
+    GenDb::ColumnNameRange crange;
+    crange.count = 100000000;
+    std::map<uint32_t, std::vector<std::string> > rows;
+    EXPECT_TRUE(cdbif.Db_GetMultiRowSlices("ReadTable", keys, crange,
+        boost::bind(&CdbIfTest::AddColumns, this, &rows, _1)));
+
+    CheckRow(rows[1], 0, 0);
+    CheckRow(rows[2], 0, 2500);
+    CheckRow(rows[3], 0, 25000);
+    CheckRow(rows[4], 0, 0);
+
+    // 1000 in the multiget, then 2000 for the second row and 2000, 4000,
+    // 8000, 10000, 10000 for the large row, each with the last column of
+    // the previous page
+    EXPECT_EQ(1U, cdbif.multigets());
+    std::vector<int32_t> counts(cdbif.counts());
+    std::sort(counts.begin(), counts.end());
+    const int32_t expected[] = {2001, 2001, 4001, 8001, 10001, 10001};
+    EXPECT_EQ(std::vector<int32_t>(expected, expected + 6), counts);
+    EXPECT_EQ(2U, cdbif.max_in_flight());
+    EXPECT_EQ(1U, cdbif.releases());
+}
+
+// The column range and count are those of one row
+TEST_F(CdbIfTest, MultiRowSlicesRange) {
+    CdbIfReadMock cdbif(4);
+    AddReadTable(&cdbif);
+    AddReadRow(&cdbif, 1, 1000);
+    AddReadRow(&cdbif, 2, 1000);
+
+    std::vector<GenDb::DbDataValueVec> keys;
+    keys.push_back(GenDb::DbDataValueVec(1, (uint32_t)1));
+    keys.push_back(GenDb::DbDataValueVec(1, (uint32_t)2));
+    GenDb::ColumnNameRange crange;
+    crange.start_.push_back(ColumnName(10));
+    crange.finish_.push_back(ColumnName(509));
+    crange.count = 150;
+    std::map<uint32_t, std::vector<std::string> > rows;
+    EXPECT_TRUE(cdbif.Db_GetMultiRowSlices("ReadTable", keys, crange,
+        boost::bind(&CdbIfTest::AddColumns, this, &rows, _1)));
+    CheckRow(rows[1], 10, 150);
+    CheckRow(rows[2], 10, 150);
+
+    crange.count = 1000;
+    rows.clear();
+    EXPECT_TRUE(cdbif.Db_GetMultiRowSlices("ReadTable", keys, crange,
+        boost::bind(&CdbIfTest::AddColumns, this, &rows, _1)));
+    CheckRow(rows[1], 10, 500);
+    CheckRow(rows[2], 10, 500);
+
+    // The rows fit in the first page, no connection is used
+    EXPECT_EQ(2U, cdbif.multigets());
+    EXPECT_EQ(0U, cdbif.sends());
+    EXPECT_EQ(0U, cdbif.releases());
+}
+
+static void RecordSends(const CdbIfReadMock *cdbif,
+                        std::vector<size_t> *sends, GenDb::ColList &) {
+    sends->push_back(cdbif->sends());
+}
+
+// The next page, or the next row, is requested before a page is processed
+TEST_F(CdbIfTest, MultiRowSlicesReadAhead) {
+    CdbIfReadMock cdbif(1);
+    AddReadTable(&cdbif);
+    AddReadRow(&cdbif, 1, 2500);
+    AddReadRow(&cdbif, 2, 1500);
+
+    std::vector<GenDb::DbDataValueVec> keys;
+    keys.push_back(GenDb::DbDataValueVec(1, (uint32_t)1));
+    keys.push_back(GenDb::DbDataValueVec(1, (uint32_t)2));
+    GenDb::ColumnNameRange crange;
+    crange.count = 100000;
+    std::vector<size_t> sends;
+    EXPECT_TRUE(cdbif.Db_GetMultiRowSlices("ReadTable", keys, crange,
+        boost::bind(&RecordSends, &cdbif, &sends, _1)));
+    ASSERT_EQ(4U, sends.size());
+    EXPECT_EQ(1U, sends[0]);
+    EXPECT_EQ(1U, sends[1]);
+    EXPECT_EQ(2U, sends[2]);
+    EXPECT_EQ(2U, sends[3]);
+}
+
+// A failed read fails the call and closes the connections
+TEST_F(CdbIfTest, MultiRowSlicesError) {
+    CdbIfReadMock cdbif(2);
+    AddReadTable(&cdbif);
+    std::vector<GenDb::DbDataValueVec> keys;
+    for (uint32_t t2 = 1; t2 <= 4; t2++) {
+        AddReadRow(&cdbif, t2, 1500);
+        keys.push_back(GenDb::DbDataValueVec(1, t2));
+    }
+    GenDb::ColumnNameRange crange;
+    crange.count = 100000;
+    std::map<uint32_t, std::vector<std::string> > rows;
+    cdbif.set_fail_recv(2);
+    EXPECT_FALSE(cdbif.Db_GetMultiRowSlices("ReadTable", keys, crange,
+        boost::bind(&CdbIfTest::AddColumns, this, &rows, _1)));
+    EXPECT_EQ(1U, cdbif.closes());
+    EXPECT_EQ(0U, cdbif.releases());
+
+    // The next read opens the connections again
+    cdbif.set_fail_recv(0);
+    rows.clear();
+    EXPECT_TRUE(cdbif.Db_GetMultiRowSlices("ReadTable", keys, crange,
+        boost::bind(&CdbIfTest::AddColumns, this, &rows, _1)));
+    for (uint32_t t2 = 1; t2 <= 4; t2++) {
+        CheckRow(rows[t2], 0, 1500);
+    }
+    EXPECT_EQ(1U, cdbif.releases());
+}
+
+// The idle connections are reused for the same keyspace, up to a limit
+TEST_F(CdbIfTest, ReadPool) {
+    ReadPool &pool = read_pool();
+    EXPECT_EQ(0U, pool.size());
+    EXPECT_TRUE(pool.Get("127.0.0.1", 9160, "ContrailAnalytics") == NULL);
+
+    ReadConn *conn = NewReadConn("ContrailAnalytics");
+    pool.Put(conn);
+    pool.Put(NewReadConn("Other"));
+    EXPECT_EQ(2U, pool.size());
+    EXPECT_TRUE(pool.Get("127.0.0.2", 9160, "ContrailAnalytics") == NULL);
+    EXPECT_EQ(conn, pool.Get("127.0.0.1", 9160, "ContrailAnalytics"));
+    EXPECT_EQ(1U, pool.size());
+    delete conn;
+
+    for (size_t i = 0; i < 2 * max_idle_read_connections(); i++) {
+        pool.Put(NewReadConn("ContrailAnalytics"));
+    }
+    EXPECT_EQ(max_idle_read_connections(), pool.size());
+    while ((conn = pool.Get("127.0.0.1", 9160, "ContrailAnalytics"))) {
+        delete conn;
+    }
+    delete pool.Get("127.0.0.1", 9160, "Other");
+    EXPECT_EQ(0U, pool.size());
+}
+
 int main(int argc, char **argv) {
     LoggingInit();
     ::testing::InitGoogleTest(&argc, argv);
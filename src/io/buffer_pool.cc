@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "io/buffer_pool.h"
+
+#include <vector>
+
+#include "io/io_types.h"
+
+BufferPool::BufferPool() {
+    for (int i = 0; i < kSizeClasses; i++) {
+        free_count_[i] = 0;
+    }
+}
+
+BufferPool::~BufferPool() {
+    Purge();
+}
+
+// Not destroyed on exit, since sessions may still release buffers from
+// static destructors.
+BufferPool *BufferPool::GetInstance() {
+    static BufferPool *pool = new BufferPool();
+    return pool;
+}
+
+int BufferPool::SizeClass(size_t size) {
+    for (int i = 0; i < kSizeClasses; i++) {
+        if (size <= ClassSize(i)) return i;
+    }
+    return -1;
+}
+
+uint8_t *BufferPool::Allocate(size_t size) {
+    stats_.allocations++;
+    stats_.in_use++;
+
+    int size_class = SizeClass(size);
+    if (size_class < 0) {
+        stats_.heap_allocations++;
+        return new uint8_t[size];
+    }
+
+    uint8_t *data;
+    if (free_list_[size_class].try_pop(data)) {
+        free_count_[size_class]--;
+        stats_.pool_hits++;
+        return data;
+    }
+    stats_.heap_allocations++;
+    return new uint8_t[ClassSize(size_class)];
+}
+
+void BufferPool::Free(uint8_t *data, size_t size) {
+    stats_.in_use--;
+
+    int size_class = SizeClass(size);
+    if (size_class < 0 ||
+        free_count_[size_class] * ClassSize(size_class) >= kMaxFreeBytes) {
+        stats_.heap_frees++;
+        delete[] data;
+        return;
+    }
+    free_count_[size_class]++;
+    free_list_[size_class].push(data);
+}
+
+void BufferPool::Purge() {
+    for (int i = 0; i < kSizeClasses; i++) {
+        uint8_t *data;
+        while (free_list_[i].try_pop(data)) {
+            free_count_[i]--;
+            stats_.heap_frees++;
+            delete[] data;
+        }
+    }
+}
+
+size_t BufferPool::FreeCount(int size_class) const {
+    return free_count_[size_class];
+}
+
+size_t BufferPool::FreeBytes() const {
+    size_t bytes = 0;
+    for (int i = 0; i < kSizeClasses; i++) {
+        bytes += free_count_[i] * ClassSize(i);
+    }
+    return bytes;
+}
+
+void BufferPool::FillResponse(IoBufferPoolResp *resp) const {
+    resp->set_allocations(stats_.allocations);
+    resp->set_pool_hits(stats_.pool_hits);
+    resp->set_heap_allocations(stats_.heap_allocations);
+    resp->set_heap_frees(stats_.heap_frees);
+    resp->set_in_use(stats_.in_use);
+    resp->set_free_bytes(FreeBytes());
+
+    std::vector<IoBufferPoolClass> classes;
+    for (int i = 0; i < kSizeClasses; i++) {
+        IoBufferPoolClass size_class;
+        size_class.set_size(ClassSize(i));
+        size_class.set_free_buffers(FreeCount(i));
+        classes.push_back(size_class);
+    }
+    resp->set_classes(classes);
+}
+
+void IoBufferPoolReq::HandleRequest() const {
+    IoBufferPoolResp *resp = new IoBufferPoolResp;
+    BufferPool::GetInstance()->FillResponse(resp);
+    resp->set_context(context());
+    resp->Response();
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __IO_BUFFER_POOL_H__
+#define __IO_BUFFER_POOL_H__
+
+#include <tbb/atomic.h>
+#include <tbb/concurrent_queue.h>
+
+#include "base/util.h"
+
+class IoBufferPoolResp;
+
+// BufferPool
+//
+// Pool of the socket receive and send buffers, shared by all the TCP
+// sessions and UDP servers of the process. Buffers are kept in power of two
+// size classes from kMinBufferSize to kMaxBufferSize, larger ones are
+// allocated from the heap.
+//
+// Concurrency: buffers are typically allocated from the event manager thread
+// and freed from a task, so the free lists are lock-free queues rather than
+// per-thread caches. Up to kMaxFreeBytes are kept per size class.
+class BufferPool {
+public:
+    static const size_t kMinBufferSize = 512;
+    static const size_t kMaxBufferSize = 64 * 1024;
+    static const size_t kMaxFreeBytes = 4 * 1024 * 1024;
+    static const int kSizeClasses = 8;
+
+    struct Stats {
+        Stats() {
+            allocations = 0;
+            pool_hits = 0;
+            heap_allocations = 0;
+            heap_frees = 0;
+            in_use = 0;
+        }
+        tbb::atomic<uint64_t> allocations;
+        tbb::atomic<uint64_t> pool_hits;
+        tbb::atomic<uint64_t> heap_allocations;
+        tbb::atomic<uint64_t> heap_frees;
+        tbb::atomic<uint64_t> in_use;
+    };
+
+    BufferPool();
+    ~BufferPool();
+
+    static BufferPool *GetInstance();
+
+    // Returns storage for at least size bytes. It must be returned with Free
+    // with the same size.
+    uint8_t *Allocate(size_t size);
+    void Free(uint8_t *data, size_t size);
+
+    // Release the free buffers to the heap.
+    void Purge();
+
+    const Stats &stats() const { return stats_; }
+    size_t FreeCount(int size_class) const;
+    size_t FreeBytes() const;
+    static size_t ClassSize(int size_class) {
+        return kMinBufferSize << size_class;
+    }
+    void FillResponse(IoBufferPoolResp *resp) const;
+
+private:
+    typedef tbb::concurrent_queue<uint8_t *> FreeList;
+
+    // Returns -1 if size is larger than kMaxBufferSize.
+    static int SizeClass(size_t size);
+
+    FreeList free_list_[kSizeClasses];
+    tbb::atomic<size_t> free_count_[kSizeClasses];
+    Stats stats_;
+
+    DISALLOW_COPY_AND_ASSIGN(BufferPool);
+};
+
+#endif  // __IO_BUFFER_POOL_H__
@@ -3,15 +3,25 @@
  */
 
 #include "io/event_manager.h"
+
+#include <pthread.h>
+#include <vector>
+
 #include "base/logging.h"
+#include "base/task.h"
 #include "io/io_log.h"
 
 using namespace boost::asio;
 
 SandeshTraceBufferPtr IOTraceBuf(SandeshTraceBufferCreate(IO_TRACE_BUF, 1000));
 
-EventManager::EventManager() {
+EventManager::EventManager(int shards) {
     shutdown_ = false;
+    next_shard_ = 0;
+    SetShardCount(shards);
+}
+
+EventManager::~EventManager() {
 }
 
 void EventManager::Shutdown() {
@@ -19,10 +29,65 @@ void EventManager::Shutdown() {
 
     // TODO: make sure that are no users of this event manager.
     io_service_.stop();
+    for (size_t i = 0; i < shards_.size(); i++) {
+        shards_[i].stop();
+    }
+}
+
+void EventManager::SetShardCount(int shards) {
+    while (shard_count() < shards) {
+        shards_.push_back(new boost::asio::io_service());
+    }
+}
+
+io_service *EventManager::io_service(int shard) {
+    if (shard == 0) return &io_service_;
+    return &shards_[shard - 1];
+}
+
+io_service *EventManager::ShardIoService() {
+    if (shards_.empty()) return &io_service_;
+    return io_service(next_shard_.fetch_and_increment() % shard_count());
+}
+
+struct ShardThreadArg {
+    EventManager *evm;
+    boost::asio::io_service *service;
+};
+
+void *EventManager::ShardThreadRun(void *arg) {
+    ShardThreadArg *shard_arg = reinterpret_cast<ShardThreadArg *>(arg);
+    shard_arg->evm->RunShard(shard_arg->service);
+    delete shard_arg;
+    return NULL;
+}
+
+// Runs an additional shard. Handlers enqueue tasks, so the thread needs its
+// own tbb scheduler like the thread calling Run.
+void EventManager::RunShard(boost::asio::io_service *service) {
+    tbb::task_scheduler_init init(TaskScheduler::GetThreadCount() + 1);
+    io_service::work work(*service);
+    if (shutdown_) return;
+    boost::system::error_code ec;
+    service->run(ec);
+    if (ec) {
+        EVENT_MANAGER_LOG_ERROR("io_service run failed: " << ec.message());
+    }
 }
 
 void EventManager::Run() {
     assert(mutex_.try_lock());
+    std::vector<pthread_t> threads;
+    for (size_t i = 0; i < shards_.size(); i++) {
+        ShardThreadArg *arg = new ShardThreadArg;
+        arg->evm = this;
+        arg->service = &shards_[i];
+        pthread_t thread_id;
+        int res = pthread_create(&thread_id, NULL, &ShardThreadRun, arg);
+        assert(res == 0);
+        threads.push_back(thread_id);
+    }
+
     io_service::work work(io_service_);
     do {
         if (shutdown_) break;
@@ -33,6 +98,10 @@ void EventManager::Run() {
             continue;
         }
     } while(0);
+
+    for (size_t i = 0; i < threads.size(); i++) {
+        pthread_join(threads[i], NULL);
+    }
     mutex_.unlock();
 }
 
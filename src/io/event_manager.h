@@ -5,6 +5,8 @@
 #pragma once
 
 #include <boost/asio/io_service.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
+#include <tbb/atomic.h>
 #include <tbb/spin_mutex.h>
 
 #include "base/util.h"
@@ -18,9 +20,19 @@
 // Poll directly or indirectly after having started a ServerThread (which
 // calls Run).
 //
+// The EventManager can be created with more than one shard, or given more
+// with SetShardCount before Run. Each additional shard is an io_service run
+// by its own thread, started and joined by Run. TcpServer spreads its
+// accepted sessions across the shards with ShardIoService, so that all the
+// handlers of a session run on the same thread. Timers that belong to a
+// session must be created on the io_service of its socket. Everything else
+// created with io_service() stays on shard 0, which is run by the thread
+// calling Run. RunOnce and Poll only run shard 0.
+//
 class EventManager {
 public:
-    EventManager();
+    explicit EventManager(int shards = 1);
+    ~EventManager();
 
     // Run until shutdown.
     void Run();
@@ -35,8 +47,20 @@ public:
 
     boost::asio::io_service *io_service() { return &io_service_; }
 
+    int shard_count() const { return shards_.size() + 1; }
+    // Adds shards up to the given count. Must be called before Run.
+    void SetShardCount(int shards);
+    boost::asio::io_service *io_service(int shard);
+    // Returns the io_service of the next shard, in round robin order.
+    boost::asio::io_service *ShardIoService();
+
 private:
+    static void *ShardThreadRun(void *arg);
+    void RunShard(boost::asio::io_service *service);
+
     boost::asio::io_service io_service_;
+    boost::ptr_vector<boost::asio::io_service> shards_;
+    tbb::atomic<uint32_t> next_shard_;
     bool shutdown_;
     tbb::spin_mutex mutex_;
 
@@ -4,6 +4,8 @@
 
 #include "io/tcp_message_write.h"
 
+#include <vector>
+
 #include "base/util.h"
 #include "base/logging.h"
 #include "io/tcp_session.h"
@@ -14,7 +16,8 @@ using namespace boost::system;
 using tbb::mutex;
 
 TcpMessageWriter::TcpMessageWriter(Socket *socket, TcpSession *session) :
-    socket_(socket), offset_(0), session_(session) {
+    socket_(socket), offset_(0), tail_capacity_(0), queued_bytes_(0),
+    corked_(false), blocked_(false), session_(session) {
 }
 
 TcpMessageWriter::~TcpMessageWriter() {
@@ -35,31 +38,52 @@ int TcpMessageWriter::Send(const uint8_t *data, size_t len, error_code &ec) {
     session_->server_->stats_.write_calls++;
     session_->server_->stats_.write_bytes += len;
 
-    if (buffer_queue_.empty()) {
-        wrote = socket_->write_some(boost::asio::buffer(data, len), ec);
-        if (TcpSession::IsSocketErrorHard(ec)) return -1;
-        assert(wrote >= 0);
-
-        if ((size_t)wrote != len) {
-            TCP_SESSION_LOG_UT_DEBUG(session_, TCP_DIR_OUT,
-                "Encountered partial send of " << wrote << " bytes when "
-                "sending " << len << " bytes, Error: " << ec);
-            BufferAppend(data + wrote, len - wrote);
-            DeferWrite();
-        }
-    } else {
+    if (blocked_ || (!corked_ && !buffer_queue_.empty())) {
         TCP_SESSION_LOG_UT_DEBUG(session_, TCP_DIR_OUT,
             "Write not ready. Enqueue buffer (len = " << len << ") and return");
         BufferAppend(data, len);
+        return wrote;
+    }
+
+    if (corked_) {
+        BufferAppend(data, len);
+        if (queued_bytes_ < kMaxCorkBytes || FlushQueue(ec))
+            return len;
+        if (TcpSession::IsSocketErrorHard(ec)) return -1;
+        DeferWrite();
+        return wrote;
+    }
+
+    wrote = socket_->write_some(boost::asio::buffer(data, len), ec);
+    session_->stats_.write_syscalls++;
+    session_->server_->stats_.write_syscalls++;
+    if (TcpSession::IsSocketErrorHard(ec)) return -1;
+    assert(wrote >= 0);
+
+    if ((size_t)wrote != len) {
+        TCP_SESSION_LOG_UT_DEBUG(session_, TCP_DIR_OUT,
+            "Encountered partial send of " << wrote << " bytes when "
+            "sending " << len << " bytes, Error: " << ec);
+        BufferAppend(data + wrote, len - wrote);
+        DeferWrite();
     }
     return wrote;
 }
 
+bool TcpMessageWriter::Uncork(error_code &ec) {
+    corked_ = false;
+    if (blocked_) return false;
+    if (FlushQueue(ec)) return true;
+    if (!TcpSession::IsSocketErrorHard(ec)) DeferWrite();
+    return false;
+}
+
 void TcpMessageWriter::DeferWrite() {
 
     // Update socket write block count.
     session_->stats_.write_blocked++;
     session_->server_->stats_.write_blocked++;
+    blocked_ = true;
     socket_->async_write_some(
         boost::asio::null_buffers(), 
         boost::bind(&TcpMessageWriter::HandleWriteReady, this,
@@ -89,29 +113,19 @@ void TcpMessageWriter::HandleWriteReady(TcpSessionPtr session_ptr,
     //
     if (session_->IsClosedLocked()) return;
 
-    while (!buffer_queue_.empty()) {
-        boost::asio::mutable_buffer head = buffer_queue_.front();
-        const uint8_t *data = buffer_cast<const uint8_t *>(head) + offset_;
-        int remaining = buffer_size(head) - offset_;
+    {
         error_code ec;
-        int wrote = socket_->write_some(buffer(data, remaining), ec);
-        if (TcpSession::IsSocketErrorHard(ec)) {
-            lock.release();
-            if (!cb_.empty()) cb_(ec);
-            return;
-        }
-        assert(wrote >= 0);
-        if (wrote != remaining) {
-            offset_ += wrote;
+        if (!FlushQueue(ec)) {
+            if (TcpSession::IsSocketErrorHard(ec)) {
+                lock.release();
+                if (!cb_.empty()) cb_(ec);
+                return;
+            }
             DeferWrite();
             return;
-        } else {
-            offset_ = 0;
-            DeleteBuffer(head);
-            buffer_queue_.pop_front();
         }
     }
-    buffer_queue_.clear();
+    blocked_ = false;
 
 done:
     lock.release();
@@ -124,8 +138,73 @@ done:
     return;
 }
 
+// Write the queue with one writev per kMaxGatherBuffers chunks. Returns
+// false if the socket did not take all the data or failed.
+bool TcpMessageWriter::FlushQueue(error_code &ec) {
+    std::vector<const_buffer> iov;
+    iov.reserve(kMaxGatherBuffers);
+    while (!buffer_queue_.empty()) {
+        iov.clear();
+        size_t total = 0;
+        int skip = offset_;
+        for (BufferQueue::const_iterator iter = buffer_queue_.begin();
+             iter != buffer_queue_.end() && iov.size() < kMaxGatherBuffers;
+             ++iter) {
+            const uint8_t *data = buffer_cast<const uint8_t *>(*iter) + skip;
+            size_t size = buffer_size(*iter) - skip;
+            skip = 0;
+            iov.push_back(const_buffer(data, size));
+            total += size;
+        }
+
+        size_t wrote = socket_->write_some(iov, ec);
+        session_->stats_.write_syscalls++;
+        session_->server_->stats_.write_syscalls++;
+        if (TcpSession::IsSocketErrorHard(ec)) return false;
+        BufferConsume(wrote);
+        if (wrote != total) return false;
+    }
+    return true;
+}
+
+// Release the chunks that have been written.
+void TcpMessageWriter::BufferConsume(size_t bytes) {
+    queued_bytes_ -= bytes;
+    while (bytes) {
+        mutable_buffer head = buffer_queue_.front();
+        size_t remaining = buffer_size(head) - offset_;
+        if (bytes < remaining) {
+            offset_ += bytes;
+            return;
+        }
+        bytes -= remaining;
+        offset_ = 0;
+        DeleteBuffer(head);
+        buffer_queue_.pop_front();
+    }
+    if (buffer_queue_.empty()) tail_capacity_ = 0;
+}
+
+// Copy the data to the tail chunk of the queue, allocating a new chunk if
+// it does not fit.
 void TcpMessageWriter::BufferAppend(const uint8_t *src, int bytes) {
-    u_int8_t *data = new u_int8_t[bytes];
+    session_->stats_.write_bytes_copied += bytes;
+    session_->server_->stats_.write_bytes_copied += bytes;
+    queued_bytes_ += bytes;
+
+    if (!buffer_queue_.empty()) {
+        mutable_buffer &tail = buffer_queue_.back();
+        size_t size = buffer_size(tail);
+        if (size + bytes <= tail_capacity_) {
+            u_int8_t *data = buffer_cast<u_int8_t *>(tail);
+            memcpy(data + size, src, bytes);
+            tail = mutable_buffer(data, size + bytes);
+            return;
+        }
+    }
+
+    tail_capacity_ = ((size_t) bytes > kChunkSize) ? bytes : kChunkSize;
+    u_int8_t *data = new u_int8_t[tail_capacity_];
     memcpy(data, src, bytes);
     mutable_buffer buffer = mutable_buffer(data, bytes);
     buffer_queue_.push_back(buffer);
@@ -18,16 +18,33 @@ using namespace boost::system;
 
 class TcpSession;
 
+// Pending data is kept in a queue of heap chunks, small messages being
+// packed into the tail chunk, and written out with a single writev of up to
+// kMaxGatherBuffers chunks.
+//
+// While corked, Send only appends to the queue and the data is written on
+// Uncork, or as soon as kMaxCorkBytes are queued. This lets a sender with a
+// batch of small messages write them with one system call.
 class TcpMessageWriter {
 public:
     typedef boost::asio::ip::tcp::socket Socket;
     static const int kDefaultBufferSize = 4 * 1024;
+    static const size_t kChunkSize = 16 * 1024;
+    static const size_t kMaxCorkBytes = 64 * 1024;
+    static const size_t kMaxGatherBuffers = 64;
     explicit TcpMessageWriter(Socket *, TcpSession *session);
     ~TcpMessageWriter();
 
-    // return false for send  
+    // Returns the number of bytes accepted, or -1 on a hard socket error.
+    // Bytes that are queued while corked count as accepted.
     int Send(const uint8_t *msg, size_t len, error_code &ec);
 
+    void Cork() { corked_ = true; }
+    // Write the data queued while corked. Returns false if the socket
+    // blocked, or failed in which case ec is set.
+    bool Uncork(error_code &ec);
+    bool corked() const { return corked_; }
+
     typedef boost::function<void(const error_code &ec)> SendReadyCb;
     void RegisterNotification(SendReadyCb);
 
@@ -36,6 +53,8 @@ private:
     typedef std::list<boost::asio::mutable_buffer> BufferQueue;
     void BufferAppend(const uint8_t *data, int len);
     void DeleteBuffer(boost::asio::mutable_buffer buffer); 
+    bool FlushQueue(error_code &ec);
+    void BufferConsume(size_t bytes);
     void DeferWrite();
     void HandleWriteReady(TcpSessionPtr session_ref, const error_code &ec,
                           uint64_t block_start_time);
@@ -44,6 +63,10 @@ private:
     SendReadyCb cb_;
     Socket *socket_;
     int offset_;
+    size_t tail_capacity_;      // allocated size of buffer_queue_.back()
+    size_t queued_bytes_;
+    bool corked_;
+    bool blocked_;              // waiting for the socket to be writable
     TcpSession *session_;
 };
 
@@ -196,12 +196,17 @@ void TcpServer::AsyncAccept() {
     if (acceptor_ == NULL) {
         return;
     }
-    so_accept_.reset(new Socket(*evm_->io_service()));
+    // The session handlers run on the shard of the socket.
+    so_accept_.reset(new Socket(*AcceptIoService()));
     acceptor_->async_accept(*so_accept_.get(),
         boost::bind(&TcpServer::AcceptHandlerInternal, this,
             TcpServerPtr(this), boost::asio::placeholders::error));
 }
 
+boost::asio::io_service *TcpServer::AcceptIoService() {
+    return evm_->ShardIoService();
+}
+
 int TcpServer::GetPort() const {
     mutex::scoped_lock lock(mutex_);
     if (acceptor_.get() == NULL) {
@@ -402,6 +407,11 @@ void TcpServer::SocketStats::GetTxStats(TcpServerSocketStats &socket_stats) cons
                      write_blocked_duration_usecs/
                      write_blocked);
     }
+    socket_stats.syscalls = write_syscalls;
+    if (write_calls) {
+        socket_stats.average_syscalls = (double) write_syscalls/write_calls;
+    }
+    socket_stats.bytes_copied = write_bytes_copied;
 }
 
 void TcpServer::GetTxSocketStats(TcpServerSocketStats &socket_stats) const {
@@ -44,7 +44,8 @@ class TcpServer {
 
     // Helper function that allocates a socket and calls the virtual method
     // AllocSession. The session object is owned by the TcpServer and must
-    // be deallocated via DeleteSession.
+    // be deallocated via DeleteSession. The socket is created on the main
+    // io_service of the event manager.
     virtual TcpSession *CreateSession();
 
     // Delete a session object.
@@ -64,6 +65,8 @@ class TcpServer {
             write_bytes = 0;
             write_blocked = 0;
             write_blocked_duration_usecs = 0;
+            write_syscalls = 0;
+            write_bytes_copied = 0;
         }
 
         void GetRxStats(TcpServerSocketStats &socket_stats) const;
@@ -75,6 +78,10 @@ class TcpServer {
         tbb::atomic<uint64_t> write_bytes;
         tbb::atomic<uint64_t> write_blocked;
         tbb::atomic<uint64_t> write_blocked_duration_usecs;
+        // write_some calls on the socket, one per writev when gathering
+        tbb::atomic<uint64_t> write_syscalls;
+        // bytes copied into the writer queue while blocked or corked
+        tbb::atomic<uint64_t> write_bytes_copied;
     };
     const SocketStats &GetSocketStats() const { return stats_; }
 
@@ -113,6 +120,10 @@ class TcpServer {
     //
     virtual bool AcceptSession(TcpSession *session);
 
+    // io_service of the socket for the next passively accepted session.
+    // The sessions are spread across the event manager shards by default.
+    virtual boost::asio::io_service *AcceptIoService();
+
     Endpoint LocalEndpoint() const;
 
   private:
@@ -12,6 +12,7 @@
 #include "base/logging.h"
 #include "base/task.h"
 #include "base/util.h"
+#include "io/buffer_pool.h"
 #include "io/event_manager.h"
 #include "io/tcp_server.h"
 #include "io/tcp_message_write.h"
@@ -21,6 +22,7 @@ using namespace boost::asio;
 using namespace boost::system;
 using namespace std;
 using tbb::mutex;
+using tbb::spin_mutex;
 
 int TcpSession::reader_task_id_ = -1;
 
@@ -51,6 +53,7 @@ TcpSession::TcpSession(
       socket_(socket),
       read_on_connect_(async_read_ready),
       buffer_size_(kDefaultBufferSize),
+      small_reads_(0),
       established_(false),
       closed_(false),
       direction_(ACTIVE),
@@ -75,10 +78,10 @@ TcpSession::~TcpSession() {
 }
 
 mutable_buffer TcpSession::AllocateBuffer() {
-    u_int8_t *data = new u_int8_t[buffer_size_];
+    u_int8_t *data = BufferPool::GetInstance()->Allocate(buffer_size_);
     mutable_buffer buffer = mutable_buffer(data, buffer_size_);
     {
-        mutex::scoped_lock lock(mutex_);
+        spin_mutex::scoped_lock lock(buffer_mutex_);
         buffer_queue_.push_back(buffer);
     }
     return buffer;
@@ -86,7 +89,7 @@ mutable_buffer TcpSession::AllocateBuffer() {
 
 void TcpSession::DeleteBuffer(mutable_buffer buffer) {
     uint8_t *data = buffer_cast<uint8_t *>(buffer);
-    delete[] data;
+    BufferPool::GetInstance()->Free(data, buffer_size(buffer));
 }
 
 static int BufferCmp(const mutable_buffer &lhs, const const_buffer &rhs) {
@@ -102,27 +105,29 @@ static int BufferCmp(const mutable_buffer &lhs, const const_buffer &rhs) {
 }
 
 void TcpSession::ReleaseBuffer(Buffer buffer) {
-    mutex::scoped_lock lock(mutex_);
-    ReleaseBufferLocked(buffer);
+    ReleaseBufferInternal(buffer);
 }
 
-void TcpSession::ReleaseBufferLocked(Buffer buffer) {
-    for (BufferQueue::iterator iter = buffer_queue_.begin();
-         iter != buffer_queue_.end(); ++iter) {
-        if (BufferCmp(*iter, buffer) == 0) {
-            DeleteBuffer(*iter);
-            buffer_queue_.erase(iter);
-            return;
+void TcpSession::ReleaseBufferInternal(Buffer buffer) {
+    mutable_buffer head;
+    {
+        spin_mutex::scoped_lock lock(buffer_mutex_);
+        BufferQueue::iterator iter = buffer_queue_.begin();
+        for (; iter != buffer_queue_.end(); ++iter) {
+            if (BufferCmp(*iter, buffer) == 0) break;
         }
+        assert(iter != buffer_queue_.end());
+        head = *iter;
+        buffer_queue_.erase(iter);
     }
-    assert(false);
+    DeleteBuffer(head);
 }
 
 void TcpSession::AsyncReadStart() {
     mutable_buffer buffer = AllocateBuffer();
     mutex::scoped_lock lock(mutex_);
     if (!established_) {
-        ReleaseBufferLocked(buffer);
+        ReleaseBufferInternal(buffer);
         return;
     }
     socket_->async_read_some(mutable_buffers_1(buffer),
@@ -296,18 +301,41 @@ bool TcpSession::Send(const u_int8_t *data, size_t size, size_t *sent) {
     return ret;
 }
 
+void TcpSession::Cork() {
+    mutex::scoped_lock lock(mutex_);
+    if (!established_ || !socket_->non_blocking()) return;
+    writer_->Cork();
+}
+
+bool TcpSession::Uncork() {
+    mutex::scoped_lock lock(mutex_);
+    if (!writer_->corked()) return true;
+    if (!established_) return false;
+    boost::system::error_code error;
+    bool ret = writer_->Uncork(error);
+    lock.release();
+    if (IsSocketErrorHard(error)) {
+        TCP_SESSION_LOG_INFO(this, TCP_DIR_OUT,
+            "Write failed due to error: " << error.category().name() << " "
+                                          << error.message());
+        CloseInternal(true);
+        return false;
+    }
+    return ret;
+}
+
 void TcpSession::AsyncReadHandler(
     TcpSessionPtr session, mutable_buffer buffer,
     const boost::system::error_code &error, size_t bytes_transferred) {
 
     mutex::scoped_lock lock(session->mutex_);
     if (session->closed_) {
-        session->ReleaseBufferLocked(buffer);
+        session->ReleaseBufferInternal(buffer);
         return;
     }
 
     if (IsSocketErrorHard(error)) {
-        session->ReleaseBufferLocked(buffer);
+        session->ReleaseBufferInternal(buffer);
         TCP_SESSION_LOG_UT_DEBUG(session, TCP_DIR_IN,
                                  "Read failed due to error " << error.value()
                                      << " : " << error.message());
@@ -321,6 +349,7 @@ void TcpSession::AsyncReadHandler(
     session->stats_.read_bytes += bytes_transferred;
     session->server_->stats_.read_calls++;
     session->server_->stats_.read_bytes += bytes_transferred;
+    session->AdjustBufferSize(bytes_transferred);
 
     Buffer rdbuf(buffer_cast<const uint8_t *>(buffer), bytes_transferred);
     Reader *task = new Reader(
@@ -330,6 +359,25 @@ void TcpSession::AsyncReadHandler(
     scheduler->Enqueue(task);
 }
 
+// Double the read size when a read fills the buffer, and halve it back after
+// kReadShrinkCount consecutive reads that use less than a quarter of it.
+void TcpSession::AdjustBufferSize(size_t bytes_transferred) {
+    if (bytes_transferred == (size_t) buffer_size_) {
+        small_reads_ = 0;
+        if (buffer_size_ < kMaxBufferSize) buffer_size_ *= 2;
+        return;
+    }
+    if (buffer_size_ > kDefaultBufferSize &&
+        bytes_transferred < (size_t) buffer_size_ / 4) {
+        if (++small_reads_ >= kReadShrinkCount) {
+            buffer_size_ /= 2;
+            small_reads_ = 0;
+        }
+    } else {
+        small_reads_ = 0;
+    }
+}
+
 int TcpSession::GetSessionInstance() const {
     return Task::kTaskInstanceAny;
 }
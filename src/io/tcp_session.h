@@ -16,6 +16,7 @@
 #include <boost/scoped_ptr.hpp>
 
 #include <tbb/mutex.h>
+#include <tbb/spin_mutex.h>
 #include <tbb/task.h>
 #ifndef _LIBCPP_VERSION
 #include <tbb/compat/condition_variable>
@@ -36,6 +37,10 @@ class TcpMessageWriter;
 class TcpSession {
   public:
     static const int kDefaultBufferSize = 4 * 1024;
+    static const int kMaxBufferSize = 64 * 1024;
+    // Consecutive reads using less than a quarter of the buffer after which
+    // the read size is halved
+    static const int kReadShrinkCount = 16;
 
     enum Event {
         EVENT_NONE,
@@ -59,6 +64,13 @@ class TcpSession {
     // Performs a non-blocking send operation.
     virtual bool Send(const u_int8_t *data, size_t size, size_t *sent);
 
+    // Queue the data of subsequent Send calls until Uncork, so that a batch
+    // of messages is written with a single writev. Uncork returns false if
+    // the socket is blocked, in which case WriteReady is invoked once the
+    // queued data has been written.
+    void Cork();
+    bool Uncork();
+
     // Called by TcpServer to trigger async read.
     virtual bool Connected(Endpoint remote);
     
@@ -129,6 +141,7 @@ class TcpSession {
     void AsyncReadStart();
 
     const TcpServer::SocketStats &GetSocketStats() const { return stats_; }
+    int read_buffer_size() const { return buffer_size_; }
     void GetRxSocketStats(TcpServerSocketStats &socket_stats) const;
     void GetTxSocketStats(TcpServerSocketStats &socket_stats) const;
 
@@ -165,7 +178,8 @@ class TcpSession {
     static void AsyncWriteHandler(TcpSessionPtr session,
                                   const boost::system::error_code &error);
 
-    void ReleaseBufferLocked(Buffer buffer);
+    void ReleaseBufferInternal(Buffer buffer);
+    void AdjustBufferSize(size_t bytes_transferred);
     void CloseInternal(bool callObserver);
     void SetEstablished(Endpoint remote, Direction dir);
 
@@ -185,7 +199,8 @@ class TcpSession {
     TcpServer *server_;
     boost::scoped_ptr<Socket> socket_;
     bool read_on_connect_;
-    int buffer_size_;
+    int buffer_size_;           // Size of the next read, adjusted per read
+    int small_reads_;
 
     // Protects session state and buffer queue.
     mutable tbb::mutex mutex_;
@@ -195,9 +210,13 @@ class TcpSession {
     bool closed_;               // Close has been called.
     Endpoint remote_;           // Remote end-point
     Direction direction_;       // direction (active, passive)
-    BufferQueue buffer_queue_;
     /**************** end protected by mutex_ ****************/
 
+    // Protects the receive buffers, so that they can be released without
+    // taking the session mutex.
+    tbb::spin_mutex buffer_mutex_;
+    BufferQueue buffer_queue_;
+
     // Protects observer manipulation and invocation. When this lock is
     // held the session mutex should not be held and vice-versa.
     tbb::mutex obs_mutex_;
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "io/buffer_pool.h"
+
+#include <vector>
+
+#include "testing/gunit.h"
+
+#include "base/logging.h"
+
+class BufferPoolTest : public ::testing::Test {
+protected:
+    BufferPool pool_;
+};
+
+TEST_F(BufferPoolTest, Reuse) {
+    uint8_t *data = pool_.Allocate(1000);
+    EXPECT_EQ(1U, (uint64_t) pool_.stats().heap_allocations);
+    EXPECT_EQ(1U, (uint64_t) pool_.stats().in_use);
+    pool_.Free(data, 1000);
+    EXPECT_EQ(0U, (uint64_t) pool_.stats().in_use);
+    EXPECT_EQ(1U, pool_.FreeCount(1));
+
+    // Any size within the same class gets the buffer back.
+    uint8_t *data2 = pool_.Allocate(1024);
+    EXPECT_EQ(data, data2);
+    EXPECT_EQ(1U, (uint64_t) pool_.stats().pool_hits);
+    EXPECT_EQ(1U, (uint64_t) pool_.stats().heap_allocations);
+    EXPECT_EQ(0U, pool_.FreeCount(1));
+
+    // A different class does not.
+    uint8_t *data3 = pool_.Allocate(4096);
+    EXPECT_EQ(2U, (uint64_t) pool_.stats().heap_allocations);
+    pool_.Free(data2, 1024);
+    pool_.Free(data3, 4096);
+    EXPECT_EQ(1U, pool_.FreeCount(1));
+    EXPECT_EQ(1U, pool_.FreeCount(3));
+    EXPECT_EQ(1024U + 4096U, pool_.FreeBytes());
+
+    pool_.Purge();
+    EXPECT_EQ(0U, pool_.FreeBytes());
+    EXPECT_EQ(2U, (uint64_t) pool_.stats().heap_frees);
+}
+
+// Buffers larger than the largest class are not pooled.
+TEST_F(BufferPoolTest, Large) {
+    size_t size = BufferPool::kMaxBufferSize + 1;
+    uint8_t *data = pool_.Allocate(size);
+    pool_.Free(data, size);
+    EXPECT_EQ(0U, pool_.FreeBytes());
+    EXPECT_EQ(1U, (uint64_t) pool_.stats().heap_allocations);
+    EXPECT_EQ(1U, (uint64_t) pool_.stats().heap_frees);
+}
+
+// No more than kMaxFreeBytes are kept per class.
+TEST_F(BufferPoolTest, MaxFree) {
+    size_t size = BufferPool::kMaxBufferSize;
+    size_t count = BufferPool::kMaxFreeBytes / size;
+    std::vector<uint8_t *> buffers;
+    for (size_t i = 0; i < count + 10; i++) {
+        buffers.push_back(pool_.Allocate(size));
+    }
+    for (size_t i = 0; i < buffers.size(); i++) {
+        pool_.Free(buffers[i], size);
+    }
+    EXPECT_EQ(count, pool_.FreeCount(BufferPool::kSizeClasses - 1));
+    EXPECT_EQ(10U, (uint64_t) pool_.stats().heap_frees);
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -3,6 +3,7 @@
  */
 
 #include <memory>
+#include <vector>
 
 #include <pthread.h>
 #include <sys/types.h>
@@ -221,6 +222,87 @@ TEST_F(EchoServerTest, Basic) {
     client.Close();
 }
 
+// Messages sent while corked are written with a single writev on Uncork.
+TEST_F(EchoServerTest, Cork) {
+    server_->Initialize(0);
+    task_util::WaitForIdle();
+    thread_->Start();		// Must be called after initialization
+    int port = server_->GetPort();
+    ASSERT_LT(0, port);
+    TcpLocalClient client(port);
+    TASK_UTIL_EXPECT_TRUE(client.Connect());
+    TASK_UTIL_EXPECT_TRUE(server_->GetSession() != NULL);
+    EchoSession *session = server_->GetSession();
+    TASK_UTIL_EXPECT_TRUE(session->IsEstablished());
+
+    const int kCount = 100;
+    const char msg[] = "Test Message";
+    session->Cork();
+    for (int i = 0; i < kCount; i++) {
+        EXPECT_TRUE(session->Send((const u_int8_t *) msg, sizeof(msg), NULL));
+    }
+    const TcpServer::SocketStats &stats = session->GetSocketStats();
+    EXPECT_EQ((uint64_t) kCount, (uint64_t) stats.write_calls);
+    EXPECT_EQ(0U, (uint64_t) stats.write_syscalls);
+    EXPECT_EQ(kCount * sizeof(msg), (uint64_t) stats.write_bytes_copied);
+
+    EXPECT_TRUE(session->Uncork());
+    EXPECT_EQ(1U, (uint64_t) stats.write_syscalls);
+
+    u_int8_t data[kCount * sizeof(msg)];
+    size_t rlen = 0;
+    while (rlen < sizeof(data)) {
+        int len = client.Recv(data + rlen, sizeof(data) - rlen);
+        ASSERT_LT(0, len);
+        rlen += len;
+    }
+    for (int i = 0; i < kCount; i++) {
+        EXPECT_EQ(0, memcmp(data + i * sizeof(msg), msg, sizeof(msg)));
+    }
+
+    // Not corked, each message is written right away without a copy.
+    EXPECT_TRUE(session->Send((const u_int8_t *) msg, sizeof(msg), NULL));
+    EXPECT_EQ(2U, (uint64_t) stats.write_syscalls);
+    EXPECT_EQ(kCount * sizeof(msg), (uint64_t) stats.write_bytes_copied);
+
+    TcpServerSocketStats socket_stats;
+    session->GetTxSocketStats(socket_stats);
+    EXPECT_EQ(2U, socket_stats.syscalls);
+    EXPECT_EQ(kCount * sizeof(msg), socket_stats.bytes_copied);
+
+    client.Close();
+}
+
+// The read size grows while reads fill the receive buffer.
+TEST_F(EchoServerTest, ReadBufferSize) {
+    server_->Initialize(0);
+    task_util::WaitForIdle();
+    thread_->Start();		// Must be called after initialization
+    int port = server_->GetPort();
+    ASSERT_LT(0, port);
+    TcpLocalClient client(port);
+    TASK_UTIL_EXPECT_TRUE(client.Connect());
+    TASK_UTIL_EXPECT_TRUE(server_->GetSession() != NULL);
+    EchoSession *session = server_->GetSession();
+    EXPECT_EQ((int) TcpSession::kDefaultBufferSize,
+              session->read_buffer_size());
+
+    const size_t kSize = 256 * 1024;
+    std::vector<u_int8_t> msg(kSize, 0xab);
+    size_t sent = 0;
+    while (sent < kSize) {
+        int len = client.Send(&msg[sent], kSize - sent);
+        ASSERT_LT(0, len);
+        sent += len;
+    }
+    TASK_UTIL_EXPECT_EQ(kSize,
+        (size_t) session->GetSocketStats().read_bytes);
+    EXPECT_LT((int) TcpSession::kDefaultBufferSize,
+              session->read_buffer_size());
+
+    client.Close();
+}
+
 TEST_F(EchoServerTest, Connect) {
     EchoServer *client = new EchoServer(evm_.get());
 
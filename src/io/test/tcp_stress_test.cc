@@ -16,6 +16,7 @@
 #include <tbb/mutex.h>
 
 #include <algorithm> 
+#include <set>
 
 #include "testing/gunit.h"
 
@@ -534,6 +535,123 @@ TEST_P(EchoServerTest, ClientDisconnect) {
     }
     task_util::WaitForIdle();
 }
+
+//
+// Checks that the sessions of a server are spread across the event manager
+// shards and that all the data sent on them is received.
+//
+class ShardEchoServer : public EchoServer {
+public:
+    explicit ShardEchoServer(EventManager *evm) : EchoServer(evm) {
+    }
+    virtual bool AcceptSession(TcpSession *session) {
+        tbb::mutex::scoped_lock lock(mutex_);
+        accepted_.push_back(static_cast<EchoSession *>(session));
+        return true;
+    }
+    std::vector<EchoSession *> accepted() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return accepted_;
+    }
+    size_t accepted_count() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return accepted_.size();
+    }
+
+private:
+    tbb::mutex mutex_;
+    std::vector<EchoSession *> accepted_;
+};
+
+class EchoServerShardTest : public ::testing::TestWithParam<int> {
+protected:
+    static const int kConnections = 16;
+    static const int kMessages = 200;
+
+    EchoServerShardTest() : evm_(new EventManager(GetParam())) {
+    }
+
+    virtual void SetUp() {
+        server_ = new ShardEchoServer(evm_.get());
+        server_->Initialize(0);
+        client_ = new ShardEchoServer(evm_.get());
+        task_util::WaitForIdle();
+        thread_.reset(new ServerThread(evm_.get()));
+        thread_->Start();		// Must be called after initialization
+    }
+
+    virtual void TearDown() {
+        BOOST_FOREACH(TcpSession *session, sessions_) {
+            session->Close();
+            client_->DeleteSession(session);
+        }
+        task_util::WaitForIdle();
+        server_->Shutdown();
+        server_->ClearSessions();
+        client_->Shutdown();
+        client_->ClearSessions();
+        task_util::WaitForIdle();
+        TcpServerManager::DeleteServer(server_);
+        TcpServerManager::DeleteServer(client_);
+        evm_->Shutdown();
+        if (thread_.get() != NULL) {
+            thread_->Join();
+        }
+        task_util::WaitForIdle();
+    }
+
+    auto_ptr<EventManager> evm_;
+    auto_ptr<ServerThread> thread_;
+    ShardEchoServer *server_;
+    ShardEchoServer *client_;
+    std::vector<TcpSession *> sessions_;
+};
+
+TEST_P(EchoServerShardTest, Delivery) {
+    boost::asio::ip::tcp::endpoint target;
+    boost::system::error_code ec;
+    target.address(boost::asio::ip::address::from_string("127.0.0.1", ec));
+    target.port(server_->GetPort());
+    for (int i = 0; i < kConnections; i++) {
+        TcpSession *session = client_->CreateClientSession(false);
+        client_->Connect(session, target);
+        sessions_.push_back(session);
+    }
+    BOOST_FOREACH(TcpSession *session, sessions_) {
+        TASK_UTIL_EXPECT_TRUE(session->IsEstablished());
+    }
+    TASK_UTIL_EXPECT_EQ((size_t) kConnections, server_->accepted_count());
+    std::vector<EchoSession *> accepted = server_->accepted();
+
+    // The accepted sockets are handed out round robin, so they use every
+    // shard. The client sockets are on the main io_service.
+    std::set<boost::asio::io_service *> shards;
+    BOOST_FOREACH(TcpSession *session, sessions_) {
+        EXPECT_EQ(evm_->io_service(), &session->socket()->get_io_service());
+    }
+    BOOST_FOREACH(EchoSession *session, accepted) {
+        shards.insert(&session->socket()->get_io_service());
+    }
+    EXPECT_EQ((size_t) evm_->shard_count(), shards.size());
+
+    const int size = 4094;
+    for (int i = 0; i < kMessages; i++) {
+        BOOST_FOREACH(TcpSession *session, sessions_) {
+            session->Send((const u_int8_t *) msg, size, NULL);
+        }
+    }
+    BOOST_FOREACH(EchoSession *session, accepted) {
+        TASK_UTIL_EXPECT_EQ((uint32_t) kMessages * size, session->total_rx());
+    }
+    TASK_UTIL_EXPECT_EQ((uint64_t) kConnections * kMessages * size,
+        (uint64_t) server_->GetSocketStats().read_bytes);
+}
+
+static vector<int> n_shards = boost::assign::list_of(1)(2)(4);
+
+INSTANTIATE_TEST_CASE_P(TcpShard, EchoServerShardTest,
+                        ValuesIn(n_shards));
+
 }  // namespace
 
 static vector<int> n_servers = boost::assign::list_of(64);
@@ -2,6 +2,7 @@
 #include <boost/bind.hpp>
 #include <base/logging.h>
 #include "udp_server.h"
+#include "buffer_pool.h"
 #include "io_log.h"
 
 using namespace boost::asio;
@@ -102,20 +103,25 @@ udp::endpoint UDPServer::GetLocalEndPoint ()
     return socket_.local_endpoint (ec);
 }
 
+// The mutable_buffer object is placed in front of the data, so that both
+// come from a single pool buffer.
 mutable_buffer *UDPServer::AllocateBuffer (std::size_t s)
 {
-    return new mutable_buffer (new u_int8_t[s], s);
+    uint8_t *data = BufferPool::GetInstance()->Allocate(
+        sizeof(mutable_buffer) + s);
+    return new (data) mutable_buffer (data + sizeof(mutable_buffer), s);
 }
 
 mutable_buffer *UDPServer::AllocateBuffer ()
 {
-    return new mutable_buffer (new u_int8_t[buffer_size_], buffer_size_);
+    return AllocateBuffer (buffer_size_);
 }
 
 void UDPServer::DeallocateBuffer (mutable_buffer *buffer)
 {
-    delete[] buffer_cast<uint8_t *>(*buffer);
-    delete buffer;
+    std::size_t s = sizeof(mutable_buffer) + buffer_size(*buffer);
+    buffer->~mutable_buffer();
+    BufferPool::GetInstance()->Free(reinterpret_cast<uint8_t *>(buffer), s);
 }
 
 udp::endpoint *UDPServer::AllocateEndPoint (std::string ipaddress, short port)
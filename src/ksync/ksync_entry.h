@@ -91,6 +91,25 @@ public:
     // User define KSync Response handler
     virtual void Response() { };
 
+    // Used by the kernel audit. Return true if the entry read from kernel
+    // has the same content, so that ADD need not be sent
+    virtual bool IsAuditMatch(const KSyncEntry &kernel) const {
+        return false;
+    };
+
+    // Used by the kernel audit to order entries read from kernel. Entries
+    // keyed on pointers to other KSync entries or on agent state must
+    // override it with a key that is also known to the kernel
+    virtual bool IsAuditLess(const KSyncEntry &rhs) const {
+        return IsLess(rhs);
+    };
+
+    // Used by the kernel audit. Return false if ADD of the entry can't
+    // overwrite the kernel entry, so that the kernel entry is deleted first
+    virtual bool IsAuditOverwrite(const KSyncEntry &kernel) const {
+        return true;
+    };
+
     size_t GetIndex() const {return index_;};
     KSyncState GetState() const {return state_;};
     uint32_t GetRefCount() const {return refcount_;} 
@@ -27,6 +27,16 @@ public:
         return index;
     };
 
+    // Mark index read from kernel as used. Returns false if index is
+    // not free
+    bool Reserve(size_t index) {
+        if (index >= table_.size() || table_[index] == 0) {
+            return false;
+        }
+        table_.set(index, 0);
+        return true;
+    };
+
     void Free(size_t index) {
         assert(index < table_.size());
         assert(table_[index] == 0);
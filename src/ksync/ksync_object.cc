@@ -33,12 +33,17 @@ KSyncObjectManager *KSyncObjectManager::singleton_;
 KSyncObject::KSyncObject() : need_index_(false), index_table_() {
 }
 
-KSyncObject::KSyncObject(int max_index) : 
+KSyncObject::KSyncObject(int max_index) :
                          need_index_(true), index_table_(max_index) {
 }
 
 KSyncObject::~KSyncObject() {
     assert(tree_.size() == 0);
+    while (audit_tree_.empty() == false) {
+        KSyncEntry *entry = audit_tree_.begin().operator->();
+        audit_tree_.erase(*entry);
+        delete entry;
+    }
 }
 
 void KSyncObject::Shutdown() {
@@ -504,6 +509,11 @@ KSyncEntry::KSyncState KSyncSM_Add(KSyncObject *obj, KSyncEntry *entry) {
     }
 
     entry->SetSeen();
+    // Nothing to send if kernel already has the same entry
+    if (obj->AuditObject()->AuditClaim(entry)) {
+        return KSyncEntry::IN_SYNC;
+    }
+
     if (entry->Add()) {
         return KSyncEntry::IN_SYNC;
     } else {
@@ -1002,6 +1012,9 @@ void KSyncObject::NotifyEvent(KSyncEntry *entry, KSyncEntry::KSyncEvent event) {
 
 void KSyncObject::NetlinkAckInternal(KSyncEntry *entry, KSyncEntry::KSyncEvent event) {
     tbb::recursive_mutex::scoped_lock lock(lock_);
+    if (AuditAck(entry)) {
+        return;
+    }
     entry->Response();
     NotifyEvent(entry, event);
 }
@@ -1010,6 +1023,123 @@ void KSyncObject::NetlinkAck(KSyncEntry *entry, KSyncEntry::KSyncEvent event) {
     NetlinkAckInternal(entry, event);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Kernel audit routines
+//
+// Entries in audit_tree_ are not part of tree_ and never go through the
+// state machine. Their state is either INIT, or DEL_ACK_WAIT once the delete
+// is sent to kernel.
+///////////////////////////////////////////////////////////////////////////////
+KSyncEntry *KSyncObject::AuditFind(const KSyncEntry *key) {
+    // tree_ is ordered on IsLess. Kernel is read before the agent adds
+    // entries, so the tree is normally empty here
+    KSyncAuditCompare less;
+    for (Tree::iterator it = tree_.begin(); it != tree_.end(); it++) {
+        if (less(*it, *key) == false && less(*key, *it) == false) {
+            return it.operator->();
+        }
+    }
+    return NULL;
+}
+
+void KSyncObject::AuditAdd(KSyncEntry *entry) {
+    tbb::recursive_mutex::scoped_lock lock(lock_);
+    // Agent has already programmed the entry, kernel data is not needed
+    if (AuditFind(entry) != NULL ||
+        audit_tree_.find(*entry) != audit_tree_.end()) {
+        delete entry;
+        return;
+    }
+
+    // Index already taken by agent, the kernel entry is overwritten
+    if (need_index_ && entry->GetIndex() != KSyncEntry::kInvalidIndex &&
+        index_table_.Reserve(entry->GetIndex()) == false) {
+        delete entry;
+        return;
+    }
+    audit_tree_.insert(*entry);
+}
+
+void KSyncObject::AuditFree(KSyncEntry *entry) {
+    audit_tree_.erase(*entry);
+    if (need_index_ && entry->GetIndex() != KSyncEntry::kInvalidIndex) {
+        index_table_.Free(entry->GetIndex());
+    }
+    delete entry;
+}
+
+// Send delete of a kernel entry. Returns true if the entry is freed
+bool KSyncObject::AuditDelete(KSyncEntry *entry) {
+    KSYNC_TRACE(Event, entry->ToString(), "Audit",
+                entry->EventString(KSyncEntry::DEL_REQ));
+    entry->SetState(KSyncEntry::DEL_ACK_WAIT);
+    if (entry->Delete()) {
+        AuditFree(entry);
+        return true;
+    }
+    return false;
+}
+
+bool KSyncObject::AuditClaim(KSyncEntry *entry) {
+    tbb::recursive_mutex::scoped_lock lock(lock_);
+    if (audit_tree_.empty()) {
+        return false;
+    }
+
+    AuditTree::iterator it = audit_tree_.find(*entry);
+    if (it == audit_tree_.end()) {
+        return false;
+    }
+
+    // Delete already sent to kernel. The ADD will follow the delete
+    KSyncEntry *kentry = it.operator->();
+    if (kentry->GetState() == KSyncEntry::DEL_ACK_WAIT) {
+        return false;
+    }
+
+    if (entry->IsAuditMatch(*kentry)) {
+        AuditFree(kentry);
+        return true;
+    }
+
+    // Delete goes on the same socket as the ADD that follows, so kernel
+    // sees them in order. Entry stays in audit tree till delete is acked
+    if (entry->IsAuditOverwrite(*kentry) == false) {
+        AuditDelete(kentry);
+        return false;
+    }
+
+    AuditFree(kentry);
+    return false;
+}
+
+bool KSyncObject::AuditAck(KSyncEntry *entry) {
+    if (audit_tree_.empty()) {
+        return false;
+    }
+
+    AuditTree::iterator it = audit_tree_.find(*entry);
+    if (it == audit_tree_.end() || it.operator->() != entry) {
+        return false;
+    }
+
+    AuditFree(entry);
+    return true;
+}
+
+void KSyncObject::AuditSweep() {
+    tbb::recursive_mutex::scoped_lock lock(lock_);
+    AuditTree::iterator it = audit_tree_.begin();
+    while (it != audit_tree_.end()) {
+        KSyncEntry *entry = it.operator->();
+        it++;
+        if (entry->GetState() == KSyncEntry::DEL_ACK_WAIT) {
+            continue;
+        }
+        AuditDelete(entry);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // KSyncEntry dependency management
 ///////////////////////////////////////////////////////////////////////////////
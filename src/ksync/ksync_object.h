@@ -63,12 +63,21 @@ struct KSyncBackReference {
     KSyncEntry      *back_reference_;
 };
 
+// Orders the audit tree on the key known to kernel
+struct KSyncAuditCompare {
+    bool operator()(const KSyncEntry &lhs, const KSyncEntry &rhs) const {
+        return lhs.IsAuditLess(rhs);
+    }
+};
+
 class KSyncObject {
 public:
     typedef boost::intrusive::member_hook<KSyncEntry,
             boost::intrusive::set_member_hook<>,
             &KSyncEntry::node_> KSyncObjectNode;
     typedef boost::intrusive::set<KSyncEntry, KSyncObjectNode> Tree;
+    typedef boost::intrusive::set<KSyncEntry, KSyncObjectNode,
+            boost::intrusive::compare<KSyncAuditCompare> > AuditTree;
 
     typedef boost::intrusive::member_hook<KSyncFwdReference,
             boost::intrusive::set_member_hook<>,
@@ -119,6 +128,28 @@ public:
     virtual void EmptyTable(void) { };
     bool IsEmpty(void) { return tree_.empty(); }; 
 
+    // Kernel audit.
+    // When the agent restarts without resetting the kernel, entries read
+    // from the kernel are added to the audit tree with AuditAdd. The tree
+    // is ordered on KSyncEntry::IsAuditLess. An entry created later with
+    // the same audit key takes over the kernel entry, and its ADD is skipped
+    // if IsAuditMatch reports no difference. Kernel entries not taken over
+    // when AuditSweep runs are deleted from the kernel.
+    //
+    // Kernel entries with a valid index keep the index reserved till they
+    // are deleted, so that the agent does not overwrite them in kernel.
+    //
+    // Add an entry read from the kernel. Takes ownership of entry
+    void AuditAdd(KSyncEntry *entry);
+    // Called before entry is added to kernel. Returns true if the kernel
+    // already has the same entry
+    bool AuditClaim(KSyncEntry *entry);
+    // Delete kernel entries that were not taken over
+    void AuditSweep();
+    size_t audit_count() const { return audit_tree_.size(); }
+    // Object holding the audit tree for entries of this object
+    virtual KSyncObject *AuditObject() { return this; }
+
     static void Shutdown();
 protected:
     // Create an entry with default state. Used internally
@@ -133,6 +164,12 @@ private:
     // Removes from tree and free index if allocated earlier
     void FreeInd(KSyncEntry *entry, uint32_t index);
     void NetlinkAckInternal(KSyncEntry *entry, KSyncEntry::KSyncEvent event);
+    // Handle ACK for delete of a kernel entry sent by the audit
+    bool AuditAck(KSyncEntry *entry);
+    // Find entry with the audit key of a kernel entry in tree_
+    KSyncEntry *AuditFind(const KSyncEntry *key);
+    void AuditFree(KSyncEntry *entry);
+    bool AuditDelete(KSyncEntry *entry);
 
     bool IsIndexValid() const { return need_index_; }
 
@@ -141,6 +178,8 @@ private:
 
     // Tree of all KSyncEntries
     Tree tree_;
+    // Entries read from kernel and not yet taken over
+    AuditTree audit_tree_;
     // Forward reference tree
     static FwdRefTree  fwd_ref_tree_;
     // Back reference tree
@@ -48,6 +48,7 @@ AgentSandeshContext *KSyncSock::agent_sandesh_ctx_;
 std::vector<KSyncSock *> KSyncSock::sock_table_;
 pid_t KSyncSock::pid_;
 tbb::atomic<bool> KSyncSock::shutdown_;
+bool KSyncSock::bulk_mode_ = true;
 
 const char* IoContext::io_wq_names[IoContext::MAX_WORK_QUEUES] = 
                                                 {"Agent::KSync", "Agent::Uve"};
@@ -159,6 +160,28 @@ void KSyncSockNetlink::AsyncSendTo(IoContext *ioc, mutable_buffers_1 buf,
     free(cl.cl_buf);
 }
 
+// Send all messages in the list as a single netlink datagram. The kernel
+// processes each nlmsghdr in the buffer independently and responds to each
+// sequence number separately
+void KSyncSockNetlink::AsyncBulkSendTo(const IoContextList &list,
+                                       HandlerCb cb) {
+    uint32_t len = 0;
+    char *buf = EncodeBulkMsg(list, &len);
+
+    boost::asio::netlink::raw::endpoint ep;
+    sock_.async_send_to(buffer(buf, len), ep,
+                        boost::bind(&KSyncSockNetlink::BulkWriteHandler, buf,
+                                    cb, placeholders::error,
+                                    placeholders::bytes_transferred));
+}
+
+void KSyncSockNetlink::BulkWriteHandler(char *buf, HandlerCb cb,
+                                        const boost::system::error_code &error,
+                                        size_t bytes_transferred) {
+    delete [] buf;
+    cb(error, bytes_transferred);
+}
+
 size_t KSyncSockNetlink::SendTo(const_buffers_1 buf) {
     struct nl_client cl;
     unsigned char *nl_buf;
@@ -278,20 +301,42 @@ void KSyncSockUdp::Receive(mutable_buffers_1 buf) {
     sock_.receive_from(buf, ep);
 }
 
-KSyncSock::KSyncSock() : tx_count_(0), err_count_(0) {
+KSyncSock::KSyncSock() : tx_pending_len_(0) {
     for(int i = 0; i < IoContext::MAX_WORK_QUEUES; i++) {
         work_queue_[i] = new WorkQueue<char *>(TaskScheduler::GetInstance()->
                              GetTaskId(IoContext::io_wq_names[i]), 0,
                              boost::bind(&KSyncSock::ProcessKernelData, this, 
                                          _1));
     }
+    tx_flush_trigger_ = new TaskTrigger(boost::bind(&KSyncSock::FlushTx, this),
+                             TaskScheduler::GetInstance()->
+                             GetTaskId(IoContext::io_wq_names
+                                       [IoContext::DEFAULT_Q_ID]), 0);
     rx_buff_ = NULL;
     seqno_ = 0;
     uve_seqno_ = 0;
+    tx_send_count_ = 0;
+    tx_msg_count_ = 0;
+    ack_count_ = 0;
+    err_count_ = 0;
 }
 
 KSyncSock::~KSyncSock() {
+    // Messages still pending bulk transmit at shutdown are never sent. The
+    // socket of the derived class is gone, so free them instead
+    {
+        tbb::mutex::scoped_lock lock(tx_mutex_);
+        tbb::mutex::scoped_lock tree_lock(mutex_);
+        for (IoContextList::iterator it = tx_pending_.begin();
+             it != tx_pending_.end(); ++it) {
+            wait_tree_.erase(wait_tree_.iterator_to(**it));
+            delete *it;
+        }
+        tx_pending_.clear();
+        tx_pending_len_ = 0;
+    }
     assert(wait_tree_.size() == 0);
+    delete tx_flush_trigger_;
 
     if (rx_buff_) {
         delete [] rx_buff_;
@@ -401,10 +446,12 @@ bool KSyncSock::ProcessKernelData(char *data) {
     ctxt->SetErrno(0);
     Decoder(data, ctxt);
     if (ctxt->GetErrno() != 0) {
+        err_count_++;
         context->ErrorHandler(ctxt->GetErrno());
     }
 
     if (!IsMoreData(data)) {
+        ack_count_++;
         context->Handler();
         tbb::mutex::scoped_lock lock(mutex_);
         wait_tree_.erase(it);
@@ -437,6 +484,8 @@ KSyncSock *KSyncSock::Get(int idx) {
 }
 
 size_t KSyncSock::BlockingSend(const char *msg, int msg_len) {
+    // Async messages queued before this one must reach the kernel first
+    FlushTx();
     return SendTo(buffer(msg, msg_len));
 }
 
@@ -482,10 +531,132 @@ void KSyncSock::SendAsyncImpl(int msg_len, char *msg,
         wait_tree_.insert(*ioc);
     }
 
-    AsyncSendTo(ioc, buffer(msg, msg_len),
-                boost::bind(&KSyncSock::WriteHandler, this,
-                            placeholders::error,
-                            placeholders::bytes_transferred));
+    if (bulk_mode_ == false) {
+        tx_send_count_++;
+        tx_msg_count_++;
+        AsyncSendTo(ioc, buffer(msg, msg_len),
+                    boost::bind(&KSyncSock::WriteHandler, this,
+                                placeholders::error,
+                                placeholders::bytes_transferred));
+        return;
+    }
+
+    // Queue the message for bulk transmit. Flush the pending list first if
+    // adding this message would go past the transmit buffer limits
+    tbb::mutex::scoped_lock lock(tx_mutex_);
+    uint32_t len = BulkMsgLen(ioc);
+    if ((tx_pending_len_ + len > kBulkBufLen) ||
+        (tx_pending_.size() >= kMaxBulkMsgCount)) {
+        FlushTxLocked();
+    }
+    tx_pending_.push_back(ioc);
+    tx_pending_len_ += len;
+    tx_flush_trigger_->Set();
+}
+
+// Invoked in Agent::KSync task context. Since Agent::KSync is mutually
+// exclusive with db::DBTable, the trigger runs only after the current burst
+// of KSync operations from DB notifications is done
+bool KSyncSock::FlushTx() {
+    tbb::mutex::scoped_lock lock(tx_mutex_);
+    FlushTxLocked();
+    return true;
+}
+
+// Must be called with tx_mutex_ held
+void KSyncSock::FlushTxLocked() {
+    if (tx_pending_.empty())
+        return;
+
+    tx_send_count_++;
+    tx_msg_count_ += tx_pending_.size();
+    AsyncBulkSendTo(tx_pending_,
+                    boost::bind(&KSyncSock::WriteHandler, this,
+                                placeholders::error,
+                                placeholders::bytes_transferred));
+    tx_pending_.clear();
+    tx_pending_len_ = 0;
+}
+
+void KSyncSock::AsyncBulkSendTo(const IoContextList &list, HandlerCb cb) {
+    for (IoContextList::const_iterator it = list.begin(); it != list.end();
+         ++it) {
+        IoContext *ioc = *it;
+        AsyncSendTo(ioc, buffer(ioc->msg_, ioc->msg_len_), cb);
+    }
+}
+
+uint32_t KSyncSock::BulkMsgLen(const IoContext *ioc) {
+    return NLMSG_ALIGN(NLMSG_HDRLEN + GENL_HDRLEN + NLA_HDRLEN +
+                       ioc->GetMsgLen());
+}
+
+char *KSyncSock::EncodeBulkMsg(const IoContextList &list, uint32_t *len) {
+    uint32_t total_len = 0;
+    for (IoContextList::const_iterator it = list.begin(); it != list.end();
+         ++it) {
+        total_len += BulkMsgLen(*it);
+    }
+
+    char *buf = new char[total_len];
+    memset(buf, 0, total_len);
+    char *ptr = buf;
+    for (IoContextList::const_iterator it = list.begin(); it != list.end();
+         ++it) {
+        IoContext *ioc = *it;
+        uint32_t msg_len = BulkMsgLen(ioc);
+
+        struct nlmsghdr *nlh = (struct nlmsghdr *)ptr;
+        nlh->nlmsg_len = NLMSG_HDRLEN + GENL_HDRLEN + NLA_HDRLEN +
+            ioc->GetMsgLen();
+        nlh->nlmsg_type = GetNetlinkFamilyId();
+        nlh->nlmsg_flags = NLM_F_REQUEST;
+        nlh->nlmsg_seq = ioc->GetSeqno();
+        nlh->nlmsg_pid = GetPid();
+
+        struct genlmsghdr *genlh = (struct genlmsghdr *)(ptr + NLMSG_HDRLEN);
+        genlh->cmd = SANDESH_REQUEST;
+
+        struct nlattr *attr = (struct nlattr *)(ptr + NLMSG_HDRLEN +
+                                                GENL_HDRLEN);
+        attr->nla_len = NLA_HDRLEN + ioc->GetMsgLen();
+        attr->nla_type = NL_ATTR_VR_MESSAGE_PROTOCOL;
+
+        memcpy(ptr + NLMSG_HDRLEN + GENL_HDRLEN + NLA_HDRLEN, ioc->GetMsg(),
+               ioc->GetMsgLen());
+        ptr += msg_len;
+    }
+
+    *len = total_len;
+    return buf;
+}
+
+size_t KSyncSock::InFlightCount() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return wait_tree_.size();
+}
+
+void KSyncSockStatsReq::HandleRequest() const {
+    KSyncSockStatsResp *resp = new KSyncSockStatsResp();
+    std::vector<KSyncSockStats> list;
+    for (size_t i = 0; i < KSyncSock::SockCount(); i++) {
+        KSyncSock *sock = KSyncSock::Get(i);
+        if (sock == NULL)
+            continue;
+        KSyncSockStats stats;
+        stats.set_index(i);
+        stats.set_bulk_mode(KSyncSock::IsBulkMode());
+        stats.set_tx_sends(sock->tx_send_count());
+        stats.set_tx_msgs(sock->tx_msg_count());
+        stats.set_msgs_per_send(sock->MsgsPerSend());
+        stats.set_in_flight(sock->InFlightCount());
+        stats.set_acks(sock->ack_count());
+        stats.set_errors(sock->err_count());
+        list.push_back(stats);
+    }
+    resp->set_sock_stats(list);
+    resp->set_context(context());
+    resp->Response();
 }
 
 KSyncIoContext::KSyncIoContext(KSyncEntry *sync_entry, int msg_len,
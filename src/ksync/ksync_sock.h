@@ -14,6 +14,7 @@
 #include <tbb/atomic.h>
 #include <tbb/mutex.h>
 #include <base/queue_task.h>
+#include <base/task_trigger.h>
 #include <sandesh/sandesh_types.h>
 #include <sandesh/sandesh.h>
 #include "vr_types.h"
@@ -85,6 +86,8 @@ public:
 
     AgentSandeshContext *GetSandeshContext() { return ctx_; }
     IoContextWorkQId GetWorkQId() { return work_q_id_; }
+    const char *GetMsg() const { return msg_; }
+    uint32_t GetMsgLen() const { return msg_len_; }
 
     boost::intrusive::set_member_hook<> node_;
 
@@ -117,11 +120,15 @@ typedef boost::intrusive::member_hook<IoContext,
         boost::intrusive::set_member_hook<>,
         &IoContext::node_> KSyncSockNode;
 typedef boost::intrusive::set<IoContext, KSyncSockNode> Tree;
+typedef std::vector<IoContext *> IoContextList;
 
 class KSyncSock {
 public:
     const static int kMsgGrowSize = 16;
     const static unsigned kBufLen = 4096;
+    // Limits for coalescing multiple messages into one transmit buffer
+    const static unsigned kBulkBufLen = 16 * 1024;
+    const static unsigned kMaxBulkMsgCount = 32;
 
     typedef boost::function<void(const boost::system::error_code &, size_t)> HandlerCb;
     KSyncSock();
@@ -134,6 +141,7 @@ public:
     // Partition to KSyncSock mapping
     static KSyncSock *Get(DBTablePartBase *partition);
     static KSyncSock *Get(int partition_id);
+    static size_t SockCount() { return sock_table_.size(); }
     // Write a KSyncEntry to kernel
     void SendAsync(KSyncEntry *entry, int msg_len, char *msg, KSyncEntry::KSyncEvent event);
     std::size_t BlockingSend(const char *msg, int msg_len);
@@ -160,6 +168,24 @@ public:
         agent_sandesh_ctx_ = ctx;
     }
     virtual void Decoder(char *data, SandeshContext *ctxt) = 0;
+
+    // Enable/disable coalescing of async messages into bulk transmits
+    static void SetBulkMode(bool enable) { bulk_mode_ = enable; }
+    static bool IsBulkMode() { return bulk_mode_; }
+    // Transmit pending bulk messages. Invoked from tx_flush_trigger_
+    bool FlushTx();
+
+    uint64_t tx_send_count() const { return tx_send_count_; }
+    uint64_t tx_msg_count() const { return tx_msg_count_; }
+    uint64_t ack_count() const { return ack_count_; }
+    uint64_t err_count() const { return err_count_; }
+    double MsgsPerSend() const {
+        if (tx_send_count_ == 0)
+            return 0;
+        return ((double)tx_msg_count_) / tx_send_count_;
+    }
+    size_t InFlightCount();
+
 protected:
     static void Init(int count);
     static void SetSockTableEntry(int i, KSyncSock *sock);
@@ -168,6 +194,13 @@ protected:
     tbb::mutex mutex_;
 
     WorkQueue<char *> *work_queue_[IoContext::MAX_WORK_QUEUES];
+
+    // Length of a message once framed with netlink/generic-netlink headers
+    static uint32_t BulkMsgLen(const IoContext *ioc);
+    // Frame all messages in the list into one netlink buffer allocated
+    // with new[]. Each message keeps its own header and sequence number,
+    // so responses are demultiplexed through wait_tree_ as before
+    static char *EncodeBulkMsg(const IoContextList &list, uint32_t *len);
 private:
     // Read handler registered with boost::asio. Demux done based on seqno_
     void ReadHandler(const boost::system::error_code& error,
@@ -181,10 +214,14 @@ private:
     virtual bool Validate(char *data) = 0;
     bool ValidateAndEnqueue(char *data);
     void SendAsyncImpl(int msg_len, char *msg, IoContext *ioc);
+    void FlushTxLocked();
 
     virtual void AsyncReceive(boost::asio::mutable_buffers_1, HandlerCb) = 0;
     virtual void AsyncSendTo(IoContext *, boost::asio::mutable_buffers_1,
                              HandlerCb) = 0;
+    // Send a list of messages in one operation. Default implementation
+    // sends them one at a time
+    virtual void AsyncBulkSendTo(const IoContextList &list, HandlerCb cb);
     virtual std::size_t SendTo(boost::asio::const_buffers_1) = 0;
     virtual void Receive(boost::asio::mutable_buffers_1) = 0;
 
@@ -197,15 +234,23 @@ private:
     static int vnsw_netlink_family_id_;
     static AgentSandeshContext *agent_sandesh_ctx_;
     static tbb::atomic<bool> shutdown_;
+    static bool bulk_mode_;
 
     char *rx_buff_;
     tbb::atomic<int> seqno_;
     tbb::atomic<int> uve_seqno_;
 
+    // Messages pending bulk transmit
+    tbb::mutex tx_mutex_;
+    IoContextList tx_pending_;
+    uint32_t tx_pending_len_;
+    TaskTrigger *tx_flush_trigger_;
+
     // Debug stats
-    int tx_count_;
-    int ack_count_;
-    int err_count_;
+    tbb::atomic<uint64_t> tx_send_count_;
+    tbb::atomic<uint64_t> tx_msg_count_;
+    tbb::atomic<uint64_t> ack_count_;
+    tbb::atomic<uint64_t> err_count_;
 
     DISALLOW_COPY_AND_ASSIGN(KSyncSock);
 };
@@ -224,9 +269,13 @@ public:
     virtual void AsyncReceive(boost::asio::mutable_buffers_1, HandlerCb);
     virtual void AsyncSendTo(IoContext *, boost::asio::mutable_buffers_1,
                              HandlerCb);
+    virtual void AsyncBulkSendTo(const IoContextList &list, HandlerCb cb);
     virtual std::size_t SendTo(boost::asio::const_buffers_1);
     virtual void Receive(boost::asio::mutable_buffers_1);
 private:
+    static void BulkWriteHandler(char *buf, HandlerCb cb,
+                                 const boost::system::error_code &error,
+                                 size_t bytes_transferred);
     boost::asio::netlink::raw::socket sock_;
 };
 
@@ -329,6 +329,32 @@ void KSyncSockTypeMap::AsyncSendTo(IoContext *ioc, mutable_buffers_1 buf,
     }
 }
 
+//decode the coalesced netlink buffer the same way the kernel would and
+//process every message in it with its own sequence number
+void KSyncSockTypeMap::AsyncBulkSendTo(const IoContextList &list,
+                                       HandlerCb cb) {
+    uint32_t len = 0;
+    char *buf = EncodeBulkMsg(list, &len);
+
+    int remaining = len;
+    struct nlmsghdr *nlh = (struct nlmsghdr *)buf;
+    while (NLMSG_OK(nlh, remaining)) {
+        uint32_t hdr_len = NLMSG_HDRLEN + GENL_HDRLEN + NLA_HDRLEN;
+        KSyncUserSockContext ctx(true, nlh->nlmsg_seq);
+        ProcessSandesh((const uint8_t *)nlh + hdr_len,
+                       nlh->nlmsg_len - hdr_len, &ctx);
+        if (ctx.IsResponseReqd()) {
+            //simulate ok response with the same seq
+            SimulateResponse(nlh->nlmsg_seq, 0, 0);
+        }
+        if (list.size() > 1)
+            bulk_msg_count_++;
+        nlh = NLMSG_NEXT(nlh, remaining);
+    }
+
+    delete [] buf;
+}
+
 //send or store in map
 size_t KSyncSockTypeMap::SendTo(const_buffers_1 buf) {
     KSyncUserSockContext ctx(true, 0);
@@ -82,6 +82,7 @@ class KSyncSockTypeMap : public KSyncSock {
 public:
     KSyncSockTypeMap(boost::asio::io_service &ios) : KSyncSock(), sock_(ios) {
         block_msg_processing_ = false;
+        bulk_msg_count_ = 0;
     }
     ~KSyncSockTypeMap() {
         assert(nh_map.size() == 0);
@@ -125,6 +126,7 @@ public:
     virtual void AsyncReceive(boost::asio::mutable_buffers_1, HandlerCb);
     virtual void AsyncSendTo(IoContext *, boost::asio::mutable_buffers_1,
                              HandlerCb);
+    virtual void AsyncBulkSendTo(const IoContextList &list, HandlerCb cb);
     virtual std::size_t SendTo(boost::asio::const_buffers_1);
     virtual void Receive(boost::asio::mutable_buffers_1);
 
@@ -151,6 +153,7 @@ public:
     static int MplsCount();
     static int RouteCount();
     static int VxLanCount();
+    static uint64_t BulkMsgCount() { return singleton_->bulk_msg_count_; }
     static KSyncSockTypeMap *GetKSyncSockTypeMap() { return singleton_; };
     static void Init(boost::asio::io_service &ios, int count);
     static void Shutdown();
@@ -175,6 +178,8 @@ private:
     udp::socket sock_;
     udp::endpoint local_ep_;
     bool block_msg_processing_;
+    // Messages received inside netlink buffers carrying more than one message
+    uint64_t bulk_msg_count_;
     static KSyncSockTypeMap *singleton_;
     static vr_flow_entry *flow_table_;
     DISALLOW_COPY_AND_ASSIGN(KSyncSockTypeMap);
@@ -65,6 +65,18 @@ public:
     virtual bool Add();
     virtual bool Change();
 
+    virtual bool IsAuditMatch(const KSyncEntry &kernel) const {
+        const Vlan &vlan = static_cast<const Vlan &>(kernel);
+        return dep_tag_ == vlan.dep_tag_;
+    }
+
+    // Kernel entry with a dependency is deleted before an entry without
+    // one is added
+    virtual bool IsAuditOverwrite(const KSyncEntry &kernel) const {
+        const Vlan &vlan = static_cast<const Vlan &>(kernel);
+        return dep_tag_ != 0 || vlan.dep_tag_ == 0;
+    }
+
     virtual bool Delete() {
         op_ = DELETE;
         delete_count_++;
@@ -740,6 +752,120 @@ TEST_F(TestUT, renew_dependency_reval) {
     EXPECT_EQ(Vlan::free_wait_count_, 2);
 }
 
+// Kernel audit: matching kernel entries are taken over without an ADD,
+// changed entries are re-added and the rest are deleted by the sweep
+TEST_F(TestUT, audit_sync) {
+    vlan_table_->AuditAdd(new Vlan(0xF01, 0));
+    vlan_table_->AuditAdd(new Vlan(0xF02, 0xF03));
+    vlan_table_->AuditAdd(new Vlan(0xF03, 0));
+    EXPECT_EQ(3U, vlan_table_->audit_count());
+
+    // Duplicate from kernel is ignored
+    vlan_table_->AuditAdd(new Vlan(0xF01, 0));
+    EXPECT_EQ(3U, vlan_table_->audit_count());
+
+    Vlan *vlan1 = AddVlan(0xF01, 0, KSyncEntry::IN_SYNC, Vlan::INIT, 0);
+    Vlan *vlan2 = AddVlan(0xF02, 0xF01, KSyncEntry::IN_SYNC, Vlan::ADD, 1);
+    EXPECT_EQ(Vlan::add_count_, 1);
+    EXPECT_EQ(1U, vlan_table_->audit_count());
+
+    vlan_table_->AuditSweep();
+    EXPECT_EQ(0U, vlan_table_->audit_count());
+    EXPECT_EQ(Vlan::delete_count_, 1);
+
+    // Entry created after the sweep is added to kernel
+    Vlan *vlan3 = AddVlan(0xF03, 0, KSyncEntry::IN_SYNC, Vlan::ADD, 2);
+    EXPECT_EQ(Vlan::add_count_, 2);
+
+    vlan_table_->Delete(vlan2);
+    vlan_table_->Delete(vlan1);
+    vlan_table_->Delete(vlan3);
+    EXPECT_EQ(Vlan::delete_count_, 4);
+}
+
+// Kernel audit with asynchronous delete of a stale entry
+TEST_F(TestUT, audit_async) {
+    Vlan *kernel1 = new Vlan(0x1, 0);
+    Vlan *kernel2 = new Vlan(0x2, 0);
+    vlan_table_->AuditAdd(kernel1);
+    vlan_table_->AuditAdd(kernel2);
+
+    // Entry already in agent is not taken from kernel
+    Vlan *vlan3 = AddVlan(0x3, 0, KSyncEntry::SYNC_WAIT, Vlan::ADD, 0);
+    vlan_table_->AuditAdd(new Vlan(0x3, 0));
+    EXPECT_EQ(2U, vlan_table_->audit_count());
+
+    vlan_table_->AuditSweep();
+    EXPECT_EQ(kernel1->GetState(), KSyncEntry::DEL_ACK_WAIT);
+    EXPECT_EQ(Vlan::delete_count_, 2);
+    EXPECT_EQ(2U, vlan_table_->audit_count());
+
+    // Add while delete is pending in kernel must be sent
+    Vlan *vlan1 = AddVlan(0x1, 0, KSyncEntry::SYNC_WAIT, Vlan::ADD, 1);
+    EXPECT_EQ(2U, vlan_table_->audit_count());
+
+    // ACK for the kernel entry does not affect the agent entry
+    vlan_table_->NetlinkAck(kernel1, KSyncEntry::DEL_ACK);
+    EXPECT_EQ(1U, vlan_table_->audit_count());
+    EXPECT_EQ(vlan1->GetState(), KSyncEntry::SYNC_WAIT);
+    vlan_table_->NetlinkAck(vlan1, KSyncEntry::ADD_ACK);
+    EXPECT_EQ(vlan1->GetState(), KSyncEntry::IN_SYNC);
+
+    vlan_table_->NetlinkAck(kernel2, KSyncEntry::DEL_ACK);
+    EXPECT_EQ(0U, vlan_table_->audit_count());
+    vlan_table_->NetlinkAck(vlan3, KSyncEntry::ADD_ACK);
+
+    vlan_table_->Delete(vlan1);
+    vlan_table_->Delete(vlan3);
+    vlan_table_->NetlinkAck(vlan1, KSyncEntry::DEL_ACK);
+    vlan_table_->NetlinkAck(vlan3, KSyncEntry::DEL_ACK);
+    EXPECT_EQ(Vlan::delete_count_, 4);
+}
+
+// Kernel entries keep their index reserved till they are swept
+TEST_F(TestUT, audit_index) {
+    Vlan *vlan1 = AddVlan(0xF11, 0, KSyncEntry::IN_SYNC, Vlan::ADD, 0);
+
+    // Index used by agent, the kernel entry is dropped
+    vlan_table_->AuditAdd(new Vlan(0xF12, 0, 0));
+    EXPECT_EQ(0U, vlan_table_->audit_count());
+
+    vlan_table_->AuditAdd(new Vlan(0xF13, 0, 1));
+    EXPECT_EQ(1U, vlan_table_->audit_count());
+    Vlan *vlan2 = AddVlan(0xF14, 0, KSyncEntry::IN_SYNC, Vlan::ADD, 2);
+
+    // Index is free again once the kernel entry is deleted
+    vlan_table_->AuditSweep();
+    EXPECT_EQ(0U, vlan_table_->audit_count());
+    Vlan *vlan3 = AddVlan(0xF15, 0, KSyncEntry::IN_SYNC, Vlan::ADD, 1);
+
+    vlan_table_->Delete(vlan1);
+    vlan_table_->Delete(vlan2);
+    vlan_table_->Delete(vlan3);
+    EXPECT_EQ(Vlan::delete_count_, 4);
+}
+
+// Kernel entry that can't be overwritten is deleted before the ADD
+TEST_F(TestUT, audit_delete_first) {
+    Vlan *kernel = new Vlan(0x21, 0x22);
+    vlan_table_->AuditAdd(kernel);
+
+    Vlan *vlan = AddVlan(0x21, 0, KSyncEntry::SYNC_WAIT, Vlan::ADD, 0);
+    EXPECT_EQ(Vlan::delete_count_, 1);
+    EXPECT_EQ(Vlan::add_count_, 1);
+    EXPECT_EQ(kernel->GetState(), KSyncEntry::DEL_ACK_WAIT);
+    EXPECT_EQ(1U, vlan_table_->audit_count());
+
+    vlan_table_->NetlinkAck(kernel, KSyncEntry::DEL_ACK);
+    EXPECT_EQ(0U, vlan_table_->audit_count());
+    vlan_table_->NetlinkAck(vlan, KSyncEntry::ADD_ACK);
+    EXPECT_EQ(vlan->GetState(), KSyncEntry::IN_SYNC);
+
+    vlan_table_->Delete(vlan);
+    vlan_table_->NetlinkAck(vlan, KSyncEntry::DEL_ACK);
+    EXPECT_EQ(Vlan::delete_count_, 2);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     LoggingInit();
@@ -520,10 +520,11 @@ class OpServerUtils(object):
         sort_fields = None
         limit = None
         filter = None
+        topn = None
 
         def __init__(self, table, start_time, end_time, select_fields,
                      where=None, sort_fields=None, sort=None, limit=None,
-                     filter=None):
+                     filter=None, topn=None):
             self.table = table
             self.start_time = start_time
             self.end_time = end_time
@@ -538,6 +539,8 @@ class OpServerUtils(object):
                 self.limit = limit
             if filter is not None:
                 self.filter = filter
+            if topn is not None:
+                self.topn = topn
         # end __init__
 
     # end class Query
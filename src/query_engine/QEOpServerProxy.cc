@@ -76,6 +76,11 @@ public:
         string post;
         uint64_t time_period;
         string table;
+        string cache_key;
+        // Per chunk, the start of the cached time bucket or 0
+        vector<uint64_t> cache_buckets;
+        // How the top N of a topn query was computed
+        string topn;
     };
 
     void JsonInsert(std::vector<query_column> &columns,
@@ -215,14 +220,37 @@ public:
         }
     }
    
+    bool QueryCacheResult(ExternalBase *handle, shared_ptr<BufferT> res,
+            shared_ptr<OutRowMultimapT> mres) {
+        auto_ptr<RawResultT> raw(new RawResultT);
+        raw->first = QPerfInfo(0, 0, 0);
+        raw->second.first = res;
+        raw->second.second = mres;
+
+        ExternalProcIf<RawResultT> * rpi =
+            static_cast<ExternalProcIf<RawResultT> *>(handle);
+        QE_LOG_NOQID(DEBUG,  " Rx data from cache for " << rpi->Key());
+        rpi->Response(raw);
+        return true;
+    }
+
     struct Stage0Out {
         Input inp;
         bool ret_code;
+        bool cached;
         QPerfInfo ret_info;
         uint32_t chunk_merge_time;
         shared_ptr<BufferT> result;
         shared_ptr<OutRowMultimapT> mresult;
     };
+
+    uint64_t CacheBucket(const Input & inp, uint32_t inst) {
+        if (!qosp_->qe_->GetCache() || inst >= inp.cache_buckets.size()) {
+            return 0;
+        }
+        return inp.cache_buckets[inst];
+    }
+
     ExternalBase::Efn QueryExec(uint32_t inst, const vector<RawResultT*> & exts,
             const Input & inp, Stage0Out & res) { 
         uint32_t step = exts.size();
@@ -243,6 +271,19 @@ public:
             else
                 res.result = shared_ptr<BufferT>(new BufferT());
 
+            res.cached = false;
+            uint64_t bucket = CacheBucket(inp, inst);
+            if (bucket) {
+                shared_ptr<BufferT> cres(new BufferT());
+                shared_ptr<OutRowMultimapT> cmres(new OutRowMultimapT());
+                if (qosp_->qe_->GetCache()->Lookup(inp.cache_key, bucket,
+                        cres.get(), cmres.get())) {
+                    res.cached = true;
+                    return boost::bind(&QEOpServerImpl::QueryCacheResult,
+                            this, _1, cres, cmres);
+                }
+            }
+
             // TODO : The chunk number should be picked off a queue
             //        This queue may be part of the input for this stage
             return boost::bind(&QueryEngine::QueryExec, qosp_->qe_,
@@ -254,6 +295,13 @@ public:
             res.ret_info = exts[0]->first;
             res.chunk_merge_time = 0;
             res.ret_code = (exts[0]->first.error == 0) ? true : false;
+            uint64_t bucket = CacheBucket(inp, inst);
+            if (res.ret_code && bucket && !res.cached) {
+                // Before the merge, which updates the rows in place
+                qosp_->qe_->GetCache()->Insert(inp.cache_key, bucket,
+                        exts[0]->second.first.get(),
+                        exts[0]->second.second.get());
+            }
             if (res.ret_code) {
                 if (inp.need_merge) {
                     uint64_t then = UTCTimestampUsec();
@@ -404,7 +452,7 @@ public:
                     QE_LOG_NOQID(INFO,  "Did Jsonify #rows " << res->size());
                     
                     uint64_t then = UTCTimestampUsec();
-                    char stat[80];
+                    char stat[128];
                     string key = "REPLY:" + ret.inp.qp.qid;
                     if (!inp.ret_code) {
                         sprintf(stat,"{\"progress\":%d}", - 5);
@@ -428,8 +476,14 @@ public:
                                 list_of(string("RPUSH"))(key)(stat));
                             rownum++;
                         }
-                        sprintf(stat,"{\"progress\":100, \"lines\":%d, \"count\":%d}",
-                            (int)rownum, (int)res->size());
+                        if (inp.inp.topn.empty()) {
+                            sprintf(stat,"{\"progress\":100, \"lines\":%d, \"count\":%d}",
+                                (int)rownum, (int)res->size());
+                        } else {
+                            sprintf(stat,"{\"progress\":100, \"lines\":%d, \"count\":%d, \"topn\":\"%s\"}",
+                                (int)rownum, (int)res->size(),
+                                inp.inp.topn.c_str());
+                        }
                     }
                     uint64_t now = UTCTimestampUsec();
                     ret.redis_time = static_cast<uint32_t>((now - then)/1000);
@@ -641,9 +695,13 @@ public:
         string select;
         string post;
         uint64_t time_period;
+        string cache_key;
+        vector<uint64_t> cache_buckets;
+        string topn;
 
         int ret = qosp_->qe_->QueryPrepare(qp, chunk_size, need_merge, map_output,
-            where, select, post, time_period, table);
+            where, select, post, time_period, table, cache_key, cache_buckets,
+            topn);
 
         if (ret!=0) {
             QueryError(qid, ret);
@@ -668,6 +726,9 @@ public:
         inp.get()->post = post;
         inp.get()->time_period = time_period;
         inp.get()->table = table;
+        inp.get()->cache_key = cache_key;
+        inp.get()->cache_buckets = cache_buckets;
+        inp.get()->topn = topn;
   
         vector<pair<int,int> > tinfo;
         for (uint idx=0; idx<chunk_size.size(); idx++) {
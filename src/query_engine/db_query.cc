@@ -24,10 +24,8 @@ query_status_t DbQueryUnit::process_query()
     cr.finish_.push_back(timestamp_end);
 
     std::vector<GenDb::DbDataValueVec> keys;    // vector of keys for multi-row get
-    std::vector<GenDb::ColList> mget_res;   // vector of result for each row
     for (uint32_t t2 = t2_start; t2 <= t2_end; t2++)
     {
-        GenDb::ColList result;
         GenDb::DbDataValueVec rowkey;
 
         if (t_only_row)
@@ -43,85 +41,19 @@ query_status_t DbQueryUnit::process_query()
         keys.push_back(rowkey);
     }
         
-    if (!m_query->dbif->Db_GetMultiRow(mget_res, cfname, keys, &cr)) {
-        QE_IO_ERROR_RETURN(0, QUERY_FAILURE);
-    } else {
-        for (std::vector<GenDb::ColList>::iterator it = mget_res.begin();
-                it != mget_res.end(); it++) {
-            uint32_t t2 = boost::get<uint32_t>(it->rowkey_.at(0));
-            std::vector<GenDb::NewCol>::iterator i;
-
-            QE_TRACE(DEBUG, "For T2:" << t2 <<
-                " Database returned " << it->columns_.size() << " cols");
+    // Stats queries that can be answered from a rollup read the rollup
+    // table, which has the same keys as the stats table
+    std::string query_cfname(cfname);
+    if (m_query->is_stat_table_query() &&
+        m_query->stat_rollup_index() != -1) {
+        query_cfname = m_query->stat_rollup_cfname(cfname);
+    }
 
-            for (i = it->columns_.begin(); i != it->columns_.end(); i++)
-            {
-                {
-                    query_result_unit_t result_unit;
-                    uint32_t t1;
-                    
-                    if (m_query->is_stat_table_query()) {
-                        assert(i->name.size()==4);
-                        assert(i->value.size()==1);                        
-                        try {
-                            t1 = boost::get<uint32_t>(i->name[2]);
-                        } catch (boost::bad_get& ex) {
-                            assert(0);
-                        }
-                    } else {
-                        int ts_at = i->name.size() - 1;
-                        assert(ts_at >= 0);
-                        
-                        try {
-                            t1 = boost::get<uint32_t>(i->name.at(ts_at));
-                        } catch (boost::bad_get& ex) {
-                            assert(0);
-                        }
-                    }
-                    result_unit.timestamp = TIMESTAMP_FROM_T2T1(t2, t1);
-
-                    if 
-                    ((result_unit.timestamp < m_query->from_time) ||
-                     (result_unit.timestamp > m_query->end_time))
-                    {
-                        //QE_TRACE(DEBUG, "Discarding timestamp "
-                        //        << result_unit.timestamp);
-                        // got a result outside of the time range
-                        continue;
-                    }
-
-                    // Add to result vector
-                    if (m_query->is_stat_table_query()) {
-                        std::string attribstr;
-                        boost::uuids::uuid uuid;
-
-                        try {
-                            uuid = boost::get<boost::uuids::uuid>(i->name[3]);
-                        } catch (boost::bad_get& ex) {
-                            QE_ASSERT(0);
-                        } catch (const std::out_of_range& oor) {
-                            QE_ASSERT(0);
-                        }
-
-                        try {
-                            attribstr = boost::get<std::string>(i->value[0]);
-                        } catch (boost::bad_get& ex) {
-                            QE_ASSERT(0);
-                        } catch (const std::out_of_range& oor) {
-                            QE_ASSERT(0);
-                        }
-
-                        result_unit.set_stattable_info(
-                            attribstr,
-                            uuid);
-                    } else {
-                        result_unit.info = i->value;
-                    }
-
-                    query_result.push_back(result_unit);
-                }
-            }
-        } // TBD handle database query errors
+    // The rows are read in parallel, their columns are added to the
+    // result one page at a time
+    if (!m_query->dbif->Db_GetMultiRowSlices(query_cfname, keys, cr,
+            boost::bind(&DbQueryUnit::process_columns, this, _1))) {
+        QE_IO_ERROR_RETURN(0, QUERY_FAILURE);
     }
 
     // Have the result ready and processing is done
@@ -135,3 +67,81 @@ query_status_t DbQueryUnit::process_query()
     parent_query->subquery_processed(this);
     return QUERY_SUCCESS;
 }
+
+void DbQueryUnit::process_columns(GenDb::ColList& col_list)
+{
+    AnalyticsQuery *m_query = (AnalyticsQuery *)main_query;
+    uint32_t t2 = boost::get<uint32_t>(col_list.rowkey_.at(0));
+    std::vector<GenDb::NewCol>::iterator i;
+
+    QE_TRACE(DEBUG, "For T2:" << t2 <<
+        " Database returned " << col_list.columns_.size() << " cols");
+
+    for (i = col_list.columns_.begin(); i != col_list.columns_.end(); i++)
+    {
+        {
+            query_result_unit_t result_unit;
+            uint32_t t1;
+            
+            if (m_query->is_stat_table_query()) {
+                assert(i->name.size()==4);
+                assert(i->value.size()==1);                        
+                try {
+                    t1 = boost::get<uint32_t>(i->name[2]);
+                } catch (boost::bad_get& ex) {
+                    assert(0);
+                }
+            } else {
+                int ts_at = i->name.size() - 1;
+                assert(ts_at >= 0);
+                
+                try {
+                    t1 = boost::get<uint32_t>(i->name.at(ts_at));
+                } catch (boost::bad_get& ex) {
+                    assert(0);
+                }
+            }
+            result_unit.timestamp = TIMESTAMP_FROM_T2T1(t2, t1);
+
+            if 
+            ((result_unit.timestamp < m_query->from_time) ||
+             (result_unit.timestamp > m_query->end_time))
+            {
+                //QE_TRACE(DEBUG, "Discarding timestamp "
+                //        << result_unit.timestamp);
+                // got a result outside of the time range
+                continue;
+            }
+
+            // Add to result vector
+            if (m_query->is_stat_table_query()) {
+                std::string attribstr;
+                boost::uuids::uuid uuid;
+
+                try {
+                    uuid = boost::get<boost::uuids::uuid>(i->name[3]);
+                } catch (boost::bad_get& ex) {
+                    QE_ASSERT(0);
+                } catch (const std::out_of_range& oor) {
+                    QE_ASSERT(0);
+                }
+
+                try {
+                    attribstr = boost::get<std::string>(i->value[0]);
+                } catch (boost::bad_get& ex) {
+                    QE_ASSERT(0);
+                } catch (const std::out_of_range& oor) {
+                    QE_ASSERT(0);
+                }
+
+                result_unit.set_stattable_info(
+                    attribstr,
+                    uuid);
+            } else {
+                result_unit.info = i->value;
+            }
+
+            query_result.push_back(result_unit);
+        }
+    }
+}
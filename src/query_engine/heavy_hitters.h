@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+/*
+ * This file has the interface for the bounded memory top N aggregation
+ * used by the approximate flow series queries
+ *
+ */
+
+#ifndef HEAVY_HITTERS_H_
+#define HEAVY_HITTERS_H_
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+#include <vector>
+#include <boost/array.hpp>
+#include <boost/functional/hash.hpp>
+#include "base/util.h"
+
+//
+// HeavyHitters
+// Finds the keys with the largest sums in a stream of weighted keys, in
+// one pass and in memory bounded by the sketch size and the number of
+// candidates, whatever the number of distinct keys.
+//
+// The sums of all the keys are estimated on a count-min sketch of depth
+// rows of width counters. A key is a candidate while its estimate is in
+// the top capacity estimates. The candidates are kept on a set ordered by
+// estimate, used as a min heap whose entries can be updated.
+//
+// An estimate is never below the sum of the key. It is above it by less
+// than epsilon() times the sum of all the weights, with a probability of
+// 1 - e^-depth. A key whose sum is above the error is a candidate at the
+// end, unless capacity keys have larger estimates.
+//
+// Each key has N sums, the candidates are ranked on the first one.
+//
+template <typename KeyT, size_t N, typename HashT = boost::hash<KeyT> >
+class HeavyHitters {
+public:
+    typedef boost::array<uint64_t, N> Counts;
+    typedef std::vector<std::pair<KeyT, Counts> > ResultT;
+
+    static const size_t kDefaultWidth = 2048;
+    static const size_t kDefaultDepth = 4;
+
+    explicit HeavyHitters(size_t capacity, size_t width = kDefaultWidth,
+                          size_t depth = kDefaultDepth) :
+        capacity_(capacity), width_(width), depth_(depth),
+        sketch_(width * depth) {
+        total_.assign(0);
+    }
+
+    void Update(const KeyT &key, const Counts &counts) {
+        size_t hash = hash_(key);
+        uint64_t estimate = std::numeric_limits<uint64_t>::max();
+        for (size_t row = 0; row < depth_; row++) {
+            Counts &cell = sketch_[row * width_ + Column(hash, row)];
+            for (size_t i = 0; i < N; i++) {
+                cell[i] += counts[i];
+            }
+            estimate = std::min(estimate, cell[0]);
+        }
+        for (size_t i = 0; i < N; i++) {
+            total_[i] += counts[i];
+        }
+        UpdateCandidate(key, estimate);
+    }
+
+    // Estimated sums of the key
+    Counts Estimate(const KeyT &key) const {
+        size_t hash = hash_(key);
+        Counts estimate;
+        estimate.assign(std::numeric_limits<uint64_t>::max());
+        for (size_t row = 0; row < depth_; row++) {
+            const Counts &cell = sketch_[row * width_ + Column(hash, row)];
+            for (size_t i = 0; i < N; i++) {
+                estimate[i] = std::min(estimate[i], cell[i]);
+            }
+        }
+        return estimate;
+    }
+
+    // The count candidates with the largest estimates, largest first
+    void Result(size_t count, ResultT *result) const {
+        result->clear();
+        result->reserve(candidates_.size());
+        for (typename CandidateMap::const_iterator it = candidates_.begin();
+             it != candidates_.end(); ++it) {
+            result->push_back(std::make_pair(it->first, Estimate(it->first)));
+        }
+        count = std::min(count, result->size());
+        std::partial_sort(result->begin(), result->begin() + count,
+                          result->end(), &HeavyHitters::IsLarger);
+        result->resize(count);
+    }
+
+    // Bound of the error of an estimate, relative to the sum of the weights
+    double epsilon() const { return kE / width_; }
+    const Counts &total() const { return total_; }
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return candidates_.size(); }
+
+private:
+    typedef std::map<KeyT, uint64_t> CandidateMap;
+    typedef std::set<std::pair<uint64_t, KeyT> > CandidateHeap;
+
+    static const double kE;
+
+    // Larger sum first, then the smaller key, for a stable order
+    static bool IsLarger(const std::pair<KeyT, Counts> &lhs,
+                         const std::pair<KeyT, Counts> &rhs) {
+        if (lhs.second[0] != rhs.second[0]) {
+            return lhs.second[0] > rhs.second[0];
+        }
+        return lhs.first < rhs.first;
+    }
+
+    // The rows need independent hashes, the key hash is mixed with the row
+    size_t Column(size_t hash, size_t row) const {
+        uint64_t h = hash ^ ((row + 1) * 0x9E3779B97F4A7C15ULL);
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h % width_;
+    }
+
+    void UpdateCandidate(const KeyT &key, uint64_t estimate) {
+        typename CandidateMap::iterator it = candidates_.find(key);
+        if (it != candidates_.end()) {
+            heap_.erase(std::make_pair(it->second, key));
+            it->second = estimate;
+            heap_.insert(std::make_pair(estimate, key));
+            return;
+        }
+        if (candidates_.size() >= capacity_) {
+            if (heap_.empty() || estimate <= heap_.begin()->first) {
+                return;
+            }
+            candidates_.erase(heap_.begin()->second);
+            heap_.erase(heap_.begin());
+        }
+        candidates_.insert(std::make_pair(key, estimate));
+        heap_.insert(std::make_pair(estimate, key));
+    }
+
+    const size_t capacity_;
+    const size_t width_;
+    const size_t depth_;
+    HashT hash_;
+    std::vector<Counts> sketch_;
+    Counts total_;
+    CandidateMap candidates_;
+    // Smallest estimate first
+    CandidateHeap heap_;
+
+    DISALLOW_COPY_AND_ASSIGN(HeavyHitters);
+};
+
+template <typename KeyT, size_t N, typename HashT>
+const double HeavyHitters<KeyT, N, HashT>::kE = 2.718281828459045;
+
+template <typename KeyT, size_t N, typename HashT>
+const size_t HeavyHitters<KeyT, N, HashT>::kDefaultWidth;
+
+template <typename KeyT, size_t N, typename HashT>
+const size_t HeavyHitters<KeyT, N, HashT>::kDefaultDepth;
+
+#endif // HEAVY_HITTERS_H_
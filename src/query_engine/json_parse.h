@@ -56,6 +56,9 @@ enum flow_dir_t {
 #define QUERY_AGG_STATS_TYPE        "stat_type"
 #define QUERY_FLOW_DIR          "dir"
 #define QUERY_FILTER            "filter"
+#define QUERY_TOPN              "topn"
+#define TOPN_EXACT                  "exact"
+#define TOPN_APPROXIMATE            "approximate"
 
  
 /**** END DERIVED SECTION ***********/
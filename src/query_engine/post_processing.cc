@@ -7,6 +7,7 @@
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 #include "query.h"
+#include "result_table.h"
 
 using boost::assign::map_list_of;
 
@@ -52,6 +53,15 @@ bool PostProcessingQuery::sort_field_comparator(
     return false;
 }
 
+// Sort the result on the sort fields. Only the first limit rows are
+// sorted, the rest are dropped by the limit anyway
+void PostProcessingQuery::sort_result(QEOpServerProxy::BufferT *result) {
+    ResultTable table(result);
+    table.Sort(sort_fields, sorting_type == ASCENDING,
+               limit > 0 ? limit : 0);
+    table.Materialize();
+}
+
 bool PostProcessingQuery::flowseries_merge_processing(
         const QEOpServerProxy::BufferT *raw_result,
         QEOpServerProxy::BufferT* merged_result, 
@@ -299,18 +309,7 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
             }
 
             if (sorted) {
-                QEOpServerProxy::BufferT *merged_result = &output;
-                if (sorting_type == ASCENDING) {
-                    std::sort(merged_result->begin(), merged_result->end(), 
-                              boost::bind(
-                                &PostProcessingQuery::sort_field_comparator, 
-                                          this, _1, _2)); 
-                } else {
-                    std::sort(merged_result->rbegin(), merged_result->rend(), 
-                              boost::bind(
-                                &PostProcessingQuery::sort_field_comparator,
-                                          this, _1, _2));
-                }
+                sort_result(&output);
             }
             goto limit;
         }
@@ -339,15 +338,7 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
         QE_TRACE(DEBUG, "Final_Merge_Processing: Done uniquify flow records");
         // Check if the result has to be sorted
         if (sorted) {
-            if (sorting_type == ASCENDING) {
-                std::sort(merged_result->begin(), merged_result->end(), 
-                          boost::bind(&PostProcessingQuery::sort_field_comparator, 
-                                      this, _1, _2)); 
-            } else {
-                std::sort(merged_result->rbegin(), merged_result->rend(), 
-                          boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                      this, _1, _2));
-            }
+            sort_result(merged_result);
         }
     } else {  // For non-flow-record queries
         // Check if the result has to be sorted
@@ -473,119 +464,36 @@ query_status_t PostProcessingQuery::process_query() {
         QE_TRACE(DEBUG, "# of entries filtered is " << num_filtered);
 
     }
-    if (filter_list.size() != 0)
-    {
-        QEOpServerProxy::BufferT filtered_table;
-        // do filter operation
-        QE_TRACE(DEBUG, "Doing filter operation");
-        for (size_t i = 0; i < raw_result->size(); i++)
-        {
-            bool delete_row = false;
-            QEOpServerProxy::ResultRowT row = (*raw_result)[i];
-
-            for (size_t j = 0; j < filter_list.size(); j++)
-            {
-                std::map<std::string, std::string>::iterator iter;
-                iter = row.first.find(filter_list[j].name);
-                if (iter == row.first.end())
-                {
-                    if (!(filter_list[j].ignore_col_absence))
-                        delete_row = true;
-                    break;
-                }
-
-                switch(filter_list[j].op)
-                {
-                    case EQUAL:
-                        if (filter_list[j].value != iter->second)
-                        {
-                            delete_row = true;
-                        }
-                        break;
-
-                    case NOT_EQUAL:
-                        if (filter_list[j].value == iter->second)
-                        {
-                            delete_row = true;
-                        }
-                        break;
-
-                    case LEQ:
-                        {
-                            int filter_value = 
-                                atoi(filter_list[j].value.c_str());
-                            int column_value= atoi(iter->second.c_str());
-                            if (column_value > filter_value)
-                            {
-                                delete_row = true;
-                            }
-                            break;
-                        }
-
-                    case GEQ:
-                        {
-                            int filter_value = 
-                                atoi(filter_list[j].value.c_str());
-                            int column_value= atoi(iter->second.c_str());
-                            if (column_value < filter_value)
-                            {
-                                delete_row = true;
-                            }
-                            break;
-                        }
-
-                    case REGEX_MATCH:
-                        {
-                            if (!boost::regex_match(iter->second, 
-                                        filter_list[j].match_e))
-                            {
-                                delete_row = true;
-                            }
-                            break;
-                        }
-
-                    default:
-                        // upsupported filter operation
-                        QE_ASSERT(0);
-                        break;
-                }
-                if (delete_row == true)
-                    break;
-            }
- 
-            if (delete_row == true)
-            {
-                QE_TRACE(DEBUG, "filter out entry #:" << i);
-            } else {
-                filtered_table.push_back(row);
-            }
-        }
-        *raw_result = filtered_table;
-    }
-
-    // Check if the result has to be sorted
-    if (sorted) {
-        if (sorting_type == ASCENDING) {
-            std::sort(raw_result->begin(), raw_result->end(), 
-                      boost::bind(&PostProcessingQuery::sort_field_comparator, 
-                                  this, _1, _2)); 
-        } else {
-            std::sort(raw_result->rbegin(), raw_result->rend(), 
-                      boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                  this, _1, _2));
-        }
-    }
-
     // If the flow series query is parallelized, we should apply the limit 
     // only after the result from all the tasks are merged 
     // (@ final_merge_processing).
+    size_t result_limit = 0;
     if ((mquery->table != g_viz_constants.FLOW_SERIES_TABLE || 
         (mquery->table == g_viz_constants.FLOW_SERIES_TABLE && 
         !mquery->is_query_parallelized())) && limit) {
-        QE_TRACE(DEBUG, "Apply Limit [" << limit << "]");
-        if (raw_result->size() > (size_t)limit) {
-            raw_result->resize(limit);
+        result_limit = limit;
+    }
+
+    // Filter, sort and limit work on the columns of the result and the
+    // rows are reordered only once, at the end
+    if (filter_list.size() != 0 || sorted || result_limit) {
+        ResultTable table(raw_result);
+        if (filter_list.size() != 0) {
+            QE_TRACE(DEBUG, "Doing filter operation");
+            size_t num_rows = table.size();
+            table.Filter(filter_list);
+            QE_TRACE(DEBUG, "# of entries filtered is " <<
+                     num_rows - table.size());
+        }
+        if (result_limit) {
+            QE_TRACE(DEBUG, "Apply Limit [" << limit << "]");
+        }
+        if (sorted) {
+            table.Sort(sort_fields, sorting_type == ASCENDING, result_limit);
+        } else {
+            table.Limit(result_limit);
         }
+        table.Materialize();
     }
 
     if (IS_TRACE_ENABLED(POSTPROCESS_RESULT_TRACE))
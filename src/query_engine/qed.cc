@@ -97,6 +97,7 @@ bool QedVersion(std::string &version) {
 #include <csignal>
 
 static EventManager * pevm = NULL;
+static QueryEngine * pqe = NULL;
 static void terminate_qe (int param)
 {
   pevm->Shutdown();
@@ -115,6 +116,33 @@ static void WaitForIdle() {
 }
 
 uint64_t QueryEngine::anal_ttl = 0;
+uint64_t QueryEngine::max_cache_size = 0;
+uint64_t QueryEngine::stat_rollup_stime = 0;
+
+void QueryCacheStatsReq::HandleRequest() const {
+    QueryCacheStatsResp *resp = new QueryCacheStatsResp;
+    QueryCache *cache = pqe ? pqe->GetCache() : NULL;
+    resp->set_enabled(cache != NULL);
+    if (cache) {
+        QueryCache::Stats stats;
+        cache->GetStats(&stats);
+        QueryCacheStats qcs;
+        qcs.set_entries(stats.entries);
+        qcs.set_bytes(stats.bytes);
+        qcs.set_max_bytes(cache->max_bytes());
+        qcs.set_lookups(stats.lookups);
+        qcs.set_hits(stats.hits);
+        qcs.set_misses(stats.lookups - stats.hits);
+        qcs.set_hit_rate(stats.lookups ?
+            (double)stats.hits / stats.lookups : 0);
+        qcs.set_hit_bytes(stats.hit_bytes);
+        qcs.set_inserts(stats.inserts);
+        qcs.set_evictions(stats.evictions);
+        resp->set_stats(qcs);
+    }
+    resp->set_context(context());
+    resp->Response();
+}
 
 int
 main(int argc, char *argv[]) {
@@ -165,6 +193,9 @@ main(int argc, char *argv[]) {
         ("start-time",
          opt::value<uint64_t>(),
          "Lowest start time for queries")
+        ("query-cache-size",
+         opt::value<int>()->default_value(256),
+         "Size(MB) of the query result cache, 0 to disable it")
         ;
     opt::variables_map var_map;
     opt::store(opt::parse_command_line(argc, argv, desc), var_map);
@@ -188,6 +219,8 @@ main(int argc, char *argv[]) {
         LoggingInit(var_map["log-file"].as<string>());
     }
     QueryEngine::anal_ttl = var_map["analytics-data-ttl"].as<int>();
+    QueryEngine::max_cache_size =
+        (uint64_t)var_map["query-cache-size"].as<int>() * 1024 * 1024;
 
     error_code error;
     string hostname(ip::host_name(error));
@@ -268,7 +301,7 @@ main(int argc, char *argv[]) {
             var_map["redis-ip"].as<string>(),
             var_map["redis-port"].as<int>());
     }
-    (void) qe;
+    pqe = qe;
 
     CpuLoadData::Init();
     qe_info_trigger =
@@ -287,6 +320,7 @@ main(int argc, char *argv[]) {
     qe_info_log_timer->Cancel();
     TimerManager::DeleteTimer(qe_info_log_timer);
     WaitForIdle();
+    pqe = NULL;
     delete qe;
     Sandesh::Uninit();
     WaitForIdle();
@@ -251,14 +251,15 @@ void AnalyticsQuery::get_query_details(bool& is_merge_needed, bool& is_map_outpu
     QE_TRACE(DEBUG, "time_slice is " << time_slice);
     if (status_details == 0)
     {
-        for (uint64_t chunk_start = original_from_time; 
+        for (uint64_t chunk_start = chunk_base_time; 
                 chunk_start < original_end_time; chunk_start += time_slice)
         {
-            if ((chunk_start+time_slice) <= original_end_time) {
-                chunk_sizes.push_back(time_slice);
-            } else {
-                chunk_sizes.push_back((original_end_time - chunk_start));
+            uint64_t chunk_end = chunk_start + time_slice;
+            if (chunk_end > original_end_time) {
+                chunk_end = original_end_time;
             }
+            chunk_sizes.push_back(chunk_end -
+                std::max(chunk_start, original_from_time));
         }
     } else {
         chunk_sizes.push_back(0); // just return some dummy value
@@ -281,6 +282,31 @@ void AnalyticsQuery::get_query_details(bool& is_merge_needed, bool& is_map_outpu
     is_map_output = is_stat_table_query();
 }
 
+void AnalyticsQuery::get_cache_details(std::string& cache_key,
+        std::vector<uint64_t>& cache_buckets)
+{
+    if (status_details != 0 || !cacheable_) {
+        return;
+    }
+
+    cache_key = QueryCache::QueryKey(json_api_data_, time_slice);
+    uint64_t now = UTCTimestampUsec();
+    for (uint64_t chunk_start = chunk_base_time; 
+            chunk_start < original_end_time; chunk_start += time_slice)
+    {
+        // Only the buckets that are fully in the time range, and that
+        // do not get new samples anymore
+        uint64_t chunk_end = chunk_start + time_slice;
+        if (chunk_start >= original_from_time &&
+            chunk_end - 1 <= original_end_time &&
+            chunk_end + QueryCache::kSettleTime <= now) {
+            cache_buckets.push_back(chunk_start);
+        } else {
+            cache_buckets.push_back(0);
+        }
+    }
+}
+
 AnalyticsQuery::AnalyticsQuery(GenDb::GenDbIf *db_if, std::string qid,
     std::map<std::string, std::string>& json_api_data, 
     uint64_t analytics_start_time) : QueryUnit(NULL, this),
@@ -305,6 +331,22 @@ bool AnalyticsQuery::can_parallelize_query() {
     return parallelize_query_;
 }
 
+/*
+ * The result of a chunk is cached only if it depends on nothing but the
+ * rows in the time bucket of the chunk
+ */
+bool AnalyticsQuery::can_cache_query() {
+    // Flow records are updated after they are written
+    if (table == g_viz_constants.FLOW_TABLE) {
+        return false;
+    }
+    // The flow series time samples are relative to the query start time
+    if (selectquery_->provide_timeseries && selectquery_->granularity) {
+        return false;
+    }
+    return true;
+}
+
 void AnalyticsQuery::Init(GenDb::GenDbIf *db_if, std::string qid,
     std::map<std::string, std::string>& json_api_data, 
     uint64_t analytics_start_time)
@@ -315,6 +357,7 @@ void AnalyticsQuery::Init(GenDb::GenDbIf *db_if, std::string qid,
     
     // populate fields 
     query_id = qid;
+    stat_rollup_index_ = -1;
 
     // Initialize database
     query_result_unit_t::dbif = db_if;
@@ -459,14 +502,28 @@ void AnalyticsQuery::Init(GenDb::GenDbIf *db_if, std::string qid,
         selectquery_->stats_->SetSortOrder(postprocess_->sort_fields);
     }
 
+    if (table == g_viz_constants.FLOW_SERIES_TABLE) {
+        select_fs_topn(json_api_data);
+        if (this->status_details != 0) {
+            QE_LOG_GLOBAL(DEBUG, "Error in topn parsing");
+            return;
+        }
+    }
+
     // just to take care of issues with Analytics start time 
          if (from_time > end_time)
             from_time = end_time - 1; 
 
+    if (this->is_stat_table_query()) {
+        select_stat_rollup();
+    }
+
     // Get the right job slice for parallelization
     original_from_time = from_time;
     original_end_time = end_time;
 
+    cacheable_ = false;
+    chunk_base_time = original_from_time;
     if (can_parallelize_query()) {
         time_slice = ((end_time - from_time)/total_parallel_batches) + 1;
 
@@ -474,6 +531,19 @@ void AnalyticsQuery::Init(GenDb::GenDbIf *db_if, std::string qid,
             time_slice = pow(2,g_viz_constants.RowTimeInBits);
         } 
 
+        // Slice a cacheable query on absolute time buckets, the next
+        // query with a sliding window then gets the same buckets
+        if (can_cache_query()) {
+            uint64_t bucket = pow(2,g_viz_constants.RowTimeInBits);
+            while (bucket < time_slice) {
+                bucket <<= 1;
+            }
+            time_slice = bucket;
+            chunk_base_time = original_from_time - 
+                (original_from_time % time_slice);
+            cacheable_ = true;
+        }
+
         // Adjust the time_slice for Flowseries query, if time granularity is 
         // specified. Divide the query based on the time granularity.
         if (selectquery_->provide_timeseries && selectquery_->granularity) {
@@ -505,8 +575,15 @@ void AnalyticsQuery::Init(GenDb::GenDbIf *db_if, std::string qid,
     }
 
     from_time = 
-        original_from_time + time_slice*parallel_batch_num;
+        chunk_base_time + time_slice*parallel_batch_num;
     end_time = from_time + time_slice;
+    if (cacheable_) {
+        // Buckets do not overlap, a sample is in one chunk only
+        end_time--;
+        if (from_time < original_from_time) {
+            from_time = original_from_time;
+        }
+    }
     if (from_time >= original_end_time)
     {
         processing_needed = false;
@@ -994,6 +1071,7 @@ QueryEngine::QueryEngine(EventManager *evm,
         dbif_(GenDb::GenDbIf::GenDbIfImpl(evm->io_service(), 
             boost::bind(&QueryEngine::db_err_handler, this),
             cassandra_ip, cassandra_port, 0, "QueryEngine")),
+        cache_(max_cache_size ? new QueryCache(max_cache_size) : NULL),
         qosp_(new QEOpServerProxy(evm,
             this, redis_ip, redis_port)),
         evm_(evm),
@@ -1079,6 +1157,14 @@ QueryEngine::QueryEngine(EventManager *evm,
                             QE_LOG_NOQID(ERROR, __func__ << "Exception for boost::get, what=" << ex.what());
                             break;
                         }
+                    } else if (col_name ==
+                        g_viz_constants.SYSTEM_OBJECT_STAT_ROLLUP_START_TIME) {
+                        try {
+                            stat_rollup_stime =
+                                boost::get<uint64_t>(it->value.at(0));
+                        } catch (boost::bad_get& ex) {
+                            QE_LOG_NOQID(ERROR, __func__ << "Exception for boost::get, what=" << ex.what());
+                        }
                     }
                 }
             }
@@ -1099,12 +1185,15 @@ QueryEngine::QueryEngine(EventManager *evm,
 using std::vector;
 
 int
-QueryEngine::QueryPrepare(QueryParams qp,
+QueryEngine::QueryPrepare(QueryParams &qp,
         std::vector<uint64_t> &chunk_size,
         bool & need_merge, bool & map_output,
         std::string& where, std::string& select, std::string& post,
         uint64_t& time_period, 
-        std::string &table) {
+        std::string &table,
+        std::string &cache_key,
+        std::vector<uint64_t> &cache_buckets,
+        std::string &topn) {
     string& qid = qp.qid;
     QE_LOG_NOQID(INFO, 
              " Got Query to prepare for QID " << qid);
@@ -1123,6 +1212,15 @@ QueryEngine::QueryPrepare(QueryParams qp,
         q->get_query_details(need_merge, map_output, chunk_size,
             where, select, post, time_period, ret_code);
         table = q->table;
+        if (ret_code == 0) {
+            // "now" relative times would otherwise move between chunks
+            qp.terms[QUERY_START_TIME] = integerToString(q->req_from_time);
+            qp.terms[QUERY_END_TIME] = integerToString(q->req_end_time);
+            if (cache_) {
+                q->get_cache_details(cache_key, cache_buckets);
+            }
+            topn = q->topn_mode();
+        }
         delete q;
     }
     return ret_code;
@@ -1282,6 +1380,102 @@ int AnalyticsQuery::stat_table_index() {
     return -1;
 }
 
+/*
+ * Use the coarsest stats rollup that gives the same result as the raw
+ * samples. The WHERE must be a single match, as the rollups are per tag
+ * and have no sample UUIDs to intersect or unite. The query must cover
+ * whole periods of the rollup, and the SELECT must only need the
+ * aggregates and time bins the rollup keeps.
+ * The periods must also be in the rollup tables: the collector writes the
+ * samples it received every STAT_ROLLUP_FLUSH_TIME seconds, and only
+ * rollups of samples received after SYSTEM_OBJECT_STAT_ROLLUP_START_TIME
+ * exist.
+ */
+void AnalyticsQuery::select_stat_rollup() {
+    if (wherequery_->json_string_.empty()) {
+        return;
+    }
+    rapidjson::Document d;
+    std::string json_string = "{ \"where\" : " + 
+        wherequery_->json_string_ + " }";
+    d.Parse<0>(const_cast<char *>(json_string.c_str()));
+    if (d.HasParseError() || !d["where"].IsArray() ||
+        d["where"].Size() != 1 || !d["where"][0u].IsArray() ||
+        d["where"][0u].Size() != 1) {
+        return;
+    }
+
+    if (QueryEngine::stat_rollup_stime == 0 ||
+        from_time < QueryEngine::stat_rollup_stime) {
+        return;
+    }
+    // One flush interval for the last samples to be received, and one for
+    // them to be written
+    uint64_t flush_time =
+        (uint64_t)g_viz_constants.STAT_ROLLUP_FLUSH_TIME * 1000000;
+    uint64_t now = UTCTimestampUsec();
+    for (int i = g_viz_constants._STAT_ROLLUPS.size() - 1; i >= 0; i--) {
+        uint64_t period =
+            (uint64_t)g_viz_constants._STAT_ROLLUPS[i].period * 1000000;
+        if ((from_time % period) != 0 || ((end_time + 1) % period) != 0) {
+            continue;
+        }
+        if (end_time + 2 * flush_time >= now) {
+            continue;
+        }
+        if (!selectquery_->stats_->CanUseRollup(period)) {
+            continue;
+        }
+        stat_rollup_index_ = i;
+        QE_TRACE(DEBUG, "Stats query uses rollup of " <<
+                g_viz_constants._STAT_ROLLUPS[i].period << " seconds");
+        return;
+    }
+}
+
+void AnalyticsQuery::select_fs_topn(
+        const std::map<std::string, std::string>& json_api_data) {
+    std::map<std::string, std::string>::const_iterator iter =
+        json_api_data.find(QUERY_TOPN);
+    if (iter == json_api_data.end()) {
+        return;
+    }
+    QE_PARSE_ERROR(iter->second.size() >= 2);
+    //strip " from the passed string
+    std::string mode(iter->second.substr(1, iter->second.size()-2));
+    QE_INVALIDARG_ERROR(mode == TOPN_EXACT || mode == TOPN_APPROXIMATE);
+    topn_mode_ = TOPN_EXACT;
+    if (mode != TOPN_APPROXIMATE) {
+        return;
+    }
+
+    // The top N is on the first sort field, in descending order. A filter
+    // on the result could drop the candidates, the query is then exact
+    if (!postprocess_->sorted || postprocess_->sorting_type != DESCENDING ||
+        postprocess_->limit <= 0 || postprocess_->sort_fields.empty() ||
+        !postprocess_->filter_list.empty()) {
+        QE_TRACE(DEBUG, "topn query is exact, no sort and limit");
+        return;
+    }
+    if (selectquery_->SetTopN(postprocess_->sort_fields[0].name,
+                              postprocess_->limit)) {
+        topn_mode_ = TOPN_APPROXIMATE;
+    }
+    QE_TRACE(DEBUG, "topn query is " << topn_mode_);
+}
+
+std::string AnalyticsQuery::stat_rollup_cfname(const std::string& cfname) {
+    QE_ASSERT(stat_rollup_index_ != -1);
+    const stat_rollup& rollup = g_viz_constants._STAT_ROLLUPS[stat_rollup_index_];
+    if (cfname == g_viz_constants.STATS_TABLE_BY_U64_STR_TAG) {
+        return rollup.u64_tag_table;
+    } else if (cfname == g_viz_constants.STATS_TABLE_BY_DBL_STR_TAG) {
+        return rollup.dbl_tag_table;
+    }
+    QE_ASSERT(cfname == g_viz_constants.STATS_TABLE_BY_STR_STR_TAG);
+    return rollup.str_tag_table;
+}
+
 bool AnalyticsQuery::is_valid_from_field(const std::string& from_field)
 {
     for(size_t i = 0; i < g_viz_constants._TABLES.size(); i++)
@@ -72,6 +72,8 @@
 #include "../analytics/viz_message.h"
 #include "json_parse.h"
 #include "QEOpServerProxy.h"
+#include "query_cache.h"
+#include "heavy_hitters.h"
 #include "base/logging.h"
 #include <sandesh/sandesh_types.h>
 #include <sandesh/sandesh.h>
@@ -252,6 +254,20 @@ struct flow_tuple {
     uint32_t direction;
 };
 
+inline size_t hash_value(const flow_tuple& tuple) {
+    size_t seed = 0;
+    boost::hash_combine(seed, tuple.vrouter);
+    boost::hash_combine(seed, tuple.source_vn);
+    boost::hash_combine(seed, tuple.dest_vn);
+    boost::hash_combine(seed, tuple.source_ip);
+    boost::hash_combine(seed, tuple.dest_ip);
+    boost::hash_combine(seed, tuple.protocol);
+    boost::hash_combine(seed, tuple.source_port);
+    boost::hash_combine(seed, tuple.dest_port);
+    boost::hash_combine(seed, tuple.direction);
+    return seed;
+}
+
 struct uuid_flow_stats {
     uuid_flow_stats(uint64_t t, flow_stats stats) : 
         last_timestamp(t), last_stats(stats) {
@@ -345,6 +361,8 @@ public:
     QueryResultMetaData() { 
     }
     virtual ~QueryResultMetaData() = 0;
+    // Deep copy, used by the query result cache
+    virtual QueryResultMetaData *Clone() const = 0;
 };
 
 class fsMetaData : public QueryResultMetaData {
@@ -354,6 +372,9 @@ public:
     }
     ~fsMetaData() {
     }
+    virtual QueryResultMetaData *Clone() const {
+        return new fsMetaData(uuids);
+    }
     std::set<boost::uuids::uuid> uuids;
 };
 
@@ -380,6 +401,10 @@ public:
     GenDb::DbDataValueVec row_key_suffix;
     bool t_only_col;    // only T is in column name
     bool t_only_row;    // only T2 is in row key
+
+private:
+    // add a page of columns of a row to the result
+    void process_columns(GenDb::ColList& col_list);
 };
 
 // This class provides interface to process SET operations involved in the 
@@ -423,6 +448,9 @@ private:
     // the given time range
     void create_uuid_tuple_map(
             std::map<boost::uuids::uuid, GenDb::DbDataValueVec>& uuid_map);
+    void add_uuid_tuple_columns(
+            std::map<boost::uuids::uuid, GenDb::DbDataValueVec>& uuid_map,
+            const GenDb::DbDataValue& row_key_suffix, GenDb::ColList& col_list);
 
 
 };
@@ -515,6 +543,13 @@ public:
                     select_column_fields[0] == g_viz_constants.OBJECT_ID));
     }
 
+    // Aggregates a flow tuple and stats query on the approximate top
+    // limit flow classes on rank_field, in bounded memory, instead of on
+    // all the flow classes. Returns false if the query can not be
+    // approximated
+    bool SetTopN(const std::string& rank_field, size_t limit);
+    bool is_topn_query() { return fs_topn_.get() != NULL; }
+
 private:
     // 
     // Object table query
@@ -535,6 +570,9 @@ private:
     static const uint64_t kMicrosecInSec = 1000 * 1000;
   
     uint8_t fs_query_type_;
+    // Whether flow_count is selected, the flows of each aggregate are only
+    // kept for it
+    bool fs_flow_count_;
     bool is_flow_tuple_specified();
     void evaluate_fs_query_type();
     typedef void (SelectQuery::*process_fs_query_callback)(const uint64_t&, 
@@ -589,6 +627,19 @@ private:
             const boost::uuids::uuid&, const flow_stats&, const flow_tuple&);
     void populate_fs_query_result_with_ts_tuple_stats_fields();
 
+    // 4. SELECT with flow tuple fields, stats fields, for the top N flow
+    //    classes. The candidates are more than N, the chunk results are
+    //    merged before the final sort and limit
+    static const size_t kTopNCandidateFactor = 4;
+    static const size_t kTopNMinCandidates = 64;
+    typedef HeavyHitters<flow_tuple, 2> fs_topn_t;
+    boost::scoped_ptr<fs_topn_t> fs_topn_;
+    // Ranked on the packets instead of the bytes
+    bool fs_topn_pkts_;
+    void process_fs_query_with_tuple_stats_topn(const uint64_t&,
+            const boost::uuids::uuid&, const flow_stats&, const flow_tuple&);
+    void populate_fs_query_result_with_tuple_stats_topn();
+
     // Rare Flow series queries
 
     // 1. SELECT with stats fields
@@ -710,6 +761,7 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
                         QEOpServerProxy::BufferT& output);
 private:
     typedef std::map<uint64_t, QEOpServerProxy::ResultRowT> fcid_rrow_map_t;
+    void sort_result(QEOpServerProxy::BufferT *result);
     bool flowseries_merge_processing(
                 const QEOpServerProxy::BufferT *raw_result,
                 QEOpServerProxy::BufferT *merged_result,
@@ -810,6 +862,10 @@ public:
     bool processing_needed;
     // time slice for each parallel instance
     uint64_t time_slice;
+    // start time of the first time slice. When the query is cacheable,
+    // the time slices are aligned on multiples of time_slice and the
+    // first one may start before original_from_time.
+    uint64_t chunk_base_time;
     // this is for merge between multiple instances running on same core
     bool merge_processing(const QEOpServerProxy::BufferT& input,
                             QEOpServerProxy::BufferT& output);
@@ -826,27 +882,45 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
         std::string& post,
         uint64_t& time_period,
         int& parse_status);
+    // Key of the query in the result cache and, for each chunk, the start
+    // of its time bucket if the result of the chunk can be cached, else 0
+    void get_cache_details(std::string& cache_key,
+        std::vector<uint64_t>& cache_buckets);
 
     // validation functions
     bool is_valid_from_field(const std::string& from_field);
     bool is_object_table_query();
     bool is_stat_table_query();
     int  stat_table_index();
+    // Index in _STAT_ROLLUPS of the rollup used by the query, -1 if the
+    // query reads the raw samples
+    int  stat_rollup_index() { return stat_rollup_index_; }
+    std::string stat_rollup_cfname(const std::string& cfname);
     bool is_valid_select_field(const std::string& select_field);
     bool is_valid_where_field(const std::string& where_field);
     bool is_valid_sort_field(const std::string& sort_field);
     std::string get_column_field_datatype(const std::string& col_field);
     bool is_flow_query(); // either flow-series or flow-records query
     bool is_query_parallelized() { return parallelize_query_; }
+    bool is_query_cacheable() { return cacheable_; }
+    // TOPN_EXACT or TOPN_APPROXIMATE for a top N query, else empty
+    const std::string& topn_mode() const { return topn_mode_; }
     uint64_t parse_time(const std::string& relative_time);
 
     private:
     bool parallelize_query_;
+    bool cacheable_;
+    int stat_rollup_index_;
+    std::string topn_mode_;
     // Init function
     void Init(GenDb::GenDbIf *db_if, std::string qid,
     std::map<std::string, std::string>& json_api_data, 
     uint64_t analytics_start_time);
     bool can_parallelize_query();
+    bool can_cache_query();
+    void select_stat_rollup();
+    void select_fs_topn(
+        const std::map<std::string, std::string>& json_api_data);
 };
 
 // limit on the size of query result we can handle
@@ -870,6 +944,10 @@ public:
 
     uint64_t stime;
     static uint64_t anal_ttl; // TTL of analytics data in hours
+    static uint64_t max_cache_size; // result cache size in bytes, 0 disables
+    // time from which the stats samples are in the rollup tables, 0 if
+    // the collector doesn't write rollups
+    static uint64_t stat_rollup_stime;
 
     QueryEngine(EventManager *evm,
             const std::string & cassandra_ip, unsigned short cassandra_port,
@@ -878,13 +956,18 @@ public:
     QueryEngine(EventManager *evm,
             const std::string & redis_ip, unsigned short redis_port);
     
+    // The time range in qp.terms is set to the absolute times, so that
+    // all the chunks of the query see the same time range
     int
-    QueryPrepare(QueryParams qp,
+    QueryPrepare(QueryParams &qp,
         std::vector<uint64_t> &chunk_size,
         bool & need_merge, bool & map_output,
         std::string& where, std::string& select, std::string& post,
         uint64_t& time_period, 
-        std::string &table);
+        std::string &table,
+        std::string &cache_key,
+        std::vector<uint64_t> &cache_buckets,
+        std::string &topn);
 
     bool
     QueryExec(void * handle, QueryParams qp, uint32_t chunk);
@@ -908,8 +991,13 @@ public:
     void QueryEngine_Test();
 
     void db_err_handler() {};
+
+    // NULL if the result cache is disabled
+    QueryCache *GetCache() { return cache_.get(); }
 private:
     boost::scoped_ptr<GenDb::GenDbIf> dbif_;
+    // Before qosp_, which starts running queries when it is created
+    boost::scoped_ptr<QueryCache> cache_;
     boost::scoped_ptr<QEOpServerProxy> qosp_;
     EventManager *evm_;
     unsigned short cassandra_port_;
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "query_cache.h"
+#include "json_parse.h"
+#include "query.h"
+
+using std::string;
+
+namespace {
+
+// Rough memory used by the strings of a row, with the map node overhead
+const size_t kNodeBytes = 64;
+
+size_t SubValBytes(const QEOpServerProxy::SubVal &val) {
+    if (val.which() == QEOpServerProxy::STRING) {
+        return boost::get<string>(val).size() + sizeof(val);
+    }
+    return sizeof(val);
+}
+
+// Drops the white space outside of the JSON strings
+string NormalizeTerm(const string &value) {
+    string norm;
+    norm.reserve(value.size());
+    bool in_string = false;
+    for (size_t i = 0; i < value.size(); i++) {
+        char c = value[i];
+        if (in_string) {
+            norm += c;
+            if (c == '\\' && i + 1 < value.size()) {
+                norm += value[++i];
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (!isspace(c)) {
+            norm += c;
+            in_string = (c == '"');
+        }
+    }
+    return norm;
+}
+
+} // namespace
+
+const uint64_t QueryCache::kSettleTime;
+
+QueryCache::QueryCache(size_t max_bytes) : max_bytes_(max_bytes) {
+}
+
+QueryCache::~QueryCache() {
+    STLDeleteElements(&entries_);
+}
+
+string QueryCache::QueryKey(const std::map<string, string> &terms,
+                            uint64_t bucket_size) {
+    string key(integerToString(bucket_size));
+    for (std::map<string, string>::const_iterator it = terms.begin();
+         it != terms.end(); ++it) {
+        // The time range is in the bucket, the rest is bookkeeping
+        if (it->first == QUERY_START_TIME || it->first == QUERY_END_TIME ||
+            it->first == "enqueue_time" || it->first == "query_metadata") {
+            continue;
+        }
+        key += "|" + it->first + "=" + NormalizeTerm(it->second);
+    }
+    return key;
+}
+
+void QueryCache::CopyResult(const QEOpServerProxy::BufferT &src,
+                            QEOpServerProxy::BufferT *dst) {
+    dst->reserve(dst->size() + src.size());
+    for (QEOpServerProxy::BufferT::const_iterator it = src.begin();
+         it != src.end(); ++it) {
+        QEOpServerProxy::MetadataT metadata;
+        if (it->second.get()) {
+            metadata.reset(it->second->Clone());
+        }
+        dst->push_back(std::make_pair(it->first, metadata));
+    }
+}
+
+size_t QueryCache::ResultBytes(
+        const QEOpServerProxy::BufferT &result,
+        const QEOpServerProxy::OutRowMultimapT &mresult) {
+    size_t bytes = 0;
+    for (QEOpServerProxy::BufferT::const_iterator it = result.begin();
+         it != result.end(); ++it) {
+        bytes += sizeof(*it);
+        for (QEOpServerProxy::OutRowT::const_iterator cit = it->first.begin();
+             cit != it->first.end(); ++cit) {
+            bytes += cit->first.size() + cit->second.size() + kNodeBytes;
+        }
+        if (it->second.get()) {
+            fsMetaData *metadata = dynamic_cast<fsMetaData *>(it->second.get());
+            if (metadata) {
+                bytes += metadata->uuids.size() *
+                    (sizeof(boost::uuids::uuid) + kNodeBytes);
+            }
+        }
+    }
+    for (QEOpServerProxy::OutRowMultimapT::const_iterator it = mresult.begin();
+         it != mresult.end(); ++it) {
+        bytes += kNodeBytes;
+        for (size_t i = 0; i < it->first.size(); i++) {
+            bytes += SubValBytes(it->first[i]);
+        }
+        for (std::map<string, QEOpServerProxy::SubVal>::const_iterator uit =
+             it->second.first.begin(); uit != it->second.first.end(); ++uit) {
+            bytes += uit->first.size() + SubValBytes(uit->second) + kNodeBytes;
+        }
+        for (QEOpServerProxy::AggRowT::const_iterator ait =
+             it->second.second.begin(); ait != it->second.second.end(); ++ait) {
+            bytes += ait->first.second.size() + SubValBytes(ait->second) +
+                kNodeBytes;
+        }
+    }
+    return bytes;
+}
+
+bool QueryCache::Lookup(const string &key, uint64_t bucket,
+                        QEOpServerProxy::BufferT *result,
+                        QEOpServerProxy::OutRowMultimapT *mresult) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    stats_.lookups++;
+    EntryMap::iterator it = entries_.find(std::make_pair(key, bucket));
+    if (it == entries_.end()) {
+        return false;
+    }
+    Entry *entry = it->second;
+    lru_.splice(lru_.begin(), lru_, entry->lru);
+    stats_.hits++;
+    stats_.hit_bytes += entry->bytes;
+
+    CopyResult(entry->result, result);
+    mresult->insert(entry->mresult.begin(), entry->mresult.end());
+    return true;
+}
+
+void QueryCache::Insert(const string &key, uint64_t bucket,
+                        const QEOpServerProxy::BufferT *result,
+                        const QEOpServerProxy::OutRowMultimapT *mresult) {
+    std::auto_ptr<Entry> entry(new Entry);
+    if (result) {
+        CopyResult(*result, &entry->result);
+    }
+    if (mresult) {
+        entry->mresult = *mresult;
+    }
+    entry->bytes = ResultBytes(entry->result, entry->mresult);
+    if (entry->bytes > max_bytes_) {
+        return;
+    }
+
+    tbb::mutex::scoped_lock lock(mutex_);
+    CacheKey ckey(key, bucket);
+    // Another query may have cached the same bucket meanwhile
+    if (entries_.find(ckey) != entries_.end()) {
+        return;
+    }
+    entry->lru = lru_.insert(lru_.begin(), ckey);
+    stats_.bytes += entry->bytes;
+    stats_.inserts++;
+    entries_.insert(std::make_pair(ckey, entry.release()));
+    Evict();
+}
+
+// Called with the mutex held
+void QueryCache::Evict() {
+    while (stats_.bytes > max_bytes_ && !lru_.empty()) {
+        EntryMap::iterator it = entries_.find(lru_.back());
+        assert(it != entries_.end());
+        stats_.bytes -= it->second->bytes;
+        stats_.evictions++;
+        delete it->second;
+        entries_.erase(it);
+        lru_.pop_back();
+    }
+}
+
+void QueryCache::GetStats(Stats *stats) const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    *stats = stats_;
+    stats->entries = entries_.size();
+}
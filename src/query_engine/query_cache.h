@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+/*
+ * This file has the interface for the cache of per chunk query results
+ * used by the QEOpServerProxy pipeline
+ *
+ */
+
+#ifndef QUERY_CACHE_H_
+#define QUERY_CACHE_H_
+
+#include <list>
+#include <map>
+#include <string>
+#include <tbb/mutex.h>
+#include "base/util.h"
+#include "QEOpServerProxy.h"
+
+//
+// QueryCache
+// Caches the result of a query chunk, keyed by the query without its time
+// range and the start of the time bucket covered by the chunk.
+//
+// Queries that can use the cache are split into chunks on absolute time
+// buckets (see AnalyticsQuery::is_query_cacheable), so a query repeated
+// with a sliding time window has the same buckets as the previous one,
+// except for the oldest and the newest. Only buckets that are fully inside
+// the time range and closed, i.e. older than kSettleTime, are cached. The
+// others are read from the database every time.
+//
+// Entries are evicted on LRU once the cache is over its size in bytes.
+// The rows are copied in and out of the cache, the pipeline merges the
+// chunk results in place.
+//
+class QueryCache {
+public:
+    // Samples can reach the database this late after their timestamp
+    static const uint64_t kSettleTime = 120 * 1000000ULL;
+
+    struct Stats {
+        Stats() : entries(0), bytes(0), lookups(0), hits(0), hit_bytes(0),
+            inserts(0), evictions(0) {
+        }
+        uint64_t entries;
+        uint64_t bytes;
+        uint64_t lookups;
+        uint64_t hits;
+        uint64_t hit_bytes;
+        uint64_t inserts;
+        uint64_t evictions;
+    };
+
+    explicit QueryCache(size_t max_bytes);
+    ~QueryCache();
+
+    // Key of the query, from all the query terms except the time range.
+    // The bucket size is part of the key, a bucket start is only unique
+    // for a given bucket size.
+    static std::string QueryKey(
+        const std::map<std::string, std::string> &terms,
+        uint64_t bucket_size);
+
+    // Copies the cached result of the bucket to result and mresult
+    bool Lookup(const std::string &key, uint64_t bucket,
+                QEOpServerProxy::BufferT *result,
+                QEOpServerProxy::OutRowMultimapT *mresult);
+    void Insert(const std::string &key, uint64_t bucket,
+                const QEOpServerProxy::BufferT *result,
+                const QEOpServerProxy::OutRowMultimapT *mresult);
+
+    void GetStats(Stats *stats) const;
+    size_t max_bytes() const { return max_bytes_; }
+
+private:
+    typedef std::pair<std::string, uint64_t> CacheKey;
+    typedef std::list<CacheKey> LruList;
+
+    struct Entry {
+        QEOpServerProxy::BufferT result;
+        QEOpServerProxy::OutRowMultimapT mresult;
+        size_t bytes;
+        LruList::iterator lru;
+    };
+    typedef std::map<CacheKey, Entry *> EntryMap;
+
+    static void CopyResult(const QEOpServerProxy::BufferT &src,
+                           QEOpServerProxy::BufferT *dst);
+    static size_t ResultBytes(const QEOpServerProxy::BufferT &result,
+                              const QEOpServerProxy::OutRowMultimapT &mresult);
+    void Evict();
+
+    const size_t max_bytes_;
+    mutable tbb::mutex mutex_;
+    EntryMap entries_;
+    // Most recently used first
+    LruList lru_;
+    Stats stats_;
+
+    DISALLOW_COPY_AND_ASSIGN(QueryCache);
+};
+
+#endif // QUERY_CACHE_H_
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <boost/unordered_map.hpp>
+#include "result_table.h"
+
+namespace {
+
+bool FilterMatch(const filter_match_t &filter, const std::string &value) {
+    switch (filter.op) {
+    case EQUAL:
+        return (filter.value == value);
+    case NOT_EQUAL:
+        return (filter.value != value);
+    case LEQ:
+        return (atoi(value.c_str()) <= atoi(filter.value.c_str()));
+    case GEQ:
+        return (atoi(value.c_str()) >= atoi(filter.value.c_str()));
+    case REGEX_MATCH:
+        return boost::regex_match(value, filter.match_e);
+    default:
+        // upsupported filter operation
+        QE_ASSERT(0);
+        return false;
+    }
+}
+
+// Orders dictionary codes on the dictionary value
+struct DictionaryCompare {
+    explicit DictionaryCompare(const std::vector<std::string> &dictionary) :
+        dictionary_(dictionary) {
+    }
+    bool operator()(uint32_t lhs, uint32_t rhs) const {
+        return dictionary_[lhs] < dictionary_[rhs];
+    }
+    const std::vector<std::string> &dictionary_;
+};
+
+} // namespace
+
+// Orders row indexes on the sort keys, in the order of the sort fields
+struct ResultTable::KeyCompare {
+    KeyCompare(const std::vector<KeyVector> &keys, bool ascending) :
+        keys_(keys), ascending_(ascending) {
+    }
+    bool operator()(uint32_t lhs, uint32_t rhs) const {
+        for (std::vector<KeyVector>::const_iterator it = keys_.begin();
+             it != keys_.end(); ++it) {
+            uint64_t lhs_val = (*it)[lhs];
+            uint64_t rhs_val = (*it)[rhs];
+            if (lhs_val != rhs_val) {
+                return ascending_ ? (lhs_val < rhs_val) : (lhs_val > rhs_val);
+            }
+        }
+        return false;
+    }
+    const std::vector<KeyVector> &keys_;
+    bool ascending_;
+};
+
+const uint32_t ResultTable::kAbsent;
+
+ResultTable::ResultTable(QEOpServerProxy::BufferT *rows) : rows_(rows) {
+    selection_.reserve(rows_->size());
+    for (size_t idx = 0; idx < rows_->size(); ++idx) {
+        selection_.push_back(idx);
+    }
+}
+
+ResultTable::~ResultTable() {
+    STLDeleteElements(&columns_);
+}
+
+const ResultTable::Column &ResultTable::GetColumn(const std::string &name) {
+    ColumnMap::iterator it = columns_.find(name);
+    if (it != columns_.end()) {
+        return *it->second;
+    }
+
+    // Only the selected rows are encoded. Rows dropped earlier keep the
+    // absent code and are never looked at again
+    typedef boost::unordered_map<std::string, uint32_t> DictionaryIndex;
+    DictionaryIndex index;
+    Column *column = new Column;
+    column->codes.resize(rows_->size(), kAbsent);
+    for (std::vector<uint32_t>::const_iterator sit = selection_.begin();
+         sit != selection_.end(); ++sit) {
+        const QEOpServerProxy::OutRowT &row = (*rows_)[*sit].first;
+        QEOpServerProxy::OutRowT::const_iterator vit = row.find(name);
+        if (vit == row.end()) {
+            continue;
+        }
+        std::pair<DictionaryIndex::iterator, bool> ret =
+            index.insert(std::make_pair(vit->second,
+                                        column->dictionary.size()));
+        if (ret.second) {
+            column->dictionary.push_back(vit->second);
+        }
+        column->codes[*sit] = ret.first->second;
+    }
+    columns_.insert(std::make_pair(name, column));
+    return *column;
+}
+
+void ResultTable::Filter(const std::vector<filter_match_t> &filters) {
+    if (filters.empty()) {
+        return;
+    }
+
+    std::vector<char> keep(rows_->size(), 0);
+    std::vector<uint32_t> pending(selection_);
+    for (std::vector<filter_match_t>::const_iterator fit = filters.begin();
+         fit != filters.end() && !pending.empty(); ++fit) {
+        const Column &column = GetColumn(fit->name);
+        std::vector<char> match(column.dictionary.size());
+        for (size_t code = 0; code < column.dictionary.size(); ++code) {
+            match[code] = FilterMatch(*fit, column.dictionary[code]);
+        }
+
+        size_t count = 0;
+        for (size_t i = 0; i < pending.size(); ++i) {
+            uint32_t code = column.codes[pending[i]];
+            if (code == kAbsent) {
+                keep[pending[i]] = fit->ignore_col_absence;
+                continue;
+            }
+            if (match[code]) {
+                pending[count++] = pending[i];
+            }
+        }
+        pending.resize(count);
+    }
+    for (size_t i = 0; i < pending.size(); ++i) {
+        keep[pending[i]] = 1;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < selection_.size(); ++i) {
+        if (keep[selection_[i]]) {
+            selection_[count++] = selection_[i];
+        }
+    }
+    selection_.resize(count);
+}
+
+void ResultTable::BuildSortKey(const sort_field_t &field, KeyVector *keys) {
+    const Column &column = GetColumn(field.name);
+    size_t size = column.dictionary.size();
+    KeyVector value(size, 0);
+    if (field.type == std::string("int") ||
+        field.type == std::string("long") ||
+        field.type == std::string("ipv4")) {
+        for (size_t code = 0; code < size; ++code) {
+            stringToInteger(column.dictionary[code], value[code]);
+        }
+    } else {
+        std::vector<uint32_t> order(size);
+        for (size_t code = 0; code < size; ++code) {
+            order[code] = code;
+        }
+        std::sort(order.begin(), order.end(),
+                  DictionaryCompare(column.dictionary));
+        for (size_t rank = 0; rank < size; ++rank) {
+            value[order[rank]] = rank;
+        }
+    }
+
+    keys->resize(rows_->size(), 0);
+    for (std::vector<uint32_t>::const_iterator sit = selection_.begin();
+         sit != selection_.end(); ++sit) {
+        uint32_t code = column.codes[*sit];
+        QE_ASSERT(code != kAbsent);
+        (*keys)[*sit] = value[code];
+    }
+}
+
+void ResultTable::Sort(const std::vector<sort_field_t> &fields,
+                       bool ascending, size_t limit) {
+    if (fields.empty() || selection_.size() < 2) {
+        Limit(limit);
+        return;
+    }
+
+    std::vector<KeyVector> keys(fields.size());
+    for (size_t i = 0; i < fields.size(); ++i) {
+        BuildSortKey(fields[i], &keys[i]);
+    }
+    KeyCompare compare(keys, ascending);
+    if (limit && limit < selection_.size()) {
+        std::partial_sort(selection_.begin(), selection_.begin() + limit,
+                          selection_.end(), compare);
+        selection_.resize(limit);
+    } else {
+        std::sort(selection_.begin(), selection_.end(), compare);
+    }
+}
+
+void ResultTable::Limit(size_t limit) {
+    if (limit && limit < selection_.size()) {
+        selection_.resize(limit);
+    }
+}
+
+void ResultTable::Materialize() {
+    QEOpServerProxy::BufferT result(selection_.size());
+    for (size_t i = 0; i < selection_.size(); ++i) {
+        QEOpServerProxy::ResultRowT &row = (*rows_)[selection_[i]];
+        result[i].first.swap(row.first);
+        result[i].second.swap(row.second);
+    }
+    rows_->swap(result);
+    selection_.clear();
+    STLDeleteElements(&columns_);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+/*
+ * This file has the interface for the column oriented view of a query
+ * result used by the post processing (filter, sort and limit)
+ *
+ */
+
+#ifndef RESULT_TABLE_H_
+#define RESULT_TABLE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+#include "base/util.h"
+#include "QEOpServerProxy.h"
+#include "query.h"
+
+//
+// ResultTable
+// Column oriented view of a result buffer. A column is built the first
+// time a filter or sort refers to it and stores one dictionary code per
+// row, with every distinct value of the column stored once in the
+// dictionary. Filters are evaluated once per dictionary entry and sort
+// keys are integers (the value for integer columns and the rank of the
+// value in the sorted dictionary for string columns), so the per row work
+// is done on flat arrays instead of on the row maps.
+//
+// Filter, Sort and Limit only update the selection, which is a list of row
+// indexes into the buffer. The buffer is rewritten once, by Materialize.
+//
+class ResultTable {
+public:
+    static const uint32_t kAbsent = 0xFFFFFFFF;
+
+    explicit ResultTable(QEOpServerProxy::BufferT *rows);
+    ~ResultTable();
+
+    // Keep the rows that match all the filters. Same semantics as the row
+    // filter: a row is dropped at the first failed filter, and evaluation
+    // stops at the first absent column, dropping the row unless the filter
+    // has ignore_col_absence set
+    void Filter(const std::vector<filter_match_t> &filters);
+    // Sort the selected rows on the given fields. If limit is not 0 only
+    // the first limit rows are sorted and kept
+    void Sort(const std::vector<sort_field_t> &fields, bool ascending,
+              size_t limit);
+    void Limit(size_t limit);
+    // Reorder the buffer as per the selection. Rows are moved out of the
+    // buffer, so the table can not be used after this
+    void Materialize();
+
+    size_t size() const { return selection_.size(); }
+
+private:
+    struct Column {
+        std::vector<uint32_t> codes;
+        std::vector<std::string> dictionary;
+    };
+    typedef std::map<std::string, Column *> ColumnMap;
+    typedef std::vector<uint64_t> KeyVector;
+    struct KeyCompare;
+
+    const Column &GetColumn(const std::string &name);
+    void BuildSortKey(const sort_field_t &field, KeyVector *keys);
+
+    QEOpServerProxy::BufferT *rows_;
+    std::vector<uint32_t> selection_;
+    ColumnMap columns_;
+
+    DISALLOW_COPY_AND_ASSIGN(ResultTable);
+};
+
+#endif
@@ -18,7 +18,9 @@ SelectQuery::SelectQuery(QueryUnit *main_query,
     QueryUnit(main_query, main_query),
     provide_timeseries(false),
     granularity(0),
-    fs_query_type_(SelectQuery::FS_SELECT_INVALID) {
+    fs_query_type_(SelectQuery::FS_SELECT_INVALID),
+    fs_flow_count_(false),
+    fs_topn_pkts_(false) {
 
     AnalyticsQuery *m_query = (AnalyticsQuery *)main_query;
     result_.reset(new BufT);
@@ -168,6 +170,12 @@ bool SelectQuery::is_flow_tuple_specified() {
 }
 
 void SelectQuery::evaluate_fs_query_type() {
+    for (std::vector<std::string>::const_iterator it =
+         select_column_fields.begin(); it != select_column_fields.end(); ++it) {
+        if (get_query_string(*it) == SELECT_FLOW_COUNT) {
+            fs_flow_count_ = true;
+        }
+    }
     if (provide_timeseries) {
         if (granularity) {
             fs_query_type_ |= SelectQuery::FS_SELECT_TS;
@@ -195,6 +203,26 @@ void SelectQuery::evaluate_fs_query_type() {
     }
 }
 
+const size_t SelectQuery::kTopNCandidateFactor;
+const size_t SelectQuery::kTopNMinCandidates;
+
+bool SelectQuery::SetTopN(const std::string& rank_field, size_t limit) {
+    // The flow count needs all the flows of each flow class
+    if (fs_query_type_ != FS_SELECT_FLOW_TUPLE_STATS || fs_flow_count_) {
+        return false;
+    }
+    if (rank_field == SELECT_SUM_BYTES) {
+        fs_topn_pkts_ = false;
+    } else if (rank_field == SELECT_SUM_PACKETS) {
+        fs_topn_pkts_ = true;
+    } else {
+        return false;
+    }
+    fs_topn_.reset(new fs_topn_t(std::max(limit * kTopNCandidateFactor,
+                                          kTopNMinCandidates)));
+    return true;
+}
+
 query_status_t SelectQuery::process_query() {
 
     if (status_details != 0)
@@ -231,13 +259,19 @@ query_status_t SelectQuery::process_query() {
 
     if (m_query->table == g_viz_constants.FLOW_SERIES_TABLE) {
         QE_TRACE(DEBUG, "Flow Series query type: " << fs_query_type_);
-        process_fs_query_cb_map_t::const_iterator query_cb_it = 
-            process_fs_query_cb_map_.find(fs_query_type_);
-        QE_ASSERT(query_cb_it != process_fs_query_cb_map_.end());
-        populate_fs_result_cb_map_t::const_iterator result_cb_it = 
-            populate_fs_result_cb_map_.find(fs_query_type_);
-        QE_ASSERT(result_cb_it != populate_fs_result_cb_map_.end());
-        process_fs_query(query_cb_it->second, result_cb_it->second);
+        if (fs_topn_.get()) {
+            process_fs_query(
+                &SelectQuery::process_fs_query_with_tuple_stats_topn,
+                &SelectQuery::populate_fs_query_result_with_tuple_stats_topn);
+        } else {
+            process_fs_query_cb_map_t::const_iterator query_cb_it = 
+                process_fs_query_cb_map_.find(fs_query_type_);
+            QE_ASSERT(query_cb_it != process_fs_query_cb_map_.end());
+            populate_fs_result_cb_map_t::const_iterator result_cb_it = 
+                populate_fs_result_cb_map_.find(fs_query_type_);
+            QE_ASSERT(result_cb_it != populate_fs_result_cb_map_.end());
+            process_fs_query(query_cb_it->second, result_cb_it->second);
+        }
     } else if (m_query->table == (g_viz_constants.FLOW_TABLE)) {
 
         std::vector<GenDb::DbDataValueVec> keys;
@@ -451,6 +485,39 @@ query_status_t SelectQuery::process_query() {
 
             StatsSelect::StatMap attribs;
 
+            if (m_query->stat_rollup_index() != -1) {
+                // Rollups have the SUM(attr), MIN(attr), MAX(attr) and
+                // COUNT(stat_attr) of the period. MIN and MAX are not
+                // selectable and are skipped.
+                rapidjson::Document d;
+                d.Parse<0>(const_cast<char *>(json_string.c_str()));
+
+                for (rapidjson::Value::ConstMemberIterator itr = d.MemberBegin();
+                        itr != d.MemberEnd(); ++itr) {
+                    QE_ASSERT(itr->name.IsString());
+
+                    std::string vname(itr->name.GetString());
+                    std::string sfield;
+                    QEOpServerProxy::AggOper agg;
+                    QEOpServerProxy::VarType vt = StatsSelect::Parse(idx, vname, 
+                        sfield, agg);
+
+                    if (agg == QEOpServerProxy::INVALID) {
+                        continue;
+                    }
+                    if (vt == QEOpServerProxy::UINT64) {
+                        attribs.insert(std::make_pair(vname,(uint64_t)itr->value.GetUint64()));
+                    } else if (vt == QEOpServerProxy::DOUBLE) {
+                        if (itr->value.IsDouble())
+                            attribs.insert(std::make_pair(vname,(double) itr->value.GetDouble()));
+                        else
+                            attribs.insert(std::make_pair(vname,(double) itr->value.GetUint64()));
+                    }
+                }
+                stats_->LoadRollupRow(it->timestamp, attribs, *mresult_);
+                continue;
+            }
+
             QE_TRACE(DEBUG, "parsing through rapidjson samples: " << json_string << " ts " << it->timestamp << " uuid " << u);
             {
                 rapidjson::Document d;
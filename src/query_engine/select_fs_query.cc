@@ -280,7 +280,9 @@ void SelectQuery::process_fs_query_with_ts_stats_fields(
     }
     map_it->second.pkts += stats.pkts;
     map_it->second.bytes += stats.bytes;
-    map_it->second.flow_list.insert(uuid);
+    if (fs_flow_count_) {
+        map_it->second.flow_list.insert(uuid);
+    }
 }
 
 void SelectQuery::populate_fs_query_result_with_ts_stats_fields() {
@@ -311,7 +313,9 @@ void SelectQuery::process_fs_query_with_tuple_stats_fields(
     }
     map_it->second.pkts += stats.pkts;
     map_it->second.bytes += stats.bytes;
-    map_it->second.flow_list.insert(uuid);
+    if (fs_flow_count_) {
+        map_it->second.flow_list.insert(uuid);
+    }
 }
 
 void SelectQuery::populate_fs_query_result_with_tuple_stats_fields() {
@@ -324,6 +328,32 @@ void SelectQuery::populate_fs_query_result_with_tuple_stats_fields() {
     }
 }
 
+void SelectQuery::process_fs_query_with_tuple_stats_topn(
+        const uint64_t& t, const boost::uuids::uuid& uuid, 
+        const flow_stats& stats, const flow_tuple& tuple) {
+    QE_TRACE(DEBUG, "");
+    flow_tuple flowclass;
+    get_flow_class(tuple, flowclass);
+    fs_topn_t::Counts counts;
+    counts[0] = fs_topn_pkts_ ? stats.pkts : stats.bytes;
+    counts[1] = fs_topn_pkts_ ? stats.bytes : stats.pkts;
+    fs_topn_->Update(flowclass, counts);
+}
+
+void SelectQuery::populate_fs_query_result_with_tuple_stats_topn() {
+    fs_topn_t::ResultT result;
+    fs_topn_->Result(fs_topn_->capacity(), &result);
+    QE_TRACE(DEBUG, "Top " << result.size() << " flow classes, error < " <<
+             fs_topn_->epsilon() * fs_topn_->total()[0]);
+    for (fs_topn_t::ResultT::const_iterator it = result.begin();
+         it != result.end(); ++it) {
+        flow_stats stats;
+        stats.pkts = fs_topn_pkts_ ? it->second[0] : it->second[1];
+        stats.bytes = fs_topn_pkts_ ? it->second[1] : it->second[0];
+        fs_write_final_result_row(NULL, &it->first, NULL, &stats, NULL);
+    }
+}
+
 void SelectQuery::process_fs_query_with_ts_tuple_stats_fields(
         const uint64_t& t, const boost::uuids::uuid& uuid,
         const flow_stats& stats, const flow_tuple& tuple) {
@@ -357,7 +387,9 @@ void SelectQuery::process_fs_query_with_ts_tuple_stats_fields(
     }
     imap_it->second.pkts += stats.pkts;
     imap_it->second.bytes += stats.bytes;
-    imap_it->second.flow_list.insert(uuid);
+    if (fs_flow_count_) {
+        imap_it->second.flow_list.insert(uuid);
+    }
 }
 
 void SelectQuery::populate_fs_query_result_with_ts_tuple_stats_fields() {
@@ -381,7 +413,9 @@ void SelectQuery::process_fs_query_with_stats_fields(
     QE_TRACE(DEBUG, "");
     fs_flow_stats_.pkts += stats.pkts;
     fs_flow_stats_.bytes += stats.bytes;
-    fs_flow_stats_.flow_list.insert(uuid);
+    if (fs_flow_count_) {
+        fs_flow_stats_.flow_list.insert(uuid);
+    }
 }
 
 void SelectQuery::populate_fs_query_result_with_stats_fields() {
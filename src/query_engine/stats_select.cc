@@ -434,19 +434,6 @@ bool StatsSelect::LoadRow(boost::uuids::uuid u,
         }
     }
 
-    // Build sort vector
-    // Last slot is reserved for the hash
-    std::vector<StatVal> ukey(sort_cols_.size() + agg_sort_cols_.size() + 1);
-    size_t hash_slot = sort_cols_.size() + agg_sort_cols_.size();
-    uint64_t hash_val = boost::hash_range(uniks.begin(), uniks.end());
-    ukey[hash_slot] = hash_val;
-
-    for (map<string, size_t>::const_iterator st = sort_cols_.begin();
-            st!=sort_cols_.end(); st++) {
-        QE_ASSERT(uniks.find(st->first) != uniks.end());
-        ukey[st->second] = uniks.at(st->first);
-    }
-
     QEOpServerProxy::AggRowT narows;
     for (StatsSelect::StatMap::const_iterator it = row.begin();
             it != row.end(); it++) {
@@ -462,8 +449,78 @@ bool StatsSelect::LoadRow(boost::uuids::uuid u,
         narows.insert(make_pair(aggkey, (uint64_t) 1));            
     }
     
-    MergeFullRow(ukey, uniks, narows, output);
+    LoadAggRow(uniks, narows, output);
 
     return true;
 }
 
+bool StatsSelect::CanUseRollup(uint64_t period) const {
+    if (!status_ || isT_ || !unik_cols_.empty()) {
+        return false;
+    }
+    if ((ts_period_ % period) != 0) {
+        return false;
+    }
+    // The rows only have the time bin to sort on
+    for (map<string, size_t>::const_iterator st = sort_cols_.begin();
+            st!=sort_cols_.end(); st++) {
+        if (st->first != g_viz_constants.STAT_TIMEBIN_FIELD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool StatsSelect::LoadRollupRow(uint64_t timestamp, const StatMap& aggs,
+        MapBufT& output) {
+
+	if (!Status()) return false;
+
+    StatMap uniks;
+    if (ts_period_) {
+		uint64_t ts = timestamp - (timestamp % ts_period_);
+        uniks.insert(make_pair(g_viz_constants.STAT_TIMEBIN_FIELD,ts)); 
+	}
+
+    QEOpServerProxy::AggRowT narows;
+    for (set<string>::const_iterator it = sum_cols_.begin();
+            it != sum_cols_.end(); it++) {
+        StatMap::const_iterator at = aggs.find(string("SUM(") + *it + ")");
+        if (at != aggs.end()) {
+            pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::SUM,*it);
+            narows.insert(make_pair(aggkey, at->second));
+        }
+    }
+
+    if (!count_field_.empty()) {
+        StatMap::const_iterator at =
+            aggs.find(string("COUNT(") + count_field_ + ")");
+        QE_ASSERT(at != aggs.end());
+        pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::COUNT,count_field_);
+        narows.insert(make_pair(aggkey, at->second));
+    }
+
+    LoadAggRow(uniks, narows, output);
+
+    return true;
+}
+
+void StatsSelect::LoadAggRow(const StatMap& uniks,
+        const QEOpServerProxy::AggRowT& narows, MapBufT& output) {
+
+    // Build sort vector
+    // Last slot is reserved for the hash
+    std::vector<StatVal> ukey(sort_cols_.size() + agg_sort_cols_.size() + 1);
+    size_t hash_slot = sort_cols_.size() + agg_sort_cols_.size();
+    uint64_t hash_val = boost::hash_range(uniks.begin(), uniks.end());
+    ukey[hash_slot] = hash_val;
+
+    for (map<string, size_t>::const_iterator st = sort_cols_.begin();
+            st!=sort_cols_.end(); st++) {
+        QE_ASSERT(uniks.find(st->first) != uniks.end());
+        ukey[st->second] = uniks.at(st->first);
+    }
+
+    MergeFullRow(ukey, uniks, narows, output);
+}
+
@@ -42,6 +42,16 @@ public:
 	bool LoadRow(boost::uuids::uuid u, uint64_t timestamp,
             const StatMap& row, MapBufT& output);
 
+    // Returns true if the SELECT can be answered from a rollup of the
+    // given period (in usec), i.e. it only has the aggregates and T= with
+    // a multiple of the period
+    bool CanUseRollup(uint64_t period) const;
+
+    // The client call this function once with every row from a rollup.
+    // The row has the SUM and COUNT aggregates of the period.
+    bool LoadRollupRow(uint64_t timestamp, const StatMap& aggs,
+            MapBufT& output);
+
 	bool Status() { return status_; }
 
     bool IsMergeNeeded() { return !isT_; }
@@ -59,6 +69,8 @@ public:
 
 private:
 
+    void LoadAggRow(const StatMap& uniks,
+            const QEOpServerProxy::AggRowT& narows, MapBufT& output);
     static void MergeAggRow(QEOpServerProxy::AggRowT &arows,
             const QEOpServerProxy::AggRowT &narows);
     static void MergeFullRow(
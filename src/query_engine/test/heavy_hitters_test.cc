@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <string>
+#include "base/logging.h"
+#include "testing/gunit.h"
+#include "../heavy_hitters.h"
+
+namespace {
+
+typedef HeavyHitters<std::string, 2> TestHeavyHitters;
+
+TestHeavyHitters::Counts MakeCounts(uint64_t bytes, uint64_t pkts) {
+    TestHeavyHitters::Counts counts;
+    counts[0] = bytes;
+    counts[1] = pkts;
+    return counts;
+}
+
+std::string Key(int i) {
+    return "vn" + integerToString(i);
+}
+
+class HeavyHittersTest : public ::testing::Test {
+};
+
+// With fewer keys than candidates and a wide sketch, the result is exact
+TEST_F(HeavyHittersTest, Exact) {
+    TestHeavyHitters topn(10, 1 << 16);
+    for (int i = 0; i < 5; i++) {
+        for (int j = 0; j <= i; j++) {
+            topn.Update(Key(i), MakeCounts(100, 1));
+        }
+    }
+    EXPECT_EQ(5U, topn.size());
+    EXPECT_EQ(1500U, topn.total()[0]);
+    EXPECT_EQ(15U, topn.total()[1]);
+
+    TestHeavyHitters::ResultT result;
+    topn.Result(3, &result);
+    ASSERT_EQ(3U, result.size());
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(Key(4 - i), result[i].first);
+        EXPECT_EQ((uint64_t)(5 - i) * 100, result[i].second[0]);
+        EXPECT_EQ((uint64_t)(5 - i), result[i].second[1]);
+    }
+}
+
+// A few heavy keys in a stream of many light keys are found with
+// a bounded number of candidates and a bounded error
+TEST_F(HeavyHittersTest, Approximate) {
+    const int kHeavy = 10;
+    const int kLight = 20000;
+    TestHeavyHitters topn(4 * kHeavy);
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < kLight; i++) {
+            topn.Update(Key(kHeavy + i), MakeCounts(10, 1));
+        }
+        for (int i = 0; i < kHeavy; i++) {
+            topn.Update(Key(i), MakeCounts(10000 * (i + 1), i + 1));
+        }
+    }
+    EXPECT_EQ((size_t)4 * kHeavy, topn.size());
+
+    TestHeavyHitters::ResultT result;
+    topn.Result(kHeavy, &result);
+    ASSERT_EQ((size_t)kHeavy, result.size());
+    uint64_t error = topn.epsilon() * topn.total()[0];
+    for (int i = 0; i < kHeavy; i++) {
+        uint64_t bytes = 10 * 10000 * (kHeavy - i);
+        EXPECT_EQ(Key(kHeavy - 1 - i), result[i].first);
+        EXPECT_LE(bytes, result[i].second[0]);
+        EXPECT_GE(bytes + error, result[i].second[0]);
+        EXPECT_LE((uint64_t)10 * (kHeavy - i), result[i].second[1]);
+    }
+
+    // A light key is never under estimated
+    EXPECT_LE(100U, topn.Estimate(Key(kHeavy))[0]);
+}
+
+TEST_F(HeavyHittersTest, NoCandidates) {
+    TestHeavyHitters topn(0);
+    topn.Update(Key(1), MakeCounts(10, 1));
+    TestHeavyHitters::ResultT result;
+    topn.Result(10, &result);
+    EXPECT_TRUE(result.empty());
+    EXPECT_LE(10U, topn.Estimate(Key(1))[0]);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <boost/assign/list_of.hpp>
+#include <boost/uuid/random_generator.hpp>
+
+#include "base/logging.h"
+#include "testing/gunit.h"
+#include "../query_cache.h"
+#include "../query.h"
+
+// Defined in query.cc, which is not linked in
+QueryResultMetaData::~QueryResultMetaData() {
+}
+
+namespace {
+
+typedef QEOpServerProxy::BufferT BufferT;
+typedef QEOpServerProxy::OutRowT OutRowT;
+typedef QEOpServerProxy::OutRowMultimapT OutRowMultimapT;
+
+std::map<std::string, std::string> Terms(const std::string &start_time,
+                                         const std::string &where) {
+    return boost::assign::map_list_of
+        (std::string(QUERY_TABLE), std::string("\"FlowSeriesTable\""))
+        (std::string(QUERY_START_TIME), start_time)
+        (std::string(QUERY_END_TIME), std::string("\"now\""))
+        (std::string("enqueue_time"), start_time)
+        (std::string("query_metadata"),
+         "{\"enqueue_time\": " + start_time + "}")
+        (std::string(QUERY_WHERE), where);
+}
+
+void FillRows(BufferT *rows, size_t count, const std::string &vn) {
+    for (size_t i = 0; i < count; i++) {
+        OutRowT row;
+        row["sourcevn"] = vn;
+        row["sum(bytes)"] = integerToString(i * 100);
+        std::set<boost::uuids::uuid> uuids;
+        uuids.insert(boost::uuids::random_generator()());
+        rows->push_back(std::make_pair(row,
+            QEOpServerProxy::MetadataT(new fsMetaData(uuids))));
+    }
+}
+
+class QueryCacheTest : public ::testing::Test {
+protected:
+    static const uint64_t kBucket = 1ULL << 26;
+};
+
+TEST_F(QueryCacheTest, QueryKey) {
+    std::string where("[[{\"name\": \"sourcevn\", \"value\": \"vn 1\"}]]");
+    std::string key(QueryCache::QueryKey(Terms("\"now-10m\"", where),
+                                         kBucket));
+
+    // The time range and the white space do not change the key
+    EXPECT_EQ(key, QueryCache::QueryKey(Terms("1365025325382585",
+        "[[{\"name\":\"sourcevn\",\"value\":\"vn 1\"}]]"), kBucket));
+    // Strings and bucket sizes do
+    EXPECT_NE(key, QueryCache::QueryKey(Terms("\"now-10m\"",
+        "[[{\"name\": \"sourcevn\", \"value\": \"vn1\"}]]"), kBucket));
+    EXPECT_NE(key, QueryCache::QueryKey(Terms("\"now-10m\"", where),
+                                        kBucket * 2));
+}
+
+TEST_F(QueryCacheTest, LookupInsert) {
+    QueryCache cache(1024 * 1024);
+    BufferT rows;
+    FillRows(&rows, 10, "vn1");
+    OutRowMultimapT mrows;
+
+    BufferT result;
+    OutRowMultimapT mresult;
+    EXPECT_FALSE(cache.Lookup("q1", kBucket, &result, &mresult));
+    cache.Insert("q1", kBucket, &rows, &mrows);
+    EXPECT_FALSE(cache.Lookup("q1", 2 * kBucket, &result, &mresult));
+    EXPECT_FALSE(cache.Lookup("q2", kBucket, &result, &mresult));
+    ASSERT_TRUE(cache.Lookup("q1", kBucket, &result, &mresult));
+
+    // The rows and their metadata are copies
+    ASSERT_EQ(rows.size(), result.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        EXPECT_TRUE(rows[i].first == result[i].first);
+        EXPECT_NE(rows[i].second.get(), result[i].second.get());
+        EXPECT_TRUE(static_cast<fsMetaData *>(rows[i].second.get())->uuids ==
+                    static_cast<fsMetaData *>(result[i].second.get())->uuids);
+    }
+    static_cast<fsMetaData *>(result[0].second.get())->uuids.clear();
+    result[0].first["sum(bytes)"] = "1";
+    BufferT result2;
+    ASSERT_TRUE(cache.Lookup("q1", kBucket, &result2, &mresult));
+    EXPECT_TRUE(rows[0].first == result2[0].first);
+    EXPECT_EQ(1U, static_cast<fsMetaData *>(
+        result2[0].second.get())->uuids.size());
+
+    QueryCache::Stats stats;
+    cache.GetStats(&stats);
+    EXPECT_EQ(1U, stats.entries);
+    EXPECT_LT(0U, stats.bytes);
+    EXPECT_EQ(5U, stats.lookups);
+    EXPECT_EQ(2U, stats.hits);
+    EXPECT_EQ(2 * stats.bytes, stats.hit_bytes);
+    EXPECT_EQ(1U, stats.inserts);
+}
+
+TEST_F(QueryCacheTest, StatsResult) {
+    QueryCache cache(1024 * 1024);
+    OutRowMultimapT mrows;
+    std::vector<QEOpServerProxy::SubVal> sortkey;
+    sortkey.push_back(std::string("vn1"));
+    std::map<std::string, QEOpServerProxy::SubVal> uniks;
+    uniks["name"] = std::string("vn1");
+    QEOpServerProxy::AggRowT aggs;
+    aggs[std::make_pair(QEOpServerProxy::SUM, std::string("in_bytes"))] =
+        (uint64_t)1000;
+    mrows.insert(std::make_pair(sortkey, std::make_pair(uniks, aggs)));
+
+    cache.Insert("q1", kBucket, NULL, &mrows);
+    BufferT result;
+    OutRowMultimapT mresult;
+    ASSERT_TRUE(cache.Lookup("q1", kBucket, &result, &mresult));
+    EXPECT_TRUE(result.empty());
+    ASSERT_EQ(1U, mresult.size());
+    EXPECT_EQ((uint64_t)1000, boost::get<uint64_t>(
+        mresult.begin()->second.second.begin()->second));
+}
+
+TEST_F(QueryCacheTest, Evict) {
+    BufferT rows;
+    FillRows(&rows, 100, "default-domain:demo:vn1");
+    QueryCache probe(1024 * 1024);
+    probe.Insert("q", 0, &rows, NULL);
+    QueryCache::Stats stats;
+    probe.GetStats(&stats);
+    uint64_t entry_bytes = stats.bytes;
+
+    // Room for 3 entries
+    QueryCache cache(3 * entry_bytes + entry_bytes / 2);
+    BufferT result;
+    OutRowMultimapT mresult;
+    cache.Insert("q", 1 * kBucket, &rows, NULL);
+    cache.Insert("q", 2 * kBucket, &rows, NULL);
+    cache.Insert("q", 3 * kBucket, &rows, NULL);
+    EXPECT_TRUE(cache.Lookup("q", 1 * kBucket, &result, &mresult));
+    cache.Insert("q", 4 * kBucket, &rows, NULL);
+
+    // The least recently used is bucket 2
+    EXPECT_TRUE(cache.Lookup("q", 1 * kBucket, &result, &mresult));
+    EXPECT_FALSE(cache.Lookup("q", 2 * kBucket, &result, &mresult));
+    EXPECT_TRUE(cache.Lookup("q", 3 * kBucket, &result, &mresult));
+    EXPECT_TRUE(cache.Lookup("q", 4 * kBucket, &result, &mresult));
+    cache.GetStats(&stats);
+    EXPECT_EQ(3U, stats.entries);
+    EXPECT_EQ(3 * entry_bytes, stats.bytes);
+    EXPECT_EQ(1U, stats.evictions);
+
+    // A result larger than the cache is not cached
+    BufferT large;
+    FillRows(&large, 1000, "default-domain:demo:vn1");
+    cache.Insert("q", 5 * kBucket, &large, NULL);
+    EXPECT_FALSE(cache.Lookup("q", 5 * kBucket, &result, &mresult));
+    cache.GetStats(&stats);
+    EXPECT_EQ(3U, stats.entries);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
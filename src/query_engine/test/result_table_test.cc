@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <boost/bind.hpp>
+
+#include "base/logging.h"
+#include "base/util.h"
+#include "testing/gunit.h"
+#include "../result_table.h"
+
+namespace {
+
+typedef QEOpServerProxy::BufferT BufferT;
+typedef QEOpServerProxy::ResultRowT ResultRowT;
+typedef QEOpServerProxy::OutRowT OutRowT;
+
+// Row at a time filter and sort, as done by the post processing before
+// the result table. Used as the reference for the result table.
+bool RowFilter(const std::vector<filter_match_t> &filters,
+               const ResultRowT &row) {
+    for (size_t j = 0; j < filters.size(); j++) {
+        OutRowT::const_iterator iter = row.first.find(filters[j].name);
+        if (iter == row.first.end()) {
+            return filters[j].ignore_col_absence;
+        }
+        switch (filters[j].op) {
+        case EQUAL:
+            if (filters[j].value != iter->second) return false;
+            break;
+        case NOT_EQUAL:
+            if (filters[j].value == iter->second) return false;
+            break;
+        case LEQ:
+            if (atoi(iter->second.c_str()) > atoi(filters[j].value.c_str()))
+                return false;
+            break;
+        case GEQ:
+            if (atoi(iter->second.c_str()) < atoi(filters[j].value.c_str()))
+                return false;
+            break;
+        case REGEX_MATCH:
+            if (!boost::regex_match(iter->second, filters[j].match_e))
+                return false;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RowCompare(const std::vector<sort_field_t> &fields,
+                const ResultRowT &lhs, const ResultRowT &rhs) {
+    for (size_t i = 0; i < fields.size(); i++) {
+        const std::string &lhs_str = lhs.first.find(fields[i].name)->second;
+        const std::string &rhs_str = rhs.first.find(fields[i].name)->second;
+        if (fields[i].type == "int" || fields[i].type == "long" ||
+            fields[i].type == "ipv4") {
+            uint64_t lhs_val = 0, rhs_val = 0;
+            stringToInteger(lhs_str, lhs_val);
+            stringToInteger(rhs_str, rhs_val);
+            if (lhs_val < rhs_val) return true;
+            if (lhs_val > rhs_val) return false;
+        } else {
+            if (lhs_str < rhs_str) return true;
+            if (lhs_str > rhs_str) return false;
+        }
+    }
+    return false;
+}
+
+void RowProcess(BufferT *rows, const std::vector<filter_match_t> &filters,
+                const std::vector<sort_field_t> &fields, bool ascending,
+                size_t limit) {
+    BufferT filtered;
+    for (size_t i = 0; i < rows->size(); i++) {
+        if (RowFilter(filters, (*rows)[i])) {
+            filtered.push_back((*rows)[i]);
+        }
+    }
+    if (ascending) {
+        std::sort(filtered.begin(), filtered.end(),
+                  boost::bind(&RowCompare, boost::cref(fields), _1, _2));
+    } else {
+        std::sort(filtered.rbegin(), filtered.rend(),
+                  boost::bind(&RowCompare, boost::cref(fields), _1, _2));
+    }
+    if (limit && filtered.size() > limit) {
+        filtered.resize(limit);
+    }
+    rows->swap(filtered);
+}
+
+void TableProcess(BufferT *rows, const std::vector<filter_match_t> &filters,
+                  const std::vector<sort_field_t> &fields, bool ascending,
+                  size_t limit) {
+    ResultTable table(rows);
+    table.Filter(filters);
+    table.Sort(fields, ascending, limit);
+    table.Materialize();
+}
+
+filter_match_t Filter(const std::string &name, match_op op,
+                      const std::string &value, bool ignore_absence = false) {
+    filter_match_t filter;
+    filter.name = name;
+    filter.op = op;
+    filter.value = value;
+    filter.ignore_col_absence = ignore_absence;
+    if (op == REGEX_MATCH) {
+        filter.match_e = boost::regex(value);
+    }
+    return filter;
+}
+
+//
+// Flow series like rows. The source VN and the protocol have few distinct
+// values, the address and the counters have many.
+//
+void FillRows(BufferT *rows, size_t count) {
+    rows->reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        OutRowT row;
+        row["sourcevn"] = "default-domain:demo:vn" + integerToString(rand() % 50);
+        row["sourceip"] = integerToString(0x0a000000 + rand() % 100000);
+        row["protocol"] = integerToString(rand() % 3 ? 6 : 17);
+        row["sum(bytes)"] = integerToString(rand());
+        if (rand() % 100) {
+            row["dport"] = integerToString(rand() % 1024);
+        }
+        rows->push_back(std::make_pair(row, QEOpServerProxy::MetadataT()));
+    }
+}
+
+// Sort keys of a row, which must be the same in both outputs. Rows that
+// compare equal may be in a different order.
+std::string SortKey(const std::vector<sort_field_t> &fields,
+                    const ResultRowT &row) {
+    std::string key;
+    for (size_t i = 0; i < fields.size(); i++) {
+        key += row.first.find(fields[i].name)->second + "/";
+    }
+    return key;
+}
+
+void ExpectSameResult(const std::vector<sort_field_t> &fields,
+                      const BufferT &expected, const BufferT &result) {
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_EQ(SortKey(fields, expected[i]), SortKey(fields, result[i]));
+    }
+}
+
+class ResultTableTest : public ::testing::Test {
+protected:
+    ResultTableTest() {
+        srand(1);
+    }
+};
+
+TEST_F(ResultTableTest, Filter) {
+    BufferT rows;
+    FillRows(&rows, 10000);
+    std::vector<sort_field_t> fields;
+    fields.push_back(sort_field_t("sourceip", "ipv4"));
+    fields.push_back(sort_field_t("sum(bytes)", "long"));
+
+    std::vector<std::vector<filter_match_t> > tests;
+    std::vector<filter_match_t> filters;
+    filters.push_back(Filter("protocol", EQUAL, "6"));
+    tests.push_back(filters);
+    filters.push_back(Filter("dport", LEQ, "512", true));
+    tests.push_back(filters);
+    filters.push_back(Filter("sourcevn", REGEX_MATCH, ".*vn1[0-9]"));
+    tests.push_back(filters);
+    filters.clear();
+    filters.push_back(Filter("dport", GEQ, "100"));
+    filters.push_back(Filter("sourcevn", NOT_EQUAL, "default-domain:demo:vn1"));
+    tests.push_back(filters);
+
+    for (size_t i = 0; i < tests.size(); i++) {
+        BufferT expected(rows);
+        BufferT result(rows);
+        RowProcess(&expected, tests[i], fields, true, 0);
+        TableProcess(&result, tests[i], fields, true, 0);
+        EXPECT_LT(0U, result.size());
+        EXPECT_GT(rows.size(), result.size());
+        ExpectSameResult(fields, expected, result);
+    }
+}
+
+TEST_F(ResultTableTest, SortLimit) {
+    BufferT rows;
+    FillRows(&rows, 10000);
+    std::vector<filter_match_t> filters;
+
+    std::vector<sort_field_t> fields;
+    fields.push_back(sort_field_t("sourcevn", "string"));
+    fields.push_back(sort_field_t("sum(bytes)", "long"));
+    for (int ascending = 0; ascending < 2; ascending++) {
+        size_t limits[] = { 0, 1, 100, 20000 };
+        for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+            BufferT expected(rows);
+            BufferT result(rows);
+            RowProcess(&expected, filters, fields, ascending, limits[i]);
+            TableProcess(&result, filters, fields, ascending, limits[i]);
+            ExpectSameResult(fields, expected, result);
+        }
+    }
+}
+
+//
+// Post processing of a million row flow series result: filter on the
+// protocol, sort on the address and the bytes, and keep the top 1000.
+//
+TEST_F(ResultTableTest, Benchmark) {
+    static const size_t kRows = 1000000;
+    static const size_t kLimit = 1000;
+
+    BufferT rows;
+    FillRows(&rows, kRows);
+    std::vector<filter_match_t> filters;
+    filters.push_back(Filter("protocol", EQUAL, "6"));
+    std::vector<sort_field_t> fields;
+    fields.push_back(sort_field_t("sourceip", "ipv4"));
+    fields.push_back(sort_field_t("sum(bytes)", "long"));
+
+    BufferT expected(rows);
+    uint64_t start = UTCTimestampUsec();
+    RowProcess(&expected, filters, fields, false, kLimit);
+    uint64_t row_usec = UTCTimestampUsec() - start;
+
+    BufferT result(rows);
+    start = UTCTimestampUsec();
+    TableProcess(&result, filters, fields, false, kLimit);
+    uint64_t table_usec = UTCTimestampUsec() - start;
+
+    ExpectSameResult(fields, expected, result);
+    LOG(DEBUG, kRows << " rows, filter, sort and limit " << kLimit <<
+        ": row at a time " << row_usec << " usec, result table " <<
+        table_usec << " usec");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
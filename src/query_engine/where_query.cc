@@ -691,7 +691,6 @@ void WhereQuery::create_uuid_tuple_map(
     QE_TRACE(DEBUG, "Querying " << (t2_end - t2_start + 1) << " rows");
 
     std::vector<GenDb::DbDataValueVec> keys;    // vector of keys for multi-row get
-    std::vector<GenDb::ColList> mget_res;   // vector of result for each row
     for (uint32_t t2 = t2_start; t2 <= t2_end; t2++)
     {
         GenDb::DbDataValueVec rowkey;
@@ -702,41 +701,45 @@ void WhereQuery::create_uuid_tuple_map(
     }
 
     GenDb::ColumnNameRange cr; cr.count = MAX_DB_QUERY_ENTRIES;
-    if (!m_query->dbif->Db_GetMultiRow(mget_res, g_viz_constants.FLOW_TABLE_ALL_FIELDS, keys, &cr)) {
+    if (!m_query->dbif->Db_GetMultiRowSlices(
+            g_viz_constants.FLOW_TABLE_ALL_FIELDS, keys, cr,
+            boost::bind(&WhereQuery::add_uuid_tuple_columns, this,
+                        boost::ref(uuid_map), row_key_suffix, _1))) {
         QE_IO_ERROR(0);
-    } else {
-        for (std::vector<GenDb::ColList>::iterator it = mget_res.begin();
-                it != mget_res.end(); it++) {
-            uint32_t t2 = boost::get<uint32_t>(it->rowkey_.at(0));
-            QE_TRACE(DEBUG, "For T2: " << t2 << " # of rows: " << 
-                    it->columns_.size());
-
-            std::vector<GenDb::NewCol>::iterator i;
-            for (i = it->columns_.begin(); i != it->columns_.end(); i++)
-            {
-                {
-                    query_result_unit_t result_unit;
-                    
-                    assert(i->name.size() > 0);
-                    result_unit.info = i->value;
-
-                    boost::uuids::uuid u; flow_stats stats;
-                    result_unit.get_uuid_stats(u, stats);
-
-                    GenDb::DbDataValueVec tuple_encoded_vec = i->name;
-                    tuple_encoded_vec.erase(tuple_encoded_vec.begin());
-                    tuple_encoded_vec.push_back(row_key_suffix);
-                    uuid_map.insert( 
-                        std::pair<boost::uuids::uuid, GenDb::DbDataValueVec>(
-                            u, tuple_encoded_vec));
-                }
-            }
-        }
     }
 
     QE_TRACE(DEBUG, "WhereQuery:finished");
 }
 
+// Add a page of columns of the special flow table to the UUID to 8-tuple map
+void WhereQuery::add_uuid_tuple_columns(
+        std::map<boost::uuids::uuid, GenDb::DbDataValueVec>& uuid_map,
+        const GenDb::DbDataValue& row_key_suffix, GenDb::ColList& col_list)
+{
+    uint32_t t2 = boost::get<uint32_t>(col_list.rowkey_.at(0));
+    QE_TRACE(DEBUG, "For T2: " << t2 << " # of rows: " <<
+            col_list.columns_.size());
+
+    std::vector<GenDb::NewCol>::iterator i;
+    for (i = col_list.columns_.begin(); i != col_list.columns_.end(); i++)
+    {
+        query_result_unit_t result_unit;
+
+        assert(i->name.size() > 0);
+        result_unit.info = i->value;
+
+        boost::uuids::uuid u; flow_stats stats;
+        result_unit.get_uuid_stats(u, stats);
+
+        GenDb::DbDataValueVec tuple_encoded_vec = i->name;
+        tuple_encoded_vec.erase(tuple_encoded_vec.begin());
+        tuple_encoded_vec.push_back(row_key_suffix);
+        uuid_map.insert(
+            std::pair<boost::uuids::uuid, GenDb::DbDataValueVec>(
+                u, tuple_encoded_vec));
+    }
+}
+
 query_status_t WhereQuery::process_query()
 {
     AnalyticsQuery *m_query = (AnalyticsQuery *)main_query;
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "routing-policy/policy_config.h"
+
+#include <sstream>
+
+#include "schema/bgp_schema_types.h"
+
+using namespace std;
+
+bool PolicyTermConfig::operator==(const PolicyTermConfig &rhs) const {
+    return (name == rhs.name &&
+            match_prefixes == rhs.match_prefixes &&
+            match_communities == rhs.match_communities &&
+            match_as_path == rhs.match_as_path &&
+            match_local_pref == rhs.match_local_pref &&
+            match_nexthop == rhs.match_nexthop &&
+            match_neighbor == rhs.match_neighbor &&
+            match_protocol == rhs.match_protocol &&
+            add_communities == rhs.add_communities &&
+            remove_communities == rhs.remove_communities &&
+            set_communities == rhs.set_communities &&
+            update_local_pref == rhs.update_local_pref &&
+            action == rhs.action);
+}
+
+bool PolicyConfig::operator==(const PolicyConfig &rhs) const {
+    return (name == rhs.name && terms == rhs.terms);
+}
+
+void PolicyConfig::Build(const string &name,
+                         const autogen::PolicyStatement &statement) {
+    this->name = name;
+    terms.clear();
+    for (vector<autogen::PolicyTerm>::const_iterator it =
+         statement.term.begin(); it != statement.term.end(); ++it) {
+        const autogen::PolicyMatch &match = it->from;
+        const autogen::PolicyAction &action = it->then;
+
+        PolicyTermConfig term;
+        ostringstream oss;
+        oss << "term-" << terms.size() + 1;
+        term.name = oss.str();
+        term.match_prefixes = match.prefix;
+        term.match_communities = match.community;
+        term.match_as_path = match.as_path;
+        term.match_local_pref = match.local_pref;
+        term.match_nexthop = match.next_hop;
+        term.match_neighbor = match.neighbor;
+        term.match_protocol = match.protocol;
+        term.add_communities = action.update.community.add;
+        term.remove_communities = action.update.community.remove;
+        term.set_communities = action.update.community.set;
+        term.update_local_pref = action.update.local_pref;
+        term.action = action.action;
+        terms.push_back(term);
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef ctrlplane_policy_config_h
+#define ctrlplane_policy_config_h
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace autogen {
+struct PolicyStatement;
+}
+
+//
+// Configuration of a single term of a routing policy. Built from the from
+// and then clauses of the PolicyTerm in the routing-policy schema.
+//
+// Match conditions, all of which need to be satisfied. Empty conditions are
+// ignored, so a term without any condition matches every route.
+//   match_prefixes    "a.b.c.d/n [exact|longer|orlonger]", default orlonger.
+//                     The route needs to match any one of the prefixes.
+//   match_communities "asn:value", "no-export", "no-advertise",
+//                     "no-export-subconfed" or "target:x:y". The route needs
+//                     to carry all of them.
+//   match_as_path     Space separated AS path pattern. Tokens are an AS
+//                     number, "." for any single AS, ".*" for any sequence
+//                     of ASes, and "^" and "$" to anchor the pattern.
+//   match_local_pref  Exact local preference, 0 to ignore.
+//   match_nexthop     Exact nexthop address.
+//   match_neighbor    Neighbor the route is learnt from.
+//   match_protocol    Protocol the route is learnt from.
+//
+// Actions
+//   add/remove/set_communities  Community updates in the same format as
+//                     match_communities. Route targets can't be set.
+//   update_local_pref Local preference to set, 0 to leave unchanged.
+//   action            "accept", "reject" or "next", default next.
+//
+struct PolicyTermConfig {
+    PolicyTermConfig() : match_local_pref(0), update_local_pref(0) {
+    }
+
+    bool operator==(const PolicyTermConfig &rhs) const;
+
+    std::string name;
+    std::vector<std::string> match_prefixes;
+    std::vector<std::string> match_communities;
+    std::string match_as_path;
+    uint32_t match_local_pref;
+    std::string match_nexthop;
+    std::string match_neighbor;
+    std::string match_protocol;
+    std::vector<std::string> add_communities;
+    std::vector<std::string> remove_communities;
+    std::vector<std::string> set_communities;
+    uint32_t update_local_pref;
+    std::string action;
+};
+
+//
+// Configuration of a routing policy i.e. its ordered list of terms. A policy
+// with an empty name stands for no policy.
+//
+struct PolicyConfig {
+    bool operator==(const PolicyConfig &rhs) const;
+    bool operator!=(const PolicyConfig &rhs) const {
+        return !operator==(rhs);
+    }
+
+    // Fill in the config from the routing-policy-entries of a routing-policy.
+    // Terms without a name are named after their position in the policy.
+    void Build(const std::string &name,
+               const autogen::PolicyStatement &statement);
+
+    std::string name;
+    std::vector<PolicyTermConfig> terms;
+};
+
+#endif // ctrlplane_policy_config_h
@@ -6,56 +6,39 @@
 
 #include <sstream>
 
-#include <boost/ptr_container/ptr_list.hpp>
-
 #include "base/logging.h"
 #include <pugixml/pugixml.hpp>
-#include "schema/routing_policy_types.h"
+#include "schema/bgp_schema_types.h"
 
 
 using namespace std;
 using namespace pugi;
 
-struct PolicyTerm {
-    std::string term_name;
-    autogen::PolicyMatch match;
-    autogen::PolicyAction action;
-};
-
-typedef boost::ptr_list<PolicyTerm> PolicyTerms;
-
-typedef std::map<std::string, PolicyTerms> PolicyMap;
-
-static bool ParseTerm(const xml_node &xterm, PolicyTerm *term) {
-    xml_attribute name = xterm.attribute("name");
-    term->term_name = name.value();
-
-    xml_node xaction;
-    xml_node xmatch = xterm.child("from"); 
-
-    if (xmatch) {
-        term->match.XmlParse(xmatch);
-        xaction = xmatch.next_sibling("then");
-    } else {
-        xaction = xterm.child("then"); 
-    }
-
-    term->action.XmlParse(xaction);
-
-    return true;
-}
-
-static bool ParsePolicy(const xml_node &node, PolicyMap *policy) {
-    PolicyTerms policy_terms;
+//
+// The policy element has the same content as the routing-policy-entries
+// of a routing-policy. Terms may in addition carry a name attribute.
+//
+static bool ParsePolicy(const xml_node &node, PolicyConfig *policy) {
     xml_attribute name = node.attribute("name");
-    for (xml_node xterm = node.child("term"); xterm;
-         xterm = xterm.next_sibling("term")) {
-        PolicyTerm *term_data = new PolicyTerm();
-        ParseTerm(xterm, term_data);
-        policy_terms.push_back(term_data);
+    if (!name) {
+        return false;
     }
 
-    policy->insert(std::make_pair(name.value(), policy_terms)); 
+    autogen::PolicyStatement statement;
+    if (!statement.XmlParse(node)) {
+        return false;
+    }
+    policy->Build(name.value(), statement);
+
+    size_t idx = 0;
+    for (xml_node xterm = node.child("term");
+         xterm && idx < policy->terms.size();
+         xterm = xterm.next_sibling("term"), idx++) {
+        xml_attribute term_name = xterm.attribute("name");
+        if (term_name) {
+            policy->terms[idx].name = term_name.value();
+        }
+    }
     return true;
 }
 
@@ -73,11 +56,23 @@ bool PolicyConfigParser::Parse(const std::string &content)  {
         return false;
     }
 
-    PolicyMap policy;
     for (xml_node node = xdoc.first_child(); node; node = node.next_sibling()) {
         if (strcmp(node.name(), "policy") == 0) {
-            ParsePolicy(node, &policy);
+            PolicyConfig policy;
+            if (!ParsePolicy(node, &policy)) {
+                LOG(WARN, "Invalid policy " << node.attribute("name").value());
+                return false;
+            }
+            policies_[policy.name] = policy;
         }
     }
     return true;
 }
+
+const PolicyConfig *PolicyConfigParser::Find(const string &name) const {
+    PolicyConfigMap::const_iterator loc = policies_.find(name);
+    if (loc == policies_.end()) {
+        return NULL;
+    }
+    return &loc->second;
+}
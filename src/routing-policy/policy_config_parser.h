@@ -4,10 +4,23 @@
 
 #ifndef ctrlplane_policy_config_parser_h
 #define ctrlplane_policy_config_parser_h
+#include <map>
 #include <string>
+
+#include "routing-policy/policy_config.h"
+
+// Convert an xml document with policy statements into PolicyConfigs.
 class PolicyConfigParser {
 public:
+    typedef std::map<std::string, PolicyConfig> PolicyConfigMap;
+
     PolicyConfigParser();
     bool Parse(const std::string &content);
+
+    const PolicyConfigMap &policies() const { return policies_; }
+    const PolicyConfig *Find(const std::string &name) const;
+
+private:
+    PolicyConfigMap policies_;
 };
 #endif //ctrlplane_policy_config_parser_h
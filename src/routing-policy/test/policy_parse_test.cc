@@ -31,7 +31,44 @@ protected:
 
 TEST_F(PolicyParserTest, Basic) {
     string content = FileRead("src/routing-policy/testdata/policy_1.xml");
-    parser_.Parse(content);
+    EXPECT_TRUE(parser_.Parse(content));
+
+    const PolicyConfig *policy = parser_.Find("Test_1");
+    ASSERT_TRUE(policy != NULL);
+    ASSERT_EQ(3U, policy->terms.size());
+
+    const PolicyTermConfig &t1 = policy->terms[0];
+    EXPECT_EQ("t1", t1.name);
+    ASSERT_EQ(1U, t1.match_communities.size());
+    EXPECT_EQ("20:20", t1.match_communities[0]);
+    ASSERT_EQ(1U, t1.match_prefixes.size());
+    EXPECT_EQ("10.1.0.0/16", t1.match_prefixes[0]);
+    ASSERT_EQ(1U, t1.add_communities.size());
+    EXPECT_EQ("target:1:2", t1.add_communities[0]);
+    EXPECT_EQ("next", t1.action);
+
+    const PolicyTermConfig &t2 = policy->terms[1];
+    EXPECT_EQ("t2", t2.name);
+    EXPECT_EQ("reject", t2.action);
+
+    const PolicyTermConfig &t3 = policy->terms[2];
+    EXPECT_EQ("default", t3.name);
+    EXPECT_TRUE(t3.match_prefixes.empty());
+    EXPECT_EQ(25U, t3.update_local_pref);
+    EXPECT_EQ("accept", t3.action);
+}
+
+TEST_F(PolicyParserTest, Compare) {
+    string content = FileRead("src/routing-policy/testdata/policy_1.xml");
+    EXPECT_TRUE(parser_.Parse(content));
+    const PolicyConfig *policy = parser_.Find("Test_1");
+    ASSERT_TRUE(policy != NULL);
+
+    PolicyConfig copy = *policy;
+    EXPECT_TRUE(copy == *policy);
+    copy.terms[1].action = "accept";
+    EXPECT_TRUE(copy != *policy);
+    EXPECT_TRUE(parser_.Find("Test_2") == NULL);
 }
 
 int main(int argc, char **argv) {
@@ -327,7 +327,11 @@ void Agent::InitModules() {
         ksync_.get()->NetlinkInit();
         ksync_.get()->VRouterInterfaceSnapshot();
         ksync_.get()->InitFlowMem();
-        ksync_.get()->ResetVRouter();
+        if (init_->ksync_audit()) {
+            ksync_.get()->VRouterAudit();
+        } else {
+            ksync_.get()->ResetVRouter();
+        }
         if (init_->create_vhost()) {
             ksync_.get()->CreateVhostIntf();
         }
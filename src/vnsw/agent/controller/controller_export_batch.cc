@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <limits>
+#include <sstream>
+#include <boost/bind.hpp>
+
+#include <base/timer.h>
+#include <base/util.h>
+#include <io/event_manager.h>
+#include <net/bgp_af.h>
+#include <pugixml/pugixml.hpp>
+#include "cmn/agent_cmn.h"
+#include "xml/xml_pugi.h"
+#include "xmpp/xmpp_init.h"
+#include "controller/controller_export_batch.h"
+#include "controller/controller_peer.h"
+
+using namespace autogen;
+
+bool RouteExportBatcher::batching_ = true;
+int RouteExportBatcher::batch_interval_msec_ =
+    RouteExportBatcher::kBatchIntervalMsec;
+
+bool RouteExportBatcher::BatchKey::operator<(const BatchKey &rhs) const {
+    if (vrf_ != rhs.vrf_) {
+        return vrf_ < rhs.vrf_;
+    }
+    if (af_ != rhs.af_) {
+        return af_ < rhs.af_;
+    }
+    return safi_ < rhs.safi_;
+}
+
+RouteExportBatcher::RouteExportBatcher(AgentXmppChannel *channel)
+    : channel_(channel),
+      timer_(TimerManager::CreateTimer(
+                 *(Agent::GetInstance()->GetEventManager())->io_service(),
+                 "RouteExportBatchTimer",
+                 TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0)),
+      pending_count_(0), message_id_(0), messages_sent_(0), routes_sent_(0),
+      routes_dropped_(0), blocked_count_(0), total_latency_usec_(0),
+      max_latency_usec_(0) {
+    blocked_ = false;
+}
+
+RouteExportBatcher::~RouteExportBatcher() {
+    timer_->Cancel();
+    TimerManager::DeleteTimer(timer_);
+}
+
+bool RouteExportBatcher::EnqueueV4UnicastRoute(const std::string &vrf,
+                                               const std::string &node_id,
+                                               const ItemType &item,
+                                               bool add_route) {
+    PendingRoute route;
+    route.add_route_ = add_route;
+    route.inet_item_.reset(new ItemType(item));
+    return Enqueue(BatchKey(vrf, item.entry.nlri.af, item.entry.nlri.safi),
+                   node_id, route);
+}
+
+bool RouteExportBatcher::EnqueueEvpnRoute(const std::string &vrf,
+                                          const std::string &node_id,
+                                          const EnetItemType &item,
+                                          bool add_route) {
+    PendingRoute route;
+    route.add_route_ = add_route;
+    route.enet_item_.reset(new EnetItemType(item));
+    return Enqueue(BatchKey(vrf, item.entry.nlri.af, item.entry.nlri.safi),
+                   node_id, route);
+}
+
+bool RouteExportBatcher::Enqueue(const BatchKey &key,
+                                 const std::string &node_id,
+                                 const PendingRoute &route) {
+    XmppChannel *channel = channel_->GetXmppChannel();
+    if (channel == NULL || channel->GetPeerState() != xmps::READY) {
+        return false;
+    }
+
+    tbb::mutex::scoped_lock lock(mutex_);
+    RouteMap &routes = batch_map_[key];
+    RouteMap::iterator it = routes.find(node_id);
+    if (it == routes.end()) {
+        it = routes.insert(std::make_pair(node_id, route)).first;
+        it->second.enqueue_time_ = UTCTimestampUsec();
+        it->second.node_id_ = node_id;
+        pending_count_++;
+    } else {
+        // Only the latest state of the route is sent. Latency is measured
+        // from the first pending change
+        uint64_t enqueue_time = it->second.enqueue_time_;
+        it->second = route;
+        it->second.enqueue_time_ = enqueue_time;
+        it->second.node_id_ = node_id;
+    }
+
+    if (batching_ == false) {
+        FlushInternal();
+        return true;
+    }
+    StartTimer();
+    return true;
+}
+
+void RouteExportBatcher::StartTimer() {
+    if (blocked_ || timer_->running())
+        return;
+    timer_->Start(batch_interval_msec_,
+                  boost::bind(&RouteExportBatcher::Flush, this));
+}
+
+bool RouteExportBatcher::Flush() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    FlushInternal();
+    return false;
+}
+
+void RouteExportBatcher::FlushVrf(const std::string &vrf) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    XmppChannel *channel = channel_->GetXmppChannel();
+    if (channel == NULL || channel->GetPeerState() != xmps::READY) {
+        return;
+    }
+
+    // The routes are sent even if the session is blocked, the subscribe
+    // message following them is queued on the session anyway
+    BatchMap::iterator it = batch_map_.lower_bound(
+        BatchKey(vrf, std::numeric_limits<int>::min(),
+                 std::numeric_limits<int>::min()));
+    while (it != batch_map_.end() && it->first.vrf_ == vrf) {
+        while (!it->second.empty()) {
+            if (!SendMessage(it->first, &it->second) && !blocked_) {
+                blocked_ = true;
+                blocked_count_++;
+            }
+        }
+        batch_map_.erase(it++);
+    }
+}
+
+// Called from the TCP write-ready callback. Do not take mutex_ here since
+// the session may be locked by a sender already holding mutex_
+void RouteExportBatcher::WriteReady() {
+    if (blocked_ == false)
+        return;
+    blocked_ = false;
+    StartTimer();
+}
+
+void RouteExportBatcher::Clear() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    routes_dropped_ += pending_count_;
+    batch_map_.clear();
+    pending_count_ = 0;
+    blocked_ = false;
+}
+
+// Must be called with mutex_ held. Returns false if session is blocked
+bool RouteExportBatcher::FlushInternal() {
+    XmppChannel *channel = channel_->GetXmppChannel();
+    if (channel == NULL || channel->GetPeerState() != xmps::READY) {
+        routes_dropped_ += pending_count_;
+        batch_map_.clear();
+        pending_count_ = 0;
+        return true;
+    }
+
+    BatchMap::iterator it = batch_map_.begin();
+    while (it != batch_map_.end()) {
+        while (!it->second.empty()) {
+            if (blocked_)
+                return false;
+            if (!SendMessage(it->first, &it->second)) {
+                blocked_ = true;
+                blocked_count_++;
+            }
+        }
+        batch_map_.erase(it++);
+    }
+    return true;
+}
+
+// Encode routes with the same operation as the first pending route into one
+// publish message followed by its collection message. Sent routes are
+// removed from the map. Returns false if the session got blocked
+bool RouteExportBatcher::SendMessage(const BatchKey &key, RouteMap *routes) {
+    XmppChannel *channel = channel_->GetXmppChannel();
+    bool add_route = routes->begin()->second.add_route_;
+    std::string node_id = routes->begin()->second.node_id_;
+
+    std::auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
+    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
+
+    pugi->AddNode("iq", "");
+    pugi->AddAttribute("type", "set");
+    pugi->AddAttribute("from", channel->FromString());
+    std::string to(channel->ToString());
+    to += "/";
+    to += XmppInit::kBgpPeer;
+    pugi->AddAttribute("to", to);
+
+    std::stringstream pubsub_id;
+    pubsub_id << "pubsub" << message_id_++;
+    pugi->AddAttribute("id", pubsub_id.str());
+
+    pugi->AddChildNode("pubsub", "");
+    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
+    pugi->AddChildNode("publish", "");
+    pugi->AddAttribute("node", node_id);
+    pugi::xml_node publish = pugi->FindNode("publish");
+
+    uint64_t now = UTCTimestampUsec();
+    size_t msg_size = 0;
+    size_t count = 0;
+    RouteMap::iterator it = routes->begin();
+    while (it != routes->end() && count < kMaxRoutesPerMessage) {
+        PendingRoute &route = it->second;
+        if (route.add_route_ != add_route) {
+            ++it;
+            continue;
+        }
+
+        pugi::xml_node node = publish.append_child("item");
+        if (route.inet_item_.get()) {
+            route.inet_item_->Encode(&node);
+        } else {
+            route.enet_item_->Encode(&node);
+        }
+
+        std::ostringstream item_str;
+        node.print(item_str, "", pugi::format_raw);
+        size_t item_size = item_str.str().size();
+        if (count && (msg_size + item_size > kMaxMessageSize)) {
+            publish.remove_child(node);
+            break;
+        }
+        msg_size += item_size;
+        count++;
+
+        uint64_t latency = now - route.enqueue_time_;
+        total_latency_usec_ += latency;
+        if (latency > max_latency_usec_)
+            max_latency_usec_ = latency;
+        routes->erase(it++);
+        pending_count_--;
+    }
+
+    std::ostringstream publish_msg;
+    pugi->PrintDoc(publish_msg);
+    std::string data(publish_msg.str());
+    bool ret = channel_->SendUpdate(
+        reinterpret_cast<uint8_t *>(const_cast<char *>(data.data())),
+        data.size());
+
+    pugi->DeleteNode("pubsub");
+    pugi->ReadNode("iq");
+
+    std::stringstream collection_id;
+    collection_id << "collection" << message_id_++;
+    pugi->ModifyAttribute("id", collection_id.str());
+    pugi->AddChildNode("pubsub", "");
+    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
+    pugi->AddChildNode("collection", "");
+
+    pugi->AddAttribute("node", key.vrf_);
+    if (add_route) {
+        pugi->AddChildNode("associate", "");
+    } else {
+        pugi->AddChildNode("dissociate", "");
+    }
+    pugi->AddAttribute("node", node_id);
+
+    std::ostringstream collection_msg;
+    pugi->PrintDoc(collection_msg);
+    data = collection_msg.str();
+    // The collection message must follow the publish message even if the
+    // session got blocked, since the control-node merges the two
+    ret = channel_->SendUpdate(
+        reinterpret_cast<uint8_t *>(const_cast<char *>(data.data())),
+        data.size()) && ret;
+
+    messages_sent_++;
+    routes_sent_ += count;
+    return ret;
+}
+
+double RouteExportBatcher::RoutesPerMessage() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    if (messages_sent_ == 0)
+        return 0;
+    return ((double)routes_sent_) / messages_sent_;
+}
+
+uint64_t RouteExportBatcher::AverageLatencyUsec() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    if (routes_sent_ == 0)
+        return 0;
+    return total_latency_usec_ / routes_sent_;
+}
+
+size_t RouteExportBatcher::PendingCount() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return pending_count_;
+}
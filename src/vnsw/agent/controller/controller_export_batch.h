@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __CONTROLLER_EXPORT_BATCH_H__
+#define __CONTROLLER_EXPORT_BATCH_H__
+
+#include <map>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <tbb/atomic.h>
+#include <tbb/mutex.h>
+
+#include <base/util.h>
+
+#include "xmpp_enet_types.h"
+#include "xmpp_unicast_types.h"
+
+class AgentXmppChannel;
+class Timer;
+
+// Accumulates route publish/retract requests towards a control-node and
+// sends them as multi-item XMPP messages.
+//
+// Routes are batched per (vrf, address-family) over a short window. A later
+// request for the same route replaces the pending one, so only the latest
+// state of a route is sent. All items in a message carry the same
+// associate/dissociate operation, which lets the control-node process them
+// through its existing per-item loop.
+//
+// When the XMPP session is blocked, sending stops and resumes from
+// AgentXmppChannel::WriteReadyCb.
+class RouteExportBatcher {
+public:
+    static const int kBatchIntervalMsec = 10;
+    static const size_t kMaxRoutesPerMessage = 64;
+    static const size_t kMaxMessageSize = 16 * 1024;
+
+    explicit RouteExportBatcher(AgentXmppChannel *channel);
+    ~RouteExportBatcher();
+
+    // Returns false if the route cannot be exported since the session is
+    // not up
+    bool EnqueueV4UnicastRoute(const std::string &vrf,
+                               const std::string &node_id,
+                               const autogen::ItemType &item, bool add_route);
+    bool EnqueueEvpnRoute(const std::string &vrf, const std::string &node_id,
+                          const autogen::EnetItemType &item, bool add_route);
+
+    // Send pending routes. Invoked on timer expiry
+    bool Flush();
+    // Send pending routes of a vrf right away. Invoked before the vrf
+    // subscribe/unsubscribe, which must not overtake its routes
+    void FlushVrf(const std::string &vrf);
+    // Session is writable again
+    void WriteReady();
+    // Drop pending routes when session goes down. Routes are exported again
+    // on the next session establishment
+    void Clear();
+
+    // Disable batching window. Every request is sent right away, one route
+    // per message
+    static void set_batching(bool enable) { batching_ = enable; }
+    static bool batching() { return batching_; }
+    // Length of the batching window, for tests
+    static void set_batch_interval(int msec) { batch_interval_msec_ = msec; }
+
+    uint64_t messages_sent() const { return messages_sent_; }
+    uint64_t routes_sent() const { return routes_sent_; }
+    uint64_t routes_dropped() const { return routes_dropped_; }
+    uint64_t blocked_count() const { return blocked_count_; }
+    uint64_t max_latency_usec() const { return max_latency_usec_; }
+    double RoutesPerMessage() const;
+    uint64_t AverageLatencyUsec() const;
+    size_t PendingCount() const;
+
+private:
+    struct PendingRoute {
+        bool add_route_;
+        uint64_t enqueue_time_;
+        std::string node_id_;
+        boost::shared_ptr<autogen::ItemType> inet_item_;
+        boost::shared_ptr<autogen::EnetItemType> enet_item_;
+    };
+
+    // Routes are keyed by the publish node id, which is unique per route
+    typedef std::map<std::string, PendingRoute> RouteMap;
+
+    struct BatchKey {
+        BatchKey(const std::string &vrf, int af, int safi)
+            : vrf_(vrf), af_(af), safi_(safi) { }
+        bool operator<(const BatchKey &rhs) const;
+
+        std::string vrf_;
+        int af_;
+        int safi_;
+    };
+    typedef std::map<BatchKey, RouteMap> BatchMap;
+
+    bool Enqueue(const BatchKey &key, const std::string &node_id,
+                 const PendingRoute &route);
+    void StartTimer();
+    bool FlushInternal();
+    bool SendMessage(const BatchKey &key, RouteMap *routes);
+
+    AgentXmppChannel *channel_;
+    Timer *timer_;
+    mutable tbb::mutex mutex_;
+    BatchMap batch_map_;
+    size_t pending_count_;
+    // Updated from the write-ready callback without taking mutex_
+    tbb::atomic<bool> blocked_;
+    uint64_t message_id_;
+
+    uint64_t messages_sent_;
+    uint64_t routes_sent_;
+    uint64_t routes_dropped_;
+    uint64_t blocked_count_;
+    uint64_t total_latency_usec_;
+    uint64_t max_latency_usec_;
+
+    static bool batching_;
+    static int batch_interval_msec_;
+
+    DISALLOW_COPY_AND_ASSIGN(RouteExportBatcher);
+};
+
+#endif // __CONTROLLER_EXPORT_BATCH_H__
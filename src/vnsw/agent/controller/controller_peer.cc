@@ -12,6 +12,8 @@
 #include "controller/controller_ifmap.h"
 #include "controller/controller_vrf_export.h"
 #include "controller/controller_init.h"
+#include "controller/controller_export_batch.h"
+#include "controller/controller_snapshot.h"
 #include "oper/vrf.h"
 #include "oper/nexthop.h"
 #include "oper/mirror_table.h"
@@ -32,7 +34,7 @@ using namespace autogen;
 AgentXmppChannel::AgentXmppChannel(XmppChannel *channel, std::string xmpp_server, 
                                    std::string label_range, uint8_t xs_idx) 
     : channel_(channel), xmpp_server_(xmpp_server), label_range_(label_range),
-      xs_idx_(xs_idx) {
+      xs_idx_(xs_idx), export_batcher_(new RouteExportBatcher(this)) {
 
     channel_->RegisterReceive(xmps::BGP, 
                               boost::bind(&AgentXmppChannel::ReceiveInternal, 
@@ -51,6 +53,7 @@ AgentXmppChannel::~AgentXmppChannel() {
     Agent::GetInstance()->GetVrfTable()->Unregister(id);
     delete bgp_peer_id_;
     channel_->UnRegisterReceive(xmps::BGP);
+    delete export_batcher_;
 }
 
 bool AgentXmppChannel::SendUpdate(uint8_t *msg, size_t size) {
@@ -635,6 +638,7 @@ std::string AgentXmppChannel::ToString() const {
 }
 
 void AgentXmppChannel::WriteReadyCb(const boost::system::error_code &ec) {
+    export_batcher_->WriteReady();
 }
 
 void AgentXmppChannel::BgpPeerDelDone() {
@@ -656,6 +660,8 @@ void AgentXmppChannel::HandleXmppClientChannelEvent(AgentXmppChannel *peer,
                 //Generate a new sequence number for the configuration
                 AgentIfMapXmppChannel::NewSeqNumber();
                 AgentIfMapVmExport::NotifyAll(peer);
+                //Remove the snapshot state not refreshed by the new server
+                AgentSnapshot::Reconcile();
             } 
         }
 
@@ -694,6 +700,9 @@ void AgentXmppChannel::HandleXmppClientChannelEvent(AgentXmppChannel *peer,
 
     } else {
 
+        //Drop routes pending export, they are exported again on READY
+        peer->export_batcher()->Clear();
+
         //Enqueue cleanup of unicast routes
         peer->GetBgpPeer()->DelPeerRoutes(
             boost::bind(&AgentXmppChannel::BgpPeerDelDone, peer));
@@ -843,6 +852,10 @@ bool AgentXmppChannel::ControllerSendSubscribe(AgentXmppChannel *peer,
     if (!peer) {
         return false;
     }      
+
+    // Routes of the vrf still in the export batch go out ahead of the
+    // subscribe/unsubscribe, else the control-node drops them
+    peer->export_batcher_->FlushVrf(vrf->GetName());
        
     //Build the DOM tree
     auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
@@ -885,17 +898,10 @@ bool AgentXmppChannel::ControllerSendV4UnicastRoute(AgentXmppChannel *peer,
                                                uint32_t mpls_label,
                                                bool add_route) {
 
-    static int id = 0;
     ItemType item;
-    uint8_t data_[4096];
-    size_t datalen_;
    
     if (!peer) return false;
 
-    //Build the DOM tree
-    auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
-    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
-
     item.entry.nlri.af = BgpAf::IPv4; 
     item.entry.nlri.safi = BgpAf::Unicast; 
     stringstream rstr;
@@ -920,23 +926,6 @@ bool AgentXmppChannel::ControllerSendV4UnicastRoute(AgentXmppChannel *peer,
     item.entry.version = 1; //TODO
     item.entry.virtual_network = vn;
    
-    pugi->AddNode("iq", "");
-    pugi->AddAttribute("type", "set");
-    
-    pugi->AddAttribute("from", peer->channel_->FromString());
-    std::string to(peer->channel_->ToString());
-    to += "/";
-    to += XmppInit::kBgpPeer; 
-    pugi->AddAttribute("to", to);
-
-    stringstream pubsub_id;
-    pubsub_id << "pubsub" << id++;
-    pugi->AddAttribute("id", pubsub_id.str()); 
-
-    pugi->AddChildNode("pubsub", "");
-    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
-    pugi->AddChildNode("publish", "");
-
     //Catering for inet4 and evpn unicast routes
     stringstream ss_node;
     ss_node << item.entry.nlri.af << "/" 
@@ -944,39 +933,10 @@ bool AgentXmppChannel::ControllerSendV4UnicastRoute(AgentXmppChannel *peer,
             << route->GetVrfEntry()->GetName() << "/" 
             << route->GetAddressString();
     std::string node_id(ss_node.str());
-    pugi->AddAttribute("node", node_id);
-    pugi->AddChildNode("item", "");
-
-    pugi::xml_node node = pugi->FindNode("item");
 
-    //Call Auto-generated Code to encode the struct
-    item.Encode(&node);
-
-    datalen_ = XmppProto::EncodeMessage(impl.get(), data_, sizeof(data_));
-    // send data
-    peer->SendUpdate(data_,datalen_);
-
-    pugi->DeleteNode("pubsub");
-    pugi->ReadNode("iq");
-
-    stringstream collection_id;
-    collection_id << "collection" << id++;
-    pugi->ModifyAttribute("id", collection_id.str()); 
-    pugi->AddChildNode("pubsub", "");
-    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
-    pugi->AddChildNode("collection", "");
-
-    pugi->AddAttribute("node", route->GetVrfEntry()->GetName());
-    if (add_route) {
-        pugi->AddChildNode("associate", "");
-    } else {
-        pugi->AddChildNode("dissociate", "");
-    }
-    pugi->AddAttribute("node", node_id);
-
-    datalen_ = XmppProto::EncodeMessage(impl.get(), data_, sizeof(data_));
-    // send data
-    return (peer->SendUpdate(data_,datalen_));
+    // Publish and collection messages are built by the batcher
+    return peer->export_batcher_->EnqueueV4UnicastRoute(
+                route->GetVrfEntry()->GetName(), node_id, item, add_route);
 }
 
 bool AgentXmppChannel::ControllerSendEvpnRoute(AgentXmppChannel *peer,
@@ -985,17 +945,10 @@ bool AgentXmppChannel::ControllerSendEvpnRoute(AgentXmppChannel *peer,
                                                uint32_t label,
                                                uint32_t tunnel_bmap,
                                                bool add_route) {
-    static int id = 0;
     EnetItemType item;
-    uint8_t data_[4096];
-    size_t datalen_;
    
     if (!peer) return false;
 
-    //Build the DOM tree
-    auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
-    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
-
     //TODO remove hardcoding
     item.entry.nlri.af = 25; 
     item.entry.nlri.safi = 242; 
@@ -1028,60 +981,14 @@ bool AgentXmppChannel::ControllerSendEvpnRoute(AgentXmppChannel *peer,
     //item.entry.version = 1; //TODO
     //item.entry.virtual_network = vn;
    
-    pugi->AddNode("iq", "");
-    pugi->AddAttribute("type", "set");
-    
-    pugi->AddAttribute("from", peer->channel_->FromString());
-    std::string to(peer->channel_->ToString());
-    to += "/";
-    to += XmppInit::kBgpPeer; 
-    pugi->AddAttribute("to", to);
-
-    stringstream pubsub_id;
-    pubsub_id << "pubsub" << id++;
-    pugi->AddAttribute("id", pubsub_id.str()); 
-
-    pugi->AddChildNode("pubsub", "");
-    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
-    pugi->AddChildNode("publish", "");
-
     stringstream ss_node;
     ss_node << item.entry.nlri.af << "/" << item.entry.nlri.safi << "/" 
         << route->GetAddressString() << "," << item.entry.nlri.address; 
     std::string node_id(ss_node.str());
-    pugi->AddAttribute("node", node_id);
-    pugi->AddChildNode("item", "");
-
-    pugi::xml_node node = pugi->FindNode("item");
-
-    //Call Auto-generated Code to encode the struct
-    item.Encode(&node);
-
-    datalen_ = XmppProto::EncodeMessage(impl.get(), data_, sizeof(data_));
-    // send data
-    peer->SendUpdate(data_,datalen_);
-
-    pugi->DeleteNode("pubsub");
-    pugi->ReadNode("iq");
 
-    stringstream collection_id;
-    collection_id << "collection" << id++;
-    pugi->ModifyAttribute("id", collection_id.str()); 
-    pugi->AddChildNode("pubsub", "");
-    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
-    pugi->AddChildNode("collection", "");
-
-    pugi->AddAttribute("node", route->GetVrfEntry()->GetName());
-    if (add_route) {
-        pugi->AddChildNode("associate", "");
-    } else {
-        pugi->AddChildNode("dissociate", "");
-    }
-    pugi->AddAttribute("node", node_id);
-
-    datalen_ = XmppProto::EncodeMessage(impl.get(), data_, sizeof(data_));
-    // send data
-    return (peer->SendUpdate(data_,datalen_));
+    // Publish and collection messages are built by the batcher
+    return peer->export_batcher_->EnqueueEvpnRoute(
+                route->GetVrfEntry()->GetName(), node_id, item, add_route);
 }
 
 bool AgentXmppChannel::ControllerSendRoute(AgentXmppChannel *peer,
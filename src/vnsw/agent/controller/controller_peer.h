@@ -16,6 +16,7 @@
 #include <oper/route_types.h>
 
 class RouteEntry;
+class RouteExportBatcher;
 class Peer;
 class VrfEntry;
 class XmlPugi;
@@ -65,6 +66,7 @@ public:
     std::string GetXmppServer() { return xmpp_server_; }
     uint8_t GetXmppServerIdx() { return xs_idx_; }
     std::string GetMcastLabelRange() { return label_range_; }
+    RouteExportBatcher *export_batcher() { return export_batcher_; }
 
 protected:
     virtual void WriteReadyCb(const boost::system::error_code &ec);
@@ -87,6 +89,7 @@ private:
     std::string label_range_;
     uint8_t xs_idx_;
     Peer *bgp_peer_id_;
+    RouteExportBatcher *export_batcher_;
 };
 
 #endif // __CONTROLLER_PEER_H__
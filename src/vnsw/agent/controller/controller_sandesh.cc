@@ -7,6 +7,7 @@
 #include <controller/controller_sandesh.h>
 #include <controller/controller_types.h>
 #include <controller/controller_peer.h>
+#include <controller/controller_export_batch.h>
 
 void AgentXmppConnectionStatusReq::HandleRequest() const {
     uint8_t count = 0;
@@ -57,6 +58,19 @@ void AgentXmppConnectionStatusReq::HandleRequest() const {
 
 		data.set_rx_proto_stats(rx_proto_stats); 
                 data.set_tx_proto_stats(tx_proto_stats); 
+
+                RouteExportBatcher *batcher = ch->export_batcher();
+                ControllerRouteExportStats export_stats;
+                export_stats.set_messages(batcher->messages_sent());
+                export_stats.set_routes(batcher->routes_sent());
+                export_stats.set_routes_per_message(batcher->RoutesPerMessage());
+                export_stats.set_average_latency_usec(
+                    batcher->AverageLatencyUsec());
+                export_stats.set_max_latency_usec(batcher->max_latency_usec());
+                export_stats.set_pending(batcher->PendingCount());
+                export_stats.set_dropped(batcher->routes_dropped());
+                export_stats.set_blocked(batcher->blocked_count());
+                data.set_route_export_stats(export_stats);
             }
 
 	    std::vector<AgentXmppData> &list =
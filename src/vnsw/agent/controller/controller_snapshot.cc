@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+#include <errno.h>
+#include <memory>
+
+#include <base/logging.h>
+#include <base/task.h>
+#include <base/timer.h>
+#include <base/util.h>
+#include <db/db_graph.h>
+#include <ifmap/ifmap_agent_parser.h>
+#include <ifmap/ifmap_agent_table.h>
+#include <ifmap/ifmap_link.h>
+#include <ifmap/ifmap_node.h>
+
+#include <cmn/agent_cmn.h>
+#include <cfg/cfg_init.h>
+#include <oper/agent_route.h>
+#include <oper/peer.h>
+#include <oper/tunnel_nh.h>
+#include <oper/vrf.h>
+
+#include <controller/controller_ifmap.h>
+#include <controller/controller_snapshot.h>
+
+using namespace pugi;
+
+AgentSnapshot *AgentSnapshot::singleton_;
+
+// Writes out a snapshot built in the DB task. The task owns the document,
+// so it does not depend on the AgentSnapshot going away meanwhile. Writes
+// are not run concurrently since all the tasks have the same instance.
+class AgentSnapshot::WriteTask : public Task {
+public:
+    WriteTask(const std::string &file, std::auto_ptr<xml_document> doc)
+        : Task(TaskScheduler::GetInstance()->GetTaskId("Agent::Snapshot"), 0),
+          file_(file), doc_(doc) {
+    }
+
+    virtual bool Run() {
+        AgentSnapshot::Write(file_, *doc_);
+        return true;
+    }
+
+private:
+    std::string file_;
+    std::auto_ptr<xml_document> doc_;
+};
+
+AgentSnapshot::RouteInfo::RouteInfo()
+    : vrf(), addr(), plen(0), server_ip(), bmap(0), label(0), dest_vn(),
+      sg_list() {
+}
+
+AgentSnapshot::AgentSnapshot(const std::string &file)
+    : file_(file),
+      peer_(new Peer(Peer::SNAPSHOT_PEER, SNAPSHOT_PEER_NAME)),
+      config_loaded_(false) {
+    int task_id = TaskScheduler::GetInstance()->GetTaskId("db::DBTable");
+    boost::asio::io_service &io =
+        *(Agent::GetInstance()->GetEventManager()->io_service());
+    save_timer_ = TimerManager::CreateTimer(io, "Agent snapshot save timer",
+                                            task_id, 0);
+    stale_timer_ = TimerManager::CreateTimer(io, "Agent snapshot stale timer",
+                                             task_id, 0);
+    vrf_listener_id_ = Agent::GetInstance()->GetVrfTable()->Register(
+        boost::bind(&AgentSnapshot::VrfNotify, this, _1, _2));
+}
+
+AgentSnapshot::~AgentSnapshot() {
+    Agent::GetInstance()->GetVrfTable()->Unregister(vrf_listener_id_);
+    TimerManager::DeleteTimer(save_timer_);
+    TimerManager::DeleteTimer(stale_timer_);
+}
+
+// Load the snapshot, if present, and start saving it periodically.
+// Called in the DB task context before connecting to the control nodes.
+void AgentSnapshot::Init(const std::string &file, int interval) {
+    assert(singleton_ == NULL);
+    singleton_ = new AgentSnapshot(file);
+    singleton_->Load();
+    if (interval > 0) {
+        singleton_->save_timer_->Start(interval * 1000,
+            boost::bind(&AgentSnapshot::SaveTimeout, singleton_));
+    }
+}
+
+// The routes added from the snapshot must have been deleted by now, since
+// they refer to the snapshot peer.
+void AgentSnapshot::Shutdown() {
+    delete singleton_;
+    singleton_ = NULL;
+}
+
+// Invoked when a configuration server is selected. The configuration from
+// the server is parsed with a new sequence number, so whatever is left with
+// the older sequence number after the stale timeout came from the snapshot
+// only. The control node routes take precedence over the snapshot routes as
+// soon as they are added, so the latter are removed after the same timeout.
+void AgentSnapshot::Reconcile() {
+    if (singleton_ == NULL)
+        return;
+
+    if (singleton_->config_loaded_) {
+        singleton_->config_loaded_ = false;
+        Agent::GetInstance()->GetIfMapAgentStaleCleaner()->
+            StaleCleanup(AgentIfMapXmppChannel::GetSeqNumber());
+    }
+    if (singleton_->stale_timer_->running())
+        return;
+    singleton_->stale_timer_->Start(kStaleTimeout,
+        boost::bind(&AgentSnapshot::StaleTimeout, singleton_));
+}
+
+bool AgentSnapshot::SaveTimeout() {
+    SaveAsync();
+    return true;
+}
+
+bool AgentSnapshot::StaleTimeout() {
+    DeleteStaleRoutes();
+    return false;
+}
+
+void AgentSnapshot::EncodeConfig(xml_node *parent) const {
+    DBGraph *graph = Agent::GetInstance()->cfg()->cfg_graph();
+    xml_node update = parent->append_child("update");
+
+    for (DBGraph::vertex_iterator iter = graph->vertex_list_begin();
+         iter != graph->vertex_list_end(); ++iter) {
+        const IFMapNode *node =
+            static_cast<const IFMapNode *>(iter.operator->());
+        if (node->IsDeleted() || node->GetObject() == NULL)
+            continue;
+        node->EncodeNodeDetail(&update);
+    }
+
+    for (DBGraph::edge_iterator iter = graph->edge_list_begin();
+         iter != graph->edge_list_end(); ++iter) {
+        const DBGraph::DBVertexPair &tuple = *iter;
+        const IFMapNode *left = static_cast<const IFMapNode *>(tuple.first);
+        const IFMapNode *right = static_cast<const IFMapNode *>(tuple.second);
+        if (left->IsDeleted() || right->IsDeleted())
+            continue;
+        xml_node link = update.append_child("link");
+        left->EncodeNode(&link);
+        right->EncodeNode(&link);
+    }
+}
+
+// Only the routes that point to a tunnel are saved. Routes that point to
+// local interfaces are added by the agent itself once the configuration is
+// loaded.
+void AgentSnapshot::EncodeRoutes(xml_node *parent) const {
+    VrfTable *vrf_table = Agent::GetInstance()->GetVrfTable();
+    for (int vidx = 0; vidx < vrf_table->PartitionCount(); ++vidx) {
+        DBTablePartBase *vpart = vrf_table->GetTablePartition(vidx);
+        for (DBEntryBase *ventry = vpart->GetFirst(); ventry != NULL;
+             ventry = vpart->GetNext(ventry)) {
+            const VrfEntry *vrf = static_cast<const VrfEntry *>(ventry);
+            if (vrf->IsDeleted())
+                continue;
+            AgentRouteTable *table =
+                vrf->GetRouteTable(AgentRouteTableAPIS::INET4_UNICAST);
+            for (int ridx = 0; ridx < table->PartitionCount(); ++ridx) {
+                DBTablePartBase *rpart = table->GetTablePartition(ridx);
+                for (DBEntryBase *rentry = rpart->GetFirst(); rentry != NULL;
+                     rentry = rpart->GetNext(rentry)) {
+                    const Inet4UnicastRouteEntry *rt =
+                        static_cast<const Inet4UnicastRouteEntry *>(rentry);
+                    if (rt->IsDeleted())
+                        continue;
+                    const AgentPath *path = rt->GetActivePath();
+                    if (path == NULL ||
+                        path->GetPeer()->GetType() != Peer::BGP_PEER)
+                        continue;
+                    const NextHop *nh = path->GetNextHop();
+                    if (nh == NULL || nh->GetType() != NextHop::TUNNEL)
+                        continue;
+                    const TunnelNH *tnh = static_cast<const TunnelNH *>(nh);
+
+                    xml_node route = parent->append_child("route");
+                    route.append_attribute("vrf") = vrf->GetName().c_str();
+                    route.append_attribute("prefix") =
+                        rt->GetIpAddress().to_string().c_str();
+                    route.append_attribute("plen") = rt->GetPlen();
+                    route.append_attribute("nexthop") =
+                        tnh->GetDip()->to_string().c_str();
+                    route.append_attribute("label") = path->GetLabel();
+                    route.append_attribute("tunnel-bmap") =
+                        path->GetTunnelBmap();
+                    route.append_attribute("vn") =
+                        path->GetDestVnName().c_str();
+                    const SecurityGroupList &sg_list =
+                        path->GetSecurityGroupList();
+                    for (SecurityGroupList::const_iterator it =
+                         sg_list.begin(); it != sg_list.end(); ++it) {
+                        route.append_child("sg").text().set(*it);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void AgentSnapshot::Encode(xml_document *doc) const {
+    uint64_t start = UTCTimestampUsec();
+    xml_node root = doc->append_child("agent-snapshot");
+    root.append_attribute("version") = kVersion;
+
+    xml_node config = root.append_child("config");
+    EncodeConfig(&config);
+    xml_node routes = root.append_child("routes");
+    EncodeRoutes(&routes);
+    LOG(DEBUG, "Agent snapshot <" << file_ << "> built in " <<
+        (UTCTimestampUsec() - start) << " usec");
+}
+
+// Write to a temporary file and rename it, so that a crash while saving
+// leaves the previous snapshot intact.
+bool AgentSnapshot::Write(const std::string &file, const xml_document &doc) {
+    uint64_t start = UTCTimestampUsec();
+    std::string tmp_file = file + ".tmp";
+    if (!doc.save_file(tmp_file.c_str(), "", format_raw)) {
+        LOG(ERROR, "Error writing agent snapshot <" << tmp_file << ">");
+        return false;
+    }
+    if (rename(tmp_file.c_str(), file.c_str()) != 0) {
+        LOG(ERROR, "Error renaming agent snapshot <" << tmp_file <<
+            ">. Error number <" << errno << ">");
+        return false;
+    }
+    LOG(DEBUG, "Agent snapshot <" << file << "> written in " <<
+        (UTCTimestampUsec() - start) << " usec");
+    return true;
+}
+
+bool AgentSnapshot::Save() {
+    xml_document doc;
+    Encode(&doc);
+    return Write(file_, doc);
+}
+
+void AgentSnapshot::SaveAsync() {
+    std::auto_ptr<xml_document> doc(new xml_document);
+    Encode(doc.get());
+    TaskScheduler::GetInstance()->Enqueue(new WriteTask(file_, doc));
+}
+
+void AgentSnapshot::DecodeRoutes(const xml_node &parent) {
+    for (xml_node node = parent.child("route"); node;
+         node = node.next_sibling("route")) {
+        RouteInfo info;
+        boost::system::error_code ec;
+        info.vrf = node.attribute("vrf").value();
+        info.addr = Ip4Address::from_string(node.attribute("prefix").value(),
+                                            ec);
+        if (ec)
+            continue;
+        info.plen = node.attribute("plen").as_uint();
+        info.server_ip =
+            Ip4Address::from_string(node.attribute("nexthop").value(), ec);
+        if (ec || info.vrf.empty() || info.plen > 32)
+            continue;
+        info.label = node.attribute("label").as_uint();
+        info.bmap = node.attribute("tunnel-bmap").as_uint();
+        info.dest_vn = node.attribute("vn").value();
+        for (xml_node sg = node.child("sg"); sg; sg = sg.next_sibling("sg")) {
+            info.sg_list.push_back(sg.text().as_int());
+        }
+        pending_[info.vrf].push_back(info);
+    }
+}
+
+// Routes can only be added once their VRF has been created from the
+// configuration, so they are kept per VRF until then.
+bool AgentSnapshot::Load() {
+    xml_document doc;
+    xml_parse_result result = doc.load_file(file_.c_str());
+    if (!result) {
+        LOG(DEBUG, "Agent snapshot <" << file_ << "> not loaded: " <<
+            result.description());
+        return false;
+    }
+    xml_node root = doc.child("agent-snapshot");
+    if (!root || root.attribute("version").as_int() != kVersion) {
+        LOG(ERROR, "Ignoring agent snapshot <" << file_ <<
+            "> with unknown version");
+        return false;
+    }
+
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        DecodeRoutes(root.child("routes"));
+        VrfTable *vrf_table = Agent::GetInstance()->GetVrfTable();
+        for (VrfRouteMap::iterator it = pending_.begin();
+             it != pending_.end(); ) {
+            VrfEntry *vrf = vrf_table->FindVrfFromName(it->first);
+            if (vrf == NULL || vrf->IsDeleted()) {
+                ++it;
+                continue;
+            }
+            AddRoutes(it->second);
+            pending_.erase(it++);
+        }
+    }
+
+    // VRFs created from the configuration pick up their routes in VrfNotify
+    Agent::GetInstance()->GetIfMapAgentParser()->ConfigParse(
+        root.child("config"), AgentIfMapXmppChannel::GetSeqNumber());
+    config_loaded_ = true;
+    LOG(DEBUG, "Agent snapshot <" << file_ << "> loaded");
+    return true;
+}
+
+void AgentSnapshot::AddRoutes(const RouteList &list) {
+    for (RouteList::const_iterator it = list.begin(); it != list.end(); ++it) {
+        Inet4UnicastAgentRouteTable::AddRemoteVmRouteReq(peer_.get(),
+            it->vrf, it->addr, it->plen, it->server_ip, it->bmap, it->label,
+            it->dest_vn, it->sg_list);
+        installed_.push_back(*it);
+    }
+}
+
+void AgentSnapshot::VrfNotify(DBTablePartBase *partition, DBEntryBase *entry) {
+    if (entry->IsDeleted())
+        return;
+
+    tbb::mutex::scoped_lock lock(mutex_);
+    VrfEntry *vrf = static_cast<VrfEntry *>(entry);
+    VrfRouteMap::iterator it = pending_.find(vrf->GetName());
+    if (it == pending_.end())
+        return;
+    AddRoutes(it->second);
+    pending_.erase(it);
+}
+
+// Routes for VRFs that never showed up are dropped as well.
+void AgentSnapshot::DeleteStaleRoutes() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    for (RouteList::const_iterator it = installed_.begin();
+         it != installed_.end(); ++it) {
+        Inet4UnicastAgentRouteTable::DeleteReq(peer_.get(), it->vrf, it->addr,
+                                               it->plen);
+    }
+    installed_.clear();
+    pending_.clear();
+}
+
+size_t AgentSnapshot::route_count() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return installed_.size();
+}
+
+size_t AgentSnapshot::pending_route_count() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    size_t count = 0;
+    for (VrfRouteMap::const_iterator it = pending_.begin();
+         it != pending_.end(); ++it) {
+        count += it->second.size();
+    }
+    return count;
+}
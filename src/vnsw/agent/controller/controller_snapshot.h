@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __CONTROLLER_SNAPSHOT_H__
+#define __CONTROLLER_SNAPSHOT_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/scoped_ptr.hpp>
+#include <tbb/mutex.h>
+#include <pugixml/pugixml.hpp>
+
+#include "cmn/agent_cmn.h"
+#include "oper/nexthop.h"
+
+class Peer;
+class Timer;
+
+//
+// AgentSnapshot
+// Periodically saves the IFMap configuration and the routes learnt from
+// the control nodes to a local file, so that a restarting agent can
+// program the forwarding state before the XMPP sessions come up.
+//
+// The snapshot is built in the DB task, since it walks the configuration
+// graph and the route tables. Writing it out to the file is done by a task
+// that does not block the DB task.
+//
+// Configuration is loaded with the current IFMap sequence number and routes
+// are added with a snapshot peer that has lower priority than the control
+// node peers. Once a configuration server is selected, the configuration
+// that was not refreshed is removed by the stale cleaner and the snapshot
+// routes are removed after the same timeout.
+//
+class AgentSnapshot {
+public:
+    static const int kVersion = 1;
+    static const int kStaleTimeout = 120 * 1000; // In milli seconds
+
+    struct RouteInfo {
+        RouteInfo();
+
+        std::string vrf;
+        Ip4Address addr;
+        uint8_t plen;
+        Ip4Address server_ip;
+        TunnelType::TypeBmap bmap;
+        uint32_t label;
+        std::string dest_vn;
+        SecurityGroupList sg_list;
+    };
+    typedef std::vector<RouteInfo> RouteList;
+
+    explicit AgentSnapshot(const std::string &file);
+    ~AgentSnapshot();
+
+    static void Init(const std::string &file, int interval);
+    static void Shutdown();
+    static void Reconcile();
+    static AgentSnapshot *GetInstance() { return singleton_; }
+
+    // Build the snapshot and write it out before returning
+    bool Save();
+    // Build the snapshot and enqueue a task to write it out
+    void SaveAsync();
+    bool Load();
+    void DeleteStaleRoutes();
+
+    const std::string &file() const { return file_; }
+    const Peer *peer() const { return peer_.get(); }
+    size_t route_count() const;
+    size_t pending_route_count() const;
+
+private:
+    class WriteTask;
+    typedef std::map<std::string, RouteList> VrfRouteMap;
+
+    void Encode(pugi::xml_document *doc) const;
+    static bool Write(const std::string &file, const pugi::xml_document &doc);
+    void EncodeConfig(pugi::xml_node *parent) const;
+    void EncodeRoutes(pugi::xml_node *parent) const;
+    void DecodeRoutes(const pugi::xml_node &parent);
+    void AddRoutes(const RouteList &list);
+    void VrfNotify(DBTablePartBase *partition, DBEntryBase *entry);
+    bool SaveTimeout();
+    bool StaleTimeout();
+
+    static AgentSnapshot *singleton_;
+
+    std::string file_;
+    boost::scoped_ptr<Peer> peer_;
+    DBTableBase::ListenerId vrf_listener_id_;
+    // Protects the route lists, which are updated from the VRF notification
+    mutable tbb::mutex mutex_;
+    VrfRouteMap pending_;
+    RouteList installed_;
+    bool config_loaded_;
+    Timer *save_timer_;
+    Timer *stale_timer_;
+
+    DISALLOW_COPY_AND_ASSIGN(AgentSnapshot);
+};
+
+#endif // __CONTROLLER_SNAPSHOT_H__
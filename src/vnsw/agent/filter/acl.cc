@@ -107,6 +107,7 @@ DBEntry *AclTable::Add(const DBRequest *req) {
          ++it) {
         acl->AddAclEntry(*it, acl->acl_entries_);
     }
+    acl->CompileClassifier();
     return acl;
 }
 
@@ -137,6 +138,8 @@ bool AclTable::OnChange(DBEntry *entry, const DBRequest *req) {
         // Delete All acl entries for now and set newly created one.
         acl->DeleteAllAclEntries();
         acl->SetAclEntries(entries);
+    } else {
+        acl->CompileClassifier();
     }
     return true;
 }
@@ -541,6 +544,7 @@ void AclDBEntry::SetAclEntries(AclEntries &entries)
         entries.erase(tmp);
         acl_entries_.insert(acl_entries_.end(), *ae);
     }
+    CompileClassifier();
 }
 
 AclEntry *AclDBEntry::AddAclEntry(const AclEntrySpec &acl_entry_spec, AclEntries &entries)
@@ -599,6 +603,7 @@ bool AclDBEntry::DeleteAclEntry(const uint32_t acl_entry_id)
             acl_entries_.erase(acl_entries_.iterator_to(*iter));
             ACL_TRACE(Info, "acl entry " + integerToString(acl_entry_id) + " deleted");
             delete ae;
+            CompileClassifier();
             return true;
         }
     }
@@ -609,6 +614,7 @@ bool AclDBEntry::DeleteAclEntry(const uint32_t acl_entry_id)
 void AclDBEntry::DeleteAllAclEntries()
 {
     AclEntries::iterator iter;
+    classifier_.Clear();
     iter = acl_entries_.begin();
     while (iter != acl_entries_.end()) {
         AclEntry *ae = iter.operator->();
@@ -618,17 +624,33 @@ void AclDBEntry::DeleteAllAclEntries()
     return;
 }
 
+void AclDBEntry::CompileClassifier()
+{
+    AclEntries::const_iterator iter;
+    classifier_.Clear();
+    for (iter = acl_entries_.begin();
+         iter != acl_entries_.end(); ++iter) {
+        classifier_.AddEntry(iter.operator->());
+    }
+    classifier_.Compile();
+}
+
+// The classifier returns the entries that match the packet in the order of
+// acl_entries_, so the actions are accumulated exactly as if the entries
+// were walked one at a time.
 bool AclDBEntry::PacketMatch(const PacketHeader &packet_header, 
 			     MatchAclParams &m_acl) const
 {
-    AclEntries::const_iterator iter;
     bool ret_val = false;
     m_acl.terminal_rule = false;
 	m_acl.action_info.action = 0;
-    for (iter = acl_entries_.begin();
-         iter != acl_entries_.end();
-         ++iter) {
-        const AclEntry::ActionList &al = iter->PacketMatch(packet_header);
+
+    BitSet matches;
+    classifier_.Match(packet_header, &matches);
+    for (size_t idx = matches.find_first(); idx != BitSet::npos;
+         idx = matches.find_next(idx)) {
+        const AclEntry *entry = classifier_.entry(idx);
+        const AclEntry::ActionList &al = entry->Actions();
 	AclEntry::ActionList::const_iterator al_it;
 	for (al_it = al.begin(); al_it != al.end(); ++al_it) {
 	     TrafficAction *ta = static_cast<TrafficAction *>(*al_it.operator->());
@@ -646,8 +668,8 @@ bool AclDBEntry::PacketMatch(const PacketHeader &packet_header,
 	}
         if (!(al.empty())) {
             ret_val = true;
-            m_acl.ace_id_list.push_back((int32_t)(iter->id()));
-            if (iter->IsTerminal()) {
+            m_acl.ace_id_list.push_back((int32_t)(entry->id()));
+            if (entry->IsTerminal()) {
 	        m_acl.terminal_rule = true;
                 return ret_val;
             }
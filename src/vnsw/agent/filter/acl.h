@@ -6,6 +6,7 @@
 #define __AGENT_ACL_N_H__
 
 #include "vnsw/agent/filter/acl_entry.h"
+#include "vnsw/agent/filter/acl_classifier.h"
 #include "vnsw/agent/filter/acl_entry_spec.h"
 
 #include <boost/intrusive/list.hpp>
@@ -129,10 +130,14 @@ public:
 		     MatchAclParams &m_acl) const;
 private:
     friend class AclTable;
+    // Rebuild the classifier after the list of entries has changed
+    void CompileClassifier();
+
     uuid uuid_;
     bool dynamic_acl_;
     std::string name_;
     AclEntries acl_entries_;
+    AclClassifier classifier_;
     DISALLOW_COPY_AND_ASSIGN(AclDBEntry);
 };
 
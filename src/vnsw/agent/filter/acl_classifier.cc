@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "vnsw/agent/filter/acl_classifier.h"
+
+#include <algorithm>
+
+#include "vnsw/agent/filter/acl_entry.h"
+#include "vnsw/agent/filter/packet_header.h"
+
+AclClassifierRule::Address::Address()
+    : type(AddressMatch::UNKNOWN_TYPE), never(false), ip(0), mask(0),
+      sg_id(0) {
+}
+
+AclClassifierRule::AclClassifierRule()
+    : match_protocol(false), match_src_port(false), match_dst_port(false) {
+}
+
+//
+// Split the value space into the elementary intervals delimited by the
+// bounds of all the ranges and record, for each interval, the rules that
+// accept the values in it. Rules without a match on the field accept all
+// the intervals.
+//
+void AclClassifier::RangeTable::Compile(
+        const std::vector<AclClassifierRule> &rules,
+        bool AclClassifierRule::*match,
+        AclClassifierRule::RangeList AclClassifierRule::*ranges) {
+    Clear();
+    bounds_.push_back(0);
+    for (std::vector<AclClassifierRule>::const_iterator it = rules.begin();
+         it != rules.end(); ++it) {
+        if (!((*it).*match))
+            continue;
+        const AclClassifierRule::RangeList &list = (*it).*ranges;
+        for (AclClassifierRule::RangeList::const_iterator rit = list.begin();
+             rit != list.end(); ++rit) {
+            if (rit->first > rit->second)
+                continue;
+            bounds_.push_back(rit->first);
+            bounds_.push_back(rit->second + 1);
+        }
+    }
+    std::sort(bounds_.begin(), bounds_.end());
+    bounds_.erase(std::unique(bounds_.begin(), bounds_.end()), bounds_.end());
+    sets_.resize(bounds_.size());
+
+    for (size_t idx = 0; idx < rules.size(); ++idx) {
+        const AclClassifierRule &rule = rules[idx];
+        if (!(rule.*match)) {
+            for (size_t pos = 0; pos < sets_.size(); ++pos) {
+                sets_[pos].set(idx);
+            }
+            continue;
+        }
+        const AclClassifierRule::RangeList &list = rule.*ranges;
+        for (AclClassifierRule::RangeList::const_iterator rit = list.begin();
+             rit != list.end(); ++rit) {
+            std::vector<uint32_t>::const_iterator bit =
+                std::lower_bound(bounds_.begin(), bounds_.end(), rit->first);
+            for (; bit != bounds_.end() && *bit <= rit->second; ++bit) {
+                sets_[bit - bounds_.begin()].set(idx);
+            }
+        }
+    }
+}
+
+const BitSet &AclClassifier::RangeTable::Lookup(uint16_t value) const {
+    std::vector<uint32_t>::const_iterator it =
+        std::upper_bound(bounds_.begin(), bounds_.end(), value);
+    return sets_[it - bounds_.begin() - 1];
+}
+
+void AclClassifier::RangeTable::Clear() {
+    bounds_.clear();
+    sets_.clear();
+}
+
+//
+// Mirrors AddressMatch::Match. A network id of "any" and a missing address
+// match both accept all packets.
+//
+void AclClassifier::AddressTable::Compile(
+        const std::vector<AclClassifierRule> &rules,
+        AclClassifierRule::Address AclClassifierRule::*address) {
+    Clear();
+    for (size_t idx = 0; idx < rules.size(); ++idx) {
+        const AclClassifierRule::Address &addr = rules[idx].*address;
+        if (addr.never)
+            continue;
+        switch (addr.type) {
+        case AddressMatch::IP_ADDR:
+            if ((addr.ip & ~addr.mask) == 0)
+                ip_[addr.mask][addr.ip].set(idx);
+            break;
+        case AddressMatch::NETWORK_ID:
+            policy_id_[addr.policy_id].set(idx);
+            break;
+        case AddressMatch::SG:
+            if (addr.sg_id == AddressMatch::kAny) {
+                any_sg_.set(idx);
+            } else {
+                sg_[addr.sg_id].set(idx);
+            }
+            break;
+        default:
+            any_.set(idx);
+            break;
+        }
+    }
+}
+
+void AclClassifier::AddressTable::Lookup(uint32_t ip,
+        const std::string *policy_id, const SecurityGroupList *sg_list,
+        BitSet *result) const {
+    *result = any_;
+    for (MaskMap::const_iterator it = ip_.begin(); it != ip_.end(); ++it) {
+        IpMap::const_iterator ip_it = it->second.find(ip & it->first);
+        if (ip_it != it->second.end())
+            result->Set(ip_it->second);
+    }
+
+    // Only look at the policy id and the security group list if there are
+    // entries that use them; callers don't always fill them in otherwise.
+    if (!policy_id_.empty() && policy_id) {
+        PolicyIdMap::const_iterator it = policy_id_.find(*policy_id);
+        if (it != policy_id_.end())
+            result->Set(it->second);
+    }
+    if ((any_sg_.any() || !sg_.empty()) && sg_list) {
+        result->Set(any_sg_);
+        for (SecurityGroupList::const_iterator it = sg_list->begin();
+             it != sg_list->end(); ++it) {
+            SgMap::const_iterator sg_it = sg_.find(*it);
+            if (sg_it != sg_.end())
+                result->Set(sg_it->second);
+        }
+    }
+}
+
+void AclClassifier::AddressTable::Clear() {
+    any_.clear();
+    ip_.clear();
+    policy_id_.clear();
+    sg_.clear();
+    any_sg_.clear();
+}
+
+AclClassifier::AclClassifier() {
+}
+
+AclClassifier::~AclClassifier() {
+}
+
+void AclClassifier::AddEntry(const AclEntry *entry) {
+    AclClassifierRule rule;
+    entry->SetClassifierRule(&rule);
+    entries_.push_back(entry);
+    rules_.push_back(rule);
+}
+
+void AclClassifier::Compile() {
+    protocol_.Compile(rules_, &AclClassifierRule::match_protocol,
+                      &AclClassifierRule::protocol);
+    src_port_.Compile(rules_, &AclClassifierRule::match_src_port,
+                      &AclClassifierRule::src_port);
+    dst_port_.Compile(rules_, &AclClassifierRule::match_dst_port,
+                      &AclClassifierRule::dst_port);
+    src_addr_.Compile(rules_, &AclClassifierRule::src);
+    dst_addr_.Compile(rules_, &AclClassifierRule::dst);
+}
+
+void AclClassifier::Clear() {
+    entries_.clear();
+    rules_.clear();
+    Compile();
+}
+
+void AclClassifier::Match(const PacketHeader &packet_header,
+                          BitSet *result) const {
+    result->clear();
+    if (entries_.empty())
+        return;
+
+    result->BuildIntersection(protocol_.Lookup(packet_header.protocol),
+                              dst_port_.Lookup(packet_header.dst_port));
+    if (result->none())
+        return;
+    *result &= src_port_.Lookup(packet_header.src_port);
+    if (result->none())
+        return;
+
+    BitSet addr;
+    src_addr_.Lookup(packet_header.src_ip, packet_header.src_policy_id,
+                     packet_header.src_sg_id_l, &addr);
+    *result &= addr;
+    if (result->none())
+        return;
+    dst_addr_.Lookup(packet_header.dst_ip, packet_header.dst_policy_id,
+                     packet_header.dst_sg_id_l, &addr);
+    *result &= addr;
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __AGENT_ACL_CLASSIFIER_H__
+#define __AGENT_ACL_CLASSIFIER_H__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/bitset.h"
+#include "vnsw/agent/cmn/agent_cmn.h"
+
+class AclEntry;
+struct PacketHeader;
+
+//
+// Match fields of an AclEntry, as filled in by the AclEntryMatch objects.
+// A field without a match is a wildcard.
+//
+struct AclClassifierRule {
+    typedef std::pair<uint16_t, uint16_t> Bounds;
+    typedef std::vector<Bounds> RangeList;
+
+    struct Address {
+        Address();
+
+        int type;
+        bool never;
+        uint32_t ip;
+        uint32_t mask;
+        std::string policy_id;
+        int sg_id;
+    };
+
+    AclClassifierRule();
+
+    Address src;
+    Address dst;
+    bool match_protocol;
+    RangeList protocol;
+    bool match_src_port;
+    RangeList src_port;
+    bool match_dst_port;
+    RangeList dst_port;
+};
+
+//
+// AclClassifier
+// Bit vector classifier over the entries of an ACL. Every field of the
+// packet header is looked up in its own table, which yields the set of
+// entries that accept the value of that field. The entries that match the
+// packet are the intersection of those sets.
+//
+// Entries are numbered in the order they are added, which is the order in
+// which they are evaluated, so walking the result from the lowest bit gives
+// the same sequence of matches as walking the ACL entry by entry.
+//
+// Port and protocol tables are split into the elementary intervals formed
+// by the bounds of all ranges. Addresses are looked up per distinct mask,
+// virtual network and security group, so the cost of a match depends on the
+// number of distinct values in the ACL rather than on the number of entries.
+//
+class AclClassifier {
+public:
+    AclClassifier();
+    ~AclClassifier();
+
+    void AddEntry(const AclEntry *entry);
+    void Compile();
+    void Clear();
+
+    void Match(const PacketHeader &packet_header, BitSet *result) const;
+
+    const AclEntry *entry(size_t index) const { return entries_[index]; }
+    size_t size() const { return entries_.size(); }
+
+private:
+    class RangeTable {
+    public:
+        void Compile(const std::vector<AclClassifierRule> &rules,
+                     bool AclClassifierRule::*match,
+                     AclClassifierRule::RangeList AclClassifierRule::*ranges);
+        const BitSet &Lookup(uint16_t value) const;
+        void Clear();
+
+    private:
+        std::vector<uint32_t> bounds_;
+        std::vector<BitSet> sets_;
+    };
+
+    class AddressTable {
+    public:
+        void Compile(const std::vector<AclClassifierRule> &rules,
+                     AclClassifierRule::Address AclClassifierRule::*address);
+        void Lookup(uint32_t ip, const std::string *policy_id,
+                    const SecurityGroupList *sg_list, BitSet *result) const;
+        void Clear();
+
+    private:
+        typedef std::map<uint32_t, BitSet> IpMap;
+        typedef std::map<uint32_t, IpMap> MaskMap;
+        typedef std::map<std::string, BitSet> PolicyIdMap;
+        typedef std::map<int, BitSet> SgMap;
+
+        BitSet any_;
+        MaskMap ip_;
+        PolicyIdMap policy_id_;
+        SgMap sg_;
+        BitSet any_sg_;
+    };
+
+    std::vector<const AclEntry *> entries_;
+    std::vector<AclClassifierRule> rules_;
+    RangeTable protocol_;
+    RangeTable src_port_;
+    RangeTable dst_port_;
+    AddressTable src_addr_;
+    AddressTable dst_addr_;
+
+    DISALLOW_COPY_AND_ASSIGN(AclClassifier);
+};
+
+#endif
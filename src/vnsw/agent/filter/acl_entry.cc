@@ -4,6 +4,7 @@
 
 #include <vector>
 #include "vnsw/agent/filter/acl_entry.h"
+#include "vnsw/agent/filter/acl_classifier.h"
 #include "vnsw/agent/filter/acl_entry_spec.h"
 #include "vnsw/agent/filter/packet_header.h"
 #include "vnsw/agent/oper/mirror_table.h"
@@ -168,6 +169,13 @@ void AclEntry::SetAclEntrySandeshData(AclEntrySandeshData &data) const {
     data.ace_id = integerToString(id_);
 }
 
+void AclEntry::SetClassifierRule(AclClassifierRule *rule) const {
+    std::vector<AclEntryMatch *>::const_iterator it;
+    for (it = matches_.begin(); it != matches_.end(); it++) {
+        (*it)->SetClassifierRule(rule);
+    }
+}
+
 bool AclEntry::IsTerminal() const
 {
     if (type_ == TERMINAL) {
@@ -310,6 +318,30 @@ void AddressMatch::SetAclEntryMatchSandeshData(AclEntrySandeshData &data)
 
 }
 
+void AddressMatch::SetClassifierRule(AclClassifierRule *rule) const
+{
+    AclClassifierRule::Address *addr = src_ ? &rule->src : &rule->dst;
+
+    if (policy_id_s_.compare("any") == 0) {
+        return;
+    }
+    addr->type = addr_type_;
+    if (addr_type_ == IP_ADDR) {
+        if (ip_addr_.is_v4()) {
+            addr->ip = ip_addr_.to_v4().to_ulong();
+            addr->mask = ip_mask_.to_v4().to_ulong();
+        } else {
+            addr->never = true;
+        }
+    } else if (addr_type_ == NETWORK_ID) {
+        addr->policy_id = policy_id_s_;
+    } else if (addr_type_ == SG) {
+        addr->sg_id = sg_id_;
+    } else {
+        addr->never = true;
+    }
+}
+
 void ProtocolMatch::SetProtocolRange(const uint16_t min_protocol, 
                                      const uint16_t max_protocol)
 {
@@ -343,6 +375,15 @@ void ProtocolMatch::SetAclEntryMatchSandeshData(AclEntrySandeshData &data)
 }
 
 
+void ProtocolMatch::SetClassifierRule(AclClassifierRule *rule) const
+{
+    rule->match_protocol = true;
+    for (RangeSList::const_iterator it = protocol_ranges_.begin(); 
+         it != protocol_ranges_.end(); it++) {
+        rule->protocol.push_back(std::make_pair((*it).min, (*it).max));
+    }
+}
+
 void PortMatch::SetPortRange(const uint16_t min_port, const uint16_t max_port)
 {
     Range *port_range = new Range(min_port, max_port);
@@ -375,6 +416,15 @@ void SrcPortMatch::SetAclEntryMatchSandeshData(AclEntrySandeshData &data)
 }
 
 
+void SrcPortMatch::SetClassifierRule(AclClassifierRule *rule) const
+{
+    rule->match_src_port = true;
+    for (RangeSList::const_iterator it = port_ranges_.begin(); 
+         it != port_ranges_.end(); it++) {
+        rule->src_port.push_back(std::make_pair((*it).min, (*it).max));
+    }
+}
+
 bool DstPortMatch::Match(const PacketHeader *packet_header) const
 {
     for (RangeSList::const_iterator it = port_ranges_.begin(); 
@@ -399,3 +449,12 @@ void DstPortMatch::SetAclEntryMatchSandeshData(AclEntrySandeshData &data)
         data.dst_port_l.push_back(port);
     }
 }
+
+void DstPortMatch::SetClassifierRule(AclClassifierRule *rule) const
+{
+    rule->match_dst_port = true;
+    for (RangeSList::const_iterator it = port_ranges_.begin(); 
+         it != port_ranges_.end(); it++) {
+        rule->dst_port.push_back(std::make_pair((*it).min, (*it).max));
+    }
+}
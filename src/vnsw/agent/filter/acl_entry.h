@@ -17,6 +17,7 @@
 
 struct PacketHeader;
 struct AclEntrySpec;
+struct AclClassifierRule;
 typedef std::vector<int32_t> AclEntryIDList;
 
 class AclEntryMatch {
@@ -24,6 +25,7 @@ public:
     virtual ~AclEntryMatch() { };
     virtual bool Match(const PacketHeader *packet_header) const = 0;
     virtual void SetAclEntryMatchSandeshData(AclEntrySandeshData &data) = 0;
+    virtual void SetClassifierRule(AclClassifierRule *rule) const = 0;
 };
 
 struct Range {
@@ -56,6 +58,7 @@ public:
     void SetPortRange(const uint16_t min_port, const uint16_t max_port);
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data) = 0;
     virtual bool Match(const PacketHeader *packet_header) const = 0;
+    virtual void SetClassifierRule(AclClassifierRule *rule) const = 0;
 protected:
     RangeSList port_ranges_;
 };
@@ -64,11 +67,13 @@ class SrcPortMatch : public PortMatch {
 public:
     bool Match(const PacketHeader *packet_header) const;
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data);
+    void SetClassifierRule(AclClassifierRule *rule) const;
 };
 class DstPortMatch : public PortMatch {
 public:
     bool Match(const PacketHeader *packet_header) const;
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data);
+    void SetClassifierRule(AclClassifierRule *rule) const;
 };
 
 class ProtocolMatch : public AclEntryMatch {
@@ -78,6 +83,7 @@ public:
     void SetProtocolRange(const uint16_t min, const uint16_t max);
     bool Match(const PacketHeader *packet_header) const;
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data);
+    void SetClassifierRule(AclClassifierRule *rule) const;
 private:
     RangeSList protocol_ranges_;
 };
@@ -109,6 +115,7 @@ public:
     // Match packet header for address
     bool Match(const PacketHeader *packet_header) const;
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data);
+    void SetClassifierRule(AclClassifierRule *rule) const;
 private:
     AddressType addr_type_;
     bool src_;
@@ -154,6 +161,8 @@ public:
     const ActionList &Actions() const {return actions_;};
 
     void SetAclEntrySandeshData(AclEntrySandeshData &data) const;
+    // Fill in the match fields used by AclClassifier
+    void SetClassifierRule(AclClassifierRule *rule) const;
 
     bool IsTerminal() const;
 
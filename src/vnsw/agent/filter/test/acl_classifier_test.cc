@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdlib.h>
+
+#include "base/logging.h"
+#include "base/util.h"
+#include "testing/gunit.h"
+
+#include "vnsw/agent/filter/acl.h"
+#include "vnsw/agent/filter/acl_entry.h"
+#include "vnsw/agent/filter/acl_entry_spec.h"
+#include "vnsw/agent/filter/packet_header.h"
+#include "vnsw/agent/filter/traffic_action.h"
+
+#include "net/address.h"
+
+void RouterIdDepInit() {
+}
+
+namespace {
+
+static const char *kNetworks[] = {
+    "default-domain:demo:vn1",
+    "default-domain:demo:vn2",
+    "default-domain:demo:vn3",
+    "default-domain:demo:vn4",
+};
+
+class AclClassifierTest : public ::testing::Test {
+protected:
+    AclClassifierTest() : acl_(boost::uuids::nil_uuid()) {
+        srand(1);
+    }
+
+    virtual void TearDown() {
+        acl_.DeleteAllAclEntries();
+        for (std::vector<AclEntry *>::iterator it = entries_.begin();
+             it != entries_.end(); ++it) {
+            delete *it;
+        }
+        entries_.clear();
+    }
+
+    static RangeSpec MakeRange(uint16_t min, uint16_t max) {
+        RangeSpec range;
+        range.min = min;
+        range.max = max;
+        return range;
+    }
+
+    static void AddAction(AclEntrySpec *spec, TrafficAction::Action action) {
+        ActionSpec action_spec;
+        action_spec.ta_type = TrafficAction::SIMPLE_ACTION;
+        action_spec.simple_action = action;
+        spec->action_l.push_back(action_spec);
+    }
+
+    // Add the entry to the ACL and keep a copy for the linear walk.
+    void AddEntry(const AclEntrySpec &spec) {
+        AclDBEntry::AclEntries entries;
+        acl_.AddAclEntry(spec, entries);
+        acl_.SetAclEntries(entries);
+        AclEntry *entry = new AclEntry();
+        entry->PopulateAclEntry(spec);
+        entries_.push_back(entry);
+    }
+
+    void SetEntries(const std::vector<AclEntrySpec> &specs) {
+        AclDBEntry::AclEntries entries;
+        for (std::vector<AclEntrySpec>::const_iterator it = specs.begin();
+             it != specs.end(); ++it) {
+            acl_.AddAclEntry(*it, entries);
+            AclEntry *entry = new AclEntry();
+            entry->PopulateAclEntry(*it);
+            entries_.push_back(entry);
+        }
+        acl_.SetAclEntries(entries);
+    }
+
+    void RandomAddress(AclEntrySpec *spec, bool src) {
+        AddressMatch::AddressType *type =
+            src ? &spec->src_addr_type : &spec->dst_addr_type;
+        switch (rand() % 5) {
+        case 0:
+            *type = AddressMatch::UNKNOWN_TYPE;
+            break;
+        case 1: {
+            *type = AddressMatch::IP_ADDR;
+            int plen = 8 + (rand() % 4) * 8;
+            uint32_t mask = ~((1ULL << (32 - plen)) - 1);
+            uint32_t ip = (0x0a000000 | (rand() & 0x00ffffff)) & mask;
+            (src ? spec->src_ip_addr : spec->dst_ip_addr) = Ip4Address(ip);
+            (src ? spec->src_ip_mask : spec->dst_ip_mask) = Ip4Address(mask);
+            break;
+        }
+        case 2: {
+            *type = AddressMatch::NETWORK_ID;
+            int idx = rand() % 5;
+            (src ? spec->src_policy_id_str : spec->dst_policy_id_str) =
+                (idx == 4 ? "any" : kNetworks[idx]);
+            break;
+        }
+        default:
+            *type = AddressMatch::SG;
+            (src ? spec->src_sg_id : spec->dst_sg_id) =
+                (rand() % 8 == 0) ? AddressMatch::kAny : 1 + rand() % 16;
+            break;
+        }
+    }
+
+    AclEntrySpec RandomSpec(uint32_t id) {
+        AclEntrySpec spec;
+        spec.id = id;
+        RandomAddress(&spec, true);
+        RandomAddress(&spec, false);
+        if (rand() % 4) {
+            spec.protocol.push_back(MakeRange(6, 6));
+            if (rand() % 2)
+                spec.protocol.push_back(MakeRange(17, 17));
+        }
+        if (rand() % 2) {
+            uint16_t port = 1 + rand() % 1024;
+            spec.dst_port.push_back(MakeRange(port, port + rand() % 64));
+        }
+        if (rand() % 4 == 0) {
+            uint16_t port = 1024 + rand() % 1024;
+            spec.src_port.push_back(MakeRange(port, 65535));
+        }
+        static const TrafficAction::Action kActions[] = {
+            TrafficAction::PASS, TrafficAction::DENY, TrafficAction::LOG,
+        };
+        AddAction(&spec, kActions[rand() % 3]);
+        spec.terminal = (rand() % 4 != 0);
+        return spec;
+    }
+
+    void RandomPacket(PacketHeader *packet) {
+        packet->src_ip = 0x0a000000 | (rand() & 0x00ffffff);
+        packet->dst_ip = 0x0a000000 | (rand() & 0x00ffffff);
+        packet->src_policy_id = &networks_[rand() % 4];
+        packet->dst_policy_id = &networks_[rand() % 4];
+        packet->src_sg_id_l = &sg_lists_[rand() % 4];
+        packet->dst_sg_id_l = &sg_lists_[rand() % 4];
+        packet->protocol = (rand() % 2) ? 6 : 17;
+        packet->src_port = rand() % 65536;
+        packet->dst_port = 1 + rand() % 1100;
+    }
+
+    void SetUpPacketData() {
+        for (int idx = 0; idx < 4; ++idx) {
+            networks_.push_back(kNetworks[idx]);
+        }
+        sg_lists_.resize(4);
+        sg_lists_[1].push_back(1 + rand() % 16);
+        sg_lists_[2].push_back(1 + rand() % 16);
+        sg_lists_[2].push_back(1 + rand() % 16);
+        sg_lists_[3].push_back(1 + rand() % 16);
+        sg_lists_[3].push_back(1 + rand() % 16);
+        sg_lists_[3].push_back(1 + rand() % 16);
+    }
+
+    // The ACL walk that AclDBEntry::PacketMatch used before the classifier.
+    bool LinearMatch(const PacketHeader &packet, MatchAclParams *m_acl) {
+        bool ret_val = false;
+        m_acl->terminal_rule = false;
+        m_acl->action_info.action = 0;
+        for (std::vector<AclEntry *>::iterator it = entries_.begin();
+             it != entries_.end(); ++it) {
+            const AclEntry::ActionList &al = (*it)->PacketMatch(packet);
+            for (AclEntry::ActionList::const_iterator al_it = al.begin();
+                 al_it != al.end(); ++al_it) {
+                m_acl->action_info.action |= 1 << (*al_it)->GetAction();
+            }
+            if (!al.empty()) {
+                ret_val = true;
+                m_acl->ace_id_list.push_back((*it)->id());
+                if ((*it)->IsTerminal()) {
+                    m_acl->terminal_rule = true;
+                    break;
+                }
+            }
+        }
+        return ret_val;
+    }
+
+    void VerifyMatch(const PacketHeader &packet) {
+        MatchAclParams expected, result;
+        bool expected_ret = LinearMatch(packet, &expected);
+        bool ret = acl_.PacketMatch(packet, result);
+        EXPECT_EQ(expected_ret, ret);
+        EXPECT_EQ(expected.terminal_rule, result.terminal_rule);
+        EXPECT_EQ(expected.action_info.action, result.action_info.action);
+        EXPECT_TRUE(expected.ace_id_list == result.ace_id_list);
+    }
+
+    AclDBEntry acl_;
+    std::vector<AclEntry *> entries_;
+    std::vector<std::string> networks_;
+    std::vector<SecurityGroupList> sg_lists_;
+};
+
+TEST_F(AclClassifierTest, Basic) {
+    AclEntrySpec spec1;
+    spec1.id = 10;
+    spec1.src_addr_type = AddressMatch::IP_ADDR;
+    spec1.src_ip_addr = IpAddress::from_string("1.1.1.0");
+    spec1.src_ip_mask = IpAddress::from_string("255.255.255.0");
+    spec1.protocol.push_back(MakeRange(6, 6));
+    spec1.dst_port.push_back(MakeRange(80, 80));
+    spec1.terminal = false;
+    AddAction(&spec1, TrafficAction::LOG);
+    AddEntry(spec1);
+
+    AclEntrySpec spec2;
+    spec2.id = 20;
+    spec2.dst_addr_type = AddressMatch::NETWORK_ID;
+    spec2.dst_policy_id_str = "vn2";
+    AddAction(&spec2, TrafficAction::PASS);
+    AddEntry(spec2);
+
+    AclEntrySpec spec3;
+    spec3.id = 30;
+    AddAction(&spec3, TrafficAction::DENY);
+    AddEntry(spec3);
+
+    std::string vn1("vn1"), vn2("vn2");
+    PacketHeader packet;
+    packet.src_ip = 0x01010102;
+    packet.dst_ip = 0x02020202;
+    packet.src_policy_id = &vn1;
+    packet.dst_policy_id = &vn2;
+    packet.src_sg_id_l = NULL;
+    packet.dst_sg_id_l = NULL;
+    packet.protocol = 6;
+    packet.dst_port = 80;
+
+    // Non-terminal entry followed by a terminal one.
+    MatchAclParams m_acl;
+    EXPECT_TRUE(acl_.PacketMatch(packet, m_acl));
+    EXPECT_TRUE(m_acl.terminal_rule);
+    EXPECT_EQ((uint32_t) (1 << TrafficAction::LOG | 1 << TrafficAction::PASS),
+              m_acl.action_info.action);
+    ASSERT_EQ(2U, m_acl.ace_id_list.size());
+    EXPECT_EQ(10, m_acl.ace_id_list[0]);
+    EXPECT_EQ(20, m_acl.ace_id_list[1]);
+
+    // Falls through to the catch all entry.
+    packet.dst_policy_id = &vn1;
+    packet.dst_port = 81;
+    MatchAclParams m_acl2;
+    EXPECT_TRUE(acl_.PacketMatch(packet, m_acl2));
+    EXPECT_EQ((uint32_t) (1 << TrafficAction::DENY),
+              m_acl2.action_info.action);
+    ASSERT_EQ(1U, m_acl2.ace_id_list.size());
+    EXPECT_EQ(30, m_acl2.ace_id_list[0]);
+
+    // Deleting entries recompiles the classifier.
+    EXPECT_TRUE(acl_.DeleteAclEntry(30));
+    MatchAclParams m_acl3;
+    EXPECT_FALSE(acl_.PacketMatch(packet, m_acl3));
+    EXPECT_TRUE(m_acl3.ace_id_list.empty());
+    EXPECT_FALSE(m_acl3.terminal_rule);
+    delete entries_.back();
+    entries_.pop_back();
+}
+
+TEST_F(AclClassifierTest, SecurityGroup) {
+    AclEntrySpec spec1;
+    spec1.id = 1;
+    spec1.src_addr_type = AddressMatch::SG;
+    spec1.src_sg_id = 5;
+    AddAction(&spec1, TrafficAction::PASS);
+    AddEntry(spec1);
+
+    AclEntrySpec spec2;
+    spec2.id = 2;
+    spec2.dst_addr_type = AddressMatch::SG;
+    spec2.dst_sg_id = AddressMatch::kAny;
+    AddAction(&spec2, TrafficAction::DENY);
+    AddEntry(spec2);
+
+    SecurityGroupList sg_list;
+    sg_list.push_back(4);
+    PacketHeader packet;
+    packet.src_sg_id_l = &sg_list;
+    packet.dst_sg_id_l = NULL;
+
+    MatchAclParams m_acl;
+    EXPECT_FALSE(acl_.PacketMatch(packet, m_acl));
+
+    sg_list.push_back(5);
+    MatchAclParams m_acl2;
+    EXPECT_TRUE(acl_.PacketMatch(packet, m_acl2));
+    ASSERT_EQ(1U, m_acl2.ace_id_list.size());
+    EXPECT_EQ(1, m_acl2.ace_id_list[0]);
+
+    sg_list.clear();
+    packet.dst_sg_id_l = &sg_list;
+    MatchAclParams m_acl3;
+    EXPECT_TRUE(acl_.PacketMatch(packet, m_acl3));
+    ASSERT_EQ(1U, m_acl3.ace_id_list.size());
+    EXPECT_EQ(2, m_acl3.ace_id_list[0]);
+}
+
+TEST_F(AclClassifierTest, Random) {
+    SetUpPacketData();
+    std::vector<AclEntrySpec> specs;
+    for (uint32_t id = 1; id <= 200; ++id) {
+        specs.push_back(RandomSpec(id));
+    }
+    SetEntries(specs);
+    EXPECT_EQ(200U, acl_.Size());
+
+    for (int idx = 0; idx < 5000; ++idx) {
+        PacketHeader packet;
+        RandomPacket(&packet);
+        VerifyMatch(packet);
+    }
+}
+
+//
+// Compare the classifier against the linear walk of the entries on a large
+// ACL. Most of the entries are non-terminal so that a packet is matched
+// against a good part of the list.
+//
+TEST_F(AclClassifierTest, Benchmark) {
+    static const uint32_t kEntries = 1000;
+    static const int kPackets = 20000;
+
+    SetUpPacketData();
+    std::vector<AclEntrySpec> specs;
+    for (uint32_t id = 1; id <= kEntries; ++id) {
+        AclEntrySpec spec = RandomSpec(id);
+        spec.terminal = (id == kEntries);
+        specs.push_back(spec);
+    }
+    SetEntries(specs);
+
+    std::vector<PacketHeader> packets(kPackets);
+    for (int idx = 0; idx < kPackets; ++idx) {
+        RandomPacket(&packets[idx]);
+    }
+
+    uint64_t start = UTCTimestampUsec();
+    size_t linear_matches = 0;
+    for (int idx = 0; idx < kPackets; ++idx) {
+        MatchAclParams m_acl;
+        LinearMatch(packets[idx], &m_acl);
+        linear_matches += m_acl.ace_id_list.size();
+    }
+    uint64_t linear_usec = UTCTimestampUsec() - start;
+
+    start = UTCTimestampUsec();
+    size_t classifier_matches = 0;
+    for (int idx = 0; idx < kPackets; ++idx) {
+        MatchAclParams m_acl;
+        acl_.PacketMatch(packets[idx], m_acl);
+        classifier_matches += m_acl.ace_id_list.size();
+    }
+    uint64_t classifier_usec = UTCTimestampUsec() - start;
+
+    EXPECT_EQ(linear_matches, classifier_matches);
+    LOG(DEBUG, "ACL with " << kEntries << " entries, " << kPackets <<
+        " packets, " << linear_matches << " matches: linear " <<
+        linear_usec << " usec, classifier " << classifier_usec << " usec");
+}
+
+} // namespace
+
+int main (int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
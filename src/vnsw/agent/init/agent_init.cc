@@ -369,6 +369,10 @@ void AgentInit::Init(AgentParam *param, Agent *agent,
     if (var_map.count("disable-packet")) {
         packet_enable_ = false;
     }
+
+    if (var_map.count("ksync-audit")) {
+        ksync_audit_ = true;
+    }
     params_ = param;
     agent_ = agent;
 }
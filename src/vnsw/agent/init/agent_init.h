@@ -26,7 +26,8 @@ public:
     AgentInit() :
         agent_(NULL), params_(NULL), create_vhost_(true), ksync_enable_(true),
         services_enable_(true), packet_enable_(true), uve_enable_(true),
-        vgw_enable_(true), router_id_dep_enable_(true), state_(CREATE_MODULES),
+        vgw_enable_(true), router_id_dep_enable_(true), ksync_audit_(false),
+        state_(CREATE_MODULES),
         trigger_list_(), vrf_trigger_(NULL), intf_trigger_(NULL),
         vrf_client_id_(-1), intf_client_id_(-1) { }
 
@@ -80,6 +81,7 @@ public:
     bool uve_enable() const { return uve_enable_; }
     bool vgw_enable() const { return vgw_enable_; }
     bool router_id_dep_enable() const { return router_id_dep_enable_; }
+    bool ksync_audit() const { return ksync_audit_; }
 
     void set_ksync_enable(bool flag) { ksync_enable_ = flag; }
     void set_services_enable(bool flag) { services_enable_ = flag; }
@@ -88,6 +90,7 @@ public:
     void set_uve_enable(bool flag) { uve_enable_ = flag; }
     void set_vgw_enable(bool flag) { vgw_enable_ = flag; }
     void set_router_id_dep_enable(bool flag) { router_id_dep_enable_ = flag; }
+    void set_ksync_audit(bool flag) { ksync_audit_ = flag; }
 private:
     void InitModules();
     void OnInterfaceCreate(DBEntryBase *entry);
@@ -108,6 +111,7 @@ private:
     bool uve_enable_;
     bool vgw_enable_;
     bool router_id_dep_enable_;
+    bool ksync_audit_;
     State state_;
 
     std::vector<TaskTrigger *> trigger_list_;
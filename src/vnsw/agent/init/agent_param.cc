@@ -402,6 +402,14 @@ void AgentParam::InitFromArguments
         }
     }
 
+    if (var_map.count("snapshot-file")) {
+        snapshot_file_ = var_map["snapshot-file"].as<string>();
+    }
+
+    if (var_map.count("snapshot-interval")) {
+        snapshot_interval_ = var_map["snapshot-interval"].as<int>();
+    }
+
     return;
 }
 
@@ -472,7 +480,8 @@ AgentParam::AgentParam() :
         log_category_(), collector_(), collector_port_(), http_server_port_(),
         host_name_(),
         agent_stats_interval_(AgentStatsCollector::AgentStatsInterval), 
-        flow_stats_interval_(FlowStatsCollector::FlowStatsInterval) {
+        flow_stats_interval_(FlowStatsCollector::FlowStatsInterval),
+        snapshot_file_(), snapshot_interval_(0) {
     vgw_config_ = std::auto_ptr<VirtualGatewayConfig>
         (new VirtualGatewayConfig());
 }
@@ -77,6 +77,8 @@ public:
     const std::string &host_name() const { return host_name_; }
     int agent_stats_interval() const { return agent_stats_interval_; }
     int flow_stats_interval() const { return flow_stats_interval_; }
+    const std::string &snapshot_file() const { return snapshot_file_; }
+    int snapshot_interval() const { return snapshot_interval_; }
     void set_agent_stats_interval(int val) { agent_stats_interval_ = val; }
     void set_flow_stats_interval(int val) { flow_stats_interval_ = val; }
     VirtualGatewayConfig *vgw_config() const { return vgw_config_.get(); }
@@ -124,6 +126,8 @@ private:
     std::string host_name_;
     int agent_stats_interval_;
     int flow_stats_interval_;
+    std::string snapshot_file_;
+    int snapshot_interval_;
 
     std::auto_ptr<VirtualGatewayConfig> vgw_config_;
 
@@ -76,17 +76,60 @@ std::string IntfKSyncEntry::ToString() const {
     return s.str();
 }
 
-int IntfKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
-    vr_interface_req encoder;
-    int encode_len, error;
+IntfKSyncEntry::IntfKSyncEntry(const vr_interface_req *req) :
+    KSyncNetlinkDBEntry(kInvalidIndex), ifname_(), type_(Interface::INVALID),
+    intf_id_(req->get_vifr_idx()), vrf_id_(req->get_vifr_vrf()),
+    fd_(kInvalidIndex), has_service_vlan_(false), mac_(),
+    ip_(req->get_vifr_ip()), policy_enabled_(false), analyzer_name_(),
+    mirror_direction_(Interface::UNKNOWN), active_(false),
+    os_index_(req->get_vifr_os_idx()), network_id_(0),
+    sub_type_(VirtualHostInterface::HOST), ipv4_forwarding_(false),
+    layer2_forwarding_(false), kernel_req_(new vr_interface_req(*req)) {
+    char name[IF_NAMESIZE + 1];
+    if (req->get_vifr_os_idx() >= 0 &&
+        if_indextoname(req->get_vifr_os_idx(), name)) {
+        ifname_ = name;
+    }
+}
 
-    // Dont send message if interface index not known
+bool IntfKSyncEntry::IsAuditMatch(const KSyncEntry &kernel) const {
+    const IntfKSyncEntry &entry = static_cast<const IntfKSyncEntry &>(kernel);
+    const vr_interface_req *kreq = entry.kernel_req_.get();
+    vr_interface_req req;
+
+    if (FillRequest(req) == false) {
+        return false;
+    }
+
+    if (req.get_vifr_type() != kreq->get_vifr_type() ||
+        req.get_vifr_flags() != kreq->get_vifr_flags() ||
+        req.get_vifr_vrf() != kreq->get_vifr_vrf() ||
+        req.get_vifr_os_idx() != kreq->get_vifr_os_idx() ||
+        req.get_vifr_ip() != kreq->get_vifr_ip() ||
+        req.get_vifr_mac() != kreq->get_vifr_mac()) {
+        return false;
+    }
+
+    if (req.get_vifr_flags() & (VIF_FLAG_MIRROR_RX | VIF_FLAG_MIRROR_TX)) {
+        return req.get_vifr_mir_id() == kreq->get_vifr_mir_id();
+    }
+    return true;
+}
+
+// vif in kernel for another OS interface is deleted before the ADD
+bool IntfKSyncEntry::IsAuditOverwrite(const KSyncEntry &kernel) const {
+    const IntfKSyncEntry &entry = static_cast<const IntfKSyncEntry &>(kernel);
+    return (os_index_ == Interface::kInvalidIndex ||
+            os_index_ == entry.os_index_);
+}
+
+// Returns false if interface index in OS is not known yet
+bool IntfKSyncEntry::FillRequest(vr_interface_req &encoder) const {
     if (os_index_ == Interface::kInvalidIndex) {
-        return 0;
+        return false;
     }
 
     uint32_t flags = 0;
-    encoder.set_h_op(op);
     switch (type_) {
     case Interface::VMPORT: {
         encoder.set_vifr_type(VIF_TYPE_VIRTUAL); 
@@ -100,7 +143,8 @@ int IntfKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
 
     case Interface::ETH: {
         encoder.set_vifr_type(VIF_TYPE_PHYSICAL); 
-        std::vector<int8_t> intf_mac(GetMac(), GetMac() + ETHER_ADDR_LEN);
+        std::vector<int8_t> intf_mac(mac_.ether_addr_octet,
+                                     mac_.ether_addr_octet + ETHER_ADDR_LEN);
         encoder.set_vifr_mac(intf_mac);
         flags |= VIF_FLAG_L3_ENABLED;
         break;
@@ -119,7 +163,8 @@ int IntfKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
             break;
 
         }
-        std::vector<int8_t> intf_mac(GetMac(), GetMac() + ETHER_ADDR_LEN);
+        std::vector<int8_t> intf_mac(mac_.ether_addr_octet,
+                                     mac_.ether_addr_octet + ETHER_ADDR_LEN);
         encoder.set_vifr_mac(intf_mac);
         flags |= VIF_FLAG_L3_ENABLED;
         break;
@@ -169,7 +214,25 @@ int IntfKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
     encoder.set_vifr_mtu(0);
     encoder.set_vifr_name(ifname_);
     encoder.set_vifr_ip(ip_);
+    return true;
+}
 
+int IntfKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
+    int encode_len, error;
+
+    // Interface read from kernel by audit is deleted with kernel data
+    if (kernel_req_.get()) {
+        kernel_req_->set_h_op(op);
+        return kernel_req_->WriteBinary((uint8_t *)buf, buf_len, &error);
+    }
+
+    vr_interface_req encoder;
+    // Dont send message if interface index not known
+    if (FillRequest(encoder) == false) {
+        return 0;
+    }
+
+    encoder.set_h_op(op);
     encode_len = encoder.WriteBinary((uint8_t *)buf, buf_len, &error);
     return encode_len;
 }
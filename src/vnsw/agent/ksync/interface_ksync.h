@@ -9,6 +9,7 @@
 
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <db/db_entry.h>
 #include <db/db_table.h>
@@ -71,6 +72,9 @@ public:
         }
     };
 
+    // Interface read from kernel for audit
+    IntfKSyncEntry(const vr_interface_req *req);
+
     virtual ~IntfKSyncEntry() {};
 
     virtual bool IsLess(const KSyncEntry &rhs) const {
@@ -78,6 +82,14 @@ public:
         return ifname_ < entry.ifname_;
     };
 
+    // Kernel knows the interface by vif index
+    virtual bool IsAuditLess(const KSyncEntry &rhs) const {
+        const IntfKSyncEntry &entry = static_cast<const IntfKSyncEntry &>(rhs);
+        return intf_id_ < entry.intf_id_;
+    };
+    virtual bool IsAuditMatch(const KSyncEntry &kernel) const;
+    virtual bool IsAuditOverwrite(const KSyncEntry &kernel) const;
+
     virtual std::string ToString() const;
 
     virtual int AddMsg(char *buf, int buf_len);
@@ -199,6 +211,7 @@ public:
 
 private:
     friend class IntfKSyncObject;
+    bool FillRequest(vr_interface_req &encoder) const;
     int Encode(sandesh_op::type op, char *buf, int buf_len);
     string ifname_;     // Key
     Interface::Type type_;
@@ -217,6 +230,8 @@ private:
     VirtualHostInterface::SubType sub_type_;
     bool ipv4_forwarding_;
     bool layer2_forwarding_;
+    // Kernel data for interfaces read by audit
+    boost::scoped_ptr<vr_interface_req> kernel_req_;
     DISALLOW_COPY_AND_ASSIGN(IntfKSyncEntry);
 };
 
@@ -22,6 +22,7 @@
 #include <ksync/ksync_entry.h>
 #include <ksync/ksync_object.h>
 #include <ksync/ksync_sock.h>
+#include <base/timer.h>
 
 #include "ksync_init.h"
 #include "ksync/interface_ksync.h"
@@ -40,6 +41,8 @@
 
 #define	VNSW_GENETLINK_FAMILY_NAME  "vnsw"
 
+Timer *KSync::audit_timer_;
+
 static int Encode(Sandesh &encoder, uint8_t *buf, int buf_len) {
     int len, error;
     len = encoder.WriteBinary(buf, buf_len, &error);
@@ -130,6 +133,204 @@ void KSync::ResetVRouter() {
     KSyncSock::Start();
 }
 
+// Sends a request to vrouter and processes the responses in the sandesh
+// context. Returns false if vrouter could not be reached
+static bool BlockingRequest(KSyncSock *sock, Sandesh &req) {
+    uint8_t msg[KSYNC_DEFAULT_MSG_SIZE];
+    int len = Encode(req, msg, KSYNC_DEFAULT_MSG_SIZE);
+    sock->BlockingSend((char *)msg, len);
+    return (sock->BlockingRecv() == 0);
+}
+
+// Deletes the flows, mirror and vxlan entries left in vrouter. These are
+// not audited and are removed the same way a vrouter reset removes them
+static void VRouterResetNoAudit(KSyncSandeshContext *ctxt, KSyncSock *sock) {
+    FlowTableKSyncObject *flow = FlowTableKSyncObject::GetKSyncObject();
+    for (uint32_t i = 0; i < flow->GetFlowTableSize(); i++) {
+        const vr_flow_entry *kflow = flow->GetKernelFlowEntry(i, false);
+        if (kflow == NULL) {
+            continue;
+        }
+        vr_flow_req req;
+        req.set_fr_op(flow_op::FLOW_SET);
+        req.set_fr_rid(0);
+        req.set_fr_index(i);
+        req.set_fr_flow_sip(kflow->fe_key.key_src_ip);
+        req.set_fr_flow_dip(kflow->fe_key.key_dest_ip);
+        req.set_fr_flow_proto(kflow->fe_key.key_proto);
+        req.set_fr_flow_sport(kflow->fe_key.key_src_port);
+        req.set_fr_flow_dport(kflow->fe_key.key_dst_port);
+        req.set_fr_flow_vrf(kflow->fe_key.key_vrf_id);
+        req.set_fr_flags(0);
+        BlockingRequest(sock, req);
+    }
+
+    ctxt->Reset();
+    ctxt->clear_dump_list();
+    do {
+        vr_mirror_req req;
+        req.set_h_op(sandesh_op::DUMP);
+        req.set_mirr_index(0);
+        req.set_mirr_marker(ctxt->GetContextMarker());
+        if (!BlockingRequest(sock, req)) {
+            LOG(ERROR, "Error getting mirror dump from VROUTER");
+            break;
+        }
+    } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+    std::vector<int> list = ctxt->dump_list();
+    for (std::vector<int>::iterator it = list.begin(); it != list.end(); ++it) {
+        vr_mirror_req req;
+        req.set_h_op(sandesh_op::DELETE);
+        req.set_mirr_index(*it);
+        BlockingRequest(sock, req);
+    }
+
+    ctxt->Reset();
+    ctxt->clear_dump_list();
+    do {
+        vr_vxlan_req req;
+        req.set_h_op(sandesh_op::DUMP);
+        req.set_vxlanr_vnid(ctxt->GetContextMarker());
+        if (!BlockingRequest(sock, req)) {
+            LOG(ERROR, "Error getting VxLan dump from VROUTER");
+            break;
+        }
+    } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+    list = ctxt->dump_list();
+    for (std::vector<int>::iterator it = list.begin(); it != list.end(); ++it) {
+        vr_vxlan_req req;
+        req.set_h_op(sandesh_op::DELETE);
+        req.set_vxlanr_vnid(*it);
+        BlockingRequest(sock, req);
+    }
+    ctxt->clear_dump_list();
+    ctxt->Reset();
+}
+
+// Used in place of ResetVRouter when the agent restarts over a running
+// vrouter. Interfaces, nexthops, MPLS labels, VRF-assign entries and IPv4
+// unicast routes in the kernel are read into the audit trees of their
+// KSync objects, so that entries re-added with the same contents are not
+// sent again and forwarding continues during the restart. Entries that are
+// not added back are deleted when the audit timer fires. Flows, mirror and
+// vxlan entries are not audited and are deleted here.
+void KSync::VRouterAudit() {
+    KSyncSandeshContext *ctxt = static_cast<KSyncSandeshContext *>
+                                (KSyncSock::GetAgentSandeshContext());
+    KSyncSock *sock = KSyncSock::Get(0);
+    ctxt->AuditClear();
+
+    VRouterResetNoAudit(ctxt, sock);
+
+    // Entries not read are overwritten when agent adds them
+    ctxt->Reset();
+    ctxt->set_audit(true);
+    do {
+        vr_interface_req req;
+        req.set_h_op(sandesh_op::DUMP);
+        req.set_vifr_idx(0);
+        req.set_vifr_marker(ctxt->GetContextMarker());
+        if (!BlockingRequest(sock, req)) {
+            LOG(ERROR, "Error getting interface dump from VROUTER");
+            break;
+        }
+    } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+    ctxt->set_audit(false);
+
+    ctxt->Reset();
+    do {
+        vr_nexthop_req req;
+        req.set_h_op(sandesh_op::DUMP);
+        req.set_nhr_id(0);
+        req.set_nhr_marker(ctxt->GetContextMarker());
+        if (!BlockingRequest(sock, req)) {
+            LOG(ERROR, "Error getting nexthop dump from VROUTER");
+            break;
+        }
+    } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+
+    ctxt->Reset();
+    do {
+        vr_mpls_req req;
+        req.set_h_op(sandesh_op::DUMP);
+        req.set_mr_label(0);
+        req.set_mr_marker(ctxt->GetContextMarker());
+        if (!BlockingRequest(sock, req)) {
+            LOG(ERROR, "Error getting MPLS dump from VROUTER");
+            break;
+        }
+    } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+
+    const std::vector<int> &vif_list = ctxt->audit_vif_list();
+    for (std::vector<int>::const_iterator it = vif_list.begin();
+         it != vif_list.end(); ++it) {
+        ctxt->Reset();
+        do {
+            vr_vrf_assign_req req;
+            req.set_h_op(sandesh_op::DUMP);
+            req.set_var_vif_index(*it);
+            if (ctxt->GetContextMarker() != -1) {
+                req.set_var_vlan_id(ctxt->GetContextMarker());
+            }
+            req.set_var_marker(ctxt->GetContextMarker());
+            if (!BlockingRequest(sock, req)) {
+                LOG(ERROR, "Error getting VRF assign dump from VROUTER");
+                break;
+            }
+        } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+    }
+
+    // vrouter dumps routes one VRF at a time
+    for (int vrf = 0; vrf <= ctxt->audit_vrf_max(); vrf++) {
+        ctxt->Reset();
+        do {
+            vr_route_req req;
+            req.set_h_op(sandesh_op::DUMP);
+            req.set_rtr_family(AF_INET);
+            req.set_rtr_vrf_id(vrf);
+            req.set_rtr_rid(0);
+            if (ctxt->GetRouteMarkerPlen() != -1) {
+                req.set_rtr_marker(ctxt->GetContextMarker());
+                req.set_rtr_marker_plen(ctxt->GetRouteMarkerPlen());
+            }
+            if (!BlockingRequest(sock, req)) {
+                LOG(ERROR, "Error getting route dump from VROUTER");
+                break;
+            }
+        } while (ctxt->GetResponseCode() & VR_MESSAGE_DUMP_INCOMPLETE);
+    }
+    ctxt->Reset();
+    ctxt->AuditClear();
+
+    LOG(DEBUG, "Audit of "
+        << IntfKSyncObject::GetKSyncObject()->audit_count() << " interfaces, "
+        << NHKSyncObject::GetKSyncObject()->audit_count() << " nexthops, "
+        << MplsKSyncObject::GetKSyncObject()->audit_count() << " labels, "
+        << VrfAssignKSyncObject::GetKSyncObject()->audit_count()
+        << " VRF assign entries and "
+        << VrfKSyncObject::GetKSyncObject()->route_audit_object()->audit_count()
+        << " routes in VROUTER");
+
+    assert(audit_timer_ == NULL);
+    audit_timer_ = TimerManager::CreateTimer
+        (*(Agent::GetInstance()->GetEventManager()->io_service()),
+         "KSync Audit Timer",
+         TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0);
+    audit_timer_->Start(kAuditTimeout, boost::bind(&KSync::AuditTimeout));
+    KSyncSock::Start();
+}
+
+// Stale entries are swept before the entries they refer to. Routes, labels
+// and VRF assign entries go first, then nexthops and lastly interfaces
+bool KSync::AuditTimeout() {
+    VrfKSyncObject::GetKSyncObject()->route_audit_object()->AuditSweep();
+    MplsKSyncObject::GetKSyncObject()->AuditSweep();
+    VrfAssignKSyncObject::GetKSyncObject()->AuditSweep();
+    NHKSyncObject::GetKSyncObject()->AuditSweep();
+    IntfKSyncObject::GetKSyncObject()->AuditSweep();
+    return false;
+}
+
 void KSync::VnswIfListenerInit() {
     EventManager *event_mgr;
 
@@ -187,6 +388,10 @@ void KSync::UpdateVhostMac() {
 }
 
 void KSync::Shutdown() {
+    if (audit_timer_) {
+        TimerManager::DeleteTimer(audit_timer_);
+        audit_timer_ = NULL;
+    }
     IntfKSyncObject::Shutdown();
     VrfKSyncObject::Shutdown();
     NHKSyncObject::Shutdown();
@@ -5,8 +5,13 @@
 #ifndef vnsw_agent_ksync_init_h
 #define vnsw_agent_ksync_init_h
 
+class Timer;
+
 class KSync {
 public:
+    // Stale vrouter entries are deleted if not added by agent in 3 minutes
+    static const int kAuditTimeout = 180000;
+
     KSync(Agent *agent) : agent_(agent) {}
     virtual ~KSync() {}
 
@@ -15,6 +20,7 @@ public:
     static void NetlinkInit();
     static void VRouterInterfaceSnapshot();
     static void ResetVRouter();
+    static void VRouterAudit();
     static void VnswIfListenerInit();
     static void CreateVhostIntf();
     static void Shutdown();
@@ -25,6 +31,9 @@ public:
     static void UpdateVhostMac();
 
 private:
+    static bool AuditTimeout();
+
+    static Timer *audit_timer_;
     Agent *agent_;
     DISALLOW_COPY_AND_ASSIGN(KSync);
 };
@@ -37,7 +37,13 @@ KSyncDBObject *MplsKSyncEntry::GetObject() {
 }
 
 MplsKSyncEntry::MplsKSyncEntry(const MplsLabel *mpls) :
-    KSyncNetlinkDBEntry(kInvalidIndex), label_(mpls->GetLabel()), nh_(NULL) {
+    KSyncNetlinkDBEntry(kInvalidIndex), label_(mpls->GetLabel()), nh_(NULL),
+    nh_index_(kInvalidIndex) {
+}
+
+MplsKSyncEntry::MplsKSyncEntry(const vr_mpls_req *req) :
+    KSyncNetlinkDBEntry(kInvalidIndex), label_(req->get_mr_label()),
+    nh_(NULL), nh_index_(req->get_mr_nhid()) {
 }
 
 bool MplsKSyncEntry::IsLess(const KSyncEntry &rhs) const {
@@ -46,13 +52,27 @@ bool MplsKSyncEntry::IsLess(const KSyncEntry &rhs) const {
     return label_ < entry.label_;
 }
 
+bool MplsKSyncEntry::IsAuditMatch(const KSyncEntry &kernel) const {
+    const MplsKSyncEntry &entry = static_cast<const MplsKSyncEntry &>(kernel);
+
+    return GetNHIndex() == entry.GetNHIndex();
+}
+
+uint32_t MplsKSyncEntry::GetNHIndex() const {
+    NHKSyncEntry *nh = GetNH();
+    if (nh) {
+        return nh->GetIndex();
+    }
+    return nh_index_;
+}
+
 std::string MplsKSyncEntry::ToString() const {
     std::stringstream s;
     NHKSyncEntry *nh = GetNH();
 
-    if (nh) {
+    if (nh || nh_index_ != kInvalidIndex) {
         s << "Mpls : " << label_ << " Index : " << GetIndex() << " NH : " 
-        << nh->GetIndex();
+        << GetNHIndex();
     } else {
         s << "Mpls : " << label_ << " Index : " << GetIndex() << " NH : <null>";
     }
@@ -82,19 +102,18 @@ bool MplsKSyncEntry::Sync(DBEntry *e) {
 int MplsKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
     vr_mpls_req encoder;
     int encode_len, error;
-    NHKSyncEntry *nh = GetNH();
 
     encoder.set_h_op(op);
     encoder.set_mr_label(label_);
     encoder.set_mr_rid(0);
-    encoder.set_mr_nhid(nh->GetIndex());
+    encoder.set_mr_nhid(GetNHIndex());
     encode_len = encoder.WriteBinary((uint8_t *)buf, buf_len, &error);
     return encode_len;
 }
 
 void MplsKSyncEntry::FillObjectLog(sandesh_op::type op, KSyncMplsInfo &info) {
     info.set_label(label_);
-    info.set_nh(GetNH()->GetIndex());
+    info.set_nh(GetNHIndex());
 
     if (op == sandesh_op::ADD) {
         info.set_operation("ADD/CHANGE");
@@ -15,17 +15,22 @@
 #include <ksync/ksync_object.h>
 #include "oper/nexthop.h"
 #include "oper/mpls.h"
+#include "vr_types.h"
 #include "ksync/agent_ksync_types.h"
 
 class MplsKSyncEntry : public KSyncNetlinkDBEntry {
 public:
     MplsKSyncEntry(const MplsKSyncEntry *entry, uint32_t index) : 
-        KSyncNetlinkDBEntry(index), label_(entry->label_), nh_(NULL) { };
+        KSyncNetlinkDBEntry(index), label_(entry->label_), nh_(NULL),
+        nh_index_(kInvalidIndex) { };
 
     MplsKSyncEntry(const MplsLabel *label);
+    // Label read from kernel for audit
+    MplsKSyncEntry(const vr_mpls_req *req);
     virtual ~MplsKSyncEntry() {};
 
     virtual bool IsLess(const KSyncEntry &rhs) const;
+    virtual bool IsAuditMatch(const KSyncEntry &kernel) const;
     virtual std::string ToString() const;
     virtual KSyncEntry *UnresolvedReference();
     virtual bool Sync(DBEntry *e);
@@ -38,11 +43,14 @@ public:
     NHKSyncEntry *GetNH() const {
         return static_cast<NHKSyncEntry *>(nh_.get());
     }
+    uint32_t GetNHIndex() const;
     void FillObjectLog(sandesh_op::type op, KSyncMplsInfo &info);
 private:
     int Encode(sandesh_op::type op, char *buf, int buf_len);
     uint32_t label_;
     KSyncEntryPtr nh_;
+    // NH index in kernel for labels read by audit
+    uint32_t nh_index_;
     DISALLOW_COPY_AND_ASSIGN(MplsKSyncEntry);
 };
 
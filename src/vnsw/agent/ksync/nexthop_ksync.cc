@@ -44,7 +44,7 @@ NHKSyncEntry::NHKSyncEntry(const NextHop *nh) :
     KSyncNetlinkDBEntry(kInvalidIndex), type_(nh->GetType()), vrf_id_(0),
     interface_(NULL), valid_(nh->IsValid()), policy_(nh->PolicyEnabled()),
     is_mcast_nh_(false), nh_(nh), vlan_tag_(0), is_layer2_(false),
-    tunnel_type_(TunnelType::INVALID)  {
+    tunnel_type_(TunnelType::INVALID), kernel_type_(0), kernel_family_(0)  {
 
     sip_.s_addr = 0;
     memset(&dmac_, 0, sizeof(dmac_));
@@ -142,6 +142,18 @@ NHKSyncEntry::NHKSyncEntry(const NextHop *nh) :
     }
 }
 
+NHKSyncEntry::NHKSyncEntry(const vr_nexthop_req *req) :
+    KSyncNetlinkDBEntry(req->get_nhr_id()), type_(NextHop::INVALID),
+    vrf_id_(req->get_nhr_vrf()), label_(0), interface_(NULL), valid_(false),
+    policy_(false), is_mcast_nh_(false), defer_(false), nh_(NULL),
+    vlan_tag_(0), is_local_ecmp_nh_(false), is_layer2_(false),
+    tunnel_type_(TunnelType::INVALID), kernel_type_(req->get_nhr_type()),
+    kernel_family_(req->get_nhr_family()) {
+    sip_.s_addr = 0;
+    dip_.s_addr = 0;
+    memset(&dmac_, 0, sizeof(dmac_));
+}
+
 bool NHKSyncEntry::IsLess(const KSyncEntry &rhs) const {
     const NHKSyncEntry &entry = static_cast<const NHKSyncEntry &>(rhs);
 
@@ -613,6 +625,13 @@ int NHKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
             encoder.set_nhr_label_list(sub_label_list);
             break;
         }
+        case NextHop::INVALID: {
+            // Nexthop read from kernel by audit. Only deleted
+            assert(op == sandesh_op::DELETE);
+            encoder.set_nhr_type(kernel_type_);
+            encoder.set_nhr_family(kernel_family_);
+            break;
+        }
         default:
             assert(0);
     }
@@ -32,13 +32,20 @@ public:
         nh_(entry->nh_), vlan_tag_(entry->vlan_tag_), 
         is_local_ecmp_nh_(entry->is_local_ecmp_nh_),
         is_layer2_(entry->is_layer2_),
-        comp_type_(entry->comp_type_), tunnel_type_(entry->tunnel_type_) {
+        comp_type_(entry->comp_type_), tunnel_type_(entry->tunnel_type_),
+        kernel_type_(0), kernel_family_(0) {
     };
 
     NHKSyncEntry(const NextHop *nh);
+    // Nexthop read from kernel for audit
+    NHKSyncEntry(const vr_nexthop_req *req);
     virtual ~NHKSyncEntry() {};
 
     virtual bool IsLess(const KSyncEntry &rhs) const;
+    // Nexthops are known to kernel by index
+    virtual bool IsAuditLess(const KSyncEntry &rhs) const {
+        return GetIndex() < rhs.GetIndex();
+    };
     virtual std::string ToString() const;
     virtual KSyncEntry *UnresolvedReference();
     virtual bool Sync(DBEntry *e);
@@ -97,6 +104,9 @@ private:
     bool is_layer2_;
     COMPOSITETYPE comp_type_;
     TunnelType tunnel_type_;
+    // Type and family in kernel for nexthops read by audit
+    uint8_t kernel_type_;
+    uint8_t kernel_family_;
     DISALLOW_COPY_AND_ASSIGN(NHKSyncEntry);
 };
 
@@ -34,17 +34,20 @@ void vr_route_req::Process(SandeshContext *context) {
     ioc->RouteMsgHandler(this);
 }
 
-KSyncDBObject *RouteKSyncEntry::GetObject() {
-    return static_cast<KSyncDBObject*>
-        (VrfKSyncObject::GetKSyncObject()->GetRouteKSyncObject(vrf_id_,
-                                                               rt_type_));
+KSyncObject *RouteKSyncEntry::GetObject() {
+    // Routes read from kernel by the audit are held by the audit object
+    if (nh_index_ != kInvalidIndex) {
+        return VrfKSyncObject::GetKSyncObject()->route_audit_object();
+    }
+    return VrfKSyncObject::GetKSyncObject()->GetRouteKSyncObject(vrf_id_,
+                                                                 rt_type_);
 }
 
 RouteKSyncEntry::RouteKSyncEntry(const RouteEntry *rt) :
     KSyncNetlinkDBEntry(kInvalidIndex),  
     vrf_id_(rt->GetVrfId()),
     nh_(NULL), label_(0), proxy_arp_(false), 
-    tunnel_type_(TunnelType::DefaultType())
+    tunnel_type_(TunnelType::DefaultType()), nh_index_(kInvalidIndex)
 {
     boost::system::error_code ec;
     switch (rt->GetTableType()) {
@@ -81,6 +84,23 @@ RouteKSyncEntry::RouteKSyncEntry(const RouteEntry *rt) :
     address_string_ = rt->GetAddressString();
 }
 
+RouteKSyncEntry::RouteKSyncEntry(const vr_route_req *req) :
+    KSyncNetlinkDBEntry(kInvalidIndex), rt_type_(RT_UCAST),
+    vrf_id_(req->get_rtr_vrf_id()),
+    addr_(Ip4Address((uint32_t)req->get_rtr_prefix())),
+    src_addr_(Ip4Address()), plen_(req->get_rtr_prefix_len()), nh_(NULL),
+    label_(0), proxy_arp_(false), tunnel_type_(TunnelType::DefaultType()),
+    nh_index_(req->get_rtr_nh_id()) {
+    memset(&mac_, 0, sizeof(mac_));
+    if (req->get_rtr_label_flags() & VR_RT_LABEL_VALID_FLAG) {
+        label_ = req->get_rtr_label();
+    }
+    if (req->get_rtr_label_flags() & VR_RT_HOSTED_FLAG) {
+        proxy_arp_ = true;
+    }
+    address_string_ = addr_.to_string();
+}
+
 RouteKSyncObject::~RouteKSyncObject() {
     UnregisterDb(GetDBTable());
     table_delete_ref_.Reset(NULL);
@@ -143,6 +163,29 @@ bool RouteKSyncEntry::IsLess(const KSyncEntry &rhs) const {
     return McIsLess(rhs);
 }
 
+bool RouteKSyncEntry::IsAuditMatch(const KSyncEntry &kernel) const {
+    const RouteKSyncEntry &entry = static_cast<const RouteKSyncEntry &>(kernel);
+    NHKSyncEntry *nh = GetNH();
+    uint32_t label = 0;
+
+    if (nh && nh->GetType() == NextHop::TUNNEL) {
+        label = label_;
+    }
+    return (GetNHIndex() == entry.GetNHIndex() && label == entry.label_ &&
+            proxy_arp_ == entry.proxy_arp_);
+}
+
+uint32_t RouteKSyncEntry::GetNHIndex() const {
+    NHKSyncEntry *nh = GetNH();
+    if (nh) {
+        return nh->GetIndex();
+    }
+    if (nh_index_ != kInvalidIndex) {
+        return nh_index_;
+    }
+    return NH_DISCARD_ID;
+}
+
 std::string RouteKSyncEntry::ToString() const {
     std::stringstream s;
     NHKSyncEntry *nh;
@@ -154,8 +197,8 @@ std::string RouteKSyncEntry::ToString() const {
     s << " Label : " << label_;
     s << " Tunnel Type: " << tunnel_type_;
 
-    if (nh) {
-        s << " NH : " << nh->GetIndex();
+    if (nh || nh_index_ != kInvalidIndex) {
+        s << " NH : " << GetNHIndex();
     } else {
         s << " NH : <NULL>";
     }
@@ -299,6 +342,10 @@ int RouteKSyncEntry::ChangeMsg(char *buf, int buf_len){
 int RouteKSyncEntry::DeleteMsg(char *buf, int buf_len) {
 
     RouteKSyncEntry key(this, KSyncEntry::kInvalidIndex);
+    // Routes read from kernel by the audit look for a covering route in
+    // the VRF added by agent, if any
+    KSyncObject *obj = VrfKSyncObject::GetKSyncObject()->
+        GetRouteKSyncObject(vrf_id_, rt_type_);
     KSyncEntry *found = NULL;
     RouteKSyncEntry *route = NULL;
     NHKSyncEntry *ksync_nh = NULL;
@@ -318,7 +365,10 @@ int RouteKSyncEntry::DeleteMsg(char *buf, int buf_len) {
 
         key.SetPLen(plen);
         key.SetIp(addr);
-        found = GetObject()->Find(&key);
+        found = NULL;
+        if (obj) {
+            found = obj->Find(&key);
+        }
         
         if (found) {
             route = static_cast<RouteKSyncEntry *>(found);
@@ -386,6 +436,10 @@ void RouteKSyncObject::Unregister() {
     }
 }
 
+KSyncObject *RouteKSyncObject::AuditObject() {
+    return VrfKSyncObject::GetKSyncObject()->route_audit_object();
+}
+
 void RouteKSyncObject::ManagedDelete() {
     marked_delete_ = true;
     Unregister();
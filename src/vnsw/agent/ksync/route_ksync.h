@@ -31,20 +31,23 @@ public:
         addr_(entry->addr_), src_addr_(entry->src_addr_), mac_(entry->mac_), 
         plen_(entry->plen_), nh_(entry->nh_), label_(entry->label_), 
         proxy_arp_(false), address_string_(entry->address_string_),
-        tunnel_type_(entry->tunnel_type_) {
+        tunnel_type_(entry->tunnel_type_), nh_index_(kInvalidIndex) {
     };
 
     RouteKSyncEntry(const RouteEntry *route);
+    // Unicast route read from kernel for audit
+    RouteKSyncEntry(const vr_route_req *req);
     virtual ~RouteKSyncEntry() { };
 
     virtual bool IsLess(const KSyncEntry &rhs) const;
+    virtual bool IsAuditMatch(const KSyncEntry &kernel) const;
     virtual std::string ToString() const;
     virtual KSyncEntry *UnresolvedReference();
     virtual bool Sync(DBEntry *e);
     virtual int AddMsg(char *buf, int buf_len);
     virtual int ChangeMsg(char *buf, int buf_len);
     virtual int DeleteMsg(char *buf, int buf_len);
-    KSyncDBObject *GetObject();
+    KSyncObject *GetObject();
     void SetPLen(uint32_t len) {
         plen_ = len;
     }
@@ -55,6 +58,7 @@ public:
     NHKSyncEntry* GetNH() const { 
         return static_cast<NHKSyncEntry *>(nh_.get());
     }
+    uint32_t GetNHIndex() const;
     void FillObjectLog(sandesh_op::type op, KSyncRouteInfo &info);
 private:
     int Encode(sandesh_op::type op, uint8_t replace_plen,
@@ -76,6 +80,8 @@ private:
     bool proxy_arp_;
     string address_string_;
     TunnelType::Type tunnel_type_;
+    // NH index in kernel for routes read by audit
+    uint32_t nh_index_;
     DISALLOW_COPY_AND_ASSIGN(RouteKSyncEntry);
 };
 
@@ -105,6 +111,7 @@ public:
     bool IsDeleteMarked() {return marked_delete_;};
     void Unregister();
     virtual void EmptyTable();
+    virtual KSyncObject *AuditObject();
 
 private:
     bool marked_delete_;
@@ -113,6 +120,23 @@ private:
     DISALLOW_COPY_AND_ASSIGN(RouteKSyncObject);
 };
 
+// Holds the routes read from kernel by the audit. Route objects are created
+// per VRF as the agent adds VRFs, so kernel routes of all VRFs are kept here
+// till the agent adds them again or the audit deletes them
+class RouteAuditKSyncObject : public KSyncObject {
+public:
+    RouteAuditKSyncObject() : KSyncObject() {};
+    virtual ~RouteAuditKSyncObject() {};
+
+    virtual KSyncEntry *Alloc(const KSyncEntry *entry, uint32_t index) {
+        assert(0);
+        return NULL;
+    };
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(RouteAuditKSyncObject);
+};
+
 class VrfKSyncObject {
 public:
     typedef std::map<uint32_t, RouteKSyncObject *> VrfRtObjectMap;
@@ -134,6 +158,7 @@ public:
     void DelFromVrfMap(RouteKSyncObject *);
     RouteKSyncObject *GetRouteKSyncObject(uint32_t vrf_id,
                                           unsigned int table_id);
+    KSyncObject *route_audit_object() { return &route_audit_object_; }
 
 private:
     static VrfKSyncObject *singleton_;
@@ -141,6 +166,7 @@ private:
     VrfRtObjectMap vrf_ucrt_object_map_;
     VrfRtObjectMap vrf_mcrt_object_map_;
     VrfRtObjectMap vrf_l2rt_object_map_;
+    RouteAuditKSyncObject route_audit_object_;
     DISALLOW_COPY_AND_ASSIGN(VrfKSyncObject);
 };
 
@@ -9,6 +9,10 @@
 #include <ksync/sandesh_ksync.h>
 #include <ksync/flowtable_ksync.h>
 #include <ksync/interface_ksync.h>
+#include <ksync/mpls_ksync.h>
+#include <ksync/nexthop_ksync.h>
+#include <ksync/route_ksync.h>
+#include <ksync/vrf_assign_ksync.h>
 #include <pkt/flowtable.h>
 #include <oper/mirror_table.h>
 
@@ -53,7 +57,9 @@ void KSyncSandeshContext::FlowMsgHandler(vr_flow_req *r) {
         key.src_port = ntohs(r->get_fr_flow_sport());
         key.dst_port = ntohs(r->get_fr_flow_dport());
         key.protocol = r->get_fr_flow_proto();
-        FlowEntry *entry = FlowTable::GetFlowTableObject()->Find(key);
+        // Flows deleted by the audit on restart are not in the flow table
+        FlowTable *table = FlowTable::GetFlowTableObject();
+        FlowEntry *entry = table ? table->Find(key) : NULL;
         in_addr src;
         in_addr dst;
         src.s_addr = r->get_fr_flow_sip();
@@ -104,7 +110,56 @@ void KSyncSandeshContext::FlowMsgHandler(vr_flow_req *r) {
     return;
 }
 
+void KSyncSandeshContext::AuditVrf(int vrf) {
+    if (vrf != VIF_VRF_INVALID && vrf > audit_vrf_max_) {
+        audit_vrf_max_ = vrf;
+    }
+}
+
 void KSyncSandeshContext::IfMsgHandler(vr_interface_req *r) {
     InterfaceKSnap::GetInstance()->KernelInterfaceData(r);
+    if (audit_) {
+        IntfKSyncObject::GetKSyncObject()->AuditAdd(new IntfKSyncEntry(r));
+        audit_vif_list_.push_back(r->get_vifr_idx());
+        AuditVrf(r->get_vifr_vrf());
+    }
     context_marker_ = r->get_vifr_idx();
 }
+
+void KSyncSandeshContext::NHMsgHandler(vr_nexthop_req *r) {
+    // Discard nexthop is added by agent at the same index on every start
+    if (r->get_nhr_id() != NH_DISCARD_ID) {
+        NHKSyncObject::GetKSyncObject()->AuditAdd(new NHKSyncEntry(r));
+    }
+    AuditVrf(r->get_nhr_vrf());
+    context_marker_ = r->get_nhr_id();
+}
+
+void KSyncSandeshContext::RouteMsgHandler(vr_route_req *r) {
+    VrfKSyncObject::GetKSyncObject()->route_audit_object()->AuditAdd
+        (new RouteKSyncEntry(r));
+    context_marker_ = r->get_rtr_prefix();
+    route_marker_plen_ = r->get_rtr_prefix_len();
+}
+
+void KSyncSandeshContext::VrfAssignMsgHandler(vr_vrf_assign_req *r) {
+    VrfAssignKSyncObject::GetKSyncObject()->AuditAdd
+        (new VrfAssignKSyncEntry(r));
+    AuditVrf(r->get_var_vif_vrf());
+    context_marker_ = r->get_var_vlan_id();
+}
+
+void KSyncSandeshContext::MirrorMsgHandler(vr_mirror_req *r) {
+    dump_list_.push_back(r->get_mirr_index());
+    context_marker_ = r->get_mirr_index();
+}
+
+void KSyncSandeshContext::VxLanMsgHandler(vr_vxlan_req *r) {
+    dump_list_.push_back(r->get_vxlanr_vnid());
+    context_marker_ = r->get_vxlanr_vnid();
+}
+
+void KSyncSandeshContext::MplsMsgHandler(vr_mpls_req *r) {
+    MplsKSyncObject::GetKSyncObject()->AuditAdd(new MplsKSyncEntry(r));
+    context_marker_ = r->get_mr_label();
+}
@@ -3,6 +3,7 @@
  */
 #include <sandesh/sandesh_types.h>
 #include <sandesh/sandesh.h>
+#include <vector>
 #include "vr_types.h"
 
 #include "ksync/agent_ksync_types.h"
@@ -16,44 +17,56 @@
  */
 class KSyncSandeshContext : public AgentSandeshContext {
 public:
-    KSyncSandeshContext() { Reset(); }
+    KSyncSandeshContext() { Reset(); AuditClear(); }
 
     virtual void IfMsgHandler(vr_interface_req *req);
-    virtual void NHMsgHandler(vr_nexthop_req *req) {
-        assert(0);
-    }
-    virtual void RouteMsgHandler(vr_route_req *req) {
-        assert(0);
-    }
-    virtual void MplsMsgHandler(vr_mpls_req *req) {
-        assert(0);
-    }
-    virtual void MirrorMsgHandler(vr_mirror_req *req) {
-        assert(0);
-    }
-    virtual void VrfAssignMsgHandler(vr_vrf_assign_req *req) {
-        assert(0);
-    }
+    virtual void NHMsgHandler(vr_nexthop_req *req);
+    virtual void RouteMsgHandler(vr_route_req *req);
+    virtual void MplsMsgHandler(vr_mpls_req *req);
+    virtual void MirrorMsgHandler(vr_mirror_req *req);
+    virtual void VrfAssignMsgHandler(vr_vrf_assign_req *req);
     virtual void VrfStatsMsgHandler(vr_vrf_stats_req *req) {
         assert(0);
     }
     virtual void DropStatsMsgHandler(vr_drop_stats_req *req) {
         assert(0);
     }
-    virtual void VxLanMsgHandler(vr_vxlan_req *req) {
-        assert(0);
-    }
+    virtual void VxLanMsgHandler(vr_vxlan_req *req);
     virtual int VrResponseMsgHandler(vr_response *r);
     virtual void FlowMsgHandler(vr_flow_req *r);
     
     int GetResponseCode() { return resp_code_; }
     int GetContextMarker() { return context_marker_; }
+    int GetRouteMarkerPlen() { return route_marker_plen_; }
     void Reset() {
         resp_code_ = 0;
         context_marker_ = -1;
+        route_marker_plen_ = -1;
     }
 
+    // Audit of vrouter state on agent restart. Interfaces dumped while
+    // audit is set are added to the audit tree of the interface object
+    void set_audit(bool audit) { audit_ = audit; }
+    void AuditClear() {
+        audit_ = false;
+        audit_vrf_max_ = -1;
+        audit_vif_list_.clear();
+        dump_list_.clear();
+    }
+    int audit_vrf_max() const { return audit_vrf_max_; }
+    const std::vector<int> &audit_vif_list() const { return audit_vif_list_; }
+    // Ids of mirror and vxlan entries read by the last dump
+    const std::vector<int> &dump_list() const { return dump_list_; }
+    void clear_dump_list() { dump_list_.clear(); }
+
 private:
+    void AuditVrf(int vrf);
+
     int resp_code_;
     int context_marker_;
+    int route_marker_plen_;
+    bool audit_;
+    int audit_vrf_max_;
+    std::vector<int> audit_vif_list_;
+    std::vector<int> dump_list_;
 };
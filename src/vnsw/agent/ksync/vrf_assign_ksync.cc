@@ -36,7 +36,7 @@ KSyncDBObject *VrfAssignKSyncEntry::GetObject() {
 }
 
 VrfAssignKSyncEntry::VrfAssignKSyncEntry(const VrfAssign *vassign) :
-    KSyncNetlinkDBEntry(kInvalidIndex) {
+    KSyncNetlinkDBEntry(kInvalidIndex), vif_index_(kInvalidIndex) {
 
     IntfKSyncObject *intf_object = IntfKSyncObject::GetKSyncObject();
     IntfKSyncEntry intf(vassign->GetInterface());
@@ -56,6 +56,12 @@ VrfAssignKSyncEntry::VrfAssignKSyncEntry(const VrfAssign *vassign) :
     }
 }
 
+VrfAssignKSyncEntry::VrfAssignKSyncEntry(const vr_vrf_assign_req *req) :
+    KSyncNetlinkDBEntry(kInvalidIndex), interface_(NULL),
+    vlan_tag_(req->get_var_vlan_id()), vrf_id_(req->get_var_vif_vrf()),
+    vif_index_(req->get_var_vif_index()) {
+}
+
 bool VrfAssignKSyncEntry::IsLess(const KSyncEntry &rhs) const {
     const VrfAssignKSyncEntry &entry = static_cast<const VrfAssignKSyncEntry &>(rhs);
 
@@ -66,6 +72,31 @@ bool VrfAssignKSyncEntry::IsLess(const KSyncEntry &rhs) const {
     return GetVlanTag() < entry.GetVlanTag();
 }
 
+// Kernel knows the rule by interface index and tag
+bool VrfAssignKSyncEntry::IsAuditLess(const KSyncEntry &rhs) const {
+    const VrfAssignKSyncEntry &entry = static_cast<const VrfAssignKSyncEntry &>(rhs);
+
+    if (GetVifIndex() != entry.GetVifIndex()) {
+        return GetVifIndex() < entry.GetVifIndex();
+    }
+
+    return GetVlanTag() < entry.GetVlanTag();
+}
+
+bool VrfAssignKSyncEntry::IsAuditMatch(const KSyncEntry &kernel) const {
+    const VrfAssignKSyncEntry &entry =
+        static_cast<const VrfAssignKSyncEntry &>(kernel);
+    return GetVrfId() == entry.GetVrfId();
+}
+
+uint32_t VrfAssignKSyncEntry::GetVifIndex() const {
+    IntfKSyncEntry *intf = GetInterface();
+    if (intf) {
+        return intf->GetIndex();
+    }
+    return vif_index_;
+}
+
 std::string VrfAssignKSyncEntry::ToString() const {
     std::stringstream s;
     IntfKSyncEntry *intf = GetInterface();
@@ -75,7 +106,7 @@ std::string VrfAssignKSyncEntry::ToString() const {
         s << "Interface : " << intf->GetName() << " Intf-Service-Vlan : " <<
             (intf->HasServiceVlan() == true ? "Enable" : "Disable");
     } else { 
-        s << "Interface : <NULL> ";
+        s << "Interface : " << vif_index_ << " ";
     }
 
     s << " Tag : " << GetVlanTag() << " Vrf : " << GetVrfId();
@@ -104,15 +135,13 @@ bool VrfAssignKSyncEntry::Sync(DBEntry *e) {
 int VrfAssignKSyncEntry::Encode(sandesh_op::type op, char *buf, int buf_len) {
     vr_vrf_assign_req encoder;
     int encode_len, error;
-    IntfKSyncEntry *intf = GetInterface();
 
     encoder.set_h_op(op);
-    encoder.set_var_vif_index(intf->GetIndex());
+    encoder.set_var_vif_index(GetVifIndex());
     encoder.set_var_vlan_id(vlan_tag_);
     encoder.set_var_vif_vrf(vrf_id_);
     encode_len = encoder.WriteBinary((uint8_t *)buf, buf_len, &error);
-    LOG(DEBUG, "VRF Assign for Interface <" << intf->GetName() << "> Tag <" 
-        << GetVlanTag() << "> Vrf <" << GetVrfId() << ">");
+    LOG(DEBUG, ToString());
     return encode_len;
 }
 
@@ -14,17 +14,23 @@
 #include <ksync/ksync_entry.h>
 #include <ksync/ksync_object.h>
 #include "oper/vrf_assign.h"
+#include "vr_types.h"
 
 class VrfAssignKSyncEntry : public KSyncNetlinkDBEntry {
 public:
     VrfAssignKSyncEntry(const VrfAssignKSyncEntry *entry, uint32_t index) :
         KSyncNetlinkDBEntry(index), interface_(entry->interface_),
-        vlan_tag_(entry->vlan_tag_), vrf_id_(entry->vrf_id_) { };
+        vlan_tag_(entry->vlan_tag_), vrf_id_(entry->vrf_id_),
+        vif_index_(kInvalidIndex) { };
 
     VrfAssignKSyncEntry(const VrfAssign *rule);
+    // Rule read from kernel for audit
+    VrfAssignKSyncEntry(const vr_vrf_assign_req *req);
     virtual ~VrfAssignKSyncEntry() {};
 
     virtual bool IsLess(const KSyncEntry &rhs) const;
+    virtual bool IsAuditLess(const KSyncEntry &rhs) const;
+    virtual bool IsAuditMatch(const KSyncEntry &kernel) const;
     virtual std::string ToString() const;
     virtual KSyncEntry *UnresolvedReference();
     virtual bool Sync(DBEntry *e);
@@ -35,6 +41,7 @@ public:
 
     uint16_t GetVlanTag() const {return vlan_tag_;};
     uint16_t GetVrfId() const {return vrf_id_;};
+    uint32_t GetVifIndex() const;
 
     IntfKSyncEntry *GetInterface() const {
         return static_cast<IntfKSyncEntry *>(interface_.get());
@@ -44,6 +51,8 @@ private:
     KSyncEntryPtr interface_;
     uint16_t vlan_tag_;
     uint16_t vrf_id_;
+    // Interface index in kernel for rules read by audit
+    uint32_t vif_index_;
     DISALLOW_COPY_AND_ASSIGN(VrfAssignKSyncEntry);
 };
 
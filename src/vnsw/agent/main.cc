@@ -29,7 +29,9 @@
 #include <oper/vrf.h>
 #include <oper/multicast.h>
 #include <oper/mirror_table.h>
+#include <oper/agent_route.h>
 #include <controller/controller_init.h>
+#include <controller/controller_snapshot.h>
 #include <controller/controller_vrf_export.h>
 #include <pkt/pkt_init.h>
 #include <services/services_init.h>
@@ -47,6 +49,13 @@ namespace opt = boost::program_options;
 void RouterIdDepInit() {
     InstanceInfoServiceServerInit(*(Agent::GetInstance()->GetEventManager()), Agent::GetInstance()->GetDB());
 
+    // Preload the configuration and routes saved before the restart
+    AgentParam *param = Agent::GetInstance()->params();
+    if (param && !param->snapshot_file().empty()) {
+        AgentSnapshot::Init(param->snapshot_file(),
+                            param->snapshot_interval());
+    }
+
     // Parse config and then connect
     VNController::Connect();
     LOG(DEBUG, "Router ID Dependent modules (Nova and BGP) INITIALIZED");
@@ -61,6 +70,10 @@ int main(int argc, char *argv[]) {
         ("disable-ksync", "Disable kernel synchronization")
         ("disable-services", "Disable services")
         ("disable-packet", "Disable packet services")
+        ("ksync-audit",
+         "Reconcile with existing vrouter state instead of resetting it")
+        ("flow-lpm-table",
+         "Use a multibit trie per VRF for route lookups in flow setup")
         ("log-local", "Enable local logging of sandesh messages")
         ("log-level", opt::value<string>()->default_value("SYS_DEBUG"),
          "Severity level for local logging of sandesh messages")
@@ -81,6 +94,10 @@ int main(int argc, char *argv[]) {
          "IP Address for the link local port")
         ("xen-ll-prefix-len", opt::value<int>(),
          "Prefix for link local IP Address")
+        ("snapshot-file", opt::value<string>(),
+         "File to save configuration and routes to, for a warm restart")
+        ("snapshot-interval", opt::value<int>()->default_value(60),
+         "Interval in seconds between saves of the snapshot file")
         ("version", "Display version information")
         ;
     opt::variables_map var_map;
@@ -105,6 +122,10 @@ int main(int argc, char *argv[]) {
         exit(0);
     }
 
+    if (var_map.count("flow-lpm-table")) {
+        Inet4UnicastAgentRouteTable::SetLpmTableEnable(true);
+    }
+
     string init_file = "";
     if (var_map.count("config-file")) {
         init_file = var_map["config-file"].as<string>();
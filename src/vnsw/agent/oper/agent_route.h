@@ -26,6 +26,7 @@
 #include <controller/controller_peer.h>
 #include <sandesh/sandesh_trace.h>
 #include <oper/route_types.h>
+#include <oper/inet4_lpm_table.h>
 
 //Route entry in route table related classes
 
@@ -665,21 +666,21 @@ public:
     typedef Patricia::Tree<Inet4UnicastRouteEntry, &Inet4UnicastRouteEntry::rtnode_, 
             Inet4UnicastRouteEntry::Rtkey> Inet4RouteTree;
 
-    Inet4UnicastAgentRouteTable(DB *db, const std::string &name) :
-        Inet4AgentRouteTable(Inet4AgentRouteTable::UNICAST, db, name), 
-        walkid_(DBTableWalker::kInvalidWalkerId) { };
+    typedef Inet4LpmTable<Inet4UnicastRouteEntry> LpmTable;
+
+    Inet4UnicastAgentRouteTable(DB *db, const std::string &name);
     virtual ~Inet4UnicastAgentRouteTable() { };
 
     Inet4UnicastRouteEntry *FindLPM(const Ip4Address &ip);
     virtual string GetTableName() const {return "Inet4UnicastAgentRouteTable";};
     virtual AgentRouteTableAPIS::TableType GetTableType() const {
         return AgentRouteTableAPIS::INET4_UNICAST;};
-    virtual void ProcessAdd(RouteEntry *rt) { 
-        tree_.Insert(static_cast<Inet4UnicastRouteEntry *>(rt));
-    };
-    virtual void ProcessDelete(RouteEntry *rt) { 
-        tree_.Remove(static_cast<Inet4UnicastRouteEntry *>(rt));
-    };
+    virtual void ProcessAdd(RouteEntry *rt);
+    virtual void ProcessDelete(RouteEntry *rt);
+    // Tables created after this is set keep an Inet4LpmTable next to the
+    // Patricia tree and use it for FindLPM.
+    static void SetLpmTableEnable(bool enable) { lpm_table_enable_ = enable; }
+    bool HasLpmTable() const { return lpm_table_.get() != NULL; }
     Inet4UnicastRouteEntry *FindRoute(const Ip4Address &ip) { 
         return FindLPM(ip); };
 
@@ -802,7 +803,10 @@ public:
                                 const Ip4Address &gw_ip);
 
 private:
+    static bool lpm_table_enable_;
+
     Inet4RouteTree tree_;
+    boost::scoped_ptr<LpmTable> lpm_table_;
     Patricia::Node rtnode_;
     DBTableWalker::WalkId walkid_;
     DISALLOW_COPY_AND_ASSIGN(Inet4UnicastAgentRouteTable);
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef vnsw_agent_inet4_lpm_table_h
+#define vnsw_agent_inet4_lpm_table_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <tbb/atomic.h>
+
+#include "base/util.h"
+
+//
+// Inet4LpmTable
+// Multibit trie with a 16-8-8 stride used to accelerate longest prefix
+// match lookups on the flow setup path. Prefixes are expanded into the
+// slots of the level that holds their last bit, so a lookup is at most
+// three array reads without any comparisons.
+//
+// A slot holds either the best matching entry, or a tagged pointer to the
+// next level node. Entry must provide GetPlen().
+//
+// The table is modified from a single writer (the DB task that processes
+// the route table) and can be read concurrently from any number of
+// threads. Slots are updated with single atomic stores and new nodes are
+// fully initialized before being linked in, so a reader always sees either
+// the old or the new entry for a slot. Nodes are never freed while the
+// table is alive for the same reason; their number is bounded by the
+// number of distinct /16 and /24 prefixes that have had longer routes.
+//
+// The table doesn't know about the prefixes, only about the expanded
+// slots. The caller has to supply the entry that replaces a deleted one,
+// which is the longest match for the deleted prefix in the route table
+// once the prefix itself has been removed.
+//
+template <typename Entry>
+class Inet4LpmTable {
+public:
+    Inet4LpmTable() : root_(new Slot[kRootSize]) {
+        for (size_t idx = 0; idx < kRootSize; ++idx) {
+            root_[idx] = 0;
+        }
+    }
+
+    ~Inet4LpmTable() {
+        for (typename std::vector<Node *>::iterator it = nodes_.begin();
+             it != nodes_.end(); ++it) {
+            delete *it;
+        }
+        delete [] root_;
+    }
+
+    void Insert(uint32_t addr, uint8_t plen, Entry *entry) {
+        Slot *slots = root_;
+        for (int level = 0; ; ++level) {
+            int end_bit = LevelEndBit(level);
+            size_t index = SlotIndex(addr, level);
+            if (plen <= end_bit) {
+                size_t count = 1 << (end_bit - plen);
+                size_t first = index & ~(count - 1);
+                for (size_t idx = first; idx < first + count; ++idx) {
+                    InsertSlot(&slots[idx], entry, plen);
+                }
+                return;
+            }
+            slots = LocateNode(&slots[index])->slots;
+        }
+    }
+
+    void Remove(uint32_t addr, uint8_t plen, Entry *entry,
+                Entry *replacement) {
+        Slot *slots = root_;
+        for (int level = 0; ; ++level) {
+            int end_bit = LevelEndBit(level);
+            size_t index = SlotIndex(addr, level);
+            if (plen <= end_bit) {
+                size_t count = 1 << (end_bit - plen);
+                size_t first = index & ~(count - 1);
+                for (size_t idx = first; idx < first + count; ++idx) {
+                    RemoveSlot(&slots[idx], entry, replacement);
+                }
+                return;
+            }
+            uintptr_t value = slots[index];
+            if (!IsNode(value))
+                return;
+            slots = ToNode(value)->slots;
+        }
+    }
+
+    Entry *Find(uint32_t addr) const {
+        uintptr_t value = root_[addr >> 16];
+        if (IsNode(value)) {
+            value = ToNode(value)->slots[(addr >> 8) & 0xff];
+            if (IsNode(value)) {
+                value = ToNode(value)->slots[addr & 0xff];
+            }
+        }
+        return reinterpret_cast<Entry *>(value);
+    }
+
+    size_t node_count() const { return nodes_.size(); }
+
+private:
+    typedef tbb::atomic<uintptr_t> Slot;
+
+    static const size_t kRootSize = 1 << 16;
+    static const size_t kNodeSize = 1 << 8;
+    static const uintptr_t kNodeTag = 1;
+
+    struct Node {
+        Slot slots[kNodeSize];
+    };
+
+    static int LevelEndBit(int level) { return 16 + level * 8; }
+
+    static size_t SlotIndex(uint32_t addr, int level) {
+        if (level == 0)
+            return addr >> 16;
+        return (addr >> (32 - LevelEndBit(level))) & 0xff;
+    }
+
+    static bool IsNode(uintptr_t value) { return (value & kNodeTag) != 0; }
+
+    static Node *ToNode(uintptr_t value) {
+        return reinterpret_cast<Node *>(value & ~kNodeTag);
+    }
+
+    // Get the node below a slot, creating it with all slots set to the
+    // entry that covered the parent slot.
+    Node *LocateNode(Slot *slot) {
+        uintptr_t value = *slot;
+        if (IsNode(value))
+            return ToNode(value);
+        Node *node = new Node;
+        for (size_t idx = 0; idx < kNodeSize; ++idx) {
+            node->slots[idx] = value;
+        }
+        nodes_.push_back(node);
+        *slot = reinterpret_cast<uintptr_t>(node) | kNodeTag;
+        return node;
+    }
+
+    // Store the entry unless the slot already has a more specific one.
+    void InsertSlot(Slot *slot, Entry *entry, uint8_t plen) {
+        uintptr_t value = *slot;
+        if (IsNode(value)) {
+            Node *node = ToNode(value);
+            for (size_t idx = 0; idx < kNodeSize; ++idx) {
+                InsertSlot(&node->slots[idx], entry, plen);
+            }
+            return;
+        }
+        Entry *current = reinterpret_cast<Entry *>(value);
+        if (current == NULL || current->GetPlen() <= plen) {
+            *slot = reinterpret_cast<uintptr_t>(entry);
+        }
+    }
+
+    void RemoveSlot(Slot *slot, Entry *entry, Entry *replacement) {
+        uintptr_t value = *slot;
+        if (IsNode(value)) {
+            Node *node = ToNode(value);
+            for (size_t idx = 0; idx < kNodeSize; ++idx) {
+                RemoveSlot(&node->slots[idx], entry, replacement);
+            }
+            return;
+        }
+        if (value == reinterpret_cast<uintptr_t>(entry)) {
+            *slot = reinterpret_cast<uintptr_t>(replacement);
+        }
+    }
+
+    Slot *root_;
+    std::vector<Node *> nodes_;
+
+    DISALLOW_COPY_AND_ASSIGN(Inet4LpmTable);
+};
+
+#endif  // vnsw_agent_inet4_lpm_table_h
@@ -29,6 +29,38 @@ Inet4UnicastRouteKey::AllocRouteEntry(VrfEntry *vrf, bool is_multicast) const
     return static_cast<RouteEntry *>(entry);
 }
 
+bool Inet4UnicastAgentRouteTable::lpm_table_enable_ = false;
+
+Inet4UnicastAgentRouteTable::Inet4UnicastAgentRouteTable(DB *db,
+                                                         const std::string &name)
+    : Inet4AgentRouteTable(Inet4AgentRouteTable::UNICAST, db, name),
+      walkid_(DBTableWalker::kInvalidWalkerId) {
+    if (lpm_table_enable_)
+        lpm_table_.reset(new LpmTable);
+}
+
+void Inet4UnicastAgentRouteTable::ProcessAdd(RouteEntry *rt) {
+    Inet4UnicastRouteEntry *uc_rt = static_cast<Inet4UnicastRouteEntry *>(rt);
+    tree_.Insert(uc_rt);
+    if (lpm_table_.get()) {
+        lpm_table_->Insert(uc_rt->GetIpAddress().to_ulong(), uc_rt->GetPlen(),
+                           uc_rt);
+    }
+}
+
+// Once the route is out of the tree, the longest match for its own prefix
+// is the route that covers the slots it leaves in the LPM table.
+void Inet4UnicastAgentRouteTable::ProcessDelete(RouteEntry *rt) {
+    Inet4UnicastRouteEntry *uc_rt = static_cast<Inet4UnicastRouteEntry *>(rt);
+    tree_.Remove(uc_rt);
+    if (lpm_table_.get()) {
+        Inet4UnicastRouteEntry key(NULL, uc_rt->GetIpAddress(),
+                                   uc_rt->GetPlen(), false);
+        lpm_table_->Remove(uc_rt->GetIpAddress().to_ulong(), uc_rt->GetPlen(),
+                           uc_rt, tree_.LPMFind(&key));
+    }
+}
+
 Inet4UnicastRouteEntry *
 Inet4UnicastAgentRouteTable::FindRoute(const string &vrf_name, 
                                        const Ip4Address &ip) {
@@ -42,6 +74,8 @@ Inet4UnicastAgentRouteTable::FindRoute(const string &vrf_name,
 
 Inet4UnicastRouteEntry *
 Inet4UnicastAgentRouteTable::FindLPM(const Ip4Address &ip) {
+    if (lpm_table_.get())
+        return lpm_table_->Find(ip.to_ulong());
     Inet4UnicastRouteEntry key(NULL, ip);
     return tree_.LPMFind(&key);
 }
@@ -14,6 +14,7 @@
 #define LOCAL_VM_PEER_NAME "Local_Vm"
 #define NOVA_PEER_NAME "Nova"
 #define MDATA_PEER_NAME "MData"
+#define SNAPSHOT_PEER_NAME "Snapshot"
 
 class AgentXmppChannel;
 
@@ -27,7 +28,8 @@ public:
         LOCAL_PEER,  // higher priority for local peer
         LOCAL_VM_PEER,
         MDATA_PEER,
-        NOVA_PEER
+        NOVA_PEER,
+        SNAPSHOT_PEER // routes preloaded from the agent snapshot
     };
 
     Peer(Type type, std::string name) : type_(type), name_(name),
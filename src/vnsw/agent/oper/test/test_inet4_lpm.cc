@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdlib.h>
+#include <algorithm>
+#include <map>
+
+#include "base/logging.h"
+#include "base/util.h"
+#include "testing/gunit.h"
+
+#include <cmn/agent_cmn.h>
+#include <oper/agent_route.h>
+#include <oper/inet4_lpm_table.h>
+
+void RouterIdDepInit() {
+}
+
+namespace {
+
+typedef Inet4UnicastAgentRouteTable::Inet4RouteTree RouteTree;
+typedef Inet4UnicastAgentRouteTable::LpmTable LpmTable;
+
+//
+// Keeps the Patricia tree and the LPM table in sync the same way
+// Inet4UnicastAgentRouteTable::ProcessAdd and ProcessDelete do.
+//
+class Inet4LpmTest : public ::testing::Test {
+protected:
+    Inet4LpmTest() {
+        srand(1);
+    }
+
+    ~Inet4LpmTest() {
+        for (RouteMap::iterator it = routes_.begin(); it != routes_.end();
+             ++it) {
+            tree_.Remove(it->second);
+            delete it->second;
+        }
+    }
+
+    Inet4UnicastRouteEntry *Add(uint32_t addr, uint8_t plen) {
+        Inet4UnicastRouteEntry *rt =
+            new Inet4UnicastRouteEntry(NULL, Ip4Address(addr), plen, false);
+        RouteKey key(rt->GetIpAddress().to_ulong(), plen);
+        if (routes_.find(key) != routes_.end()) {
+            delete rt;
+            return routes_[key];
+        }
+        routes_[key] = rt;
+        tree_.Insert(rt);
+        table_.Insert(key.first, plen, rt);
+        return rt;
+    }
+
+    void Delete(uint32_t addr, uint8_t plen) {
+        RouteMap::iterator it = routes_.find(RouteKey(addr, plen));
+        ASSERT_TRUE(it != routes_.end());
+        Inet4UnicastRouteEntry *rt = it->second;
+        routes_.erase(it);
+        tree_.Remove(rt);
+        Inet4UnicastRouteEntry key(NULL, rt->GetIpAddress(), plen, false);
+        table_.Remove(addr, plen, rt, tree_.LPMFind(&key));
+        delete rt;
+    }
+
+    Inet4UnicastRouteEntry *TreeLookup(uint32_t addr) {
+        Inet4UnicastRouteEntry key(NULL, Ip4Address(addr));
+        return tree_.LPMFind(&key);
+    }
+
+    static uint32_t RandomAddress() {
+        return 0x0a000000 | (rand() & 0x00ffffff);
+    }
+
+    typedef std::pair<uint32_t, uint8_t> RouteKey;
+    typedef std::map<RouteKey, Inet4UnicastRouteEntry *> RouteMap;
+
+    RouteTree tree_;
+    LpmTable table_;
+    RouteMap routes_;
+};
+
+TEST_F(Inet4LpmTest, Basic) {
+    EXPECT_TRUE(table_.Find(0x0a010101) == NULL);
+
+    Inet4UnicastRouteEntry *rt8 = Add(0x0a000000, 8);
+    Inet4UnicastRouteEntry *rt24 = Add(0x0a010100, 24);
+    Inet4UnicastRouteEntry *rt32 = Add(0x0a010101, 32);
+    Inet4UnicastRouteEntry *rt16 = Add(0x0a010000, 16);
+    Inet4UnicastRouteEntry *rt0 = Add(0, 0);
+
+    EXPECT_EQ(rt32, table_.Find(0x0a010101));
+    EXPECT_EQ(rt24, table_.Find(0x0a010102));
+    EXPECT_EQ(rt16, table_.Find(0x0a010201));
+    EXPECT_EQ(rt8, table_.Find(0x0a020201));
+    EXPECT_EQ(rt0, table_.Find(0x0b000001));
+
+    // Deleted routes are replaced by the next covering route.
+    Delete(0x0a010100, 24);
+    EXPECT_EQ(rt32, table_.Find(0x0a010101));
+    EXPECT_EQ(rt16, table_.Find(0x0a010102));
+    Delete(0x0a000000, 8);
+    EXPECT_EQ(rt0, table_.Find(0x0a020201));
+    EXPECT_EQ(rt16, table_.Find(0x0a010201));
+    Delete(0, 0);
+    EXPECT_TRUE(table_.Find(0x0a020201) == NULL);
+    Delete(0x0a010101, 32);
+    EXPECT_EQ(rt16, table_.Find(0x0a010101));
+    Delete(0x0a010000, 16);
+    EXPECT_TRUE(table_.Find(0x0a010101) == NULL);
+}
+
+TEST_F(Inet4LpmTest, Random) {
+    std::vector<RouteKey> keys;
+    for (int idx = 0; idx < 10000; ++idx) {
+        uint8_t plen = (rand() % 2) ? 32 : 8 + rand() % 25;
+        Inet4UnicastRouteEntry *rt = Add(RandomAddress(), plen);
+        keys.push_back(RouteKey(rt->GetIpAddress().to_ulong(), plen));
+    }
+    for (int idx = 0; idx < 100000; ++idx) {
+        uint32_t addr = RandomAddress();
+        ASSERT_EQ(TreeLookup(addr), table_.Find(addr));
+    }
+
+    std::random_shuffle(keys.begin(), keys.end());
+    for (size_t idx = 0; idx < keys.size() / 2; ++idx) {
+        if (routes_.find(keys[idx]) != routes_.end())
+            Delete(keys[idx].first, keys[idx].second);
+    }
+    for (int idx = 0; idx < 100000; ++idx) {
+        uint32_t addr = RandomAddress();
+        ASSERT_EQ(TreeLookup(addr), table_.Find(addr));
+    }
+}
+
+//
+// Lookup rate on a VRF with 100K host routes spread over a /12, plus the
+// subnet routes for each /24 and a default route.
+//
+TEST_F(Inet4LpmTest, Benchmark) {
+    static const int kRoutes = 100000;
+    static const int kLookups = 1000000;
+
+    Add(0, 0);
+    for (int idx = 0; idx < kRoutes; ++idx) {
+        uint32_t addr = 0x0a000000 | (rand() & 0x000fffff);
+        Add(addr, 32);
+        Add(addr & 0xffffff00, 24);
+    }
+
+    std::vector<uint32_t> addrs;
+    for (int idx = 0; idx < kLookups; ++idx) {
+        addrs.push_back(0x0a000000 | (rand() & 0x000fffff));
+    }
+
+    uint64_t start = UTCTimestampUsec();
+    size_t tree_sum = 0;
+    for (int idx = 0; idx < kLookups; ++idx) {
+        tree_sum += TreeLookup(addrs[idx])->GetPlen();
+    }
+    uint64_t tree_usec = UTCTimestampUsec() - start;
+
+    start = UTCTimestampUsec();
+    size_t table_sum = 0;
+    for (int idx = 0; idx < kLookups; ++idx) {
+        table_sum += table_.Find(addrs[idx])->GetPlen();
+    }
+    uint64_t table_usec = UTCTimestampUsec() - start;
+
+    EXPECT_EQ(tree_sum, table_sum);
+    LOG(DEBUG, routes_.size() << " routes, " << table_.node_count() <<
+        " trie nodes, " << kLookups << " lookups: patricia " << tree_usec <<
+        " usec, lpm table " << table_usec << " usec");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <algorithm>
+#include "services/dns_cache.h"
+
+DnsResponseCache::DnsResponseCache() : max_entries_(kMaxEntries) {
+}
+
+DnsResponseCache::~DnsResponseCache() {
+}
+
+bool DnsResponseCache::Lookup(const std::string &vdns, const std::string &name,
+                              uint16_t type, dns_flags &flags,
+                              std::vector<DnsItem> &ans,
+                              std::vector<DnsItem> &auth,
+                              std::vector<DnsItem> &add) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    EntryMap::iterator it = entries_.find(Key(vdns, name, type));
+    if (it == entries_.end()) {
+        stats_.misses++;
+        return false;
+    }
+
+    uint64_t now = UTCTimestampUsec();
+    Entry &entry = it->second;
+    if (now >= entry.expiry_time) {
+        Remove(it);
+        stats_.misses++;
+        return false;
+    }
+
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+    uint32_t elapsed = (now - entry.insert_time) / 1000000;
+    flags = entry.flags;
+    ans = entry.ans;
+    auth = entry.auth;
+    add = entry.add;
+    AdjustTtl(ans, elapsed);
+    AdjustTtl(auth, elapsed);
+    AdjustTtl(add, elapsed);
+    stats_.hits++;
+    return true;
+}
+
+void DnsResponseCache::Add(const std::string &vdns, const std::string &name,
+                           uint16_t type, const dns_flags &flags,
+                           const std::vector<DnsItem> &ans,
+                           const std::vector<DnsItem> &auth,
+                           const std::vector<DnsItem> &add) {
+    uint32_t ttl = GetTtl(flags, ans, auth, add);
+    if (!ttl || !max_entries_)
+        return;
+
+    tbb::mutex::scoped_lock lock(mutex_);
+    Key key(vdns, name, type);
+    EntryMap::iterator it = entries_.find(key);
+    if (it == entries_.end()) {
+        EvictLocked();
+        it = entries_.insert(std::make_pair(key, Entry())).first;
+        lru_.push_front(key);
+        it->second.lru = lru_.begin();
+    } else {
+        lru_.splice(lru_.begin(), lru_, it->second.lru);
+    }
+
+    Entry &entry = it->second;
+    entry.flags = flags;
+    entry.ans = ans;
+    entry.auth = auth;
+    entry.add = add;
+    entry.insert_time = UTCTimestampUsec();
+    entry.expiry_time = entry.insert_time + (uint64_t)ttl * 1000000;
+    stats_.inserts++;
+}
+
+void DnsResponseCache::Invalidate(const std::string &vdns) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    EntryMap::iterator it = entries_.lower_bound(Key(vdns, "", 0));
+    while (it != entries_.end() && it->first.vdns == vdns) {
+        Remove(it++);
+        stats_.invalidations++;
+    }
+}
+
+void DnsResponseCache::Clear() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    entries_.clear();
+    lru_.clear();
+}
+
+std::size_t DnsResponseCache::Size() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return entries_.size();
+}
+
+void DnsResponseCache::set_max_entries(uint32_t max_entries) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    max_entries_ = max_entries;
+    while (entries_.size() > max_entries_) {
+        Remove(entries_.find(lru_.back()));
+        stats_.evictions++;
+    }
+}
+
+DnsResponseCache::Stats DnsResponseCache::GetStats() const {
+    tbb::mutex::scoped_lock lock(mutex_);
+    return stats_;
+}
+
+void DnsResponseCache::ClearStats() {
+    tbb::mutex::scoped_lock lock(mutex_);
+    stats_.Reset();
+}
+
+uint32_t DnsResponseCache::GetTtl(const dns_flags &flags,
+                                  const std::vector<DnsItem> &ans,
+                                  const std::vector<DnsItem> &auth,
+                                  const std::vector<DnsItem> &add) const {
+    uint32_t ttl = kMaxTtl;
+    if (flags.ret == DNS_ERR_NO_SUCH_NAME ||
+        (flags.ret == DNS_ERR_NO_ERROR && ans.empty())) {
+        // negative response, use the SOA minimum if present
+        ttl = kNegativeTtl;
+        for (unsigned int i = 0; i < auth.size(); ++i) {
+            if (auth[i].type == DNS_TYPE_SOA) {
+                ttl = std::min(auth[i].ttl, auth[i].soa.ttl);
+                break;
+            }
+        }
+        return (ttl > kMaxNegativeTtl) ? kMaxNegativeTtl : ttl;
+    }
+
+    if (flags.ret != DNS_ERR_NO_ERROR)
+        return 0;
+
+    for (unsigned int i = 0; i < ans.size(); ++i)
+        ttl = std::min(ttl, ans[i].ttl);
+    for (unsigned int i = 0; i < auth.size(); ++i)
+        ttl = std::min(ttl, auth[i].ttl);
+    for (unsigned int i = 0; i < add.size(); ++i)
+        ttl = std::min(ttl, add[i].ttl);
+    return ttl;
+}
+
+void DnsResponseCache::AdjustTtl(std::vector<DnsItem> &items,
+                                 uint32_t elapsed) const {
+    for (unsigned int i = 0; i < items.size(); ++i)
+        items[i].ttl = (items[i].ttl > elapsed) ? items[i].ttl - elapsed : 0;
+}
+
+void DnsResponseCache::Remove(EntryMap::iterator it) {
+    lru_.erase(it->second.lru);
+    entries_.erase(it);
+}
+
+// Must be called with mutex_ held, before adding a new entry
+void DnsResponseCache::EvictLocked() {
+    while (!lru_.empty() && entries_.size() >= max_entries_) {
+        Remove(entries_.find(lru_.back()));
+        stats_.evictions++;
+    }
+}
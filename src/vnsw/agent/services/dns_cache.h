@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef vnsw_agent_dns_cache_hpp
+#define vnsw_agent_dns_cache_hpp
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <tbb/mutex.h>
+#include "base/util.h"
+#include "bind/bind_util.h"
+
+// Cache of the responses received from the DNS servers, keyed by
+// (virtual DNS, query name, query type). Default DNS responses use an empty
+// virtual DNS name.
+//
+// Successful responses are kept for the smallest TTL in the response.
+// NXDOMAIN and empty responses are kept for the TTL of the SOA in the
+// authority section (RFC 2308), or kNegativeTtl when there is no SOA.
+// Once the cache is full, the least recently used entry is evicted.
+class DnsResponseCache {
+public:
+    static const uint32_t kMaxEntries = 4096;
+    static const uint32_t kMaxTtl = 86400;          // seconds
+    static const uint32_t kNegativeTtl = 30;        // seconds
+    static const uint32_t kMaxNegativeTtl = 300;    // seconds
+
+    struct Stats {
+        uint32_t hits;
+        uint32_t misses;
+        uint32_t inserts;
+        uint32_t evictions;
+        uint32_t invalidations;
+
+        void Reset() {
+            hits = misses = inserts = evictions = invalidations = 0;
+        }
+        Stats() { Reset(); }
+    };
+
+    DnsResponseCache();
+    virtual ~DnsResponseCache();
+
+    // On a hit, the TTLs in the returned items are reduced by the time the
+    // entry has been in the cache
+    bool Lookup(const std::string &vdns, const std::string &name,
+                uint16_t type, dns_flags &flags, std::vector<DnsItem> &ans,
+                std::vector<DnsItem> &auth, std::vector<DnsItem> &add);
+    void Add(const std::string &vdns, const std::string &name, uint16_t type,
+             const dns_flags &flags, const std::vector<DnsItem> &ans,
+             const std::vector<DnsItem> &auth,
+             const std::vector<DnsItem> &add);
+    // Remove all the entries for a virtual DNS
+    void Invalidate(const std::string &vdns);
+    void Clear();
+
+    std::size_t Size() const;
+    uint32_t max_entries() const { return max_entries_; }
+    void set_max_entries(uint32_t max_entries);
+    Stats GetStats() const;
+    void ClearStats();
+
+private:
+    struct Key {
+        std::string vdns;
+        std::string name;
+        uint16_t type;
+
+        Key(const std::string &v, const std::string &n, uint16_t t)
+            : vdns(v), name(n), type(t) {}
+        bool operator<(const Key &rhs) const {
+            if (vdns != rhs.vdns)
+                return vdns < rhs.vdns;
+            if (name != rhs.name)
+                return name < rhs.name;
+            return type < rhs.type;
+        }
+    };
+
+    typedef std::list<Key> LruList;
+
+    struct Entry {
+        dns_flags flags;
+        std::vector<DnsItem> ans;
+        std::vector<DnsItem> auth;
+        std::vector<DnsItem> add;
+        uint64_t insert_time;
+        uint64_t expiry_time;
+        LruList::iterator lru;
+    };
+
+    typedef std::map<Key, Entry> EntryMap;
+
+    uint32_t GetTtl(const dns_flags &flags, const std::vector<DnsItem> &ans,
+                    const std::vector<DnsItem> &auth,
+                    const std::vector<DnsItem> &add) const;
+    void AdjustTtl(std::vector<DnsItem> &items, uint32_t elapsed) const;
+    void Remove(EntryMap::iterator it);
+    void EvictLocked();
+
+    mutable tbb::mutex mutex_;
+    EntryMap entries_;
+    LruList lru_;               // most recently used at the front
+    uint32_t max_entries_;
+    Stats stats_;
+
+    DISALLOW_COPY_AND_ASSIGN(DnsResponseCache);
+};
+
+#endif // vnsw_agent_dns_cache_hpp
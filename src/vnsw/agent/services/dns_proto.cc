@@ -455,6 +455,11 @@ bool DnsHandler::HandleDefaultDnsRequest(const VmPortInterface *vmitf) {
     BindUtil::BuildDnsHeader(dns_, ntohs(dns_->xid), DNS_QUERY_RESPONSE, 
                              DNS_OPCODE_QUERY, 0, 1, DNS_ERR_NO_ERROR, 
                              ntohs(dns_->ques_rrcount));
+    if (ResolveFromCache("")) {
+        dns_proto->DelVmRequest(rkey_);
+        return true;
+    }
+
     for (uint32_t i = 0; i < items_.size(); i++) {
         ResolveHandler resolv_handler = 
             boost::bind(&DnsHandler::DefaultDnsResolveHandler, this, _1, _2, i);
@@ -516,7 +521,13 @@ void DnsHandler::DefaultDnsResolveHandler(const error_code& error,
     {
         tbb::mutex::scoped_lock lock(mutex_);
         if (error) {
-            dns_->flags.ret = DNS_ERR_NO_SUCH_NAME;
+            // Only a name the resolver knows not to exist is NXDOMAIN, which
+            // may be cached. Timeouts and network errors are transient
+            if (error == boost::asio::error::host_not_found) {
+                dns_->flags.ret = DNS_ERR_NO_SUCH_NAME;
+            } else {
+                dns_->flags.ret = DNS_ERR_SERVER_FAIL;
+            }
         } else {
             bool resolved = true;
             items_[index].ttl = DEFAULT_DNS_TTL;
@@ -568,6 +579,15 @@ void DnsHandler::DefaultDnsResolveHandler(const error_code& error,
 
 void DnsHandler::DefaultDnsSendResponse() {
     Agent::GetInstance()->GetDnsProto()->DelVmRequest(rkey_);
+    // Errors other than NXDOMAIN are not cached
+    if (items_.size() == 1 &&
+        ((dns_->flags.ret == DNS_ERR_NO_ERROR && dns_->ans_rrcount) ||
+         dns_->flags.ret == DNS_ERR_NO_SUCH_NAME)) {
+        std::vector<DnsItem> ans, none;
+        if (dns_->ans_rrcount)
+            ans.push_back(items_[0]);
+        AddToCache("", dns_->flags, ans, none, none);
+    }
     if (dns_->flags.ret) {
         DNS_BIND_TRACE(DnsBindError, "Query failed : " << 
                        BindUtil::DnsResponseCode(dns_->flags.ret) <<
@@ -602,11 +622,14 @@ bool DnsHandler::HandleVirtualDnsRequest(const VmPortInterface *vmitf) {
             dns_resp_size_ = BindUtil::ParseDnsQuery((uint8_t *)dns_, items_);
             resp_ptr_ = (uint8_t *)dns_ + dns_resp_size_;
             UpdateQueryNames();
-            xid_ = dns_proto->GetTransId();
             action_ = DnsHandler::DNS_QUERY;
             BindUtil::BuildDnsHeader(dns_, ntohs(dns_->xid), DNS_QUERY_RESPONSE, 
                                      DNS_OPCODE_QUERY, 0, 1, ret, 
                                      ntohs(dns_->ques_rrcount));
+            if (ResolveFromCache(ipam_type_.ipam_dns_server.
+                                 virtual_dns_server_name))
+                break;
+            xid_ = dns_proto->GetTransId();
             if (SendDnsQuery())
                 return false;
             break;
@@ -729,6 +752,11 @@ bool DnsHandler::HandleBindResponse() {
         BindUtil::ParseDnsQuery(ipc->resp, xid, flags, ques, ans, auth, add);
         switch(handler->action_) {
             case DnsHandler::DNS_QUERY:
+                // Resolve updates the items for the requesting VM, cache
+                // them as received from the server
+                handler->AddToCache(handler->ipam_type_.ipam_dns_server.
+                                    virtual_dns_server_name,
+                                    flags, ans, auth, add);
                 handler->Resolve(flags, ques, ans, auth, add);
                 if (flags.ret) {
                     DNS_BIND_TRACE(DnsBindError, "Query failed : " << 
@@ -790,6 +818,8 @@ bool DnsHandler::HandleModifyVdns() {
     DnsUpdateIpc *ipc = static_cast<DnsUpdateIpc *>(pkt_info_->ipc);
     DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
     std::vector<DnsHandler::DnsUpdateIpc *> change_list;
+    dns_proto->GetCache()->Invalidate(ipc->old_vdns);
+    dns_proto->GetCache()->Invalidate(ipc->new_vdns);
     const DnsProto::DnsUpdateSet &update_set = dns_proto->GetUpdateRequestSet();
     for (DnsProto::DnsUpdateSet::const_iterator it = update_set.begin();
          it != update_set.end(); ++it) {
@@ -977,6 +1007,34 @@ void DnsHandler::UpdateQueryNames() {
     }
 }
 
+// Respond to a single question query from the response cache
+bool DnsHandler::ResolveFromCache(const std::string &vdns) {
+    if (items_.size() != 1)
+        return false;
+
+    dns_flags flags;
+    std::vector<DnsItem> ans, auth, add;
+    DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
+    if (!dns_proto->GetCache()->Lookup(vdns, items_[0].name, items_[0].type,
+                                       flags, ans, auth, add))
+        return false;
+
+    DNS_BIND_TRACE(DnsBindTrace, "DNS query resolved from cache; xid = " <<
+                   dns_->xid << "; " << DnsItemsToString(items_) << ";");
+    Resolve(flags, items_, ans, auth, add);
+    return true;
+}
+
+void DnsHandler::AddToCache(const std::string &vdns, const dns_flags &flags,
+                            const std::vector<DnsItem> &ans,
+                            const std::vector<DnsItem> &auth,
+                            const std::vector<DnsItem> &add) {
+    if (items_.size() != 1)
+        return;
+    Agent::GetInstance()->GetDnsProto()->GetCache()->Add(
+        vdns, items_[0].name, items_[0].type, flags, ans, auth, add);
+}
+
 // In case we added domain name to the queries, the response to the VM 
 // should not have the domain name. Update the offsets in the DnsItems
 // accordingly.
@@ -1017,6 +1075,7 @@ void DnsHandler::UpdateGWAddress(DnsItem &item) {
 void DnsHandler::Update(DnsUpdateIpc *update) {
     bool free_update = true;
     DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
+    dns_proto->GetCache()->Invalidate(update->xmpp_data->virtual_dns);
     DnsUpdateIpc *update_req = dns_proto->FindUpdateRequest(update);
     if (update_req) {
         DnsUpdateData *data = update_req->xmpp_data;
@@ -1059,6 +1118,7 @@ void DnsHandler::DelUpdate(DnsUpdateIpc *update) {
     DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
     DnsUpdateIpc *update_req = dns_proto->FindUpdateRequest(update);
     while (update_req) {
+        dns_proto->GetCache()->Invalidate(update_req->xmpp_data->virtual_dns);
         for (DnsItems::iterator item = update_req->xmpp_data->items.begin(); 
              item != update_req->xmpp_data->items.end(); ++item) {
             // in case of delete, set the class to NONE and ttl to 0
@@ -10,6 +10,7 @@
 #include "vnc_cfg_types.h"
 #include "bind/bind_util.h"
 #include "bind/xmpp_dns_agent.h"
+#include "services/dns_cache.h"
 
 #define DEFAULT_DNS_TTL 120
 
@@ -169,6 +170,11 @@ private:
     bool SendDnsQuery();
     void SendDnsResponse();
     void UpdateQueryNames();
+    bool ResolveFromCache(const std::string &vdns);
+    void AddToCache(const std::string &vdns, const dns_flags &flags,
+                    const std::vector<DnsItem> &ans,
+                    const std::vector<DnsItem> &auth,
+                    const std::vector<DnsItem> &add);
     void UpdateOffsets(DnsItem &item, bool name_update_required);
     void UpdateGWAddress(DnsItem &item);
     void Update(DnsUpdateIpc *update);
@@ -286,7 +292,10 @@ public:
     void IncrStatsFail() { stats_.fail++; }
     void IncrStatsDrop() { stats_.drop++; }
     DnsStats GetStats() { return stats_; }
-    void ClearStats() { stats_.Reset(); }
+    void ClearStats() { stats_.Reset(); cache_.ClearStats(); }
+
+    DnsResponseCache *GetCache() { return &cache_; }
+    void ClearCache() { cache_.Clear(); }
 
 private:
     void ItfUpdate(DBEntryBase *entry);
@@ -312,6 +321,7 @@ private:
     DnsBindQueryMap dns_query_map_;
     DnsVmRequestSet curr_vm_requests_;
     DnsStats stats_;
+    DnsResponseCache cache_;
     uint32_t timeout_;   // milli seconds
     uint32_t max_retries_;
 
@@ -172,6 +172,14 @@ void ServicesSandesh::DnsStatsSandesh(std::string ctxt, bool more) {
     dns->set_dns_unsupported(nstats.unsupported);
     dns->set_dns_failures(nstats.fail);
     dns->set_dns_drops(nstats.drop);
+    DnsResponseCache *cache = Agent::GetInstance()->GetDnsProto()->GetCache();
+    DnsResponseCache::Stats cstats = cache->GetStats();
+    dns->set_dns_cache_entries(cache->Size());
+    dns->set_dns_cache_hits(cstats.hits);
+    dns->set_dns_cache_misses(cstats.misses);
+    dns->set_dns_cache_inserts(cstats.inserts);
+    dns->set_dns_cache_evictions(cstats.evictions);
+    dns->set_dns_cache_invalidations(cstats.invalidations);
     dns->set_context(ctxt);
     dns->set_more(more);
     dns->Response();
@@ -405,6 +405,8 @@ TEST_F(DnsTesting, VirtualDnsReqTest) {
     CHECK_CONDITION(stats.fail < 1);
     CHECK_STATS(stats, 8, 4, 2, 1, 1, 0);
 
+    // the first response is cached, flush it so that the query is sent
+    Agent::GetInstance()->GetDnsProto()->ClearCache();
     Agent::GetInstance()->GetDnsProto()->SetTimeout(30);
     Agent::GetInstance()->GetDnsProto()->SetMaxRetries(1);
     SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, a_items);
@@ -440,6 +442,154 @@ TEST_F(DnsTesting, VirtualDnsReqTest) {
     Agent::GetInstance()->GetDnsProto()->ClearStats();
 }
 
+TEST_F(DnsTesting, VirtualDnsCacheTest) {
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+    };
+    IpamInfo ipam_info[] = {
+        {"1.2.3.128", 27, "1.2.3.129"},
+        {"7.8.9.0", 24, "7.8.9.12"},
+        {"1.1.1.0", 24, "1.1.1.200"},
+    };
+
+    char vdns_attr[] = 
+        "<virtual-DNS-data>\
+            <domain-name>test.contrail.juniper.net</domain-name>\
+            <dynamic-records-from-client>true</dynamic-records-from-client>\
+            <record-order>fixed</record-order>\
+            <default-ttl-seconds>120</default-ttl-seconds>\
+        </virtual-DNS-data>\n";
+    char ipam_attr[] = "<network-ipam-mgmt>\n <ipam-dns-method>virtual-dns-server</ipam-dns-method>\n <ipam-dns-server><virtual-dns-server-name>vdns1</virtual-dns-server-name></ipam-dns-server>\n </network-ipam-mgmt>\n";
+
+    CreateVmportEnv(input, 1, 0);
+    client->WaitForIdle();
+    client->Reset();
+    AddVDNS("vdns1", vdns_attr);
+    client->WaitForIdle();
+    AddIPAM("vn1", ipam_info, 3, ipam_attr, "vdns1");
+    client->WaitForIdle();
+
+    IntfCfgAdd(input, 0);
+    WaitForItfUpdate(1);
+
+    DnsResponseCache *cache = Agent::GetInstance()->GetDnsProto()->GetCache();
+    cache->Clear();
+    Agent::GetInstance()->GetDnsProto()->ClearStats();
+
+    // first query goes to the server
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, &a_items[1]);
+    g_xid++;
+    usleep(1000);
+    client->WaitForIdle();
+    SendDnsResp(1, &a_items[1], 1, auth_items, 1, add_items);
+    DnsProto::DnsStats stats;
+    int count = 0;
+    CHECK_CONDITION(stats.resolved < 1);
+    EXPECT_EQ(1U, cache->Size());
+
+    // same query is answered from the cache
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, &a_items[1]);
+    CHECK_CONDITION(stats.resolved < 2);
+    CHECK_STATS(stats, 2, 2, 0, 0, 0, 0);
+    EXPECT_EQ(1U, cache->GetStats().hits);
+
+    // negative response is cached as well
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, &a_items[2]);
+    g_xid++;
+    usleep(1000);
+    client->WaitForIdle();
+    SendDnsResp(1, &a_items[2], 1, auth_items, 1, add_items, true);
+    CHECK_CONDITION(stats.fail < 1);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, &a_items[2]);
+    CHECK_CONDITION(stats.fail < 2);
+    CHECK_STATS(stats, 4, 2, 0, 0, 2, 0);
+    EXPECT_EQ(2U, cache->GetStats().hits);
+    EXPECT_EQ(2U, cache->Size());
+
+    // update to the virtual DNS flushes its entries
+    SendDnsReq(DNS_OPCODE_UPDATE, GetItfId(0), 1, a_items, true);
+    client->WaitForIdle();
+    CHECK_CONDITION(stats.resolved < 3);
+    EXPECT_EQ(0U, cache->Size());
+    EXPECT_EQ(2U, cache->GetStats().invalidations);
+    SendDnsReq(DNS_OPCODE_UPDATE, GetItfId(0), 1, a_items, false);
+    client->WaitForIdle();
+    CHECK_CONDITION(stats.resolved < 4);
+
+    client->Reset();
+    DelIPAM("vn1", "vdns1"); 
+    client->WaitForIdle();
+    DelVDNS("vdns1"); 
+    client->WaitForIdle();
+
+    client->Reset();
+    DeleteVmportEnv(input, 1, 1, 0); 
+    client->WaitForIdle();
+
+    IntfCfgDel(input, 0);
+    WaitForItfUpdate(0);
+    Agent::GetInstance()->GetDnsProto()->ClearStats();
+}
+
+TEST_F(DnsTesting, DnsResponseCacheTest) {
+    DnsResponseCache cache;
+    cache.set_max_entries(2);
+    dns_flags flags;
+    memset(&flags, 0, sizeof(flags));
+    std::vector<DnsItem> ans, auth, add, none;
+    ans.push_back(a_items[0]);
+
+    // LRU entry is evicted when the cache is full
+    cache.Add("vdns1", names[0], DNS_A_RECORD, flags, ans, none, none);
+    cache.Add("vdns1", names[1], DNS_A_RECORD, flags, ans, none, none);
+    EXPECT_TRUE(cache.Lookup("vdns1", names[0], DNS_A_RECORD,
+                             flags, ans, auth, add));
+    cache.Add("vdns2", names[2], DNS_A_RECORD, flags, ans, none, none);
+    EXPECT_EQ(2U, cache.Size());
+    EXPECT_EQ(1U, cache.GetStats().evictions);
+    EXPECT_FALSE(cache.Lookup("vdns1", names[1], DNS_A_RECORD,
+                              flags, ans, auth, add));
+    EXPECT_FALSE(cache.Lookup("vdns1", names[0], DNS_PTR_RECORD,
+                              flags, ans, auth, add));
+
+    cache.Invalidate("vdns1");
+    EXPECT_EQ(1U, cache.Size());
+    EXPECT_TRUE(cache.Lookup("vdns2", names[2], DNS_A_RECORD,
+                             flags, ans, auth, add));
+
+    // entries expire with the smallest TTL in the response
+    ans.clear();
+    ans.push_back(a_items[0]);
+    ans[0].ttl = 1;
+    cache.Add("vdns2", names[3], DNS_A_RECORD, flags, ans, none, none);
+    EXPECT_TRUE(cache.Lookup("vdns2", names[3], DNS_A_RECORD,
+                             flags, ans, auth, add));
+    usleep(1100000);
+    EXPECT_FALSE(cache.Lookup("vdns2", names[3], DNS_A_RECORD,
+                              flags, ans, auth, add));
+
+    // server failures and zero TTLs are not cached
+    ans[0].ttl = 0;
+    cache.Add("vdns2", names[4], DNS_A_RECORD, flags, ans, none, none);
+    flags.ret = DNS_ERR_SERVER_FAIL;
+    ans[0].ttl = 100;
+    cache.Add("vdns2", names[4], DNS_PTR_RECORD, flags, ans, none, none);
+    EXPECT_EQ(1U, cache.Size());
+
+    // negative responses use the SOA minimum TTL
+    flags.ret = DNS_ERR_NO_SUCH_NAME;
+    std::vector<DnsItem> soa;
+    soa.push_back(add_items[0]);
+    soa[0].ttl = 1;
+    cache.Add("vdns2", names[4], DNS_A_RECORD, flags, none, soa, none);
+    EXPECT_TRUE(cache.Lookup("vdns2", names[4], DNS_A_RECORD,
+                             flags, ans, auth, add));
+    EXPECT_EQ(DNS_ERR_NO_SUCH_NAME, (int)flags.ret);
+    usleep(1100000);
+    EXPECT_FALSE(cache.Lookup("vdns2", names[4], DNS_A_RECORD,
+                              flags, ans, auth, add));
+}
+
 TEST_F(DnsTesting, DnsXmppTest) {
     struct PortInfo input[] = {
         {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
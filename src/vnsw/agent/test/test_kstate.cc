@@ -9,6 +9,7 @@
 #include "oper/tunnel_nh.h"
 #include "xmpp/test/xmpp_test_util.h"
 #include "ksync/ksync_sock_user.h"
+#include "ksync/mpls_ksync.h"
 
 #define vm1_ip "1.1.1.1"
 #define vm2_ip "2.1.1.1"
@@ -278,6 +279,64 @@ TEST_F(KStateTest, MplsDumpTest) {
     DeletePorts();
 }
 
+// Port creation generates a burst of KSync operations. Verify that they are
+// coalesced into bulk netlink messages and every message is acked
+TEST_F(KStateTest, KSyncBulkTxTest) {
+    KSyncSock *sock = KSyncSock::Get(0);
+    uint64_t sends = sock->tx_send_count();
+    uint64_t msgs = sock->tx_msg_count();
+    uint64_t bulk_msgs = KSyncSockTypeMap::BulkMsgCount();
+
+    CreatePorts(0, 0, 0);
+    client->WaitForIdle(2);
+    EXPECT_TRUE(KSyncSock::IsBulkMode());
+    EXPECT_GT((sock->tx_msg_count() - msgs), (sock->tx_send_count() - sends));
+    EXPECT_GT(KSyncSockTypeMap::BulkMsgCount(), bulk_msgs);
+    WAIT_FOR(1000, 1000, (0U == sock->InFlightCount()));
+
+    DeletePorts();
+    WAIT_FOR(1000, 1000, (0U == sock->InFlightCount()));
+}
+
+// Audit of MPLS labels with KSyncSockTypeMap standing in for a kernel that
+// kept its state across an agent restart. Labels added back by the agent are
+// taken over, and labels that are not added back are deleted by the sweep.
+TEST_F(KStateTest, MplsAuditTest) {
+    KSyncSockTypeMap *sock = KSyncSockTypeMap::GetKSyncSockTypeMap();
+    MplsKSyncObject *obj = MplsKSyncObject::GetKSyncObject();
+
+    CreatePorts(0, 0, 0);
+    KSyncSockTypeMap::ksync_map_mpls kernel_map = sock->mpls_map;
+    DeletePorts();
+    WAIT_FOR(1000, 1000, (0 == KSyncSockTypeMap::MplsCount()));
+
+    for (KSyncSockTypeMap::ksync_map_mpls::iterator it = kernel_map.begin();
+         it != kernel_map.end(); ++it) {
+        sock->mpls_map[it->first] = it->second;
+        obj->AuditAdd(new MplsKSyncEntry(&it->second));
+    }
+    EXPECT_EQ(static_cast<size_t>(MAX_TEST_MPLS), obj->audit_count());
+
+    CreatePorts(0, 0, 0);
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (0U == obj->audit_count()));
+
+    // Label in kernel that agent does not add back
+    vr_mpls_req stale(kernel_map.begin()->second);
+    stale.set_mr_label(MplsTable::kStartLabel + 1000);
+    sock->mpls_map[stale.get_mr_label()] = stale;
+    obj->AuditAdd(new MplsKSyncEntry(&stale));
+    EXPECT_EQ(1U, obj->audit_count());
+
+    obj->AuditSweep();
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (MAX_TEST_MPLS == KSyncSockTypeMap::MplsCount()));
+    WAIT_FOR(1000, 1000, (0U == obj->audit_count()));
+
+    DeletePorts();
+    WAIT_FOR(1000, 1000, (0 == KSyncSockTypeMap::MplsCount()));
+}
+
 TEST_F(KStateTest, MplsGetTest) {
     int mpls_count = 0;
     TestMplsKState::Init();
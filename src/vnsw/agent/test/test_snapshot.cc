@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <stdio.h>
+
+#include "testing/gunit.h"
+
+#include <base/logging.h>
+#include <base/util.h>
+#include <io/event_manager.h>
+#include <tbb/task.h>
+#include <base/task.h>
+
+#include <cmn/agent_cmn.h>
+
+#include "cfg/cfg_init.h"
+#include "oper/operdb_init.h"
+#include "controller/controller_init.h"
+#include "controller/controller_snapshot.h"
+#include "pkt/pkt_init.h"
+#include "services/services_init.h"
+#include "ksync/ksync_init.h"
+#include "oper/interface.h"
+#include "oper/nexthop.h"
+#include "oper/tunnel_nh.h"
+#include "route/route.h"
+#include "oper/vrf.h"
+#include "oper/vn.h"
+#include "openstack/instance_service_server.h"
+#include "test_cmn_util.h"
+#include "vr_types.h"
+
+void RouterIdDepInit() {
+}
+
+class TestBgpPeer : public Peer {
+public:
+    TestBgpPeer() : Peer(BGP_PEER, "TestSnapshotBgp") { }
+};
+
+class AgentSnapshotTest : public ::testing::Test {
+protected:
+    static const int kRoutes = 1000;
+
+    AgentSnapshotTest() : file_("agent_snapshot_test.xml"),
+        server_ip_(Ip4Address::from_string("10.1.1.11")) {
+    }
+
+    virtual void SetUp() {
+        client->Reset();
+        AddVrf("vrf1");
+        AddVn("vn1", 1);
+        AddLink("virtual-network", "vn1", "routing-instance", "vrf1");
+        client->WaitForIdle();
+        ASSERT_TRUE(VrfFind("vrf1"));
+    }
+
+    virtual void TearDown() {
+        DelLink("virtual-network", "vn1", "routing-instance", "vrf1");
+        DelVn("vn1");
+        DelVrf("vrf1");
+        client->WaitForIdle();
+        WAIT_FOR(100, 1000, (VrfFind("vrf1") == false));
+        remove(file_.c_str());
+    }
+
+    static Ip4Address RouteAddress(int idx) {
+        return Ip4Address(0x01010000 + idx);
+    }
+
+    void AddRoutes(const Peer *peer, int count) {
+        SecurityGroupList sg_list;
+        sg_list.push_back(1);
+        for (int idx = 0; idx < count; ++idx) {
+            Inet4UnicastAgentRouteTable::AddRemoteVmRouteReq(peer, "vrf1",
+                RouteAddress(idx), 32, server_ip_,
+                TunnelType::DefaultTypeBmap(), 1000 + idx, "vn1", sg_list);
+        }
+        client->WaitForIdle();
+    }
+
+    void DeleteRoutes(const Peer *peer, int count) {
+        for (int idx = 0; idx < count; ++idx) {
+            Inet4UnicastAgentRouteTable::DeleteReq(peer, "vrf1",
+                                                   RouteAddress(idx), 32);
+        }
+        client->WaitForIdle();
+    }
+
+    std::string file_;
+    Ip4Address server_ip_;
+    TestBgpPeer bgp_peer_;
+};
+
+TEST_F(AgentSnapshotTest, SaveLoad) {
+    AddRoutes(&bgp_peer_, kRoutes);
+    EXPECT_TRUE(RouteFind("vrf1", RouteAddress(kRoutes - 1), 32));
+
+    AgentSnapshot snapshot(file_);
+    EXPECT_TRUE(snapshot.Save());
+
+    // Emulate a restart by removing the routes and the configuration.
+    DeleteRoutes(&bgp_peer_, kRoutes);
+    DelLink("virtual-network", "vn1", "routing-instance", "vrf1");
+    DelVn("vn1");
+    DelVrf("vrf1");
+    client->WaitForIdle();
+    WAIT_FOR(100, 1000, (VrfFind("vrf1") == false));
+    EXPECT_FALSE(VnFind(1));
+
+    // Restart-to-forwarding time is the time it takes from loading the
+    // snapshot until the last route is in the route table.
+    AgentSnapshot restored(file_);
+    uint64_t start = UTCTimestampUsec();
+    EXPECT_TRUE(restored.Load());
+    WAIT_FOR(1000, 10000, RouteFind("vrf1", RouteAddress(kRoutes - 1), 32));
+    uint64_t elapsed = UTCTimestampUsec() - start;
+    LOG(DEBUG, kRoutes << " routes restored from snapshot in " << elapsed <<
+        " usec");
+
+    EXPECT_TRUE(VnFind(1));
+    EXPECT_EQ(0U, restored.pending_route_count());
+    EXPECT_EQ(static_cast<size_t>(kRoutes), restored.route_count());
+    for (int idx = 0; idx < kRoutes; ++idx) {
+        Inet4UnicastRouteEntry *rt = RouteGet("vrf1", RouteAddress(idx), 32);
+        ASSERT_TRUE(rt != NULL);
+        const AgentPath *path = rt->GetActivePath();
+        EXPECT_EQ(Peer::SNAPSHOT_PEER, path->GetPeer()->GetType());
+        EXPECT_EQ(static_cast<uint32_t>(1000 + idx), path->GetLabel());
+        EXPECT_EQ("vn1", path->GetDestVnName());
+        EXPECT_EQ(1U, path->GetSecurityGroupList().size());
+        const TunnelNH *nh =
+            static_cast<const TunnelNH *>(path->GetNextHop());
+        EXPECT_EQ(server_ip_, *nh->GetDip());
+    }
+
+    // Routes from the control node take precedence over the snapshot.
+    AddRoutes(&bgp_peer_, 1);
+    Inet4UnicastRouteEntry *rt = RouteGet("vrf1", RouteAddress(0), 32);
+    EXPECT_EQ(Peer::BGP_PEER, rt->GetActivePath()->GetPeer()->GetType());
+
+    restored.DeleteStaleRoutes();
+    client->WaitForIdle();
+    EXPECT_TRUE(RouteFind("vrf1", RouteAddress(0), 32));
+    EXPECT_FALSE(RouteFind("vrf1", RouteAddress(1), 32));
+    EXPECT_FALSE(RouteFind("vrf1", RouteAddress(kRoutes - 1), 32));
+    DeleteRoutes(&bgp_peer_, 1);
+}
+
+// Routes are held back until the configuration creates their VRF.
+TEST_F(AgentSnapshotTest, PendingVrf) {
+    AddRoutes(&bgp_peer_, 10);
+    AgentSnapshot snapshot(file_);
+    EXPECT_TRUE(snapshot.Save());
+    DeleteRoutes(&bgp_peer_, 10);
+
+    // Drop the configuration from the file, keeping the routes.
+    pugi::xml_document doc;
+    ASSERT_TRUE(doc.load_file(file_.c_str()));
+    pugi::xml_node root = doc.child("agent-snapshot");
+    root.remove_child("config");
+    ASSERT_TRUE(doc.save_file(file_.c_str()));
+
+    DelLink("virtual-network", "vn1", "routing-instance", "vrf1");
+    DelVrf("vrf1");
+    client->WaitForIdle();
+    WAIT_FOR(100, 1000, (VrfFind("vrf1") == false));
+
+    AgentSnapshot restored(file_);
+    EXPECT_TRUE(restored.Load());
+    client->WaitForIdle();
+    EXPECT_EQ(10U, restored.pending_route_count());
+    EXPECT_FALSE(RouteFind("vrf1", RouteAddress(0), 32));
+
+    AddVrf("vrf1");
+    AddLink("virtual-network", "vn1", "routing-instance", "vrf1");
+    client->WaitForIdle();
+    WAIT_FOR(100, 1000, RouteFind("vrf1", RouteAddress(9), 32));
+    EXPECT_EQ(0U, restored.pending_route_count());
+    EXPECT_EQ(10U, restored.route_count());
+
+    restored.DeleteStaleRoutes();
+    client->WaitForIdle();
+    EXPECT_FALSE(RouteFind("vrf1", RouteAddress(0), 32));
+}
+
+// The file is written by a task of its own, after SaveAsync returns.
+TEST_F(AgentSnapshotTest, SaveAsync) {
+    AddRoutes(&bgp_peer_, 10);
+    AgentSnapshot snapshot(file_);
+    snapshot.SaveAsync();
+    client->WaitForIdle();
+    DeleteRoutes(&bgp_peer_, 10);
+
+    pugi::xml_document doc;
+    ASSERT_TRUE(doc.load_file(file_.c_str()));
+    pugi::xml_node routes = doc.child("agent-snapshot").child("routes");
+    int count = 0;
+    for (pugi::xml_node node = routes.child("route"); node;
+         node = node.next_sibling("route")) {
+        count++;
+    }
+    EXPECT_EQ(10, count);
+}
+
+TEST_F(AgentSnapshotTest, BadVersion) {
+    pugi::xml_document doc;
+    doc.append_child("agent-snapshot").append_attribute("version") =
+        AgentSnapshot::kVersion + 1;
+    ASSERT_TRUE(doc.save_file(file_.c_str()));
+
+    AgentSnapshot snapshot(file_);
+    EXPECT_FALSE(snapshot.Load());
+    remove(file_.c_str());
+    EXPECT_FALSE(snapshot.Load());
+}
+
+int main(int argc, char **argv) {
+    GETUSERARGS();
+    client = TestInit(init_file, ksync_init, true, false);
+
+    return RUN_ALL_TESTS();
+}
@@ -40,6 +40,7 @@
 
 #include "controller/controller_peer.h" 
 #include "controller/controller_export.h" 
+#include "controller/controller_export_batch.h"
 #include "controller/controller_vrf_export.h" 
 #include "controller/controller_types.h" 
 
@@ -106,11 +107,26 @@ private:
 
 class ControlNodeMockBgpXmppPeer {
 public:
-    ControlNodeMockBgpXmppPeer() : channel_ (NULL), rx_count_(0) {
+    ControlNodeMockBgpXmppPeer() : channel_ (NULL), rx_count_(0),
+        unsubscribed_rx_count_(0) {
     }
 
     void ReceiveUpdate(const XmppStanza::XmppMessage *msg) {
         rx_count_++;
+        if (msg->type != XmppStanza::IQ_STANZA) {
+            return;
+        }
+        // The control-node drops route updates of unsubscribed vrfs
+        const XmppStanza::XmppMessageIq *iq =
+            static_cast<const XmppStanza::XmppMessageIq *>(msg);
+        if (iq->action.compare("subscribe") == 0) {
+            unsubscribed_.erase(iq->node);
+        } else if (iq->action.compare("unsubscribe") == 0) {
+            unsubscribed_.insert(iq->node);
+        } else if (iq->action.compare("collection") == 0 &&
+                   unsubscribed_.count(iq->node)) {
+            unsubscribed_rx_count_++;
+        }
     }    
 
     void HandleXmppChannelEvent(XmppChannel *channel,
@@ -147,11 +163,14 @@ public:
     }
 
     size_t Count() const { return rx_count_; }
+    size_t UnsubscribedCount() const { return unsubscribed_rx_count_; }
     virtual ~ControlNodeMockBgpXmppPeer() {
     }
 private:
     XmppChannel *channel_;
     size_t rx_count_;
+    std::set<std::string> unsubscribed_;
+    size_t unsubscribed_rx_count_;
 };
 
 
@@ -585,6 +604,95 @@ TEST_F(AgentXmppUnitTest, Connection) {
 
 }
 
+// Routes exported in a burst must be batched into multi-item messages
+TEST_F(AgentXmppUnitTest, RouteExportBatch) {
+
+    client->Reset();
+    client->WaitForIdle();
+
+    XmppConnectionSetUp();
+    //wait for connection establishment
+    WAIT_FOR(100, 10000, (sconnection->GetStateMcState() == xmsm::ESTABLISHED));
+    WAIT_FOR(100, 10000, (cchannel->GetPeerState() == xmps::READY));
+
+    //expect subscribe for __default__ at the mock server
+    WAIT_FOR(100, 10000, (mock_peer.get()->Count() == 1));
+
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+        {"vnet2", 2, "1.1.1.2", "00:00:00:01:01:02", 1, 2},
+        {"vnet3", 3, "1.1.1.3", "00:00:00:01:01:03", 1, 3},
+        {"vnet4", 4, "1.1.1.4", "00:00:00:01:01:04", 1, 4},
+    };
+
+    RouteExportBatcher *batcher = bgp_peer.get()->export_batcher();
+    uint64_t messages = batcher->messages_sent();
+    uint64_t routes = batcher->routes_sent();
+
+    VxLanNetworkIdentifierMode(false);
+    client->WaitForIdle();
+    CreateVmportEnv(input, 4);
+    client->WaitForIdle();
+
+    //4 inet and 4 layer2 routes
+    WAIT_FOR(100, 10000, ((batcher->routes_sent() - routes) >= 8));
+    WAIT_FOR(100, 10000, (batcher->PendingCount() == 0));
+    EXPECT_LT((batcher->messages_sent() - messages),
+              (batcher->routes_sent() - routes));
+    EXPECT_GT(batcher->RoutesPerMessage(), 1.0);
+
+    DeleteVmportEnv(input, 4, true);
+    client->WaitForIdle();
+    WAIT_FOR(100, 10000, (batcher->PendingCount() == 0));
+    EXPECT_FALSE(VmPortFind(input, 0));
+
+    xc->ConfigUpdate(new XmppConfigData());
+    client->WaitForIdle(5);
+}
+
+// Routes of a vrf still in the export batch when the vrf is deleted must
+// be sent before the unsubscribe
+TEST_F(AgentXmppUnitTest, RouteExportBatchVrfDelete) {
+
+    client->Reset();
+    client->WaitForIdle();
+
+    XmppConnectionSetUp();
+    //wait for connection establishment
+    WAIT_FOR(100, 10000, (sconnection->GetStateMcState() == xmsm::ESTABLISHED));
+    WAIT_FOR(100, 10000, (cchannel->GetPeerState() == xmps::READY));
+
+    //expect subscribe for __default__ at the mock server
+    WAIT_FOR(100, 10000, (mock_peer.get()->Count() == 1));
+
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+        {"vnet2", 2, "1.1.1.2", "00:00:00:01:01:02", 1, 2},
+    };
+
+    // Keep the routes in the batch until the vrf is gone
+    RouteExportBatcher::set_batch_interval(2000);
+    RouteExportBatcher *batcher = bgp_peer.get()->export_batcher();
+    CreateVmportEnv(input, 2);
+    client->WaitForIdle();
+    EXPECT_LT(0U, batcher->PendingCount());
+
+    DeleteVmportEnv(input, 2, true);
+    client->WaitForIdle();
+    EXPECT_FALSE(VrfFind("vrf1"));
+    EXPECT_EQ(0U, batcher->PendingCount());
+
+    // Nothing of the vrf reaches the control-node after the unsubscribe
+    usleep(3000 * 1000);
+    client->WaitForIdle();
+    EXPECT_EQ(0U, mock_peer.get()->UnsubscribedCount());
+
+    RouteExportBatcher::set_batch_interval(
+        RouteExportBatcher::kBatchIntervalMsec);
+    xc->ConfigUpdate(new XmppConfigData());
+    client->WaitForIdle(5);
+}
+
 TEST_F(AgentXmppUnitTest, CfgServerSelection) {
 
     client->Reset();
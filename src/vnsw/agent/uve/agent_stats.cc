@@ -165,8 +165,10 @@ void AgentStatsCollector::DelVrfStatsEntry(const VrfEntry *vrf) {
 }
 
 bool AgentStatsCollector::Run() {
-    SendIntfBulkGet();
+    // VRF stats are read ahead of interface stats, so that the UVEs sent
+    // from the interface stats handler carry the VRF stats of this interval
     SendVrfStatsBulkGet();
+    SendIntfBulkGet();
     SendDropStatsBulkGet();
     return true;
 }
@@ -218,7 +220,6 @@ void IntfStatsIoContext::ErrorHandler(int err) {
 void VrfStatsIoContext::Handler() {
     AgentStatsCollector *collector = AgentUve::GetInstance()->GetStatsCollector();
     collector->vrf_stats_responses_++;
-    UveClient::GetInstance()->SendVnStats();
     /* Reset the marker for query during next timer interval, if there is
      * no additional records for the current query */
     AgentStatsSandeshContext *ctx = AgentUve::GetInstance()->
@@ -275,6 +276,10 @@ void AgentStatsSandeshContext::IfMsgHandler(vr_interface_req *req) {
     if (!stats) {
         return;
     }
+    bool changed = (stats->in_pkts != (uint64_t)req->get_vifr_ipackets() ||
+                    stats->in_bytes != (uint64_t)req->get_vifr_ibytes() ||
+                    stats->out_pkts != (uint64_t)req->get_vifr_opackets() ||
+                    stats->out_bytes != (uint64_t)req->get_vifr_obytes());
     if (intf->GetType() == Interface::VMPORT) {
         AgentStats::GetInstance()->IncrInPkts(req->get_vifr_ipackets() - stats->in_pkts);
         AgentStats::GetInstance()->IncrInBytes(req->get_vifr_ibytes() - stats->in_bytes);
@@ -288,6 +293,31 @@ void AgentStatsSandeshContext::IfMsgHandler(vr_interface_req *req) {
     stats->out_bytes = req->get_vifr_obytes();
     stats->speed = req->get_vifr_speed();
     stats->duplexity = req->get_vifr_duplex();
+    if (changed) {
+        UveClient::GetInstance()->IntfStatsChanged(intf);
+    }
+}
+
+// Compare with the values last read from the kernel
+static bool VrfStatsChanged(const AgentStatsCollector::VrfStats *stats,
+                            const vr_vrf_stats_req *req) {
+    return (stats->k_discards != (uint64_t)req->get_vsr_discards() ||
+        stats->k_resolves != (uint64_t)req->get_vsr_resolves() ||
+        stats->k_receives != (uint64_t)req->get_vsr_receives() ||
+        stats->k_udp_tunnels != (uint64_t)req->get_vsr_udp_tunnels() ||
+        stats->k_gre_mpls_tunnels != (uint64_t)req->get_vsr_gre_mpls_tunnels() ||
+        stats->k_udp_mpls_tunnels != (uint64_t)req->get_vsr_udp_mpls_tunnels() ||
+        stats->k_l2_mcast_composites !=
+            (uint64_t)req->get_vsr_l2_mcast_composites() ||
+        stats->k_l3_mcast_composites !=
+            (uint64_t)req->get_vsr_l3_mcast_composites() ||
+        stats->k_ecmp_composites != (uint64_t)req->get_vsr_ecmp_composites() ||
+        stats->k_fabric_composites !=
+            (uint64_t)req->get_vsr_fabric_composites() ||
+        stats->k_multi_proto_composites !=
+            (uint64_t)req->get_vsr_multi_proto_composites() ||
+        stats->k_encaps != (uint64_t)req->get_vsr_encaps() ||
+        stats->k_l2_encaps != (uint64_t)req->get_vsr_l2_encaps());
 }
 
 void AgentStatsSandeshContext::VrfStatsMsgHandler(vr_vrf_stats_req *req) {
@@ -347,6 +377,9 @@ void AgentStatsSandeshContext::VrfStatsMsgHandler(vr_vrf_stats_req *req) {
          * notification
          */
         if (req->get_vsr_vrf() != collector->GetNamelessVrfId()) { 
+            if (VrfStatsChanged(stats, req)) {
+                UveClient::GetInstance()->VrfStatsChanged(vrf);
+            }
             stats->k_discards = req->get_vsr_discards();
             stats->k_resolves = req->get_vsr_resolves();
             stats->k_receives = req->get_vsr_receives();
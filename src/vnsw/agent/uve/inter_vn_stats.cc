@@ -5,6 +5,7 @@
 #include "inter_vn_stats.h"
 #include <oper/interface.h>
 #include <oper/mirror_table.h>
+#include <uve/uve_client.h>
 
 using namespace std;
 
@@ -97,6 +98,8 @@ void InterVnStatsCollector::UpdateVnStats(FlowEntry *fe, uint64_t bytes,
             VnStatsUpdateInternal(dst_vn, src_vn, bytes, pkts, true);
         }
     }
+    UveClient::GetInstance()->MarkVnDirty(src_vn, UVE_DIRTY_INTER_VN);
+    UveClient::GetInstance()->MarkVnDirty(dst_vn, UVE_DIRTY_INTER_VN);
     //PrintAll();
 }
 
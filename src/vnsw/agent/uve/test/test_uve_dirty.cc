@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <cfg/cfg_init.h>
+#include <cfg/cfg_interface.h>
+#include <oper/operdb_init.h>
+#include <controller/controller_init.h>
+#include <pkt/pkt_init.h>
+#include <services/services_init.h>
+#include <ksync/ksync_init.h>
+#include <cmn/agent_cmn.h>
+#include <base/task.h>
+#include <io/event_manager.h>
+#include <base/util.h>
+#include <ifmap_agent_parser.h>
+#include <ifmap_agent_table.h>
+#include <oper/vn.h>
+#include <oper/vm.h>
+#include <oper/interface.h>
+#include <oper/mirror_table.h>
+#include <uve/uve_init.h>
+#include <uve/uve_client.h>
+#include <uve/agent_stats.h>
+
+#include "testing/gunit.h"
+#include "test_cmn_util.h"
+#include "vr_types.h"
+
+using namespace std;
+
+void RouterIdDepInit() {
+}
+
+class UveDirtyTest : public ::testing::Test {
+};
+
+// VM and VN stats are framed only when marked dirty
+TEST_F(UveDirtyTest, SendOnlyDirty_1) {
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+    };
+    UveClient *uve = UveClient::GetInstance();
+
+    CreateVmportEnv(input, 1);
+    client->WaitForIdle();
+    EXPECT_TRUE(VmPortActive(input, 0));
+
+    // New VM and VN are framed in the next interval
+    EXPECT_EQ(1U, uve->DirtyVmCount());
+    EXPECT_EQ(1U, uve->DirtyVnCount());
+    uve->SendVnStats();
+    uve->SendVmStats();
+    EXPECT_EQ(0U, uve->DirtyVmCount());
+    EXPECT_EQ(0U, uve->DirtyVnCount());
+    EXPECT_LE(1U, uve->last_send_stats().vm_uves);
+    EXPECT_LE(1U, uve->last_send_stats().vn_uves);
+
+    // Nothing changed, nothing is framed or sent
+    uve->SendVnStats();
+    uve->SendVmStats();
+    EXPECT_EQ(0U, uve->last_send_stats().vm_uves);
+    EXPECT_EQ(0U, uve->last_send_stats().vn_uves);
+    EXPECT_EQ(1U, uve->last_send_stats().vm_skipped);
+
+    // Change in interface counters marks both the VM and VN
+    uve->IntfStatsChanged(VmPortGet(1));
+    EXPECT_EQ(1U, uve->DirtyVmCount());
+    EXPECT_EQ(1U, uve->DirtyVnCount());
+    uve->SendVnStats();
+    uve->SendVmStats();
+    EXPECT_EQ(0U, uve->DirtyVmCount());
+    EXPECT_EQ(0U, uve->last_send_stats().vm_skipped);
+
+    // Unknown objects are not tracked
+    uve->MarkVnDirty("unknown-vn", UVE_DIRTY_ALL);
+    uve->MarkVmDirty("unknown-vm", UVE_DIRTY_ALL);
+    EXPECT_EQ(0U, uve->DirtyVmCount());
+    EXPECT_EQ(0U, uve->DirtyVnCount());
+
+    DeleteVmportEnv(input, 1, true);
+    client->WaitForIdle();
+    EXPECT_EQ(0U, uve->DirtyVmCount());
+    EXPECT_EQ(0U, uve->DirtyVnCount());
+}
+
+int main(int argc, char **argv) {
+    GETUSERARGS();
+    client = TestInit(init_file, ksync_init);
+
+    // Stats are sent only from the test
+    AgentUve::GetInstance()->GetStatsCollector()->SetExpiryTime(3600 * 1000);
+    usleep(10000);
+    return RUN_ALL_TESTS();
+}
@@ -189,6 +189,7 @@ void UveClient::VnVmListSend(const string &vn) {
     s_vn.set_virtualmachine_list(vm_list);
     vn_vmlist_updates_++;
     UveVirtualNetworkAgentTrace::Send(s_vn);
+    send_stats_.vn_uves++;
 }
 
 void UveClient::AddVmToVn(const VmPortInterface *intf, const string vm_name, const string vn_name) {
@@ -297,6 +298,8 @@ void UveClient::IntfNotify(DBTablePartBase *partition, DBEntryBase *e) {
                 DelIntfFromVn(intf);
                 DelIntfFromIfStatsTree(intf);
                 DelVmFromVn(vm_port, state->vm_name_, state->vn_name_);
+                MarkVmDirty(state->vm_name_, UVE_DIRTY_ALL);
+                MarkVnDirty(state->vn_name_, UVE_DIRTY_ALL);
             }
             SendVmAndVnMsg(vm_port);
         } else {
@@ -307,6 +310,8 @@ void UveClient::IntfNotify(DBTablePartBase *partition, DBEntryBase *e) {
             AddIntfToVn(vn, intf);
             AddIntfToIfStatsTree(intf);
             AddVmToVn(vm_port, vm->GetCfgName(), vn->GetName());
+            MarkVmDirty(vm->GetCfgName(), UVE_DIRTY_ALL);
+            MarkVnDirty(vn->GetName(), UVE_DIRTY_ALL);
             SendVmAndVnMsg(vm_port);
             if (state) {
                 state->vm_name_ = vm->GetCfgName();
@@ -354,52 +359,73 @@ void UveClient::IntfNotify(DBTablePartBase *partition, DBEntryBase *e) {
     return;
 }
 
+// Only the attributes marked in dirty are framed
 bool UveClient::FrameVmStatsMsg(const VmEntry *vm, L4PortBitmap *vm_port_bitmap,
-                                UveVmEntry *uve) {
+                                UveVmEntry *uve, uint32_t dirty) {
     bool changed = false;
     uve->uve_info.set_name(vm->GetCfgName());
     vector<VmInterfaceAgentStats> s_intf_list;
     vector<VmInterfaceAgentBMap> if_bmap_list;
+    bool if_stats = (dirty & UVE_DIRTY_IF_STATS) != 0;
+    bool port_bitmap = (dirty & UVE_DIRTY_PORT_BITMAP) != 0;
 
     for (VmIntfMap::iterator it = vm_intf_map_.find(vm); 
-         it != vm_intf_map_.end(); it++) {
+         (if_stats || port_bitmap) && it != vm_intf_map_.end(); it++) {
 
         if (it->first != vm) {
             break;
         }
 
-        VmInterfaceAgentStats s_intf;
         const Interface *intf = it->second.intf;
         const VmPortInterface *vm_port =
             static_cast<const VmPortInterface *>(intf);
-        if (FrameIntfStatsMsg(vm_port, &s_intf)) {
-            s_intf_list.push_back(s_intf);
+        if (if_stats) {
+            VmInterfaceAgentStats s_intf;
+            if (FrameIntfStatsMsg(vm_port, &s_intf)) {
+                s_intf_list.push_back(s_intf);
+            }
+        }
+        if (port_bitmap) {
+            PortBucketBitmap map;
+            VmInterfaceAgentBMap vmif_map;
+            L4PortBitmap &port_bmap = it->second.port_bitmap;
+            port_bmap.Encode(map);
+            vmif_map.set_name(vm_port->GetCfgName());
+            vmif_map.set_port_bucket_bmap(map);
+            if_bmap_list.push_back(vmif_map);
         }
-        PortBucketBitmap map;
-        VmInterfaceAgentBMap vmif_map;
-        L4PortBitmap &port_bmap = it->second.port_bitmap;
-        port_bmap.Encode(map);
-        vmif_map.set_name(vm_port->GetCfgName());
-        vmif_map.set_port_bucket_bmap(map);
-        if_bmap_list.push_back(vmif_map);
     }
 
     LastVmUveSet::iterator uve_it = last_vm_uve_set_.find(vm->GetCfgName());
     UveVirtualMachineAgent &last_uve = uve_it->second.uve_info;
-    if (UveVmIfStatsListChanged(s_intf_list, last_uve)) {
-        uve->uve_info.set_if_stats_list(s_intf_list);
-        last_uve.set_if_stats_list(s_intf_list);
-        changed = true;
+    if (if_stats) {
+        if (UveVmIfStatsListChanged(s_intf_list, last_uve)) {
+            uve->uve_info.set_if_stats_list(s_intf_list);
+            last_uve.set_if_stats_list(s_intf_list);
+            changed = true;
+        }
+
+        // Bandwidth has to be recomputed in the next interval till it
+        // drops to zero, even if the counters do not change
+        for (vector<VmInterfaceAgentStats>::const_iterator it =
+             s_intf_list.begin(); it != s_intf_list.end(); ++it) {
+            if (it->get_in_bandwidth_usage() || it->get_out_bandwidth_usage()) {
+                MarkVmDirty(vm->GetCfgName(), UVE_DIRTY_IF_STATS);
+                break;
+            }
+        }
     }
     
-    if (last_uve.get_if_bmap_list() != if_bmap_list) {
-        uve->uve_info.set_if_bmap_list(if_bmap_list);
-        last_uve.set_if_bmap_list(if_bmap_list);
-        changed = true;
-    }
+    if (port_bitmap) {
+        if (last_uve.get_if_bmap_list() != if_bmap_list) {
+            uve->uve_info.set_if_bmap_list(if_bmap_list);
+            last_uve.set_if_bmap_list(if_bmap_list);
+            changed = true;
+        }
 
-    if (SetVmPortBitmap(vm_port_bitmap, uve)) {
-        changed = true;
+        if (SetVmPortBitmap(vm_port_bitmap, uve)) {
+            changed = true;
+        }
     }
     return changed;
 }
@@ -462,16 +488,39 @@ void UveClient::SendVmMsg(const VmEntry *vm, bool stats) {
     bool ret = false;
     UveVmEntry uve;
     if (stats) {
-        ret = FrameVmStatsMsg(vm, &it->second.port_bitmap, &uve);
+        ret = FrameVmStatsMsg(vm, &it->second.port_bitmap, &uve,
+                              UVE_DIRTY_ALL);
     } else {
         ret = FrameVmMsg(vm, &it->second.port_bitmap, &uve);
     }
     if (ret) {
         UveVirtualMachineAgentTrace::Send(uve.uve_info);
+        send_stats_.vm_uves++;
     }
 }
 
-bool UveClient::UveVmVRouterChanged(string &new_value, 
+void UveClient::SendVmStatsMsg(LastVmUveSet::iterator &it) {
+    UveVmEntry &entry = it->second;
+    uint32_t dirty;
+    {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        dirty = entry.dirty;
+        entry.dirty = UVE_DIRTY_NONE;
+    }
+
+    const VmEntry *vm = entry.vm;
+    if (vm == NULL || vm_intf_map_.find(vm) == vm_intf_map_.end()) {
+        return;
+    }
+
+    UveVmEntry uve;
+    if (FrameVmStatsMsg(vm, &entry.port_bitmap, &uve, dirty)) {
+        UveVirtualMachineAgentTrace::Send(uve.uve_info);
+        send_stats_.vm_uves++;
+    }
+}
+
+bool UveClient::UveVmVRouterChanged(const string &new_value, 
                                     const UveVirtualMachineAgent &s_vm) {
     if (!s_vm.__isset.vrouter) {
         return true;
@@ -482,36 +531,45 @@ bool UveClient::UveVmVRouterChanged(string &new_value,
     return true;
 }
 
-bool UveClient::UveVmIfListChanged(vector<VmInterfaceAgent> &new_list, 
+bool UveClient::UveVmIfListChanged(const vector<VmInterfaceAgent> &new_list, 
                                    const UveVirtualMachineAgent &s_vm) {
-    vector<VmInterfaceAgent> old_list = s_vm.get_interface_list();
-    if (new_list != old_list) {
+    if (new_list != s_vm.get_interface_list()) {
         return true;
     }
     return false;
 }
 
-bool UveClient::UveVmIfStatsListChanged(vector<VmInterfaceAgentStats> &new_list,
-                                        const UveVirtualMachineAgent &s_vm) {
-    vector<VmInterfaceAgentStats> old_list = s_vm.get_if_stats_list();
-    if (new_list != old_list) {
+bool UveClient::UveVmIfStatsListChanged
+    (const vector<VmInterfaceAgentStats> &new_list,
+     const UveVirtualMachineAgent &s_vm) {
+    if (new_list != s_vm.get_if_stats_list()) {
         return true;
     }
     return false;
 }
 
+// Send stats for the VMs marked dirty since the previous interval. Invoked
+// once per stats interval, after SendVnStats
 void UveClient::SendVmStats(void) {
-    //Go thru VN and send there stats
-    const VmEntry *prev_vm = NULL;
-    for (VmIntfMap::iterator it = vm_intf_map_.begin();
-         it != vm_intf_map_.end(); ++it) {
-        const VmEntry *vm = it->first;
-        if (prev_vm == vm) {
+    DirtySet dirty_set;
+    {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        dirty_set.swap(dirty_vm_set_);
+    }
+    send_stats_.vm_skipped += last_vm_uve_set_.size() - dirty_set.size();
+
+    for (DirtySet::iterator it = dirty_set.begin(); it != dirty_set.end();
+         ++it) {
+        LastVmUveSet::iterator uve_it = last_vm_uve_set_.find(*it);
+        if (uve_it == last_vm_uve_set_.end()) {
             continue;
         }
-        SendVmMsg(vm, true);
-        prev_vm = vm;
+        SendVmStatsMsg(uve_it);
     }
+
+    last_send_stats_ = send_stats_;
+    total_uves_sent_ += send_stats_.vn_uves + send_stats_.vm_uves;
+    send_stats_.Reset();
 }
 
 void UveClient::DeleteAllIntf(const VmEntry *e) {
@@ -537,7 +595,12 @@ void UveClient::VmNotify(DBTablePartBase *partition, DBEntryBase *e) {
             s_vm.set_name(vm->GetCfgName());
             s_vm.set_deleted(true); 
             UveVirtualMachineAgentTrace::Send(s_vm);
-            last_vm_uve_set_.erase(s_vm.get_name());
+            send_stats_.vm_uves++;
+            {
+                tbb::mutex::scoped_lock lock(dirty_mutex_);
+                last_vm_uve_set_.erase(s_vm.get_name());
+                dirty_vm_set_.erase(s_vm.get_name());
+            }
             if (Agent::GetInstance()->IsTestMode() == false) {
                 VmStat::Stop(state->stat_);
             }
@@ -555,7 +618,12 @@ void UveClient::VmNotify(DBTablePartBase *partition, DBEntryBase *e) {
 
         UveVmEntry uve;
         uve.uve_info.set_name(vm->GetCfgName());
-        last_vm_uve_set_.insert(LastVmUvePair(vm->GetCfgName(), uve));
+        uve.vm = vm;
+        {
+            tbb::mutex::scoped_lock lock(dirty_mutex_);
+            last_vm_uve_set_.insert(LastVmUvePair(vm->GetCfgName(), uve));
+        }
+        MarkVmDirty(vm->GetCfgName(), UVE_DIRTY_ALL);
 
         //Create object to poll for VM stats
         if (Agent::GetInstance()->IsTestMode() == false) { 
@@ -848,115 +916,79 @@ bool UveClient::GetUveVnEntry(const string vn_name, UveVnEntry &entry) {
     return true;
 }
 
+// Interface counters are walked only if interface stats or floating-ip
+// count are dirty
 bool UveClient::FrameVnStatsMsg(const VnEntry *vn,
-                                L4PortBitmap *vn_port_bitmap, UveVnEntry *uve) {
+                                L4PortBitmap *vn_port_bitmap, UveVnEntry *uve,
+                                uint32_t dirty) {
     bool changed = false;
     uve->uve_info.set_name(vn->GetName());
 
-    uint64_t in_pkts = 0;
-    uint64_t in_bytes = 0;
-    uint64_t out_pkts = 0;
-    uint64_t out_bytes = 0;
-
-    int fip_count = 0;
-    for (VnIntfMap::iterator it = vn_intf_map_.find(vn); 
-         it != vn_intf_map_.end(); it++) {
-
-        if (it->first != vn) {
-            break;
-        }
-
-        const Interface *intf = it->second;
-        const VmPortInterface *vm_port = static_cast<const VmPortInterface *>(intf);
-        fip_count += vm_port->GetFloatingIpCount();
-
-        const AgentStatsCollector::IfStats *s = 
-            AgentUve::GetInstance()->GetStatsCollector()->GetIfStats(intf);
-        if (s == NULL) {
-            continue;
-        }
-        in_pkts += s->in_pkts;
-        in_bytes += s->in_bytes;
-        out_pkts += s->out_pkts;
-        out_bytes += s->out_bytes;
-    }
-    
     LastVnUveSet::iterator it = last_vn_uve_set_.find(vn->GetName());
     UveVnEntry &prev_uve_vn_entry = it->second;
     UveVirtualNetworkAgent &last_uve = prev_uve_vn_entry.uve_info;
 
-    uint64_t diff_in_bytes = 0;
-    if (UveVnIfInStatsChanged(in_bytes, in_pkts, last_uve)) {
-        uve->uve_info.set_in_tpkts(in_pkts);
-        uve->uve_info.set_in_bytes(in_bytes);
-        last_uve.set_in_tpkts(in_pkts);
-        last_uve.set_in_bytes(in_bytes);
-        changed = true;
-    }
+    if (dirty & (UVE_DIRTY_IF_STATS | UVE_DIRTY_CONFIG)) {
+        uint64_t in_pkts = 0;
+        uint64_t in_bytes = 0;
+        uint64_t out_pkts = 0;
+        uint64_t out_bytes = 0;
 
-    uint64_t diff_out_bytes = 0;
-    if (UveVnIfOutStatsChanged(out_bytes, out_pkts, last_uve)) {
-        uve->uve_info.set_out_tpkts(out_pkts);
-        uve->uve_info.set_out_bytes(out_bytes);
-        last_uve.set_out_tpkts(out_pkts);
-        last_uve.set_out_bytes(out_bytes);
-        changed = true;
-    }
+        int fip_count = 0;
+        for (VnIntfMap::iterator intf_it = vn_intf_map_.find(vn); 
+             intf_it != vn_intf_map_.end(); intf_it++) {
 
-    uint64_t diff_seconds = 0;
-    uint64_t cur_time = UTCTimestampUsec();
-    bool send_bandwidth = false;
-    uint64_t in_band, out_band;
-    if (it->second.prev_stats_update_time == 0) {
-        in_band = out_band = 0;
-        send_bandwidth = true;
-        it->second.prev_stats_update_time = cur_time;
-    } else {
-        diff_seconds = (cur_time - it->second.prev_stats_update_time) / 
-                       bandwidth_intvl_;
-        if (diff_seconds > 0) {
-            diff_in_bytes = in_bytes - prev_uve_vn_entry.prev_in_bytes;
-            diff_out_bytes = out_bytes - prev_uve_vn_entry.prev_out_bytes;
-            in_band = (diff_in_bytes * 8)/diff_seconds;
-            out_band = (diff_out_bytes * 8)/diff_seconds;
-            it->second.prev_stats_update_time = cur_time;
-            prev_uve_vn_entry.prev_in_bytes = in_bytes;
-            prev_uve_vn_entry.prev_out_bytes = out_bytes;
-            send_bandwidth = true;
+            if (intf_it->first != vn) {
+                break;
+            }
+
+            const Interface *intf = intf_it->second;
+            const VmPortInterface *vm_port =
+                static_cast<const VmPortInterface *>(intf);
+            fip_count += vm_port->GetFloatingIpCount();
+
+            const AgentStatsCollector::IfStats *s = 
+                AgentUve::GetInstance()->GetStatsCollector()->GetIfStats(intf);
+            if (s == NULL) {
+                continue;
+            }
+            in_pkts += s->in_pkts;
+            in_bytes += s->in_bytes;
+            out_pkts += s->out_pkts;
+            out_bytes += s->out_bytes;
         }
-    }
-    if (send_bandwidth && UveVnInBandChanged(in_band, last_uve)) {
-        uve->uve_info.set_in_bandwidth_usage(in_band);
-        last_uve.set_in_bandwidth_usage(in_band);
-        changed = true;
-    }
 
-    if (send_bandwidth && UveVnOutBandChanged(out_band, last_uve)) {
-        uve->uve_info.set_out_bandwidth_usage(out_band);
-        last_uve.set_out_bandwidth_usage(out_band);
-        changed = true;
-    }
+        if ((dirty & UVE_DIRTY_IF_STATS) &&
+            FrameVnIfStats(it, in_pkts, in_bytes, out_pkts, out_bytes,
+                           &uve->uve_info)) {
+            changed = true;
+        }
 
-    int acl_rule_count;
-    if (vn->GetAcl()) {
-        acl_rule_count = vn->GetAcl()->Size();
-    } else {
-        acl_rule_count = 0;
-    }
-    /* We have not registered for ACL notification. So total_acl_rules
-     * field is updated during stats updation
-     */
-    if (UveVnAclRuleCountChanged(acl_rule_count, last_uve)) {
-        uve->uve_info.set_total_acl_rules(acl_rule_count);
-        last_uve.set_total_acl_rules(acl_rule_count);
-        changed = true;
+        if ((dirty & UVE_DIRTY_CONFIG) &&
+            UpdateVnFipCount(it, fip_count, &uve->uve_info)) {
+            changed = true;
+        }
     }
 
-    if (UpdateVnFlowCount(vn, it, &uve->uve_info)) {
-        changed = true;
+    if (dirty & UVE_DIRTY_CONFIG) {
+        int acl_rule_count;
+        if (vn->GetAcl()) {
+            acl_rule_count = vn->GetAcl()->Size();
+        } else {
+            acl_rule_count = 0;
+        }
+        /* We have not registered for ACL notification. So total_acl_rules
+         * field is updated during stats updation
+         */
+        if (UveVnAclRuleCountChanged(acl_rule_count, last_uve)) {
+            uve->uve_info.set_total_acl_rules(acl_rule_count);
+            last_uve.set_total_acl_rules(acl_rule_count);
+            changed = true;
+        }
     }
 
-    if (UpdateVnFipCount(it, fip_count, &uve->uve_info)) {
+    if ((dirty & UVE_DIRTY_FLOW) &&
+        UpdateVnFlowCount(vn, it, &uve->uve_info)) {
         changed = true;
     }
 
@@ -964,16 +996,18 @@ bool UveClient::FrameVnStatsMsg(const VnEntry *vn,
      * removed from VN. That message has only two fields set - vn name
      * and virtualmachine_list */
 
-    if (PopulateInterVnStats(vn->GetName(), &uve->uve_info)) {
+    if ((dirty & UVE_DIRTY_INTER_VN) &&
+        PopulateInterVnStats(vn->GetName(), &uve->uve_info)) {
         changed = true;
     }
 
-    if (SetVnPortBitmap(vn_port_bitmap, uve)) {
+    if ((dirty & UVE_DIRTY_PORT_BITMAP) &&
+        SetVnPortBitmap(vn_port_bitmap, uve)) {
         changed = true;
     }
 
     VrfEntry *vrf = vn->GetVrf();
-    if (vrf) {
+    if ((dirty & UVE_DIRTY_VRF_STATS) && vrf) {
         UveVrfStats vrf_stats;
         vector<UveVrfStats> vlist;
 
@@ -1005,6 +1039,75 @@ bool UveClient::FrameVnStatsMsg(const VnEntry *vn,
     return changed;
 }
 
+bool UveClient::FrameVnIfStats(LastVnUveSet::iterator &it, uint64_t in_pkts,
+                               uint64_t in_bytes, uint64_t out_pkts,
+                               uint64_t out_bytes,
+                               UveVirtualNetworkAgent *s_vn) {
+    bool changed = false;
+    UveVnEntry &prev_uve_vn_entry = it->second;
+    UveVirtualNetworkAgent &last_uve = prev_uve_vn_entry.uve_info;
+
+    uint64_t diff_in_bytes = 0;
+    if (UveVnIfInStatsChanged(in_bytes, in_pkts, last_uve)) {
+        s_vn->set_in_tpkts(in_pkts);
+        s_vn->set_in_bytes(in_bytes);
+        last_uve.set_in_tpkts(in_pkts);
+        last_uve.set_in_bytes(in_bytes);
+        changed = true;
+    }
+
+    uint64_t diff_out_bytes = 0;
+    if (UveVnIfOutStatsChanged(out_bytes, out_pkts, last_uve)) {
+        s_vn->set_out_tpkts(out_pkts);
+        s_vn->set_out_bytes(out_bytes);
+        last_uve.set_out_tpkts(out_pkts);
+        last_uve.set_out_bytes(out_bytes);
+        changed = true;
+    }
+
+    uint64_t diff_seconds = 0;
+    uint64_t cur_time = UTCTimestampUsec();
+    bool send_bandwidth = false;
+    uint64_t in_band, out_band;
+    if (prev_uve_vn_entry.prev_stats_update_time == 0) {
+        in_band = out_band = 0;
+        send_bandwidth = true;
+        prev_uve_vn_entry.prev_stats_update_time = cur_time;
+    } else {
+        diff_seconds = (cur_time - prev_uve_vn_entry.prev_stats_update_time) / 
+                       bandwidth_intvl_;
+        if (diff_seconds > 0) {
+            diff_in_bytes = in_bytes - prev_uve_vn_entry.prev_in_bytes;
+            diff_out_bytes = out_bytes - prev_uve_vn_entry.prev_out_bytes;
+            in_band = (diff_in_bytes * 8)/diff_seconds;
+            out_band = (diff_out_bytes * 8)/diff_seconds;
+            prev_uve_vn_entry.prev_stats_update_time = cur_time;
+            prev_uve_vn_entry.prev_in_bytes = in_bytes;
+            prev_uve_vn_entry.prev_out_bytes = out_bytes;
+            send_bandwidth = true;
+        }
+    }
+    if (send_bandwidth && UveVnInBandChanged(in_band, last_uve)) {
+        s_vn->set_in_bandwidth_usage(in_band);
+        last_uve.set_in_bandwidth_usage(in_band);
+        changed = true;
+    }
+
+    if (send_bandwidth && UveVnOutBandChanged(out_band, last_uve)) {
+        s_vn->set_out_bandwidth_usage(out_band);
+        last_uve.set_out_bandwidth_usage(out_band);
+        changed = true;
+    }
+
+    // Bandwidth has to be recomputed in the next interval till it drops to
+    // zero, even if the counters do not change
+    if (!send_bandwidth || last_uve.get_in_bandwidth_usage() ||
+        last_uve.get_out_bandwidth_usage()) {
+        MarkVnDirty(it->first, UVE_DIRTY_IF_STATS);
+    }
+    return changed;
+}
+
 void UveClient::SendVnMsg(const VnEntry *vn, bool stats) {
     if (vn->GetName() == Agent::GetInstance()->NullString()) {
        return;
@@ -1018,12 +1121,35 @@ void UveClient::SendVnMsg(const VnEntry *vn, bool stats) {
     UveVnEntry uve;
     bool send;
     if (stats) {
-        send = FrameVnStatsMsg(vn, &it->second.port_bitmap, &uve);
+        send = FrameVnStatsMsg(vn, &it->second.port_bitmap, &uve,
+                               UVE_DIRTY_ALL);
     } else {
         send = FrameVnMsg(vn, &it->second.port_bitmap, &uve);
     }
     if (send) {
         UveVirtualNetworkAgentTrace::Send(uve.uve_info);
+        send_stats_.vn_uves++;
+    }
+}
+
+void UveClient::SendVnStatsMsg(LastVnUveSet::iterator &it) {
+    UveVnEntry &entry = it->second;
+    uint32_t dirty;
+    {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        dirty = entry.dirty;
+        entry.dirty = UVE_DIRTY_NONE;
+    }
+
+    const VnEntry *vn = entry.vn;
+    if (vn == NULL || vn_intf_map_.find(vn) == vn_intf_map_.end()) {
+        return;
+    }
+
+    UveVnEntry uve;
+    if (FrameVnStatsMsg(vn, &entry.port_bitmap, &uve, dirty)) {
+        UveVirtualNetworkAgentTrace::Send(uve.uve_info);
+        send_stats_.vn_uves++;
     }
 }
 
@@ -1072,6 +1198,7 @@ void UveClient::SendUnresolvedVnMsg(string vn_name) {
 
     if (changed) {
         UveVirtualNetworkAgentTrace::Send(uve.uve_info);
+        send_stats_.vn_uves++;
     }
 }
 
@@ -1119,7 +1246,7 @@ bool UveClient::UveVnFipCountChanged(int32_t size,
     return false;
 }
 
-bool UveClient::UveVnAclChanged(string name, 
+bool UveClient::UveVnAclChanged(const string &name, 
                                 const UveVirtualNetworkAgent &s_vn) {
     if (!s_vn.__isset.acl) {
         return true;
@@ -1130,7 +1257,7 @@ bool UveClient::UveVnAclChanged(string name,
     return false;
 }
 
-bool UveClient::UveVnMirrorAclChanged(string name, const 
+bool UveClient::UveVnMirrorAclChanged(const string &name, const 
                                       UveVirtualNetworkAgent &s_vn) {
     if (!s_vn.__isset.mirror_acl) {
         return true;
@@ -1191,7 +1318,7 @@ bool UveClient::UveVnOutBandChanged(uint64_t out_band,
     return false;
 }
 
-bool UveClient::UveVnVrfStatsChanged(vector<UveVrfStats> &vlist, 
+bool UveClient::UveVnVrfStatsChanged(const vector<UveVrfStats> &vlist, 
                                     const UveVirtualNetworkAgent &prev_vn) {
     if (!prev_vn.__isset.vrf_stats_list) {
         return true;
@@ -1202,7 +1329,7 @@ bool UveClient::UveVnVrfStatsChanged(vector<UveVrfStats> &vlist,
     return false;
 }
 
-bool UveClient::UveVnIfListChanged(vector<string> new_list, 
+bool UveClient::UveVnIfListChanged(const vector<string> &new_list, 
                                    const UveVirtualNetworkAgent &s_vn) {
     if (!s_vn.__isset.interface_list) {
         return true;
@@ -1225,8 +1352,9 @@ bool UveClient::UveInterVnStatsChanged(const vector<InterVnStats> &new_list,
     return false;
 }
 
-bool UveClient::UveInterVnInStatsChanged(vector<UveInterVnStats> new_list, 
-                                         const UveVirtualNetworkAgent &s_vn) {
+bool UveClient::UveInterVnInStatsChanged
+    (const vector<UveInterVnStats> &new_list,
+     const UveVirtualNetworkAgent &s_vn) {
     if (!s_vn.__isset.in_stats) {
         return true;
     }
@@ -1236,8 +1364,9 @@ bool UveClient::UveInterVnInStatsChanged(vector<UveInterVnStats> new_list,
     return false;
 }
 
-bool UveClient::UveInterVnOutStatsChanged(vector<UveInterVnStats> new_list, 
-                                          const UveVirtualNetworkAgent &s_vn) {
+bool UveClient::UveInterVnOutStatsChanged
+    (const vector<UveInterVnStats> &new_list,
+     const UveVirtualNetworkAgent &s_vn) {
     if (!s_vn.__isset.out_stats) {
         return true;
     }
@@ -1247,17 +1376,30 @@ bool UveClient::UveInterVnOutStatsChanged(vector<UveInterVnStats> new_list,
     return false;
 }
 
+// Send stats for the VNs marked dirty since the previous call
 void UveClient::SendVnStats(void) {
-    //Go thru VN and send there stats
-    const VnEntry *prev_vn = NULL;
-    for (VnIntfMap::iterator it = vn_intf_map_.begin(); 
-         it != vn_intf_map_.end(); ++it) {
-        const VnEntry *vn = it->first;
-        if (prev_vn == vn) {
+    DirtySet dirty_set;
+    {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        if (++vn_resync_count_ >= kVnResyncCount) {
+            vn_resync_count_ = 0;
+            for (LastVnUveSet::iterator it = last_vn_uve_set_.begin();
+                 it != last_vn_uve_set_.end(); ++it) {
+                it->second.dirty |= UVE_DIRTY_ALL;
+                dirty_vn_set_.insert(it->first);
+            }
+        }
+        dirty_set.swap(dirty_vn_set_);
+    }
+    send_stats_.vn_skipped += last_vn_uve_set_.size() - dirty_set.size();
+
+    for (DirtySet::iterator it = dirty_set.begin(); it != dirty_set.end();
+         ++it) {
+        LastVnUveSet::iterator uve_it = last_vn_uve_set_.find(*it);
+        if (uve_it == last_vn_uve_set_.end()) {
             continue;
         }
-        SendVnMsg(vn, true);
-        prev_vn = vn;
+        SendVnStatsMsg(uve_it);
     }
     SendUnresolvedVnMsg(*FlowHandler::UnknownVn());
     SendUnresolvedVnMsg(*FlowHandler::LinkLocalVn());
@@ -1287,7 +1429,19 @@ void UveClient::VnNotify(DBTablePartBase *partition, DBEntryBase *e) {
             s_vn.set_name(vn->GetName());
             s_vn.set_deleted(true); 
             UveVirtualNetworkAgentTrace::Send(s_vn);
-            last_vn_uve_set_.erase(s_vn.get_name());
+            send_stats_.vn_uves++;
+
+            {
+                tbb::mutex::scoped_lock lock(dirty_mutex_);
+                LastVnUveSet::iterator it =
+                    last_vn_uve_set_.find(vn->GetName());
+                if (it != last_vn_uve_set_.end() &&
+                    !it->second.vrf_name.empty()) {
+                    vrf_vn_map_.erase(it->second.vrf_name);
+                }
+                last_vn_uve_set_.erase(s_vn.get_name());
+                dirty_vn_set_.erase(s_vn.get_name());
+            }
 
             delete state;
             e->ClearState(partition->parent(), vn_listener_id_);
@@ -1304,9 +1458,82 @@ void UveClient::VnNotify(DBTablePartBase *partition, DBEntryBase *e) {
         AddLastVnUve(vn->GetName());
     }
 
+    LastVnUveSet::iterator it = last_vn_uve_set_.find(vn->GetName());
+    if (it != last_vn_uve_set_.end()) {
+        it->second.vn = vn;
+        UpdateVnVrf(vn, &it->second);
+        MarkVnDirty(vn->GetName(), UVE_DIRTY_ALL);
+    }
+
     SendVnMsg(vn, false);
 }
 
+void UveClient::UpdateVnVrf(const VnEntry *vn, UveVnEntry *entry) {
+    string vrf_name;
+    if (vn->GetVrf()) {
+        vrf_name = vn->GetVrf()->GetName();
+    }
+    if (vrf_name == entry->vrf_name) {
+        return;
+    }
+    tbb::mutex::scoped_lock lock(dirty_mutex_);
+    if (!entry->vrf_name.empty()) {
+        vrf_vn_map_.erase(entry->vrf_name);
+    }
+    if (!vrf_name.empty()) {
+        vrf_vn_map_[vrf_name] = vn->GetName();
+    }
+    entry->vrf_name = vrf_name;
+}
+
+// Invoked from the flow and stats collector tasks as well as the DB task
+void UveClient::MarkVmDirty(const string &vm_name, uint32_t flags) {
+    tbb::mutex::scoped_lock lock(dirty_mutex_);
+    LastVmUveSet::iterator it = last_vm_uve_set_.find(vm_name);
+    if (it == last_vm_uve_set_.end()) {
+        return;
+    }
+    it->second.dirty |= flags;
+    dirty_vm_set_.insert(vm_name);
+}
+
+void UveClient::MarkVnDirty(const string &vn_name, uint32_t flags) {
+    tbb::mutex::scoped_lock lock(dirty_mutex_);
+    LastVnUveSet::iterator it = last_vn_uve_set_.find(vn_name);
+    if (it == last_vn_uve_set_.end()) {
+        return;
+    }
+    it->second.dirty |= flags;
+    dirty_vn_set_.insert(vn_name);
+}
+
+void UveClient::IntfStatsChanged(const Interface *intf) {
+    if (intf->GetType() != Interface::VMPORT) {
+        return;
+    }
+    const VmPortInterface *vm_port = static_cast<const VmPortInterface *>(intf);
+    if (vm_port->GetVmEntry()) {
+        MarkVmDirty(vm_port->GetVmEntry()->GetCfgName(), UVE_DIRTY_IF_STATS);
+    }
+    if (vm_port->GetVnEntry()) {
+        MarkVnDirty(vm_port->GetVnEntry()->GetName(), UVE_DIRTY_IF_STATS);
+    }
+}
+
+// Invoked from the stats collector task, vrf_vn_map_ is updated in DB task
+void UveClient::VrfStatsChanged(const VrfEntry *vrf) {
+    string vn_name;
+    {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        VrfVnMap::iterator it = vrf_vn_map_.find(vrf->GetName());
+        if (it == vrf_vn_map_.end()) {
+            return;
+        }
+        vn_name = it->second;
+    }
+    MarkVnDirty(vn_name, UVE_DIRTY_VRF_STATS);
+}
+
 void UveClient::VnWalkDone(DBTableBase *base, 
                            std::vector<std::string> *vn_list) {
     VrouterAgent vrouter_agent;
@@ -1855,12 +2082,14 @@ void UveClient::NewFlow(const FlowEntry *flow) {
     LastVnUveSet::iterator vn_it = last_vn_uve_set_.find(flow->data.source_vn);
     if (vn_it != last_vn_uve_set_.end()) {
         vn_it->second.port_bitmap.AddPort(proto, sport, dport);
+        MarkVnDirty(vn_it->first, UVE_DIRTY_PORT_BITMAP | UVE_DIRTY_FLOW);
     }
 
     // Update dest-vn port bitmap
     vn_it = last_vn_uve_set_.find(flow->data.dest_vn);
     if (vn_it != last_vn_uve_set_.end()) {
         vn_it->second.port_bitmap.AddPort(proto, sport, dport);
+        MarkVnDirty(vn_it->first, UVE_DIRTY_PORT_BITMAP | UVE_DIRTY_FLOW);
     }
 
     const Interface *intf = flow->data.intf_entry.get();
@@ -1882,6 +2111,7 @@ void UveClient::NewFlow(const FlowEntry *flow) {
     LastVmUveSet::iterator vm_it = last_vm_uve_set_.find(vm->GetCfgName());
     if (vm_it != last_vm_uve_set_.end()) {
         vm_it->second.port_bitmap.AddPort(proto, sport, dport);
+        MarkVmDirty(vm_it->first, UVE_DIRTY_PORT_BITMAP);
     }
 
     // Update Intf port bitmap in VM
@@ -1922,6 +2152,8 @@ void UveClient::BuildXmppStatsList(vector<AgentXmppStats> &list) {
 void UveClient::DeleteFlow(const FlowEntry *flow) {
     /* We need not reset bitmaps on flow deletion. We will have to 
      * provide introspect to reset this */
+    MarkVnDirty(flow->data.source_vn, UVE_DIRTY_FLOW);
+    MarkVnDirty(flow->data.dest_vn, UVE_DIRTY_FLOW);
 }
 
 bool UveClient::SendAgentStats() {
@@ -2156,6 +2388,7 @@ bool UveClient::SendAgentStats() {
 void UveClient::AddLastVnUve(string vn_name) {
     UveVnEntry uve;
     uve.uve_info.set_name(vn_name);
+    tbb::mutex::scoped_lock lock(dirty_mutex_);
     last_vn_uve_set_.insert(LastVnUvePair(vn_name, uve));
 }
 
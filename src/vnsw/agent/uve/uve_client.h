@@ -15,6 +15,7 @@
 #include <uve/flow_uve.h>
 #include <oper/interface.h>
 #include <uve/agent_stats.h>
+#include <tbb/mutex.h>
 
 class UveClientTest;
 class VmStat;
@@ -52,15 +53,33 @@ struct UveVnVmEntryCmp {
     }
 };
 
+// Attributes of a VM/VN UVE that may have changed since they were last
+// framed. Only the marked attributes are framed in the periodic stats message
+enum UveDirtyFlags {
+    UVE_DIRTY_NONE = 0,
+    UVE_DIRTY_IF_STATS = 1 << 0,    // interface counters and bandwidth
+    UVE_DIRTY_PORT_BITMAP = 1 << 1, // L4 port bitmaps
+    UVE_DIRTY_FLOW = 1 << 2,        // flow counts
+    UVE_DIRTY_INTER_VN = 1 << 3,    // inter-vn stats
+    UVE_DIRTY_VRF_STATS = 1 << 4,   // vrf stats
+    UVE_DIRTY_CONFIG = 1 << 5,      // acl rule count, floating-ip count
+    UVE_DIRTY_ALL = 0x3F
+};
+
 struct UveVmEntry {
     L4PortBitmap port_bitmap;
     UveVirtualMachineAgent  uve_info;
+    const VmEntry *vm;
+    uint32_t dirty;
 
-    UveVmEntry() : port_bitmap(), uve_info() { }
+    UveVmEntry() : port_bitmap(), uve_info(), vm(NULL),
+                   dirty(UVE_DIRTY_NONE) { }
     ~UveVmEntry() {}
     UveVmEntry(const UveVmEntry &rhs) {
         port_bitmap = rhs.port_bitmap;
         uve_info = rhs.uve_info;
+        vm = rhs.vm;
+        dirty = rhs.dirty;
     }
 };
 
@@ -70,9 +89,13 @@ struct UveVnEntry {
     uint64_t prev_stats_update_time;
     uint64_t prev_in_bytes;
     uint64_t prev_out_bytes;
+    const VnEntry *vn;
+    std::string vrf_name;
+    uint32_t dirty;
 
     UveVnEntry() : port_bitmap(), uve_info(), prev_stats_update_time(0),
-                   prev_in_bytes(0), prev_out_bytes(0) { }
+                   prev_in_bytes(0), prev_out_bytes(0), vn(NULL), vrf_name(),
+                   dirty(UVE_DIRTY_NONE) { }
     ~UveVnEntry() {}
     UveVnEntry(const UveVnEntry &rhs) {
         port_bitmap = rhs.port_bitmap;
@@ -80,6 +103,9 @@ struct UveVnEntry {
         prev_stats_update_time = rhs.prev_stats_update_time;
         prev_in_bytes = rhs.prev_in_bytes;
         prev_out_bytes = rhs.prev_out_bytes;
+        vn = rhs.vn;
+        vrf_name = rhs.vrf_name;
+        dirty = rhs.dirty;
     }
 };
 
@@ -102,6 +128,23 @@ public:
     static const uint8_t bandwidth_mod_1min = 2;
     static const uint8_t bandwidth_mod_5min = 10;
     static const uint8_t bandwidth_mod_10min = 20;
+    // Attributes without change notification (ex. ACL rule count) are
+    // refreshed for all VNs once every kVnResyncCount calls to SendVnStats
+    static const uint32_t kVnResyncCount = 10;
+
+    // Number of VN/VM UVEs sent and skipped in a stats interval
+    struct UveSendStats {
+        UveSendStats() : vn_uves(0), vm_uves(0), vn_skipped(0),
+                         vm_skipped(0) { }
+        void Reset() {
+            vn_uves = vm_uves = vn_skipped = vm_skipped = 0;
+        }
+        uint32_t vn_uves;
+        uint32_t vm_uves;
+        uint32_t vn_skipped;    // clean VNs that were not framed
+        uint32_t vm_skipped;    // clean VMs that were not framed
+    };
+
     UveClient(uint64_t b_intvl) : 
         vn_vmlist_updates_(0), vn_vm_set_(), vn_intf_map_(),
         vm_intf_map_(), phy_intf_set_(), vn_listener_id_(DBTableBase::kInvalidId),
@@ -109,6 +152,8 @@ public:
         intf_listener_id_(DBTableBase::kInvalidId), prev_stats_(),
         prev_vrouter_(), last_vm_uve_set_(), last_vn_uve_set_(),
         port_bitmap_(), bandwidth_intvl_(b_intvl), 
+        dirty_vm_set_(), dirty_vn_set_(), vrf_vn_map_(), vn_resync_count_(0),
+        send_stats_(), last_send_stats_(), total_uves_sent_(0),
         signal_(*(Agent::GetInstance()->GetEventManager()->io_service())) {
             start_time_ = UTCTimestampUsec();
             AddLastVnUve(*FlowHandler::UnknownVn());
@@ -129,6 +174,8 @@ public:
     typedef std::map<std::string, UveVnEntry> LastVnUveSet;
     typedef std::pair<std::string, UveVnEntry> LastVnUvePair;
     typedef std::set<const Interface *> PhyIntfSet;
+    typedef std::set<std::string> DirtySet;
+    typedef std::map<std::string, std::string> VrfVnMap;
 
     
     bool GetUveVnEntry(const string vn_name, UveVnEntry &entry);
@@ -186,6 +233,24 @@ public:
     void NewFlow(const FlowEntry *flow);
     void DeleteFlow(const FlowEntry *flow);
 
+    // Mark the VM/VN UVEs to be framed in the next stats interval
+    void MarkVmDirty(const std::string &vm_name, uint32_t flags);
+    void MarkVnDirty(const std::string &vn_name, uint32_t flags);
+    // Invoked by the stats collectors when the counters change
+    void IntfStatsChanged(const Interface *intf);
+    void VrfStatsChanged(const VrfEntry *vrf);
+    uint32_t DirtyVmCount() const {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        return dirty_vm_set_.size();
+    }
+    uint32_t DirtyVnCount() const {
+        tbb::mutex::scoped_lock lock(dirty_mutex_);
+        return dirty_vn_set_.size();
+    }
+    const UveSendStats &send_stats() const { return send_stats_; }
+    const UveSendStats &last_send_stats() const { return last_send_stats_; }
+    uint64_t total_uves_sent() const { return total_uves_sent_; }
+
     static void Init();
     void Shutdown();
     void RegisterSigHandler();
@@ -218,35 +283,43 @@ private:
     bool UpdateVnFlowCount(const VnEntry *vn, LastVnUveSet::iterator &it, UveVirtualNetworkAgent *s_vn);
     bool BuildPhyIfList(std::vector<AgentIfStats> &phy_if_list);
     void BuildXmppStatsList(std::vector<AgentXmppStats> &list);
-    bool UveVmVRouterChanged(std::string &new_value, const UveVirtualMachineAgent &s_vm);
-    bool UveVmIfListChanged(std::vector<VmInterfaceAgent> &new_list, 
+    bool UveVmVRouterChanged(const std::string &new_value,
+                             const UveVirtualMachineAgent &s_vm);
+    bool UveVmIfListChanged(const std::vector<VmInterfaceAgent> &new_list, 
                             const UveVirtualMachineAgent &s_vm);
-    bool UveVnAclChanged(std::string name, const UveVirtualNetworkAgent &s_vn);
+    bool UveVnAclChanged(const std::string &name,
+                         const UveVirtualNetworkAgent &s_vn);
     bool UveVnAclRuleCountChanged(int32_t size, const UveVirtualNetworkAgent &s_vn);
-    bool UveVnMirrorAclChanged(std::string name,
+    bool UveVnMirrorAclChanged(const std::string &name,
                                const UveVirtualNetworkAgent &s_vn);
     bool UveVnIfInStatsChanged(uint64_t bytes, uint64_t pkts, 
                                const UveVirtualNetworkAgent &s_vn);
     bool UveVnIfOutStatsChanged(uint64_t bytes, uint64_t pkts, 
                                 const UveVirtualNetworkAgent &s_vn);
-    bool UveVnIfListChanged(vector<std::string> new_list, 
+    bool UveVnIfListChanged(const vector<std::string> &new_list, 
                             const UveVirtualNetworkAgent &s_vn);
     bool UveVnInBandChanged(uint64_t in_band, const UveVirtualNetworkAgent &prev_vn);
     bool UveVnOutBandChanged(uint64_t out_band, const UveVirtualNetworkAgent &prev_vn);
-    bool UveVnVrfStatsChanged(std::vector<UveVrfStats> &vlist, 
+    bool UveVnVrfStatsChanged(const std::vector<UveVrfStats> &vlist, 
                               const UveVirtualNetworkAgent &prev_vn);
-    bool UveInterVnInStatsChanged(vector<UveInterVnStats> new_list, 
+    bool UveInterVnInStatsChanged(const vector<UveInterVnStats> &new_list, 
                                   const UveVirtualNetworkAgent &s_vn);
-    bool UveInterVnOutStatsChanged(vector<UveInterVnStats> new_list, 
+    bool UveInterVnOutStatsChanged(const vector<UveInterVnStats> &new_list, 
                                    const UveVirtualNetworkAgent &s_vn);
     bool UveInterVnStatsChanged(const vector<InterVnStats> &new_list, 
                                 const UveVirtualNetworkAgent &s_vn) const;
     bool FrameVnStatsMsg(const VnEntry *vn, L4PortBitmap *vn_port_bitmap,
-                         UveVnEntry *uve);
+                         UveVnEntry *uve, uint32_t dirty);
     void SendVmAndVnMsg(const VmPortInterface* vm_port);
     bool FrameVmStatsMsg(const VmEntry *vm, L4PortBitmap *vm_port_bitmap,
-                         UveVmEntry *uve);
-    bool UveVmIfStatsListChanged(vector<VmInterfaceAgentStats> &new_list, 
+                         UveVmEntry *uve, uint32_t dirty);
+    void SendVmStatsMsg(LastVmUveSet::iterator &it);
+    void SendVnStatsMsg(LastVnUveSet::iterator &it);
+    bool FrameVnIfStats(LastVnUveSet::iterator &it, uint64_t in_pkts,
+                        uint64_t in_bytes, uint64_t out_pkts,
+                        uint64_t out_bytes, UveVirtualNetworkAgent *s_vn);
+    void UpdateVnVrf(const VnEntry *vn, UveVnEntry *entry);
+    bool UveVmIfStatsListChanged(const vector<VmInterfaceAgentStats> &new_list, 
                                  const UveVirtualMachineAgent &s_vm);
     bool FrameIntfStatsMsg(const VmPortInterface *vm_intf,
                            VmInterfaceAgentStats *s_intf);
@@ -268,6 +341,20 @@ private:
     LastVnUveSet last_vn_uve_set_;
     L4PortBitmap port_bitmap_;
     uint64_t bandwidth_intvl_; //in microseconds
+    // Names of the VMs/VNs with pending changes. Flags for the changed
+    // attributes are kept in UveVmEntry/UveVnEntry. Objects are marked from
+    // the flow and stats collector tasks, so the sets, the flags and the
+    // adds/deletes of UVE entries are done under dirty_mutex_
+    mutable tbb::mutex dirty_mutex_;
+    DirtySet dirty_vm_set_;
+    DirtySet dirty_vn_set_;
+    // VRF name to VN name, to map VRF stats to the VN UVE. Read from the
+    // stats collector task, so it is also updated under dirty_mutex_
+    VrfVnMap vrf_vn_map_;
+    uint32_t vn_resync_count_;
+    UveSendStats send_stats_;
+    UveSendStats last_send_stats_;
+    uint64_t total_uves_sent_;
     boost::asio::signal_set signal_;
     WorkQueue<VmStatData *> *event_queue_;
     uint64_t start_time_;
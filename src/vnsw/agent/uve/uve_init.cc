@@ -102,6 +102,22 @@ void GetStatsInterval::HandleRequest() const {
     return;
 }
 
+void GetUveSendStats::HandleRequest() const {
+    UveClient *client = UveClient::GetInstance();
+    const UveClient::UveSendStats &stats = client->last_send_stats();
+    UveSendStatsResp *resp = new UveSendStatsResp();
+    resp->set_vn_uves_last_interval(stats.vn_uves);
+    resp->set_vm_uves_last_interval(stats.vm_uves);
+    resp->set_vn_skipped_last_interval(stats.vn_skipped);
+    resp->set_vm_skipped_last_interval(stats.vm_skipped);
+    resp->set_dirty_vns(client->DirtyVnCount());
+    resp->set_dirty_vms(client->DirtyVmCount());
+    resp->set_total_uves_sent(client->total_uves_sent());
+    resp->set_context(context());
+    resp->Response();
+    return;
+}
+
 void AgentUve::Init() {
     UveClient::Init();
 }
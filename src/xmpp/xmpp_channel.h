@@ -36,6 +36,11 @@ public:
 
     virtual ~XmppChannel() { }
     virtual bool Send(const uint8_t *, size_t, xmps::PeerId, SendReadyCb) = 0;
+    // Hold back the messages of subsequent Sends until Uncork, to write a
+    // batch of them together. Uncork returns false if the connection is
+    // send blocked, the callback is invoked once it is ready again.
+    virtual void Cork() = 0;
+    virtual bool Uncork(xmps::PeerId, SendReadyCb) = 0;
     virtual void RegisterReceive(xmps::PeerId, ReceiveCb) = 0;
     virtual void UnRegisterReceive(xmps::PeerId) = 0;
     virtual std::string ToString() const = 0;
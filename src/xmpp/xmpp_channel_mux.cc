@@ -48,6 +48,22 @@ bool XmppChannelMux::Send(const uint8_t *msg, size_t msgsize,
     return res;
 }
 
+void XmppChannelMux::Cork() {
+    if (!connection_) return;
+    connection_->Cork();
+}
+
+bool XmppChannelMux::Uncork(xmps::PeerId id, SendReadyCb cb) {
+    if (!connection_) return true;
+
+    tbb::mutex::scoped_lock lock(mutex_);
+    bool res = connection_->Uncork();
+    if (res == false) {
+        RegisterWriteReady(id, cb);
+    }
+    return res;
+}
+
 void XmppChannelMux::RegisterReceive(xmps::PeerId id, ReceiveCb cb) {
     rxmap_.insert(make_pair(id, cb));
 }
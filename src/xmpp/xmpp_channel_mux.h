@@ -19,6 +19,8 @@ public:
     virtual ~XmppChannelMux();
 
     virtual bool Send(const uint8_t *, size_t, xmps::PeerId, SendReadyCb);
+    virtual void Cork();
+    virtual bool Uncork(xmps::PeerId, SendReadyCb);
     virtual void RegisterReceive(xmps::PeerId, ReceiveCb);
     virtual void UnRegisterReceive(xmps::PeerId);
     size_t ReceiverCount() const;
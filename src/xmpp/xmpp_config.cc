@@ -15,7 +15,8 @@ int const XmppChannelConfig::default_server_port = 5269;
 int const XmppChannelConfig::default_client_port = 5222;
 
 XmppChannelConfig::XmppChannelConfig(bool isClient) : 
-     ToAddr(""), FromAddr(""), NodeAddr(""), logUVE(false), isClient_(isClient) {
+     ToAddr(""), FromAddr(""), NodeAddr(""), logUVE(false), io_service(NULL),
+     isClient_(isClient) {
 }
 
 int XmppChannelConfig::CompareTo(const XmppChannelConfig &rhs) const {
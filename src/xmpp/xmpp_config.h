@@ -24,6 +24,9 @@ public:
     boost::asio::ip::tcp::endpoint endpoint;
     boost::asio::ip::tcp::endpoint local_endpoint;
     bool logUVE;
+    // io_service for the timers of the connection, that of the socket of
+    // its session. NULL for the main io_service of the event manager.
+    boost::asio::io_service *io_service;
 
     int CompareTo(const XmppChannelConfig &rhs) const;
     static int const default_client_port;
@@ -36,11 +36,13 @@ XmppConnection::XmppConnection(TcpServer *server,
       server_(server),
       endpoint_(config->endpoint),
       local_endpoint_(config->local_endpoint),
+      io_service_(config->io_service ? config->io_service :
+                  server->event_manager()->io_service()),
       config_(NULL),
       session_(NULL),
       state_machine_(new XmppStateMachine(this, config->ClientOnly())),
       keepalive_timer_(TimerManager::CreateTimer(
-                           *server->event_manager()->io_service(),
+                           *io_service_,
                            "Xmpp keepalive timer")),
       log_uve_(config->logUVE),
       admin_down_(false), 
@@ -182,6 +184,24 @@ bool XmppConnection::Send(const uint8_t *data, size_t size) {
     return session_->Send(data, size, &sent);
 }
 
+void XmppConnection::Cork() {
+    tbb::spin_mutex::scoped_lock lock(spin_mutex_);
+    if (session_ == NULL) {
+        return;
+    }
+    session_->Cork();
+}
+
+// Nothing is held back without a session, the corked data of a closed
+// session is discarded with it.
+bool XmppConnection::Uncork() {
+    tbb::spin_mutex::scoped_lock lock(spin_mutex_);
+    if (session_ == NULL) {
+        return true;
+    }
+    return session_->Uncork();
+}
+
 void XmppConnection::SendOpen(TcpSession *session) {
     if (!session) return;
     XmppProto::XmppStanza::XmppStreamMessage openstream;
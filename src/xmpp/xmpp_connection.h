@@ -46,6 +46,8 @@ public:
     virtual boost::asio::ip::tcp::endpoint endpoint() const;
     virtual boost::asio::ip::tcp::endpoint local_endpoint() const;
     TcpServer *server() { return server_; }
+    // io_service of the timers of the connection
+    boost::asio::io_service *io_service() { return io_service_; }
     XmppSession *CreateSession();
 
     std::string ToString() const; 
@@ -53,6 +55,8 @@ public:
     std::string FromString() const;
     void SetAdminDown(bool toggle);
     bool Send(const uint8_t *data, size_t size);
+    void Cork();
+    bool Uncork();
 
     // Xmpp connection messages
     void SendOpen(TcpSession *session);
@@ -183,6 +187,7 @@ private:
     TcpServer *server_;
     boost::asio::ip::tcp::endpoint endpoint_;
     boost::asio::ip::tcp::endpoint local_endpoint_;
+    boost::asio::io_service *io_service_;
     const XmppChannelConfig *config_;
     // Protection for session_ and keepalive_timer_
     tbb::spin_mutex spin_mutex_;
@@ -215,6 +215,8 @@ XmppConnection *XmppServer::CreateConnection(XmppSession *session) {
     cfg.endpoint = remote_endpoint;
     cfg.FromAddr = this->ServerAddr();
     cfg.logUVE = this->log_uve_;
+    // The timers of the connection run on the shard of its session
+    cfg.io_service = &session->socket()->get_io_service();
 
     XMPP_DEBUG(XmppCreateConnection,
                session->remote_endpoint().address().to_string());
@@ -281,6 +283,8 @@ bool XmppServer::DequeueSession(XmppConnection *connection) {
             // Also appropriately take care of asserts in bgp_xmpp_channel.cc
             // for ReceiveUpdate
             //
+            // The timers of the old connection stay on the shard of its
+            // first session.
             connection = loc->second;
             if (connection->session()) {
                 DeleteSession(connection->session());